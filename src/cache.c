@@ -0,0 +1,306 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "z80hla.h"
+
+#ifdef _WIN32
+#include <process.h>
+#include <io.h>
+#include <fcntl.h>
+#define getpid _getpid
+#define open _open
+#define write _write
+#define close _close
+#define O_WRONLY _O_WRONLY
+#define O_APPEND _O_APPEND
+#define O_CREAT _O_CREAT
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+// The build cache is a directory that can be shared by compilations in different directories or machines,
+// the files written by a compilation are kept there under a digest of the options and of the content of the
+// files read. Which files are read is only known after parsing, so for each digest of the options a manifest
+// has the files read by each build kept and the files it wrote. A build with the files read unchanged is
+// found before parsing and its files are copied to where they were written. SHA-256 is used for the digests,
+// two builds or files taken for the same one would restore the wrong files.
+
+#define BUILD_CACHE_HEADER      "z80hla build cache 2 v" Z80HLA_VERSION_HI "." Z80HLA_VERSION_LO
+
+#define DIGEST_TEXT_SIZE        (SHA256_SIZE * 2 + 1)
+
+struct CachedBuild
+{
+    struct Sha256 sha256;
+    char digest[DIGEST_TEXT_SIZE];
+    int written_count;
+    BOOL successful;
+
+    // The build as it is added to the manifest
+    char *record;
+    size_t record_size;
+    size_t record_capacity;
+};
+
+// The format of the cache is part of the name of the manifest, so a manifest only has builds in its format
+static void get_manifest_path(char *dst)
+{
+    struct Sha256 sha256;
+    uint8_t digest[SHA256_SIZE];
+    char digest_text[DIGEST_TEXT_SIZE];
+
+    init_sha256(&sha256);
+    update_sha256(&sha256, BUILD_CACHE_HEADER, sizeof(BUILD_CACHE_HEADER));
+    update_sha256(&sha256, context->build_options_digest, SHA256_SIZE);
+    finish_sha256(&sha256, digest);
+    sprint_digest(digest_text, digest);
+    sprintf(dst, "%s/%s.z80cm", context->cache_directory, digest_text);
+}
+
+static void get_cached_file_path(char *dst, char *build_digest, int index)
+{
+    sprintf(dst, "%s/%s.%d.z80cf", context->cache_directory, build_digest, index);
+}
+
+static BOOL copy_file(char *src, char *dst)
+{
+    FILE *fp_src = fopen(src, "rb");
+    if (!fp_src) { return FALSE; }
+
+    FILE *fp_dst = fopen(dst, "wb");
+    if (!fp_dst)
+    {
+        fclose(fp_src);
+        return FALSE;
+    }
+
+    char buffer[16384];
+    size_t read_size;
+    BOOL result = TRUE;
+    while (result && (read_size = fread(buffer, 1, sizeof(buffer), fp_src)) > 0)
+    {
+        result = fwrite(buffer, 1, read_size, fp_dst) == read_size;
+    }
+    result = result && !ferror(fp_src);
+    fclose(fp_src);
+
+    return !fclose(fp_dst) && result;
+}
+
+static BOOL is_file_digest(char *filename, BOOL binary, char *digest)
+{
+    uint8_t current_digest[SHA256_SIZE];
+    char current_digest_text[DIGEST_TEXT_SIZE];
+    if (!digest_file(filename, binary, current_digest)) { return FALSE; }
+    sprint_digest(current_digest_text, current_digest);
+
+    return !strcmp(digest, current_digest_text);
+}
+
+// Lines of a build are "build DIGEST", "read t|b DIGEST FILE" for each file read, "written FILE" for each
+// file written and "end DIGEST". The files of the first build with all the files read unchanged are copied,
+// a build without its own "end" (the compilation adding it stopped while writing it) is skipped.
+static BOOL restore_build(FILE *fp)
+{
+    char line[1024], build_digest[DIGEST_TEXT_SIZE], digest[DIGEST_TEXT_SIZE];
+    BOOL in_build = FALSE, unchanged = FALSE, found = FALSE;
+    int written_count = 0;
+    char **written_paths = NULL;
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        int name_start = 0;
+        char mode = 0;
+        line[strcspn(line, "\r\n")] = 0;
+
+        if (sscanf(line, "build %64s", digest) == 1)
+        {
+            strcpy(build_digest, digest);
+            in_build = unchanged = TRUE;
+            for(int i = 0; i < written_count; i++)
+            {
+                free(written_paths[i]);
+            }
+            written_count = 0;
+        }
+        else if (!in_build || !unchanged)
+        {
+            in_build = in_build && strncmp(line, "end ", 4);
+        }
+        else if (sscanf(line, "read %c %64s %n", &mode, digest, &name_start) == 2 && name_start > 0)
+        {
+            unchanged = is_file_digest(line + name_start, mode == 'b', digest);
+        }
+        else if (!strncmp(line, "written ", 8))
+        {
+            written_paths = (char **)realloc(written_paths, sizeof(char *) * (written_count + 1));
+            written_paths[written_count] = (char *)malloc(strlen(line + 8) + 1);
+            strcpy(written_paths[written_count++], line + 8);
+        }
+        else if (sscanf(line, "end %64s", digest) == 1 && !strcmp(digest, build_digest) && written_count > 0)
+        {
+            found = TRUE;
+            break;
+        }
+        else
+        {
+            in_build = FALSE;
+        }
+    }
+
+    BOOL restored = found;
+    for(int i = 0; i < written_count; i++)
+    {
+        char cached_path[1024];
+        get_cached_file_path(cached_path, build_digest, i);
+        restored = restored && copy_file(cached_path, written_paths[i]);
+        free(written_paths[i]);
+    }
+    free(written_paths);
+
+    return restored;
+}
+
+// TRUE when the files written by a build with the same options and files read were copied from the cache
+BOOL restore_cached_build()
+{
+    char path[1024];
+
+    if (context->cache_directory == NULL) { return FALSE; }
+
+    if (!make_directory(context->cache_directory))
+    {
+        write_error("Unable to create build cache directory \"%s\"", context->cache_directory);
+        context->cache_directory = NULL;
+        return FALSE;
+    }
+
+    get_manifest_path(path);
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) { return FALSE; }
+
+    BOOL restored = restore_build(fp);
+    fclose(fp);
+
+    return restored;
+}
+
+static void digest_read_file(char *filename, BOOL binary, uint8_t *digest, void *argument)
+{
+    struct CachedBuild *build = (struct CachedBuild *)argument;
+    update_sha256(&build->sha256, &binary, sizeof(binary));
+    update_sha256(&build->sha256, digest, SHA256_SIZE);
+    update_sha256(&build->sha256, filename, strlen(filename) + 1);
+}
+
+static void add_to_record(struct CachedBuild *build, char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int size = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+
+    if (build->record_size + (size_t)size + 1 > build->record_capacity)
+    {
+        build->record_capacity = MAX(build->record_capacity * 2, build->record_size + (size_t)size + 1024);
+        build->record = (char *)realloc(build->record, build->record_capacity);
+    }
+
+    va_start(args, fmt);
+    vsnprintf(build->record + build->record_size, (size_t)size + 1, fmt, args);
+    va_end(args);
+    build->record_size += (size_t)size;
+}
+
+static void add_read_file(char *filename, BOOL binary, uint8_t *digest, void *argument)
+{
+    char digest_text[DIGEST_TEXT_SIZE];
+    sprint_digest(digest_text, digest);
+    add_to_record((struct CachedBuild *)argument, "read %c %s %s\n", binary ? 'b' : 't', digest_text, filename);
+}
+
+// Written files are copied to a temporary file first, so a compilation reading the cache at the same
+// time never finds one partly written
+static void store_written_file(char *path, void *argument)
+{
+    struct CachedBuild *build = (struct CachedBuild *)argument;
+    char cached_path[1024], temporary_path[1024 + 32];
+
+    if (!build->successful) { return; }
+
+    get_cached_file_path(cached_path, build->digest, build->written_count++);
+    sprintf(temporary_path, "%s.%d.tmp", cached_path, (int)getpid());
+    build->successful = copy_file(path, temporary_path) && !rename(temporary_path, cached_path);
+    if (!build->successful)
+    {
+        remove(temporary_path);
+    }
+}
+
+static void add_written_file_to_record(char *path, void *argument)
+{
+    add_to_record((struct CachedBuild *)argument, "written %s\n", path);
+}
+
+// The files written by a successful compilation are kept in the cache and the build is added to the
+// manifest. Builds are only appended, each one with a single write to the end of the file, so the
+// builds added by compilations at the same time are never mixed.
+void store_cached_build(BOOL successful)
+{
+    char path[1024];
+
+    if (context->cache_directory == NULL || !successful) { return; }
+
+    struct CachedBuild build;
+    memset(&build, 0, sizeof(build));
+    uint8_t digest[SHA256_SIZE];
+    init_sha256(&build.sha256);
+    update_sha256(&build.sha256, BUILD_CACHE_HEADER, sizeof(BUILD_CACHE_HEADER));
+    update_sha256(&build.sha256, context->build_options_digest, SHA256_SIZE);
+    for_each_cached_file(digest_read_file, &build);
+    finish_sha256(&build.sha256, digest);
+    sprint_digest(build.digest, digest);
+
+    build.successful = TRUE;
+    for_each_written_file(store_written_file, &build);
+    if (!build.successful || build.written_count == 0) { return; }
+
+    add_to_record(&build, "build %s\n", build.digest);
+    for_each_cached_file(add_read_file, &build);
+    for_each_written_file(add_written_file_to_record, &build);
+    add_to_record(&build, "end %s\n", build.digest);
+
+    get_manifest_path(path);
+    int fd = open(path, O_WRONLY | O_APPEND | O_CREAT, 0666);
+    if (fd >= 0)
+    {
+        write(fd, build.record, build.record_size);
+        close(fd);
+    }
+    free(build.record);
+}
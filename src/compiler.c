@@ -28,53 +28,54 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
-
-static int output_length = 0;
-
-struct OutputElement
-{
-    uint8_t value;
-    struct ASTNode *node;
-    BOOL final; // an element to be written to the output file
-    BOOL set_address; // set compiler address at this point
-
-    struct OutputElement *next, *previous;
-};
-
-struct OutputElement *first_output_elem, *last_output_elem;
+#include <errno.h>
 
 void init_compiler()
 {
-    first_output_elem = (struct OutputElement *)malloc(sizeof(struct OutputElement));
-    first_output_elem->node = NULL;
-    first_output_elem->next = NULL;
-    first_output_elem->previous = NULL;
+    context->first_output_elem = (struct OutputElement *)malloc(sizeof(struct OutputElement));
+    context->first_output_elem->node = NULL;
+    context->first_output_elem->next = NULL;
+    context->first_output_elem->previous = NULL;
+
+    context->first_output_elem->final = FALSE;
+    context->first_output_elem->size = 1;
+    context->first_output_elem->values = NULL;
 
-    last_output_elem = first_output_elem;
+    context->last_output_elem = context->first_output_elem;
 
-    output_length = 0;
+    context->output_length = 0;
+    context->output_bytes = 0;
 }
 
 static void inner_add_output_element(uint8_t value, struct ASTNode *node, BOOL final, BOOL set_address)
 {
-    struct OutputElement *elem = first_output_elem;
+    struct OutputElement *elem = context->first_output_elem;
 
-    if (output_length > 0)
+    if (context->output_length > 0)
     {
         elem = (struct OutputElement *)malloc(sizeof(struct OutputElement));
         elem->next = NULL;
-        elem->previous = last_output_elem;
-        last_output_elem->next = elem;
+        elem->previous = context->last_output_elem;
+        context->last_output_elem->next = elem;
 
-        last_output_elem = elem;
+        context->last_output_elem = elem;
     }
 
     elem->value = value;
+    elem->values = NULL;
+    elem->size = 1;
     elem->node = node;
     elem->final = final;
     elem->set_address = set_address;
 
-    output_length++;
+    context->output_length++;
+    if (final) { context->output_bytes++; }
+
+    COUNT_STAT(output_elements);
+    if (node != NULL)
+    {
+        COUNT_STAT(output_fixups[node->type]);
+    }
 }
 
 void add_output_element(uint8_t value, struct ASTNode *node)
@@ -92,12 +93,21 @@ static void add_output_element_not_final(struct ASTNode *node)
     inner_add_output_element(0, node, FALSE, FALSE);
 }
 
-static int struct_count = 0;
+// Adds a run of bytes as a single element, values are not copied
+static void add_output_run(uint8_t *values, int size)
+{
+    if (size <= 0) { return; }
+
+    inner_add_output_element(values != NULL ? values[0] : 0, NULL, TRUE, TRUE);
+    context->last_output_elem->values = values;
+    context->last_output_elem->size = size;
+    context->output_bytes += size - 1;
+}
 
 static char *get_new_struct_name()
 {
-    char *name = (char *)malloc(sizeof(char) * 32);
-    sprintf(name, "@%d", struct_count++);
+    char *name = (char *)allocate_context_memory(sizeof(char) * 32);
+    sprintf(name, "@%d", context->struct_count++);
     return name;
 }
 
@@ -185,33 +195,47 @@ static int build_structured_type(struct ASTNode *struct_node, char **name, int *
 
 static void write_print_start(char *filename, int current_line)
 {
-	printf("[%s:%d] ", filename, current_line);
+	write_print("[%s:%d] ", filename, current_line);
 }
 
 static void write_print_string(char *str, int str_size)
 {
-	printf("%.*s", str_size, str);
+	write_print("%.*s", str_size, str);
 }
 
 static void write_print_expression(int64_t value)
 {
-	printf("%"PRId64"", value);
+	write_print("%"PRId64"", value);
 }
 
 static void write_print_end()
 {
-	printf("\n");
+	write_print("\n");
+}
+
+// Labels generated for control structures are only identified by a number
+int get_new_label()
+{
+    return context->new_label_count++;
+}
+
+static struct ASTNode *create_label_expression_node(int label)
+{
+    struct ASTNode *expression_node = create_node_str(NODE_TYPE_EXPRESSION, NULL, "@", 1);
+    expression_node->num_value = label;
+
+    return expression_node;
 }
 
-static int new_label_count = 0;
-char *get_new_label()
+static struct ASTNode *create_label_node(int label)
 {
-    char *label = (char*)malloc(sizeof(char) * 64);
-    sprintf(label, "@l_%d", new_label_count++);
-    return label;
+    struct ASTNode *label_node = create_node(NODE_TYPE_GENERATED_LABEL, NULL);
+    label_node->num_value = label;
+
+    return label_node;
 }
 
-static struct ASTNode *create_jp_cond_node(char *cond, int cond_size, char *label)
+static struct ASTNode *create_jp_cond_node(char *cond, int cond_size, int label)
 {
     struct ASTNode *jp_node = create_node_str(NODE_TYPE_OP, NULL, "jp", 2);
     struct ASTNode *jp_op1_node = create_node_str(NODE_TYPE_COND, NULL, cond, cond_size);
@@ -219,7 +243,7 @@ static struct ASTNode *create_jp_cond_node(char *cond, int cond_size, char *labe
     {
         jp_op1_node->type = NODE_TYPE_REGISTER;
     }
-    struct ASTNode *jp_op2_node = create_node_str(NODE_TYPE_EXPRESSION, NULL, label, (int)strlen(label));
+    struct ASTNode *jp_op2_node = create_label_expression_node(label);
     jp_node->children[0] = jp_op1_node;
     jp_node->children[1] = jp_op2_node;
     jp_node->children_count = 2;
@@ -227,7 +251,7 @@ static struct ASTNode *create_jp_cond_node(char *cond, int cond_size, char *labe
     return jp_node;
 }
 
-static struct ASTNode *create_jr_cond_node(char *cond, int cond_size, char *label)
+static struct ASTNode *create_jr_cond_node(char *cond, int cond_size, int label)
 {
     struct ASTNode *jp_node = NULL;
     if (is_str_equal(cond, cond_size, "c") || is_str_equal(cond, cond_size, "nc") || is_str_equal(cond, cond_size, "z") || is_str_equal(cond, cond_size, "nz"))
@@ -243,7 +267,7 @@ static struct ASTNode *create_jr_cond_node(char *cond, int cond_size, char *labe
     {
         jp_op1_node->type = NODE_TYPE_REGISTER;
     }
-    struct ASTNode *jp_op2_node = create_node_str(NODE_TYPE_EXPRESSION, NULL, label, (int)strlen(label));
+    struct ASTNode *jp_op2_node = create_label_expression_node(label);
     jp_node->children[0] = jp_op1_node;
     jp_node->children[1] = jp_op2_node;
     jp_node->children_count = 2;
@@ -251,7 +275,7 @@ static struct ASTNode *create_jr_cond_node(char *cond, int cond_size, char *labe
     return jp_node;
 }
 
-static struct ASTNode *create_reverse_jp_cond_node(char *cond, int cond_size, char *label)
+static struct ASTNode *create_reverse_jp_cond_node(char *cond, int cond_size, int label)
 {
     if (is_str_equal(cond, cond_size, "c"))
     {
@@ -289,7 +313,7 @@ static struct ASTNode *create_reverse_jp_cond_node(char *cond, int cond_size, ch
     return NULL;
 }
 
-static struct ASTNode *create_reverse_jr_cond_node(char *cond, int cond_size, char *label)
+static struct ASTNode *create_reverse_jr_cond_node(char *cond, int cond_size, int label)
 {
     if (is_str_equal(cond, cond_size, "c"))
     {
@@ -327,41 +351,76 @@ static struct ASTNode *create_reverse_jr_cond_node(char *cond, int cond_size, ch
     return NULL;
 }
 
-static struct ASTNode *create_jp_node(char *label)
+static struct ASTNode *create_jp_node(int label)
 {
     struct ASTNode *jp_node = create_node_str(NODE_TYPE_OP, NULL, "jp", 2);
-    struct ASTNode *jp_op1_node = create_node_str(NODE_TYPE_EXPRESSION, NULL, label, (int)strlen(label));
+    struct ASTNode *jp_op1_node = create_label_expression_node(label);
     jp_node->children[0] = jp_op1_node;
     jp_node->children_count = 1;
 
     return jp_node;
 }
 
-static struct ASTNode *create_jr_node(char *label)
+static struct ASTNode *create_jr_node(int label)
 {
     struct ASTNode *jr_node = create_node_str(NODE_TYPE_OP, NULL, "jr", 2);
-    struct ASTNode *jr_op1_node = create_node_str(NODE_TYPE_EXPRESSION, NULL, label, (int)strlen(label));
+    struct ASTNode *jr_op1_node = create_label_expression_node(label);
     jr_node->children[0] = jr_op1_node;
     jr_node->children_count = 1;
 
     return jr_node;
 }
 
-static struct ASTNode *add_main_node_to_end(struct ASTNode *child_node, struct ASTNode *last_main_node)
+// Flat list of the ops, labels, data and directives to assemble, in output order.
+// It is produced by the first pass and walked by the second pass.
+struct IRElement
+{
+    struct ASTNode *node;
+    int length; // length of an op in bytes
+    int library_symbol_end; // on the label of a library function, index of the element after its code
+};
+
+// Appends an element, a NULL node reserves its place to be set later
+static int add_ir_element(struct ASTNode *node)
+{
+    if (context->ir_elements_count == context->ir_elements_capacity)
+    {
+        context->ir_elements_capacity = MAX(1024, context->ir_elements_capacity * 2);
+        context->ir_elements = (struct IRElement *)realloc(context->ir_elements, sizeof(struct IRElement) * context->ir_elements_capacity);
+    }
+
+    context->ir_elements[context->ir_elements_count].node = node;
+    context->ir_elements[context->ir_elements_count].length = 0;
+    context->ir_elements[context->ir_elements_count].library_symbol_end = 0;
+
+    return context->ir_elements_count++;
+}
+
+// Sets an op in a reserved element adding its length to length
+static int set_ir_op(int index, struct ASTNode *node, int *length)
 {
-    struct ASTNode *new_node = create_node(NODE_TYPE_MAIN, NULL);
-    new_node->children_count = 1;
-    new_node->children[0] = child_node;
+    int op_length = 0;
+    if (compile_op(node, FALSE, &op_length))
+    {
+        return 1;
+    }
+    assert(op_length > 0 && op_length < MAX(5, MAX_AST_NODE_CHILDREN+1));
 
-    last_main_node->children_count = 2;
-    last_main_node->children[1] = new_node;
+    context->ir_elements[index].node = node;
+    context->ir_elements[index].length = op_length;
+    *length += op_length;
 
-    return new_node;
+    return 0;
+}
+
+static int add_ir_op(struct ASTNode *node, int *length)
+{
+    return set_ir_op(add_ir_element(NULL), node, length);
 }
 
 static int check_condition_op(struct ASTNode *node, char *cond, int cond_size)
 {
-    if (cpu_type == CPU_TYPE_GB)
+    if (context->cpu_type == CPU_TYPE_GB)
     {
         if (is_str_equal(cond, cond_size, "p") ||
             is_str_equal(cond, cond_size, "m") ||
@@ -376,6 +435,128 @@ static int check_condition_op(struct ASTNode *node, char *cond, int cond_size)
     return 0;
 }
 
+// Functions and interrupts at the top level are lowered at the same time in different threads before the first
+// pass, each one with its own labels numbered from 0 that are renumbered when its elements are added
+struct LoweredFunction
+{
+    struct ASTNode *node;
+    enum CPUType cpu_type, end_cpu_type; // where it starts, as assumed, and where it ends
+    BOOL assemble_all, end_assemble_all;
+    BOOL jr_in_loops, end_jr_in_loops;
+
+    struct IRElement *ir_elements;
+    int ir_elements_count;
+    int label_count;
+    int length;
+    int result;
+    char *messages;
+};
+
+static int recursive_first_pass(struct ASTNode *first_node, int *length);
+
+// Span of the time trace about a symbol, with its library
+static void add_symbol_trace_span(char *name, struct ASTNode *node, uint64_t start)
+{
+    char symbol[512];
+
+    if (node->str_size2 > 0)
+    {
+        snprintf(symbol, sizeof(symbol), "%.*s::%.*s", node->str_size2, node->str_value2, node->str_size, node->str_value);
+    }
+    else
+    {
+        snprintf(symbol, sizeof(symbol), "%.*s", node->str_size, node->str_value);
+    }
+    add_trace_span("compile", name, symbol, (int)strlen(symbol), start);
+}
+
+static int lower_function_body(struct ASTNode *node, int *length)
+{
+    uint64_t trace_start = start_trace_span();
+
+    if (recursive_first_pass(node->children[0], length)) { return 1; }
+
+    struct ASTNode *ret_node = NULL;
+    if (node->type == NODE_TYPE_FUNCTION)
+    {
+        ret_node = create_node_str(NODE_TYPE_OP, NULL, "ret", 3);
+    }
+    else
+    {
+        ret_node = create_node_str(NODE_TYPE_OP, NULL, "reti", 4);
+        if (is_str_equal(node->str_value, node->str_size, "nmi") && context->cpu_type != CPU_TYPE_GB)
+        {
+            ret_node->str_value = "retn";
+        }
+    }
+
+    int result = add_ir_op(ret_node, length);
+    add_symbol_trace_span("lower function", node, trace_start);
+
+    return result;
+}
+
+static struct LoweredFunction *take_lowered_function(struct ASTNode *node)
+{
+    if (context->next_lowered_function < context->lowered_functions_count &&
+        context->lowered_functions[context->next_lowered_function].node == node)
+    {
+        return &context->lowered_functions[context->next_lowered_function++];
+    }
+
+    return NULL;
+}
+
+static void renumber_generated_labels(struct ASTNode *node, int first_label)
+{
+    if (node->type == NODE_TYPE_GENERATED_LABEL)
+    {
+        node->num_value += first_label;
+    }
+    else if (node->type == NODE_TYPE_OP)
+    {
+        for(int i = 0; i < node->children_count; i++)
+        {
+            struct ASTNode *operand_node = node->children[i];
+            if (operand_node != NULL && operand_node->children_count == 0 && operand_node->str_size == 1 && operand_node->str_value[0] == '@')
+            {
+                operand_node->num_value += first_label;
+            }
+        }
+    }
+}
+
+// Adds the elements of a function lowered in another thread, unless it was lowered with other options than
+// the ones in effect where it is
+static int add_lowered_function(struct LoweredFunction *lowered_function, int *length, BOOL *added)
+{
+    *added = lowered_function->cpu_type == context->cpu_type &&
+        lowered_function->assemble_all == context->assemble_all &&
+        lowered_function->jr_in_loops == context->jr_in_loops;
+    if (!*added) { return 0; }
+
+    if (lowered_function->messages != NULL)
+    {
+        printf("%s", lowered_function->messages);
+    }
+    if (lowered_function->result) { return 1; }
+
+    for(int i = 0; i < lowered_function->ir_elements_count; i++)
+    {
+        renumber_generated_labels(lowered_function->ir_elements[i].node, context->new_label_count);
+        int index = add_ir_element(lowered_function->ir_elements[i].node);
+        context->ir_elements[index].length = lowered_function->ir_elements[i].length;
+    }
+    context->new_label_count += lowered_function->label_count;
+    *length += lowered_function->length;
+
+    context->cpu_type = lowered_function->end_cpu_type;
+    context->assemble_all = lowered_function->end_assemble_all;
+    context->jr_in_loops = lowered_function->end_jr_in_loops;
+
+    return 0;
+}
+
 static int recursive_first_pass(struct ASTNode *first_node, int *length)
 {
     struct ASTNode *current_node = first_node, *node;    
@@ -390,18 +571,12 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
         {
             case NODE_TYPE_OP:
             {
-                int op_length = 0;
-                if (compile_op(node, FALSE, &op_length))
-                {
-                    return 1;
-                }
-                assert(op_length > 0 && op_length < MAX(5, MAX_AST_NODE_CHILDREN+1));
-                *length += op_length;
+                if (add_ir_op(node, length)) { return 1; }
                 break;
             }
             case NODE_TYPE_FUNCTION:
             {
-                struct ASTNode *last_node = current_node->children[1], *last_cur_node;
+                struct LoweredFunction *lowered_function = take_lowered_function(node);
 
                 // check if this function is inside a library and needed
                 if (node->str_size2 > 0 && !is_library_symbol_needed(node->str_value2, node->str_size2, node->str_value, node->str_size))
@@ -412,59 +587,33 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
 
                 struct ASTNode *label_node = create_node_str2(NODE_TYPE_LABEL, NULL, node->str_value, node->str_size, node->str_value2, node->str_size2);
                 label_node->filename = node->filename; label_node->file_line = node->file_line;
-                current_node->children[0] = label_node;
-
-                last_cur_node = current_node->children[1] = node->children[0];
-                while(last_cur_node->children_count != 0)
-                {
-                    last_cur_node = last_cur_node->children[1];
-                }
-
-                struct ASTNode *ret_node = create_node_str(NODE_TYPE_OP, NULL, "ret", 3);
-                last_cur_node->children_count = 1;
-                last_cur_node->children[0] = ret_node;
+                int label_index = add_ir_element(label_node);
 
                 int inner_length = 0;
-                if (recursive_first_pass(current_node, &inner_length) ) { return 1; }
+                BOOL added = FALSE;
+                if (lowered_function != NULL && add_lowered_function(lowered_function, &inner_length, &added)) { return 1; }
+                if (!added && lower_function_body(node, &inner_length)) { return 1; }
                 *length += inner_length;
-
-                last_cur_node->children_count = 2;
-                last_cur_node->children[1] = last_node;
-
-                current_node = last_cur_node;
+                if (node->str_size2 > 0)
+                {
+                    context->ir_elements[label_index].library_symbol_end = context->ir_elements_count;
+                }
                 break;
             }
             case NODE_TYPE_INTERRUPT:
             {
-                struct ASTNode *last_node = current_node->children[1], *last_cur_node;
+                struct LoweredFunction *lowered_function = take_lowered_function(node);
 
                 struct ASTNode *label_node = create_node_str(NODE_TYPE_LABEL, NULL, node->str_value, node->str_size);
                 label_node->filename = node->filename; label_node->file_line = node->file_line;
-                current_node->children[0] = label_node;
-
-                last_cur_node = current_node->children[1] = node->children[0];
-                while(last_cur_node->children_count != 0)
-                {
-                    last_cur_node = last_cur_node->children[1];
-                }
-                
-                struct ASTNode *ret_node = create_node_str(NODE_TYPE_OP, NULL, "reti", 4);
-                if (is_str_equal(node->str_value, node->str_size, "nmi") && cpu_type != CPU_TYPE_GB)
-                {
-                    ret_node->str_value = "retn";
-                }
-                last_cur_node->children_count = 1;
-                last_cur_node->children[0] = ret_node;
+                add_ir_element(label_node);
 
                 int inner_length = 0;
-                if (recursive_first_pass(current_node, &inner_length) ) { return 1; }
+                BOOL added = FALSE;
+                if (lowered_function != NULL && add_lowered_function(lowered_function, &inner_length, &added)) { return 1; }
+                if (!added && lower_function_body(node, &inner_length)) { return 1; }
                 *length += inner_length;
                 write_debug("Size inside function \"%.*s\" is %d bytes", node->str_size, node->str_value, inner_length);
-
-                last_cur_node->children_count = 2;
-                last_cur_node->children[1] = last_node;
-
-                current_node = last_cur_node;
                 break;
             }
             case NODE_TYPE_FUNCTION_CALL:
@@ -496,33 +645,15 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                     }
 
                     // inline
+                    uint64_t trace_start = start_trace_span();
                     inline_node = duplicate_node_and_replace_deep(inline_node, inline_symbol, node->children[0]);
 
-                    if (inline_node->children_count == 0)
-                    {
-                        break;
-                    }
-
-                    struct ASTNode *last_node = current_node->children[1], *last_cur_node, *one_before_last = NULL;                    
-
                     push_inline_symbol_stack(node->str_value, node->str_size, node->str_value2, node->str_size2);
                     int inner_length = 0;
                     if (recursive_first_pass(inline_node, &inner_length)) { return 1; }
                     *length += inner_length;
                     pop_inline_symbol_stack();
-
-                    current_node->children[0] = inline_node->children[0];
-                    one_before_last = current_node;
-                    last_cur_node = current_node->children[1] = inline_node->children[1];
-
-                    while(last_cur_node->children_count != 0)
-                    {
-                        one_before_last = last_cur_node;
-                        last_cur_node = last_cur_node->children[1];
-                    }
-                    one_before_last->children[1] = last_node;
-
-                    current_node = one_before_last;
+                    add_symbol_trace_span("inline", node, trace_start);
                 }
                 else
                 {
@@ -543,11 +674,7 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                     call_node->children[0] = expression_node;
                     call_node->children_count = 1;
 
-                    current_node->children[0] = call_node;
-
-                    int inner_length = 0;
-                    compile_op(call_node, FALSE, &inner_length);
-                    *length += inner_length;
+                    if (add_ir_op(call_node, length)) { return 1; }
                 }
                 break;
             }
@@ -555,27 +682,34 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
             {
                 BOOL has_else = (node->children_count == 2);
 
+                // the jumps depend on the size of the clauses so their places are reserved
+                int jp_index = add_ir_element(NULL), jp2_index = -1, label1_index = -1, label2_index = -1;
+
                 int if_clause_length = 0, else_clause_length = 0;
                 if (recursive_first_pass(node->children[0], &if_clause_length)) { return 1; }
                 write_debug("Size inside if in line %d is %d bytes", node->file_line, if_clause_length);
                 if (has_else)
                 {
+                    jp2_index = add_ir_element(NULL);
+                    label1_index = add_ir_element(NULL);
                     if (recursive_first_pass(node->children[1], &else_clause_length)) { return 1; }
                     write_debug("Size inside else in line %d is %d bytes", node->file_line, else_clause_length);
+                    label2_index = add_ir_element(NULL);
+                }
+                else
+                {
+                    label1_index = add_ir_element(NULL);
                 }
                 *length += if_clause_length + else_clause_length;
 
-                char *label1 = get_new_label();
+                int label1 = get_new_label();
                 struct ASTNode *jp_node = NULL;
-                char *label2 = get_new_label();
-                struct ASTNode *label2_node = create_node_str(NODE_TYPE_LABEL, NULL, label2, (int)strlen(label2));
-                struct ASTNode *jp2_node = NULL;
-
-                int inner_length = 0;
+                int label2 = get_new_label();
 
                 if (has_else)
                 {
-                    if (jr_in_loops && else_clause_length < 128)
+                    struct ASTNode *jp2_node = NULL;
+                    if (context->jr_in_loops && else_clause_length < 128)
                     {
                         jp2_node = create_jr_node(label2);
                     }
@@ -584,14 +718,17 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                         jp2_node = create_jp_node(label2);
                     }
 
-                    if (compile_op(jp2_node, FALSE, &inner_length)) { return 1; }
-                    *length += inner_length;
-                    if_clause_length += inner_length;
+                    int jp2_length = 0;
+                    if (set_ir_op(jp2_index, jp2_node, &jp2_length)) { return 1; }
+                    *length += jp2_length;
+                    if_clause_length += jp2_length;
+
+                    context->ir_elements[label2_index].node = create_label_node(label2);
                 }
                 
                 if (check_condition_op(node, node->str_value, node->str_size)) { return 1; }
 
-                if (!jr_in_loops || if_clause_length > 127)
+                if (!context->jr_in_loops || if_clause_length > 127)
                 {
                     jp_node = create_reverse_jp_cond_node(node->str_value, node->str_size, label1);
                 }
@@ -600,65 +737,23 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                     jp_node = create_reverse_jr_cond_node(node->str_value, node->str_size, label1);
                 }
 
-                if (compile_op(jp_node, FALSE, &inner_length)) { return 1; }
-                *length += inner_length;
-
                 assert(jp_node != NULL);
+                if (set_ir_op(jp_index, jp_node, length)) { return 1; }
 
-                struct ASTNode *label1_node = create_node_str(NODE_TYPE_LABEL, NULL, label1, (int)strlen(label1));
-
-                struct ASTNode *last_node = current_node->children[1], *last_cur_node;
-                
-                current_node->children[0] = jp_node;
-
-                last_cur_node = current_node->children[1] = node->children[0];
-
-                while(last_cur_node->children_count != 0)
-                {
-                    last_cur_node = last_cur_node->children[1];
-                }
-
-                if (!has_else)
-                {
-                    last_cur_node->children_count = 2;
-                    last_cur_node->children[0] = label1_node;
-                    last_cur_node->children[1] = last_node;
-
-                    current_node = last_cur_node;
-
-                    break;
-                }                
-
-                last_cur_node->children_count = 2;
-                last_cur_node->children[0] = jp2_node;
-
-                struct ASTNode *new_node = create_node(NODE_TYPE_MAIN, NULL);
-                last_cur_node->children[1] = new_node;
-
-                new_node->children_count = 2;
-                new_node->children[0] = label1_node;
-
-                last_cur_node = new_node->children[1] = node->children[1];
-                while(last_cur_node->children_count != 0)
-                {
-                    last_cur_node = last_cur_node->children[1];
-                }
-
-                last_cur_node->children_count = 2;
-                last_cur_node->children[0] = label2_node;
-                last_cur_node->children[1] = last_node;
-
-                current_node = last_cur_node;
+                context->ir_elements[label1_index].node = create_label_node(label1);
 
                 break;
             }
             case NODE_TYPE_WHILE:
             {
-                char *label1 = get_new_label(), *label2 = get_new_label();
+                int label1 = get_new_label(), label2 = get_new_label();
 
                 push_loop_label(label1, label2);
 
-                int inner_while_length = 0, inner_length = 0;
+                add_ir_element(create_label_node(label1));
+                int jp_index = add_ir_element(NULL);
+
+                int inner_while_length = 0;
                 if (recursive_first_pass(node->children[0], &inner_while_length)) { return 1; }
                 *length += inner_while_length;
                 write_debug("Size inside while in line %d is %d bytes", node->file_line, inner_while_length);
@@ -669,7 +764,7 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                 
                 if (check_condition_op(node, node->str_value, node->str_size)) { return 1; }
 
-                if (jr_in_loops && inner_while_length < 124)
+                if (context->jr_in_loops && inner_while_length < 124)
                 {
                     jp_node = create_reverse_jr_cond_node(node->str_value, node->str_size, label2);
                 }
@@ -678,29 +773,11 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                     jp_node = create_reverse_jp_cond_node(node->str_value, node->str_size, label2);
                 }
                 assert(jp_node != NULL);
-                if (compile_op(jp_node, FALSE, &inner_length)) { return 1; }
-                *length += inner_length;
-
-                struct ASTNode *label1_node = create_node_str(NODE_TYPE_LABEL, NULL, label1, (int)strlen(label1));
-                struct ASTNode *new_node = create_node(NODE_TYPE_MAIN, NULL);                
-
-                struct ASTNode *last_node = current_node->children[1], *last_cur_node;
-                current_node->children[0] = label1_node;
-                current_node->children[1] = new_node;
-                current_node->children_count = 2;
-
-                new_node->children_count = 2;
-                new_node->children[0] = jp_node;
-                last_cur_node = new_node->children[1] = node->children[0];
-                while(last_cur_node->children_count != 0)
-                {
-                    last_cur_node = last_cur_node->children[1];
-                }
+                if (set_ir_op(jp_index, jp_node, length)) { return 1; }
 
-                struct ASTNode *label2_node = create_node_str(NODE_TYPE_LABEL, NULL, label2, (int)strlen(label2));
                 struct ASTNode *jp2_node = NULL;
                 
-                if (jr_in_loops && inner_while_length < 124)
+                if (context->jr_in_loops && inner_while_length < 124)
                 {
                     jp2_node = create_jr_node(label1);
                 }
@@ -708,33 +785,21 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                 {
                     jp2_node = create_jp_node(label1);
                 }
-                if (compile_op(jp2_node, FALSE, &inner_length)) { return 1; }
-                *length += inner_length;
-
-
-                last_cur_node->children_count = 2;
-                last_cur_node->children[0] = jp2_node;
+                if (add_ir_op(jp2_node, length)) { return 1; }
 
-                new_node = create_node(NODE_TYPE_MAIN, NULL);
-                last_cur_node->children[1] = new_node;
-
-                new_node->children_count = 2;
-                new_node->children[0] = label2_node;
-
-                last_cur_node = new_node;
-                last_cur_node->children[1] = last_node;
-
-                current_node = last_cur_node;
+                add_ir_element(create_label_node(label2));
 
                 break;
             }
             case NODE_TYPE_DO:
             {
-                char *label1 = get_new_label(), *label2 = get_new_label();
+                int label1 = get_new_label(), label2 = get_new_label();
 
                 push_loop_label(label1, label2);
 
-                int inner_do_length = 0, inner_length = 0;
+                add_ir_element(create_label_node(label1));
+
+                int inner_do_length = 0;
                 if (recursive_first_pass(node->children[0], &inner_do_length)) { return 1; }
                 *length += inner_do_length;
                 write_debug("Size inside do in line %d is %d bytes", node->file_line, inner_do_length);
@@ -744,7 +809,7 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                 if (check_condition_op(node, node->str_value, node->str_size)) { return 1; }
 
                 struct ASTNode *jp_node = NULL;
-                if (jr_in_loops && inner_do_length < 127)
+                if (context->jr_in_loops && inner_do_length < 127)
                 {
                     jp_node = create_jr_cond_node(node->str_value, node->str_size, label1);
                 }
@@ -753,38 +818,21 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                     jp_node = create_jp_cond_node(node->str_value, node->str_size, label1);
                 }
                 assert(jp_node != NULL);
-                if (compile_op(jp_node, FALSE, &inner_length)) { return 1; }
-                *length += inner_length;
-
-                struct ASTNode *label1_node = create_node_str(NODE_TYPE_LABEL, NULL, label1, (int)strlen(label1));
-
-                struct ASTNode *last_node = current_node->children[1], *last_cur_node;
-                current_node->children[0] = label1_node;
-                current_node->children_count = 2;
-                last_cur_node = current_node->children[1] = node->children[0];
-                while(last_cur_node->children_count != 0)
-                {
-                    last_cur_node = last_cur_node->children[1];
-                }
-
-                last_cur_node->children_count = 2;
-                last_cur_node->children[0] = jp_node;
-                
-                struct ASTNode *new_node = add_main_node_to_end(create_node_str(NODE_TYPE_LABEL, NULL, label2, (int)strlen(label2)), last_cur_node);
-                new_node->children_count = 2;
-                new_node->children[1] = last_node;
+                if (add_ir_op(jp_node, length)) { return 1; }
 
-                current_node = new_node;
+                add_ir_element(create_label_node(label2));
 
                 break;
             }
             case NODE_TYPE_FOREVER:
             {
-                char *label1 = get_new_label(), *label2 = get_new_label();
+                int label1 = get_new_label(), label2 = get_new_label();
 
                 push_loop_label(label1, label2);
 
-                int inner_forever_length = 0, inner_length = 0;
+                add_ir_element(create_label_node(label1));
+
+                int inner_forever_length = 0;
                 if (recursive_first_pass(node->children[0], &inner_forever_length)) { return 1; }
                 *length += inner_forever_length;
                 write_debug("Size inside forever in line %d is %d bytes", node->file_line, inner_forever_length);
@@ -792,7 +840,7 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                 pop_loop_label();
 
                 struct ASTNode *jp_node = NULL;                
-                if (jr_in_loops && inner_forever_length < 127)
+                if (context->jr_in_loops && inner_forever_length < 127)
                 {
                     jp_node = create_jr_node(label1);
                 }
@@ -801,52 +849,29 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
                     jp_node = create_jp_node(label1);
                 }
                 assert(jp_node != NULL);
-                if (compile_op(jp_node, FALSE, &inner_length)) { return 1; }
-                *length += inner_length;
-
-                struct ASTNode *label1_node = create_node_str(NODE_TYPE_LABEL, NULL, label1, (int)strlen(label1));
-
-                struct ASTNode *last_node = current_node->children[1], *last_cur_node;
-                current_node->children[0] = label1_node;
-                current_node->children_count = 2;
-                last_cur_node = current_node->children[1] = node->children[0];
-                while(last_cur_node->children_count != 0)
-                {
-                    last_cur_node = last_cur_node->children[1];
-                }
-
-                last_cur_node->children_count = 2;
-                last_cur_node->children[0] = jp_node;
+                if (add_ir_op(jp_node, length)) { return 1; }
 
-                struct ASTNode *new_node = add_main_node_to_end(create_node_str(NODE_TYPE_LABEL, NULL, label2, (int)strlen(label2)), last_cur_node);
-                new_node->children_count = 2;
-                new_node->children[1] = last_node;
-
-                current_node = new_node;
+                add_ir_element(create_label_node(label2));
 
                 break;
             }
             case NODE_TYPE_BREAK:
             {
-                char *label = peek_loop_label_end();
-                if (label == NULL)
+                int label = peek_loop_label_end();
+                if (label < 0)
                 {
                     write_compiler_error(node->filename, node->file_line, "break not inside of loop", 0);
                     return 1;
                 }
 
-                struct ASTNode *last_node = current_node->children[1];
-
-                struct ASTNode *new_node = add_main_node_to_end(create_jp_node(label), current_node);
-                new_node->children_count = 2;
-                new_node->children[1] = last_node;
+                if (add_ir_op(create_jp_node(label), length)) { return 1; }
 
                 break;
             }
             case NODE_TYPE_BREAKIF:
             {
-                char *label = peek_loop_label_end();
-                if (label == NULL)
+                int label = peek_loop_label_end();
+                if (label < 0)
                 {
                     write_compiler_error(node->filename, node->file_line, "breakif not inside of loop", 0);
                     return 1;
@@ -854,36 +879,27 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
 
                 if (check_condition_op(node, node->str_value, node->str_size)) { return 1; }
 
-                struct ASTNode *last_node = current_node->children[1];
-
-                struct ASTNode *jp_node = create_jp_cond_node(node->str_value, node->str_size, label);
-                struct ASTNode *new_node = add_main_node_to_end(jp_node, current_node);
-                new_node->children_count = 2;
-                new_node->children[1] = last_node;
+                if (add_ir_op(create_jp_cond_node(node->str_value, node->str_size, label), length)) { return 1; }
 
                 break;
             }
             case NODE_TYPE_CONTINUE:
             {
-                char *label = peek_loop_label_start();
-                if (label == NULL)
+                int label = peek_loop_label_start();
+                if (label < 0)
                 {
                     write_compiler_error(node->filename, node->file_line, "continue not inside of loop", 0);
                     return 1;
                 }
 
-                struct ASTNode *last_node = current_node->children[1];
-
-                struct ASTNode *new_node = add_main_node_to_end(create_jp_node(label), current_node);
-                new_node->children_count = 2;
-                new_node->children[1] = last_node;
+                if (add_ir_op(create_jp_node(label), length)) { return 1; }
 
                 break;
             }
             case NODE_TYPE_CONTINUEIF:
             {
-                char *label = peek_loop_label_start();
-                if (label == NULL)
+                int label = peek_loop_label_start();
+                if (label < 0)
                 {
                     write_compiler_error(node->filename, node->file_line, "continueif not inside of loop", 0);
                     return 1;
@@ -891,41 +907,42 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
 
                 if (check_condition_op(node, node->str_value, node->str_size)) { return 1; }
 
-                struct ASTNode *last_node = current_node->children[1];
-
-                struct ASTNode *jp_node = create_jp_cond_node(node->str_value, node->str_size, label);
-                struct ASTNode *new_node = add_main_node_to_end(jp_node, current_node);
-                new_node->children_count = 2;
-                new_node->children[1] = last_node;
+                if (add_ir_op(create_jp_cond_node(node->str_value, node->str_size, label), length)) { return 1; }
 
                 break;
             }
             case NODE_TYPE_SET_CPU_TYPE:
             {
-                cpu_type = (enum CPUType)node->num_value;
+                context->cpu_type = (enum CPUType)node->num_value;
+                add_ir_element(node);
                 break;
             }
             case NODE_TYPE_ASSEMBLEALL_ON:
             {
-                assemble_all = TRUE;
+                context->assemble_all = TRUE;
+                add_ir_element(node);
                 break;
             }
             case NODE_TYPE_ASSEMBLEALL_OFF:
             {
-                assemble_all = FALSE;
+                context->assemble_all = FALSE;
+                add_ir_element(node);
                 break;
             }
             case NODE_TYPE_JRINLOOPS_ON:
             {
-                jr_in_loops = TRUE;
+                context->jr_in_loops = TRUE;
+                add_ir_element(node);
                 break;
             }
             case NODE_TYPE_JRINLOOPS_OFF:
             {
-                jr_in_loops = FALSE;
+                context->jr_in_loops = FALSE;
+                add_ir_element(node);
                 break;
             }
             default:
+                add_ir_element(node);
                 break;
         }
 
@@ -935,190 +952,316 @@ static int recursive_first_pass(struct ASTNode *first_node, int *length)
     return 0;
 }   
 
-static int compile_struct_init(struct ASTNode *struct_init, struct StructuredType *structured_type, int offset)
+static int lower_function_job(void *argument, int index)
 {
-    struct ASTNode *struct_init_element = struct_init->children[0];
-    while (struct_init_element != NULL)
-    {
-        struct StructElement *struct_element = get_struct_element(structured_type, struct_init_element->str_value, struct_init_element->str_size);
-        struct StructuredType *inner_structured_type = NULL;
+    struct LoweredFunction *lowered_function = &((struct LoweredFunction *)argument)[index];
+    struct Z80HLAContext *previous_context = context;
+    struct Z80HLAContext function_context = *context;
+
+    context = &function_context;
+    context->ir_elements = NULL;
+    context->ir_elements_count = context->ir_elements_capacity = 0;
+    context->new_label_count = 0;
+    context->first_loop_label = context->last_loop_label = NULL;
+    context->first_inline_symbol_stack = context->last_inline_symbol_stack = NULL;
+    context->lowered_functions = NULL;
+    context->lowered_functions_count = context->next_lowered_function = 0;
+    context->cpu_type = lowered_function->cpu_type;
+    context->assemble_all = lowered_function->assemble_all;
+    context->jr_in_loops = lowered_function->jr_in_loops;
+
+    hold_messages(TRUE);
+    lowered_function->length = 0;
+    lowered_function->result = lower_function_body(lowered_function->node, &lowered_function->length);
+    lowered_function->messages = take_held_messages();
+    hold_messages(FALSE);
+
+    lowered_function->ir_elements = context->ir_elements;
+    lowered_function->ir_elements_count = context->ir_elements_count;
+    lowered_function->label_count = context->new_label_count;
+    lowered_function->end_cpu_type = context->cpu_type;
+    lowered_function->end_assemble_all = context->assemble_all;
+    lowered_function->end_jr_in_loops = context->jr_in_loops;
+
+    context = previous_context;
+
+    return lowered_function->result;
+}
 
-        if (struct_element == NULL)
-        {
-            write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Element \"%.*s\" not found in structure", struct_init_element->str_size, struct_init_element->str_value);
-            return 1;
-        }
+// Finds the functions at the top level with the options in effect where they are, assuming functions don't change them
+static void lower_functions(struct ASTNode *first_node)
+{
+    enum CPUType cpu_type = context->cpu_type;
+    BOOL assemble_all = context->assemble_all, jr_in_loops = context->jr_in_loops;
+    int capacity = 0;
 
-        BOOL is_struct_element_native = is_native_type(struct_element->type, struct_element->type_size);
+    for(struct ASTNode *current_node = first_node; current_node != NULL && current_node->children_count > 0; current_node = current_node->children[1])
+    {
+        struct ASTNode *node = current_node->children[0];
 
-        if (!is_struct_element_native)
+        switch(node->type)
         {
-            inner_structured_type = get_structured_type(struct_element->type, struct_element->type_size, struct_element->type_library, struct_element->type_library_size);
-            if (inner_structured_type == NULL)
+            case NODE_TYPE_FUNCTION:
+            case NODE_TYPE_INTERRUPT:
             {
-                if (struct_element->type_library_size > 0)
+                if (node->type == NODE_TYPE_FUNCTION && node->str_size2 > 0 && !is_library_symbol_needed(node->str_value2, node->str_size2, node->str_value, node->str_size))
                 {
-                    write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Type \"%.*s::%.*s\" not found", struct_element->type_library_size, struct_element->type_library, struct_element->type_size, struct_element->type);
+                    break;
                 }
-                else
+
+                if (context->lowered_functions_count == capacity)
                 {
-                    write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Type \"%.*s\" not found", struct_element->type_size, struct_element->type);
+                    capacity = MAX(64, capacity * 2);
+                    context->lowered_functions = (struct LoweredFunction *)realloc(context->lowered_functions, sizeof(struct LoweredFunction) * capacity);
                 }
-            }
-        }
 
-        if (struct_element == NULL)
-        {
-            write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Structure element \"%.*s\" not found", struct_init_element->str_size, struct_init_element->str_value);
-            return 1;
-        }
-
-        write_debug("Setting value for element \"%.*s\"", struct_init_element->str_size, struct_init_element->str_value);
-
-        int index = 0;
-        struct ASTNode *struct_init_element_value = struct_init_element->children[0];        
-        while (struct_init_element_value != NULL)
-        {
-            if (index + 1 > struct_element->array_length)
+                struct LoweredFunction *lowered_function = &context->lowered_functions[context->lowered_functions_count++];
+                memset(lowered_function, 0, sizeof(struct LoweredFunction));
+                lowered_function->node = node;
+                lowered_function->cpu_type = context->cpu_type;
+                lowered_function->assemble_all = context->assemble_all;
+                lowered_function->jr_in_loops = context->jr_in_loops;
+                break;
+            }
+            case NODE_TYPE_SET_CPU_TYPE:
             {
-                write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Initialization of values beyond the length of \"%.*s\" which is %d", struct_element->name_size, struct_element->name, struct_element->array_length);
-                return 1;
+                context->cpu_type = (enum CPUType)node->num_value;
+                break;
             }
-
-            if (is_struct_element_native)
+            case NODE_TYPE_ASSEMBLEALL_ON:
+            case NODE_TYPE_ASSEMBLEALL_OFF:
             {
-                if (!is_node_expression(struct_init_element_value->children[0]))
-                {
-                    write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Expected expression for element \"%.*s\"", struct_element->name_size, struct_element->name);
-                    return 1;
-                }
-
-                set_struct_bytes(structured_type, offset, struct_element, index, struct_init_element_value->children[0]);
+                context->assemble_all = node->type == NODE_TYPE_ASSEMBLEALL_ON;
+                break;
             }
-            else
+            case NODE_TYPE_JRINLOOPS_ON:
+            case NODE_TYPE_JRINLOOPS_OFF:
             {
-                if (struct_init_element_value->children[0]->type != NODE_TYPE_STRUCT_INIT)
-                {
-                    write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Expected structure initializer for element \"%.*s\"", struct_element->name_size, struct_element->name);
-                    return 1;
-                }
-
-                if (compile_struct_init(struct_init_element_value->children[0], inner_structured_type, struct_element->position + (index * inner_structured_type->struct_size))) { return 1; }
+                context->jr_in_loops = node->type == NODE_TYPE_JRINLOOPS_ON;
+                break;
             }
-
-            struct_init_element_value = struct_init_element_value->children[1];
-            index++;
+            default:
+                break;
         }
-
-        struct_init_element = struct_init_element->children[1];
     }
-    return 0;
-}
 
-uint16_t compiler_current_address = 0;
+    context->cpu_type = cpu_type;
+    context->assemble_all = assemble_all;
+    context->jr_in_loops = jr_in_loops;
+    context->next_lowered_function = 0;
 
-static void fprint_start_list(FILE *fp, struct ASTNode *node)
-{
-    fprintf(fp, "%04X\t", compiler_current_address);
-    if (node->file_line > 0)
+    if (context->lowered_functions_count > 1)
     {
-        fprintf(fp, "%35s:%-5d\t", node->filename, node->file_line);
+        run_workers(context->lowered_functions_count, context->thread_count, lower_function_job, context->lowered_functions);
     }
     else
     {
-        fprintf(fp, "%35s %5s\t", "  ", " ");
+        context->lowered_functions_count = 0;
     }
 }
 
-static void fprint_identifier(FILE *fp, struct ASTNode *node)
+static void free_lowered_functions()
 {
-    if (node->str_size2 > 0)
-    {
-        fprintf(fp_list, "%.*s::%.*s", node->str_size2, node->str_value2, node->str_size, node->str_value);
-    }
-    else
+    for(int i = 0; i < context->lowered_functions_count; i++)
     {
-        fprintf(fp_list, "%.*s", node->str_size, node->str_value);
+        free(context->lowered_functions[i].ir_elements);
+        free(context->lowered_functions[i].messages);
     }
+    free(context->lowered_functions);
+    context->lowered_functions = NULL;
+    context->lowered_functions_count = context->next_lowered_function = 0;
 }
 
-static int fprint_db_count = 0;
-enum FprintDbType
+// Frees the output and the tables of the passes, the values of runs are in the memory of the context or in the file cache
+void free_compiler()
 {
-    FPRINT_DB_TYPE_BYTE,
-    FPRINT_DB_TYPE_WORD,
-    FPRINT_DB_TYPE_DWORD
-};
+    for(struct OutputElement *elem = context->first_output_elem, *next_elem; elem != NULL; elem = next_elem)
+    {
+        next_elem = elem->next;
+        free(elem);
+    }
+    context->first_output_elem = context->last_output_elem = NULL;
 
-static void fprint_db_list(FILE *fp, struct ASTNode *node, uint32_t value, struct ASTNode *expression_node, enum FprintDbType type)
+    free_lowered_functions();
+    free(context->ir_elements);
+    free(context->list_lines);
+    context->ir_elements = NULL;
+    context->list_lines = NULL;
+}
+
+static int compile_struct_init(struct ASTNode *struct_init, struct StructuredType *structured_type, int offset)
 {
-    if (fprint_db_count % 16 == 0)
+    struct ASTNode *struct_init_element = struct_init->children[0];
+    while (struct_init_element != NULL)
     {
-        if (fprint_db_count > 0)
+        struct StructElement *struct_element = get_struct_element(structured_type, struct_init_element->str_value, struct_init_element->str_size);
+
+        if (struct_element == NULL)
         {
-            fprintf(fp, "\n");
+            write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Element \"%.*s\" not found in structure", struct_init_element->str_size, struct_init_element->str_value);
+            return 1;
         }
-        fprint_start_list(fp, node);
-        switch(type)
+
+        // Element layout (position, size and inner type) is resolved when the structured type is built
+        BOOL is_struct_element_native = struct_element->is_native_type;
+        struct StructuredType *inner_structured_type = struct_element->structured_type;
+
+        write_debug("Setting value for element \"%.*s\"", struct_init_element->str_size, struct_init_element->str_value);
+
+        int index = 0;
+        struct ASTNode *struct_init_element_value = struct_init_element->children[0];        
+        while (struct_init_element_value != NULL)
         {
-            case FPRINT_DB_TYPE_BYTE:
-                fprintf(fp, "\tBYTE ");
-                break;
-            case FPRINT_DB_TYPE_WORD:
-                fprintf(fp, "\tWORD ");
-                break;
-            case FPRINT_DB_TYPE_DWORD:
-                fprintf(fp, "\tDWORD ");
-                break;
+            if (index + 1 > struct_element->array_length)
+            {
+                write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Initialization of values beyond the length of \"%.*s\" which is %d", struct_element->name_size, struct_element->name, struct_element->array_length);
+                return 1;
+            }
+
+            if (is_struct_element_native)
+            {
+                if (!is_node_expression(struct_init_element_value->children[0]))
+                {
+                    write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Expected expression for element \"%.*s\"", struct_element->name_size, struct_element->name);
+                    return 1;
+                }
+
+                add_struct_init_value(offset, struct_element, index, struct_init_element_value->children[0]);
+            }
+            else
+            {
+                if (struct_init_element_value->children[0]->type != NODE_TYPE_STRUCT_INIT)
+                {
+                    write_compiler_error(struct_init_element->filename, struct_init_element->file_line, "Expected structure initializer for element \"%.*s\"", struct_element->name_size, struct_element->name);
+                    return 1;
+                }
+
+                if (compile_struct_init(struct_init_element_value->children[0], inner_structured_type, offset + struct_element->position + (index * inner_structured_type->struct_size))) { return 1; }
+            }
+
+            struct_init_element_value = struct_init_element_value->children[1];
+            index++;
         }
+
+        struct_init_element = struct_init_element->children[1];
     }
-    else
+    return 0;
+}
+
+// Listing lines are recorded while compiling and printed after the third pass from the final output
+enum ListLineType
+{
+    LIST_LINE_OP,
+    LIST_LINE_LABEL,
+    LIST_LINE_DATA,
+    LIST_LINE_DATA_RESERVED,
+    LIST_LINE_DATA_SIZE
+};
+
+struct ListLine
+{
+    enum ListLineType type;
+    struct ASTNode *node;
+    uint16_t address;
+    int output_offset; // position of the first byte in the output
+    int length; // number of bytes
+    int size_of_type; // size of each value listed in data
+    int data_size, data_length;
+};
+
+static void add_list_line(enum ListLineType type, struct ASTNode *node)
+{
+    if (context->fp_list == NULL) { return; }
+
+    if (context->list_lines_count == context->list_lines_capacity)
     {
-        fprintf(fp, ", ");
+        context->list_lines_capacity = context->list_lines_capacity == 0 ? 1024 : context->list_lines_capacity * 2;
+        context->list_lines = (struct ListLine *)realloc(context->list_lines, sizeof(struct ListLine) * context->list_lines_capacity);
     }
 
-    if (expression_node == NULL)
+    struct ListLine *line = &context->list_lines[context->list_lines_count++];
+    line->type = type;
+    line->node = node;
+    line->address = context->compiler_current_address;
+    line->output_offset = context->output_bytes;
+    line->length = 0;
+    line->size_of_type = 1;
+    line->data_size = 0;
+    line->data_length = 0;
+}
+
+// Sets the length of the last line with the bytes output since it was added
+static void end_list_line()
+{
+    if (context->fp_list == NULL) { return; }
+
+    context->list_lines[context->list_lines_count - 1].length = context->output_bytes - context->list_lines[context->list_lines_count - 1].output_offset;
+}
+
+static void add_list_data_line(struct ASTNode *node, int size_of_type)
+{
+    add_list_line(LIST_LINE_DATA, node);
+    if (context->fp_list != NULL)
     {
-        fprintf(fp, "%"PRIu32"", value);
+        context->list_lines[context->list_lines_count - 1].size_of_type = size_of_type;
     }
-    else
+}
+
+static void add_list_data_size_line(struct ASTNode *node, int size, int length)
+{
+    add_list_line(LIST_LINE_DATA_SIZE, node);
+    if (context->fp_list != NULL)
     {
-        fprint_operand_node(fp, expression_node, TRUE);
+        context->list_lines[context->list_lines_count - 1].data_size = size;
+        context->list_lines[context->list_lines_count - 1].data_length = length;
     }
-
-    fprint_db_count++;
 }
 
-static void fprint_db_list_end(FILE *fp)
+// Data listed from a position of the data being compiled, with values of size_of_type bytes
+static void add_list_data_part_line(struct ASTNode *node, int offset, int length, int size_of_type)
 {
-    fprintf(fp, "\n");
-    fprint_db_count = 0;
+    if (context->fp_list == NULL || length <= 0) { return; }
+
+    add_list_data_line(node, size_of_type);
+    struct ListLine *line = &context->list_lines[context->list_lines_count - 1];
+    line->address += offset;
+    line->output_offset += offset;
+    line->length = length;
 }
 
-static void fprint_data_list(FILE *fp, struct ASTNode *node, int size, int length)
+static BOOL is_value_in_range(int64_t value, int size)
 {
-    fprint_start_list(fp, node);
-    fprintf(fp, "; sizeof(");
-    fprint_identifier(fp, node);
-    fprintf(fp, ") = %d\n", size);
-    fprint_start_list(fp, node);
-    fprintf(fp, "; length(");
-    fprint_identifier(fp, node);
-    fprintf(fp, ") = %d\n", length);
+    switch(size)
+    {
+        case 1: return value <= UINT8_MAX && value >= INT8_MIN;
+        case 2: return value <= UINT16_MAX && value >= INT16_MIN;
+        case 4: return value <= UINT32_MAX && value >= INT32_MIN;
+    }
+    return FALSE;
 }
 
 static int compile_data_init(char *type_name, int type_name_size, struct StructuredType *structured_type, struct ASTNode *node, struct ASTNode *node_expression, int *data_length, BOOL allow_string)
 {
+    if (node_expression->type == NODE_TYPE_DATA_PACKED)
+    {
+        // Values already packed by the parser
+        uint8_t *values = (uint8_t *)node_expression->str_value;
+
+        add_output_run(values, node_expression->str_size);
+        context->compiler_current_address += node_expression->str_size;
+        if (data_length != NULL) { *data_length += (int)node_expression->num_value; }
+
+        return 0;
+    }
+
     if (is_str_equal(type_name, type_name_size, "byte"))
     {
         if (is_node_expression_type(node_expression->type))
         {
-           node_expression->type = NODE_TYPE_EXPRESSION_8;
+            node_expression->type = NODE_TYPE_EXPRESSION_8;
             add_output_element_set_address(0, node_expression);
 
-            if (fp_list != NULL) fprint_db_list(fp_list, node, 0, node_expression, FPRINT_DB_TYPE_BYTE);
-
-            compiler_current_address++;
+            context->compiler_current_address++;
         }
         else if (node_expression->type == NODE_TYPE_STRING)
         {
@@ -1131,10 +1274,8 @@ static int compile_data_init(char *type_name, int type_name_size, struct Structu
             for(int i = 0; i < node_expression->str_size; i++)
             {
                 add_output_element_set_address(node_expression->str_value[i], NULL);
-
-                if (fp_list != NULL) fprint_db_list(fp_list, node, node_expression->str_value[i], NULL, FPRINT_DB_TYPE_BYTE);
             }
-            compiler_current_address += node_expression->str_size;
+            context->compiler_current_address += node_expression->str_size;
             if (data_length != NULL) { *data_length += node_expression->str_size - 1; }
         }
         else
@@ -1155,9 +1296,7 @@ static int compile_data_init(char *type_name, int type_name_size, struct Structu
         add_output_element(0, node_expression);
         add_output_element_set_address(0, NULL);
 
-        if (fp_list != NULL) fprint_db_list(fp_list, node, 0, node_expression, FPRINT_DB_TYPE_WORD);
-
-        compiler_current_address += 2;                            
+        context->compiler_current_address += 2;                            
     }
     else if (is_str_equal(type_name, type_name_size, "dword"))
     {
@@ -1173,9 +1312,7 @@ static int compile_data_init(char *type_name, int type_name_size, struct Structu
         add_output_element(0, NULL);
         add_output_element_set_address(0, NULL);
 
-        if (fp_list != NULL) fprint_db_list(fp_list, node, 0, node_expression, FPRINT_DB_TYPE_DWORD);
-
-        compiler_current_address += 4;                            
+        context->compiler_current_address += 4;                            
     }
     else
     {
@@ -1187,100 +1324,254 @@ static int compile_data_init(char *type_name, int type_name_size, struct Structu
 
         struct ASTNode *struct_init = node_expression;
 
-        clear_struct_bytes(structured_type->struct_size);
+        clear_struct_init_values();
         if (compile_struct_init(struct_init, structured_type, 0)) { return 1; }
-        int list_skip_bytes = 0;
-        for(int i = 0; i < structured_type->struct_size; i++)
+
+        int values_count = 0;
+        struct StructInitValue *values = get_struct_init_values(&values_count);
+
+        // Each element is listed with the width of its type, the bytes in between as byte values
+        if (context->fp_list != NULL)
         {
-            add_output_element_set_address(0, struct_bytes[i]);                                
+            int list_offset = 0;
+            for(int i = 0; i < values_count; i++)
+            {
+                add_list_data_part_line(node, list_offset, values[i].offset - list_offset, 1);
+                add_list_data_part_line(node, values[i].offset, values[i].size, values[i].size);
+                list_offset = values[i].offset + values[i].size;
+            }
+            add_list_data_part_line(node, list_offset, structured_type->struct_size - list_offset, 1);
+        }
 
-            if (struct_bytes[i] != NULL)
+        // Literal values are placed directly in the bytes of the runs, only other expressions need an element each,
+        // literals out of the range of their type too so the error is reported in the third pass
+        uint8_t *run_values = NULL;
+        int run_start = 0;
+        for(int i = 0; i < values_count; i++)
+        {
+            if (is_node_literal(values[i].node) && is_value_in_range(values[i].node->num_value, values[i].size))
             {
-                if (i > 0)
+                int64_t value = values[i].node->num_value;
+                if (run_values == NULL)
                 {
-                    if (fp_list != NULL) fprint_db_list_end(fp_list);
+                    run_values = (uint8_t *)allocate_context_memory(structured_type->struct_size);
+                    memset(run_values, 0, structured_type->struct_size);
                 }
-                switch(struct_bytes[i]->type)
-                {                    
-                    case NODE_TYPE_EXPRESSION_16:
-                    {                        
-                        if (fp_list != NULL) fprint_db_list(fp_list, node, 0, struct_bytes[i], FPRINT_DB_TYPE_WORD);
-                        list_skip_bytes = 2;
-                        break;
-                    }
-                    case NODE_TYPE_EXPRESSION_32:
-                    {
-                        if (fp_list != NULL) fprint_db_list(fp_list, node, 0, struct_bytes[i], FPRINT_DB_TYPE_DWORD);
-                        list_skip_bytes = 4;
-                        break;
-                    }
-                    default:
-                    {
-                        if (fp_list != NULL) fprint_db_list(fp_list, node, 0, struct_bytes[i], FPRINT_DB_TYPE_BYTE);
-                        list_skip_bytes = 1;
-                    }
+                for(int b = 0; b < values[i].size; b++)
+                {
+                    run_values[values[i].offset + b] = (value >> (b * 8)) & 0xFF;
                 }
             }
-            else if (list_skip_bytes == 0)
+            else
             {
-                if (i > 0)
+                add_output_run(run_values != NULL ? run_values + run_start : NULL, values[i].offset - run_start);
+                add_output_element_set_address(0, values[i].node);
+                for(int b = 1; b < values[i].size; b++)
                 {
-                    if (fp_list != NULL) fprint_db_list_end(fp_list);
+                    add_output_element_set_address(0, NULL);
                 }
-                if (fp_list != NULL) fprint_db_list(fp_list, node, 0, struct_bytes[i], FPRINT_DB_TYPE_BYTE);
+                run_start = values[i].offset + values[i].size;
             }
+        }
+        add_output_run(run_values != NULL ? run_values + run_start : NULL, structured_type->struct_size - run_start);
+
+        context->compiler_current_address += structured_type->struct_size;
+    }
+    if (data_length != NULL) {(*data_length)++;}
+
+    return 0;
+}
 
-            if (list_skip_bytes > 0)
+// Ops are encoded at the same time in different threads before the second pass, in chunks of elements that
+// start with the cpu type found walking the elements. The second pass adds the elements of each op to the output.
+#define ENCODED_CHUNK_MIN_SIZE 4096
+
+struct EncodedOp
+{
+    struct OutputElement *first_output_elem, *last_output_elem;
+    int output_length;
+    int output_bytes;
+    int length;
+    BOOL failed;
+    char *messages;
+};
+
+struct EncodedChunk
+{
+    struct EncodedOp *ops; // indexed by element
+    int first_element, end_element;
+    enum CPUType cpu_type;
+};
+
+static int encode_chunk_job(void *argument, int index)
+{
+    struct EncodedChunk *chunk = &((struct EncodedChunk *)argument)[index];
+    struct Z80HLAContext *previous_context = context;
+    struct Z80HLAContext chunk_context = *context;
+
+    context = &chunk_context;
+    context->cpu_type = chunk->cpu_type;
+    init_compiler();
+
+    uint64_t trace_start = start_trace_span();
+    hold_messages(TRUE);
+    for(int i = chunk->first_element; i < chunk->end_element; i++)
+    {
+        struct ASTNode *node = context->ir_elements[i].node;
+        if (node->type == NODE_TYPE_SET_CPU_TYPE)
+        {
+            context->cpu_type = (enum CPUType)node->num_value;
+        }
+        else if (node->type == NODE_TYPE_OP)
+        {
+            struct EncodedOp *op = &chunk->ops[i];
+            struct OutputElement *previous_output_elem = context->output_length > 0 ? context->last_output_elem : NULL;
+            int old_output_length = context->output_length, old_output_bytes = context->output_bytes;
+
+            if (compile_op(node, TRUE, &op->length))
             {
-                list_skip_bytes--;
+                op->failed = TRUE;
+                op->messages = take_held_messages();
+                break;
             }
-            
-            compiler_current_address++;
+
+            op->first_output_elem = previous_output_elem != NULL ? previous_output_elem->next : context->first_output_elem;
+            op->last_output_elem = context->last_output_elem;
+            op->output_length = context->output_length - old_output_length;
+            op->output_bytes = context->output_bytes - old_output_bytes;
+        }
+    }
+    free(take_held_messages());
+    hold_messages(FALSE);
+    add_trace_span("compile", "encode chunk", NULL, 0, trace_start);
+
+    context = previous_context;
+
+    return 0;
+}
+
+static struct EncodedOp *encode_ops()
+{
+    struct EncodedOp *ops = (struct EncodedOp *)calloc(MAX(1, context->ir_elements_count), sizeof(struct EncodedOp));
+    int chunk_size = MAX(ENCODED_CHUNK_MIN_SIZE, context->ir_elements_count / (context->thread_count * 4));
+    int chunks_count = (context->ir_elements_count + chunk_size - 1) / chunk_size;
+    struct EncodedChunk *chunks = (struct EncodedChunk *)malloc(sizeof(struct EncodedChunk) * MAX(1, chunks_count));
+
+    enum CPUType cpu_type = context->initial_cpu_type;
+    for(int i = 0; i < context->ir_elements_count; i++)
+    {
+        if (i % chunk_size == 0)
+        {
+            struct EncodedChunk *chunk = &chunks[i / chunk_size];
+            chunk->ops = ops;
+            chunk->first_element = i;
+            chunk->end_element = MIN(i + chunk_size, context->ir_elements_count);
+            chunk->cpu_type = cpu_type;
+        }
+
+        if (context->ir_elements[i].node->type == NODE_TYPE_SET_CPU_TYPE)
+        {
+            cpu_type = (enum CPUType)context->ir_elements[i].node->num_value;
         }
     }
-    if (data_length != NULL) {(*data_length)++;}
+
+    run_workers(chunks_count, context->thread_count, encode_chunk_job, chunks);
+    free(chunks);
+
+    return ops;
+}
+
+// Adds the output elements of an op encoded in another thread
+static int add_encoded_op(struct EncodedOp *op, int *length)
+{
+    if (op->failed)
+    {
+        if (op->messages != NULL)
+        {
+            printf("%s", op->messages);
+        }
+        return 1;
+    }
+
+    if (context->output_length == 0)
+    {
+        free(context->first_output_elem);
+        context->first_output_elem = op->first_output_elem;
+        op->first_output_elem->previous = NULL;
+    }
+    else
+    {
+        context->last_output_elem->next = op->first_output_elem;
+        op->first_output_elem->previous = context->last_output_elem;
+    }
+    context->last_output_elem = op->last_output_elem;
+    context->last_output_elem->next = NULL;
+    context->output_length += op->output_length;
+    context->output_bytes += op->output_bytes;
+    *length = op->length;
 
     return 0;
 }
 
-static int second_pass(struct ASTNode *first_node)
+static void free_encoded_ops(struct EncodedOp *ops)
 {
-    struct ASTNode *current_node = first_node, *node;
+    if (ops == NULL) { return; }
+
+    for(int i = 0; i < context->ir_elements_count; i++)
+    {
+        free(ops[i].messages);
+    }
+    free(ops);
+}
+
+static int second_pass(struct EncodedOp *encoded_ops)
+{
+    struct ASTNode *node;
 
     write_debug("Compiler second pass...", 0);
 
-    compiler_current_address = 0;
+    context->compiler_current_address = 0;
 
-    assemble_all = FALSE;
-    jr_in_loops = FALSE;
+    context->assemble_all = FALSE;
+    context->jr_in_loops = FALSE;
 
-    while (current_node != NULL && current_node->children_count > 0)
+    int library_symbol_end = -1;
+    for(int i = 0; i < context->ir_elements_count; i++)
     {
-        node = current_node->children[0];
+        node = context->ir_elements[i].node;
 
-        assert(current_node->type == NODE_TYPE_MAIN);
+        // In object files each library symbol is a section, the linker leaves out the ones nothing refers to
+        if (i == library_symbol_end)
+        {
+            add_object_section(NULL, 0, NULL, 0);
+        }
+        if (context->ir_elements[i].library_symbol_end > 0 || (node->type == NODE_TYPE_DATA && node->str_size > 0 && node->str_size2 > 0))
+        {
+            add_object_section(node->str_value2, node->str_size2, node->str_value, node->str_size);
+            library_symbol_end = MAX(i + 1, context->ir_elements[i].library_symbol_end);
+        }
 
         switch(node->type)
         {
             case NODE_TYPE_OP:
             {
-                int old_output_length = output_length;
+                int old_output_length = context->output_length;
                 int op_length = -1;
-                if (compile_op(node, TRUE, &op_length))
+                add_list_line(LIST_LINE_OP, node);
+                if (encoded_ops != NULL)
                 {
-                    return 1;
+                    if (add_encoded_op(&encoded_ops[i], &op_length)) { return 1; }
                 }
-
-                if (fp_list != NULL)
+                else if (compile_op(node, TRUE, &op_length))
                 {
-                    fprint_start_list(fp_list, node);
-                    fprintf(fp_list, "\t");
-                    fprint_op(fp_list, node);
+                    return 1;
                 }
 
-                assert(op_length > 0 && op_length < MAX(5, MAX_AST_NODE_CHILDREN+1));
-                last_output_elem->set_address = TRUE;
-                compiler_current_address += output_length - old_output_length;
+                end_list_line();
+
+                assert(op_length == context->ir_elements[i].length);
+                context->last_output_elem->set_address = TRUE;
+                context->compiler_current_address += context->output_length - old_output_length;
                 break;
             }
             case NODE_TYPE_LABEL:
@@ -1290,14 +1581,19 @@ static int second_pass(struct ASTNode *first_node)
                     write_compiler_error(node->filename, node->file_line, "Symbol \"%.*s\" already defined", node->str_size, node->str_value);
                     return 1;
                 }
-                set_constant(node->str_value2, node->str_size2, node->str_value, node->str_size, compiler_current_address);
+                set_constant(node->str_value2, node->str_size2, node->str_value, node->str_size, context->compiler_current_address);
+                add_object_symbol(node->str_value2, node->str_size2, node->str_value, node->str_size, TRUE, context->compiler_current_address);
 
-                if (fp_list != NULL)
-                {
-                    fprint_start_list(fp_list, node);
-                    fprint_identifier(fp_list, node);
-                    fprintf(fp_list, ":\n");
-                }
+                add_list_line(LIST_LINE_LABEL, node);
+
+                break;
+            }
+            case NODE_TYPE_GENERATED_LABEL:
+            {
+                set_generated_label((int)node->num_value, context->compiler_current_address);
+                add_object_generated_label((int)node->num_value, context->compiler_current_address);
+
+                add_list_line(LIST_LINE_LABEL, node);
 
                 break;
             }
@@ -1317,14 +1613,10 @@ static int second_pass(struct ASTNode *first_node)
                         write_compiler_error(node->filename, node->file_line, "Symbol \"%.*s\" already defined", node->str_size, node->str_value);
                         return 1;
                     }
-                    set_constant(node->str_value2, node->str_size2, node->str_value, node->str_size, compiler_current_address);
+                    set_constant(node->str_value2, node->str_size2, node->str_value, node->str_size, context->compiler_current_address);
+                    add_object_symbol(node->str_value2, node->str_size2, node->str_value, node->str_size, TRUE, context->compiler_current_address);
 
-                    if (fp_list != NULL)
-                    {
-                        fprint_start_list(fp_list, node);
-                        fprint_identifier(fp_list, node);
-                        fprintf(fp_list, ":\n");
-                    }
+                    add_list_line(LIST_LINE_LABEL, node);
                 }
                 
                 struct StructuredType *structured_type = NULL;
@@ -1347,6 +1639,14 @@ static int second_pass(struct ASTNode *first_node)
                     }
                 }                
 
+                // Structured values are listed by element when they are initialized and uninitialized data as a single reservation
+                BOOL is_reserved = node->children[1]->type == NODE_TYPE_DATA_SIZE && node->children[1]->children_count < 2;
+                BOOL list_data = node->children[1]->type == NODE_TYPE_DATA_FROM || (structured_type == NULL && !is_reserved);
+                if (list_data)
+                {
+                    add_list_data_line(node, structured_type != NULL ? 1 : get_native_type_size(node->children[0]->str_value, node->children[0]->str_size));
+                }
+
                 if (node->children[1]->type == NODE_TYPE_DATA_VALUE)
                 {
                     int data_length = 0;
@@ -1357,7 +1657,7 @@ static int second_pass(struct ASTNode *first_node)
                         node_value = node_value->children[1];
                     }
 
-                    if (fp_list != NULL) fprint_db_list_end(fp_list);
+                    if (list_data) { end_list_line(); }
 
                     if (node->str_size > 0)
                     {
@@ -1377,7 +1677,7 @@ static int second_pass(struct ASTNode *first_node)
                                 return 1;
                             }
 
-                        if (fp_list != NULL) fprint_data_list(fp_list, node, get_last_data_symbol()->size_of_type * data_length, data_length);
+                        add_list_data_size_line(node, get_last_data_symbol()->size_of_type * data_length, data_length);
                     }                    
                 }
                 else if (node->children[1]->type == NODE_TYPE_DATA_SIZE)
@@ -1403,84 +1703,51 @@ static int second_pass(struct ASTNode *first_node)
 
                     // TODO: check value versus address positions left
 
-                    for(int i = 0; i < value; i++)
+                    if (node->children[1]->children_count == 2)
                     {
-                        if (node->children[1]->children_count == 2)
+                        // of
+                        for(int i = 0; i < value; i++)
                         {
-                            // of
                             if (compile_data_init(node->children[0]->str_value, node->children[0]->str_size, structured_type, node, node->children[1]->children[1], NULL, FALSE)) { return 1; }
                         }
-                        else
-                        {
-                            if (is_str_equal(node->children[0]->str_value, node->children[0]->str_size, "byte"))
-                            {                            
-                                add_output_element_set_address(0, NULL);
-
-                                if (fp_list != NULL) fprint_db_list(fp_list, node, 0, NULL, FPRINT_DB_TYPE_BYTE);
-
-                                compiler_current_address++;                            
-                            }
-                            else if (is_str_equal(node->children[0]->str_value, node->children[0]->str_size, "word"))
-                            {
-                                add_output_element(0, NULL);
-                                add_output_element_set_address(0, NULL);
-
-                                if (fp_list != NULL) fprint_db_list(fp_list, node, 0, NULL, FPRINT_DB_TYPE_WORD);
-
-                                compiler_current_address += 2;                            
-                            }
-                            else if (is_str_equal(node->children[0]->str_value, node->children[0]->str_size, "dword"))
-                            {
-                                add_output_element(0, NULL);
-                                add_output_element(0, NULL);
-                                add_output_element(0, NULL);
-                                add_output_element_set_address(0, NULL);
-
-                                if (fp_list != NULL) fprint_db_list(fp_list, node, 0, NULL, FPRINT_DB_TYPE_DWORD);
+                    }
+                    else
+                    {
+                        // Uninitialized data only reserves space, a single run of zeros that is skipped while output is off
+                        int size_of_type = structured_type != NULL ? structured_type->struct_size : get_native_type_size(node->children[0]->str_value, node->children[0]->str_size);
 
-                                compiler_current_address += 4;                            
-                            }
-                            else
-                            {
-                                for(int j = 0; j < structured_type->struct_size; j++)
-                                {
-                                    add_output_element_set_address(0, NULL);
-                                    if (fp_list != NULL) fprint_db_list(fp_list, node, 0, NULL, FPRINT_DB_TYPE_BYTE);
-                                    compiler_current_address++;
-                                }
-                            }    
-                        }                    
+                        add_list_line(LIST_LINE_DATA_RESERVED, node);
+                        add_output_run(NULL, (int)value * size_of_type);
+                        context->compiler_current_address += (int)value * size_of_type;
+                        end_list_line();
                     }
 
-                    if (fp_list != NULL) fprint_db_list_end(fp_list);
+                    if (list_data) { end_list_line(); }
 
                     if (node->str_size > 0)
                     {
-                        if (fp_list != NULL) fprint_data_list(fp_list, node, get_last_data_symbol()->size_of_type * get_last_data_symbol()->length, get_last_data_symbol()->length);
+                        add_list_data_size_line(node, get_last_data_symbol()->size_of_type * get_last_data_symbol()->length, get_last_data_symbol()->length);
                     }
                 }
                 else if (node->children[1]->type == NODE_TYPE_DATA_FROM)
                 {
                     struct ASTNode *from_node = node->children[1];
 
-                    char *new_filename = (char*)malloc(256);
+                    char *new_filename = (char*)allocate_context_memory(256);
                     if (!get_file_include_path(new_filename, from_node->str_value, from_node->filename))
                     {
                         write_compiler_error(from_node->filename, from_node->file_line, "Error including binary file \"%s\"", from_node->str_value);
                         return 1;
                     }
                     
-                    FILE *fp = fopen(new_filename, "rb");
-                    if (fp == NULL)
+                    long file_size = 0;
+                    uint8_t *content = (uint8_t *)read_file_to_cache(new_filename, TRUE, &file_size, NULL, NULL);
+                    if (content == NULL)
                     {
                         write_compiler_error(node->filename, node->file_line, "Unable to open file \"%s\" in data statement", new_filename);
                         return 1;
                     }
 
-                    fseek(fp, 0, SEEK_END);
-                    long file_size = ftell(fp);
-                    fseek(fp, 0, SEEK_SET);
-
                     int size_of_type = 0;
                     if (structured_type != NULL)
                     {
@@ -1518,23 +1785,14 @@ static int second_pass(struct ASTNode *first_node)
                             node->children[0]->str_value2, node->children[0]->str_size2, file_size / size_of_type);
                     }
 
-                    uint8_t byte_read;
-                    int bytes_read_count = (int)fread(&byte_read, 1, 1, fp);
-                    while (bytes_read_count)
-                    {
-                        add_output_element_set_address(byte_read, NULL);
-                        bytes_read_count = (int)fread(&byte_read, 1, 1, fp);
-
-                        if (fp_list != NULL) fprint_db_list(fp_list, node, byte_read, NULL, FPRINT_DB_TYPE_BYTE);
-
-                        compiler_current_address++;
-                    }
+                    add_output_run(content, (int)file_size);
+                    context->compiler_current_address += (uint16_t)file_size;
 
-                    if (fp_list != NULL) fprint_db_list_end(fp_list);
+                    end_list_line();
 
                     if (node->str_size > 0)
                     {
-                        if (fp_list != NULL) fprint_data_list(fp_list, node, get_last_data_symbol()->size_of_type * get_last_data_symbol()->length, get_last_data_symbol()->length);
+                        add_list_data_size_line(node, get_last_data_symbol()->size_of_type * get_last_data_symbol()->length, get_last_data_symbol()->length);
                     }
                 }
                 else
@@ -1557,6 +1815,7 @@ static int second_pass(struct ASTNode *first_node)
                 }
 
                 set_constant(node->str_value2, node->str_size2, node->str_value, node->str_size, value);
+                add_object_symbol(node->str_value2, node->str_size2, node->str_value, node->str_size, FALSE, value);
                 break;
             }
             case NODE_TYPE_STRUCT:
@@ -1578,7 +1837,8 @@ static int second_pass(struct ASTNode *first_node)
                     write_compiler_error(node->filename, node->file_line, "Expression in #origin cannot be resolved", 0);
                     return 1;
                 }
-                compiler_current_address = (int)result;
+                context->compiler_current_address = (int)result;
+                add_object_section(NULL, 0, NULL, 0);
 
                 break;
             }
@@ -1592,98 +1852,132 @@ static int second_pass(struct ASTNode *first_node)
             }
             case NODE_TYPE_INCLUDE_BINARY:
             {
-                char *new_filename = (char*)malloc(256);
+                char *new_filename = (char*)allocate_context_memory(256);
                 if (!get_file_include_path(new_filename, node->str_value, node->filename))
                 {
                     write_compiler_error(node->filename, node->file_line, "Error including binary file \"%s\"", node->str_value);
                     return 1;
                 }
 
-                FILE *fp = fopen(new_filename, "rb");
-                if (fp == NULL)
+                long file_size = 0;
+                uint8_t *content = (uint8_t *)read_file_to_cache(new_filename, TRUE, &file_size, NULL, NULL);
+                if (content == NULL)
                 {
                     write_compiler_error(node->filename, node->file_line, "Unable to open binary file \"%s\"", new_filename);
                     return 1;
                 }
 
-                uint8_t byte_read;
-                int bytes_read_count = (int)fread(&byte_read, 1, 1, fp);
-                while (bytes_read_count)
+                for(long i = 0; i < file_size; i++)
                 {
-                    add_output_element(byte_read, NULL);
-                    bytes_read_count = (int)fread(&byte_read, 1, 1, fp);
+                    add_output_element(content[i], NULL);
                 }
 
                 break;
             }
             case NODE_TYPE_SET_CPU_TYPE:
             {
-                cpu_type = (enum CPUType)node->num_value;
+                context->cpu_type = (enum CPUType)node->num_value;
                 break;
             }
             case NODE_TYPE_ASSEMBLEALL_ON:
             {
-                assemble_all = TRUE;
+                context->assemble_all = TRUE;
                 break;
             }
             case NODE_TYPE_ASSEMBLEALL_OFF:
             {
-                assemble_all = FALSE;
+                context->assemble_all = FALSE;
                 break;
             }
             case NODE_TYPE_JRINLOOPS_ON:
             {
-                jr_in_loops = TRUE;
+                context->jr_in_loops = TRUE;
                 break;
             }
             case NODE_TYPE_JRINLOOPS_OFF:
             {
-                jr_in_loops = FALSE;
+                context->jr_in_loops = FALSE;
                 break;
             }
             default:
                 break;
         }
-        current_node = current_node->children[1];        
     }
 
     return 0;
 }
 
-char *compiler_output_filename;
-static FILE *compiler_fp_output = NULL;
+// Output files of a configuration are written in its own directory
+void get_output_path(char *dst, char *filename)
+{
+    filename_add_path(dst, filename, context->output_directory != NULL ? context->output_directory : "");
+}
 
-BOOL assemble_all = FALSE;
+// The time an output file is open is its span in the time trace
+static void close_output_file()
+{
+    if (context->compiler_fp_output == NULL) { return; }
 
-BOOL jr_in_loops = FALSE;
+    fclose(context->compiler_fp_output);
+    context->compiler_fp_output = NULL;
 
-int bytes_saved = 0;
+    char output_path[256];
+    get_output_path(output_path, context->compiler_output_filename);
+    add_trace_span("write", "write", output_path, (int)strlen(output_path), context->output_file_trace_start);
+}
 
-static void write_output_byte(uint8_t value)
+static int write_output_bytes(uint8_t *values, int size)
 {
-    if (!compiler_fp_output)
+    static uint8_t zeros[256] = { 0 };
+
+    if (context->check_only)
+    {
+        context->bytes_saved += size;
+        return 0;
+    }
+
+    if (!context->compiler_fp_output)
+    {
+        char output_path[256];
+        get_output_path(output_path, context->compiler_output_filename);
+        context->compiler_fp_output = fopen(output_path, "wb");
+        if (!context->compiler_fp_output)
+        {
+            write_error("Unable to open output file \"%s\"", output_path);
+            return 1;
+        }
+        add_written_file(output_path);
+        context->output_file_trace_start = start_trace_span();
+    }
+
+    if (values != NULL)
+    {
+        fwrite(values, 1, size, context->compiler_fp_output);
+    }
+    else
     {
-        compiler_fp_output = fopen(compiler_output_filename, "wb");
+        for(int written = 0; written < size; written += (int)sizeof(zeros))
+        {
+            fwrite(zeros, 1, MIN(size - written, (int)sizeof(zeros)), context->compiler_fp_output);
+        }
     }
+    context->bytes_saved += size;
 
-    fwrite(&(value), 1, 1, compiler_fp_output);
-    bytes_saved++;
+    return 0;
 }
 
-static int third_pass(struct ASTNode *node)
+// Resolves the values of the output elements from first to end (not included) starting at an address
+// The element being resolved is kept in resolving_output_elem, on an error it is the one that failed
+static int resolve_output_elements(struct OutputElement *first_output_elem, struct OutputElement *end_output_elem, int current_address, struct OutputElement **resolving_output_elem)
 {
     int64_t value;
     struct OutputElement *current_output_elem = first_output_elem;
-    BOOL write_output_content = TRUE;
-
-    write_debug("Compiler third pass...", 0);
 
-    int current_address = compiler_current_address = 0;
-
-    while(current_output_elem != NULL)
+    while(current_output_elem != end_output_elem)
     {        
         if (current_output_elem->node != NULL)
         {
+            *resolving_output_elem = current_output_elem;
             switch(current_output_elem->node->type)
             {
                 case NODE_TYPE_EXPRESSION:
@@ -1692,7 +1986,6 @@ static int third_pass(struct ASTNode *node)
                     if (resolve_expression(current_output_elem->node, &value)) return 1; 
                     current_output_elem->value = (uint8_t)value;
                     current_output_elem->node = NULL;
-                    if (write_output_content) write_output_byte(current_output_elem->value);
                     break;
                 }
                 case NODE_TYPE_EXPRESSION_8c:
@@ -1701,7 +1994,6 @@ static int third_pass(struct ASTNode *node)
                     if (resolve_expression(current_output_elem->node, &value)) return 1; 
                     current_output_elem->value = (uint8_t)(value-2);
                     current_output_elem->node = NULL;
-                    if (write_output_content) write_output_byte(current_output_elem->value);
                     break;
                 }
                 case NODE_TYPE_EXPRESSION_16:
@@ -1709,11 +2001,9 @@ static int third_pass(struct ASTNode *node)
                     if (resolve_expression(current_output_elem->node, &value)) return 1;
                     current_output_elem->value = value & 0xFF;
                     current_output_elem->node = NULL;
-                    if (write_output_content) write_output_byte(current_output_elem->value);
                     current_output_elem = current_output_elem->next;
                     current_output_elem->value = (value >> 8) & 0xFF;
                     current_output_elem->node = NULL;
-                    if (write_output_content) write_output_byte(current_output_elem->value);
                     current_address++;
                     break;                    
                 }
@@ -1722,19 +2012,15 @@ static int third_pass(struct ASTNode *node)
                     if (resolve_expression(current_output_elem->node, &value)) return 1;
                     current_output_elem->value = value & 0xFF;
                     current_output_elem->node = NULL;
-                    if (write_output_content) write_output_byte(current_output_elem->value);
                     current_output_elem = current_output_elem->next;
                     current_output_elem->value = (value >> 8) & 0xFF;
                     current_output_elem->node = NULL;
-                    if (write_output_content) write_output_byte(current_output_elem->value);
                     current_output_elem = current_output_elem->next;
                     current_output_elem->value = (value >> 16) & 0xFF;
                     current_output_elem->node = NULL;
-                    if (write_output_content) write_output_byte(current_output_elem->value);
                     current_output_elem = current_output_elem->next;
                     current_output_elem->value = (value >> 24) & 0xFF;
                     current_output_elem->node = NULL;
-                    if (write_output_content) write_output_byte(current_output_elem->value);
                     current_address+=3;
                     break;                    
                 }
@@ -1749,7 +2035,6 @@ static int third_pass(struct ASTNode *node)
                             current_output_elem->value = (uint8_t)current_node->num_value2;
                             current_output_elem->node = NULL;
 
-                            if (write_output_content) write_output_byte(current_output_elem->value);
                             break;
                         }
                         current_node = current_node->children[0];
@@ -1773,7 +2058,6 @@ static int third_pass(struct ASTNode *node)
                     value &= 0xFF;
                     current_output_elem->value = (uint8_t)value;
                     current_output_elem->node = NULL;
-                    if (write_output_content) write_output_byte((uint8_t)value);
                     break;
                 }
                 case NODE_TYPE_PRINT:
@@ -1808,10 +2092,55 @@ static int third_pass(struct ASTNode *node)
                     struct ASTNode *origin_expression_node = current_output_elem->node->children[0];
                     int64_t result = 0;
                     if (resolve_expression(origin_expression_node, &result)) { return 1; }
-                    compiler_current_address = current_address = (int)result;
+                    context->compiler_current_address = current_address = (int)result;
 
                     break;
                 }
+                case NODE_TYPE_OUTPUT_ON:
+                case NODE_TYPE_OUTPUT_OFF:
+                case NODE_TYPE_SET_OUTPUT_FILE:
+                {
+                    // handled when writing the output
+                    break;
+                }
+                default:
+                {
+                    assert(1 == 0 && "Unexpected AST node type");
+                }
+            }
+        }
+
+        if (current_output_elem != NULL && current_output_elem->final)
+        {
+            current_address += current_output_elem->size;
+            if (current_output_elem->set_address)
+            {
+                context->compiler_current_address = current_address;
+            }
+        }
+        current_output_elem = current_output_elem->next;
+    }
+
+    return 0;
+}
+
+static int write_output_elements(struct OutputElement *first_output_elem, struct OutputElement *end_output_elem, BOOL write_output_content)
+{
+    struct OutputElement *current_output_elem = first_output_elem;
+
+    while(current_output_elem != end_output_elem)
+    {
+        if (current_output_elem->final)
+        {
+            if (write_output_content)
+            {
+                if (write_output_bytes(current_output_elem->size > 1 ? current_output_elem->values : &current_output_elem->value, current_output_elem->size)) { return 1; }
+            }
+        }
+        else if (current_output_elem->node != NULL)
+        {
+            switch(current_output_elem->node->type)
+            {
                 case NODE_TYPE_OUTPUT_ON:
                 {
                     write_output_content = TRUE;
@@ -1825,35 +2154,554 @@ static int third_pass(struct ASTNode *node)
                 case NODE_TYPE_SET_OUTPUT_FILE:
                 {
                     write_debug("Changing output file to \"%s\"", current_output_elem->node->str_value);
-                    if (compiler_fp_output)
-                    {
-                        fclose(compiler_fp_output);
-                        compiler_fp_output = NULL;
-                    }
-                    compiler_output_filename = current_output_elem->node->str_value;
+                    close_output_file();
+                    context->compiler_output_filename = current_output_elem->node->str_value;
                     break;
                 }
                 default:
-                {
-                    assert(1 == 0 && "Unexpected AST node type");
-                }
+                    break;
             }
         }
-        else if (current_output_elem->final)
+        current_output_elem = current_output_elem->next;
+    }
+
+    return 0;
+}
+
+// *************
+// Output segments
+// *************
+
+// The output is split in segments that are resolved on their own, once the addresses are known the values only
+// depend on the address where the segment starts, found walking the output. Each #output_file starts a segment
+// that is also written on its own.
+#define OUTPUT_SEGMENT_MIN_SIZE 4096
+
+struct OutputSegment
+{
+    struct OutputElement *first_output_elem;
+    int address;
+    uint16_t compiler_address;
+    BOOL write_output_content;
+    BOOL starts_output_file;
+
+    int result;
+    char *messages;
+    int bytes_saved;
+    struct OutputElement *failed_output_elem;
+};
+
+struct OutputSegments
+{
+    struct OutputSegment *segments;
+    int count;
+    int capacity;
+
+    int *output_files; // indexes of the segments that start output files
+    int output_files_count;
+    BOOL write_in_parallel;
+};
+
+static void add_output_segment(struct OutputSegments *segments, struct OutputElement *first_output_elem, int address, BOOL write_output_content, BOOL starts_output_file)
+{
+    if (segments->count == segments->capacity)
+    {
+        segments->capacity = MAX(16, segments->capacity * 2);
+        segments->segments = (struct OutputSegment *)realloc(segments->segments, sizeof(struct OutputSegment) * segments->capacity);
+        segments->output_files = (int *)realloc(segments->output_files, sizeof(int) * segments->capacity);
+    }
+
+    if (starts_output_file)
+    {
+        segments->output_files[segments->output_files_count++] = segments->count;
+    }
+
+    struct OutputSegment *segment = &segments->segments[segments->count++];
+    segment->first_output_elem = first_output_elem;
+    segment->address = address;
+    segment->compiler_address = context->compiler_current_address;
+    segment->write_output_content = write_output_content;
+    segment->starts_output_file = starts_output_file;
+    segment->result = 0;
+    segment->messages = NULL;
+    segment->bytes_saved = 0;
+    segment->failed_output_elem = NULL;
+}
+
+static BOOL is_output_file_in_segments(struct OutputSegments *segments, char *filename)
+{
+    if (!strcmp(context->compiler_output_filename, filename)) { return TRUE; }
+
+    for(int i = 1; i < segments->output_files_count; i++)
+    {
+        if (!strcmp(segments->segments[segments->output_files[i]].first_output_elem->node->str_value, filename)) { return TRUE; }
+    }
+
+    return FALSE;
+}
+
+// Follows the addresses like the third pass without resolving anything but #origin, the output is not split
+// after an #origin that can't be resolved. Output files are written one after the other when two segments
+// would write the same file.
+static void find_output_segments(struct OutputSegments *segments)
+{
+    struct OutputElement *current_output_elem = context->first_output_elem;
+    BOOL write_output_content = TRUE;
+    int current_address = context->compiler_current_address = 0;
+    int segment_size = MAX(OUTPUT_SEGMENT_MIN_SIZE, context->output_length / (context->thread_count * 4));
+    int current_segment_size = 0;
+
+    segments->write_in_parallel = TRUE;
+    add_output_segment(segments, current_output_elem, current_address, write_output_content, TRUE);
+
+    while(current_output_elem != NULL)
+    {
+        if (current_segment_size >= segment_size &&
+            (current_output_elem->node == NULL || current_output_elem->node->type != NODE_TYPE_SET_OUTPUT_FILE))
         {
-            if (write_output_content) write_output_byte(current_output_elem->value);
+            add_output_segment(segments, current_output_elem, current_address, write_output_content, FALSE);
+            current_segment_size = 0;
         }
+        current_segment_size++;
 
-        if (current_output_elem != NULL && current_output_elem->final)
+        if (current_output_elem->node != NULL)
         {
-            current_address++;
+            switch(current_output_elem->node->type)
+            {
+                case NODE_TYPE_EXPRESSION_16:
+                {
+                    current_output_elem = current_output_elem->next;
+                    current_address++;
+                    break;
+                }
+                case NODE_TYPE_EXPRESSION_32:
+                {
+                    current_output_elem = current_output_elem->next->next->next;
+                    current_address += 3;
+                    break;
+                }
+                case NODE_TYPE_ORIGIN:
+                {
+                    int64_t result = 0;
+                    hold_messages(TRUE);
+                    int error = resolve_expression(current_output_elem->node->children[0], &result);
+                    free(take_held_messages());
+                    hold_messages(FALSE);
+                    if (error) { return; }
+                    context->compiler_current_address = current_address = (int)result;
+                    break;
+                }
+                case NODE_TYPE_OUTPUT_ON:
+                case NODE_TYPE_OUTPUT_OFF:
+                {
+                    write_output_content = current_output_elem->node->type == NODE_TYPE_OUTPUT_ON;
+                    break;
+                }
+                case NODE_TYPE_SET_OUTPUT_FILE:
+                {
+                    if (is_output_file_in_segments(segments, current_output_elem->node->str_value))
+                    {
+                        segments->write_in_parallel = FALSE;
+                    }
+                    add_output_segment(segments, current_output_elem, current_address, write_output_content, TRUE);
+                    current_segment_size = 1;
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        if (current_output_elem->final)
+        {
+            current_address += current_output_elem->size;
             if (current_output_elem->set_address)
             {
-                compiler_current_address = current_address;
+                context->compiler_current_address = current_address;
             }
         }
         current_output_elem = current_output_elem->next;
     }
+}
+
+// Segments work on a copy of the context, they only change the current address and the output file,
+// messages are held to be written in the order of the segments
+static int resolve_segment_job(void *argument, int index)
+{
+    struct OutputSegments *segments = (struct OutputSegments *)argument;
+    struct OutputSegment *segment = &segments->segments[index];
+    struct OutputElement *end_output_elem = index + 1 < segments->count ? segments->segments[index + 1].first_output_elem : NULL;
+    struct Z80HLAContext *previous_context = context;
+    struct Z80HLAContext segment_context = *context;
+
+    context = &segment_context;
+    context->compiler_current_address = segment->compiler_address;
+
+    uint64_t trace_start = start_trace_span();
+    hold_messages(TRUE);
+    segment->result = resolve_output_elements(segment->first_output_elem, end_output_elem, segment->address, &segment->failed_output_elem);
+    segment->messages = take_held_messages();
+    hold_messages(FALSE);
+    add_trace_span("compile", "resolve segment", NULL, 0, trace_start);
+
+    context = previous_context;
+
+    return segment->result;
+}
+
+static int write_segment_job(void *argument, int index)
+{
+    struct OutputSegments *segments = (struct OutputSegments *)argument;
+    struct OutputSegment *segment = &segments->segments[segments->output_files[index]];
+    struct OutputElement *end_output_elem = index + 1 < segments->output_files_count ? segments->segments[segments->output_files[index + 1]].first_output_elem : NULL;
+    struct Z80HLAContext *previous_context = context;
+    struct Z80HLAContext segment_context = *context;
+
+    context = &segment_context;
+    context->compiler_fp_output = NULL;
+    context->bytes_saved = 0;
+
+    hold_messages(TRUE);
+    segment->result = write_output_elements(segment->first_output_elem, end_output_elem, segment->write_output_content);
+    close_output_file();
+    segment->messages = take_held_messages();
+    hold_messages(FALSE);
+    segment->bytes_saved = context->bytes_saved;
+
+    context = previous_context;
+
+    return segment->result;
+}
+
+// Writes the messages of the segments in order until the first one with an error, as the passes stop there
+static int finish_segments(struct OutputSegments *segments)
+{
+    int result = 0;
+
+    for(int i = 0; i < segments->count; i++)
+    {
+        struct OutputSegment *segment = &segments->segments[i];
+        if (segment->messages != NULL && !result)
+        {
+            printf("%s", segment->messages);
+        }
+        free(segment->messages);
+        segment->messages = NULL;
+
+        if (segment->result) { result = 1; }
+        segment->result = 0;
+    }
+
+    return result;
+}
+
+// On an error failed_output_elem is the first element that couldn't be resolved
+static int third_pass(struct OutputSegments *segments, struct OutputElement **failed_output_elem)
+{
+    write_debug("Compiler third pass...", 0);
+
+    if (segments->count == 1)
+    {
+        context->compiler_current_address = 0;
+        return resolve_output_elements(context->first_output_elem, NULL, 0, failed_output_elem);
+    }
+
+    run_workers(segments->count, context->thread_count, resolve_segment_job, segments);
+    for(int i = 0; i < segments->count; i++)
+    {
+        if (segments->segments[i].result)
+        {
+            *failed_output_elem = segments->segments[i].failed_output_elem;
+            break;
+        }
+    }
+    return finish_segments(segments);
+}
+
+// The output files before the element that failed are written and the file with it is removed,
+// as it was when the values were resolved while the output was written
+static void write_output_before_error(struct OutputElement *failed_output_elem)
+{
+    char *output_filename = context->compiler_output_filename;
+    struct OutputElement *output_file_elem = NULL;
+
+    for(struct OutputElement *current_output_elem = context->first_output_elem; current_output_elem != NULL && current_output_elem != failed_output_elem; current_output_elem = current_output_elem->next)
+    {
+        if (!current_output_elem->final && current_output_elem->node != NULL && current_output_elem->node->type == NODE_TYPE_SET_OUTPUT_FILE)
+        {
+            output_file_elem = current_output_elem;
+        }
+    }
+
+    if (output_file_elem != NULL)
+    {
+        write_output_elements(context->first_output_elem, output_file_elem, TRUE);
+        close_output_file();
+        context->compiler_output_filename = output_filename;
+        output_filename = output_file_elem->node->str_value;
+    }
+
+    if (context->check_only) { return; }
+
+    char output_path[256];
+    get_output_path(output_path, output_filename);
+    if (remove(output_path) && errno != ENOENT)
+    {
+        write_error("Unable to remove file \"%s\"", output_path);
+    }
+}
+
+static int write_output(struct OutputSegments *segments)
+{
+    if (segments->output_files_count == 1 || !segments->write_in_parallel)
+    {
+        int result = write_output_elements(context->first_output_elem, NULL, TRUE);
+        close_output_file();
+        return result;
+    }
+
+    run_workers(segments->output_files_count, context->thread_count, write_segment_job, segments);
+    for(int i = 0; i < segments->output_files_count; i++)
+    {
+        context->bytes_saved += segments->segments[segments->output_files[i]].bytes_saved;
+    }
+    return finish_segments(segments);
+}
+
+struct OutputReader
+{
+    struct OutputElement *elem;
+    int elem_offset; // position inside the current element
+    int offset; // position in the output
+};
+
+static uint8_t read_output(struct OutputReader *reader)
+{
+    while (!reader->elem->final || reader->elem_offset >= reader->elem->size)
+    {
+        reader->elem = reader->elem->next;
+        reader->elem_offset = 0;
+    }
+
+    struct OutputElement *elem = reader->elem;
+    uint8_t value = elem->size > 1 ? (elem->values != NULL ? elem->values[reader->elem_offset] : 0) : elem->value;
+    reader->elem_offset++;
+    reader->offset++;
+
+    return value;
+}
+
+static void seek_output(struct OutputReader *reader, int offset)
+{
+    while (reader->offset < offset)
+    {
+        if (!reader->elem->final || reader->elem_offset >= reader->elem->size)
+        {
+            reader->elem = reader->elem->next;
+            reader->elem_offset = 0;
+            continue;
+        }
+
+        int skip = MIN(reader->elem->size - reader->elem_offset, offset - reader->offset);
+        reader->elem_offset += skip;
+        reader->offset += skip;
+    }
+}
+
+static void fprint_start_list(FILE *fp, uint16_t address, struct ASTNode *node, uint8_t *bytes, int size)
+{
+    int column = 0;
+
+    fprintf(fp, "%04X\t", address);
+    for(int i = 0; i < size; i++)
+    {
+        column += fprintf(fp, "%02X ", bytes[i]);
+    }
+    fprintf(fp, "%*s\t", MAX(0, 12 - column), "");
+
+    if (node->file_line > 0)
+    {
+        fprintf(fp, "%35s:%-5d\t", node->filename, node->file_line);
+    }
+    else
+    {
+        fprintf(fp, "%35s %5s\t", "  ", " ");
+    }
+}
+
+static void fprint_identifier(FILE *fp, struct ASTNode *node)
+{
+    if (node->type == NODE_TYPE_GENERATED_LABEL)
+    {
+        fprintf(fp, "@l_%"PRId64"", node->num_value);
+    }
+    else if (node->str_size2 > 0)
+    {
+        fprintf(fp, "%.*s::%.*s", node->str_size2, node->str_value2, node->str_size, node->str_value);
+    }
+    else
+    {
+        fprintf(fp, "%.*s", node->str_size, node->str_value);
+    }
+}
+
+// Prints the listing lines with the values in the output after the third pass
+static int fprint_listing(void *argument)
+{
+    FILE *fp = (FILE *)argument;
+    struct OutputReader reader = { context->first_output_elem, 0, 0 };
+    uint64_t trace_start = start_trace_span();
+    uint8_t *bytes = NULL;
+    int bytes_capacity = 0;
+
+    for(int i = 0; i < context->list_lines_count; i++)
+    {
+        struct ListLine *line = &context->list_lines[i];
+
+        seek_output(&reader, line->output_offset);
+
+        switch(line->type)
+        {
+            case LIST_LINE_OP:
+            {
+                if (line->length > bytes_capacity)
+                {
+                    bytes_capacity = MAX(line->length, 16);
+                    bytes = (uint8_t *)realloc(bytes, bytes_capacity);
+                }
+                for(int j = 0; j < line->length; j++)
+                {
+                    bytes[j] = read_output(&reader);
+                }
+                fprint_start_list(fp, line->address, line->node, bytes, line->length);
+                fprintf(fp, "\t");
+                fprint_op(fp, line->node);
+                break;
+            }
+            case LIST_LINE_LABEL:
+            {
+                fprint_start_list(fp, line->address, line->node, NULL, 0);
+                fprint_identifier(fp, line->node);
+                fprintf(fp, ":\n");
+                break;
+            }
+            case LIST_LINE_DATA:
+            {
+                int count = 0;
+                for(int j = 0; j + line->size_of_type <= line->length; j += line->size_of_type)
+                {
+                    uint32_t value = 0;
+                    for(int b = 0; b < line->size_of_type; b++)
+                    {
+                        value |= (uint32_t)read_output(&reader) << (b * 8);
+                    }
+
+                    if (count % 16 == 0)
+                    {
+                        if (count > 0)
+                        {
+                            fprintf(fp, "\n");
+                        }
+                        fprint_start_list(fp, (uint16_t)(line->address + j), line->node, NULL, 0);
+                        fprintf(fp, line->size_of_type == 4 ? "\tDWORD " : (line->size_of_type == 2 ? "\tWORD " : "\tBYTE "));
+                    }
+                    else
+                    {
+                        fprintf(fp, ", ");
+                    }
+                    fprintf(fp, "%"PRIu32"", value);
+                    count++;
+                }
+                if (count > 0)
+                {
+                    fprintf(fp, "\n");
+                }
+                break;
+            }
+            case LIST_LINE_DATA_RESERVED:
+            {
+                fprint_start_list(fp, line->address, line->node, NULL, 0);
+                fprintf(fp, "\t; reserved %d byte%s\n", line->length, line->length == 1 ? "" : "s");
+                break;
+            }
+            case LIST_LINE_DATA_SIZE:
+            {
+                fprint_start_list(fp, line->address, line->node, NULL, 0);
+                fprintf(fp, "; sizeof(");
+                fprint_identifier(fp, line->node);
+                fprintf(fp, ") = %d\n", line->data_size);
+                fprint_start_list(fp, line->address, line->node, NULL, 0);
+                fprintf(fp, "; length(");
+                fprint_identifier(fp, line->node);
+                fprintf(fp, ") = %d\n", line->data_length);
+                break;
+            }
+        }
+    }
+
+    free(bytes);
+    add_trace_span("write", "write", context->listing_filename, (int)strlen(context->listing_filename), trace_start);
+
+    return 0;
+}
+
+// Third pass, the values in the output are resolved and the output files are written
+static int resolve_and_write_output()
+{
+    printf("pass 3...\n");
+    uint64_t trace_start = start_trace_span();
+
+    // Segments of the output are resolved and output files are written in parallel
+    struct OutputSegments segments;
+    memset(&segments, 0, sizeof(segments));
+    if (context->thread_count > 1)
+    {
+        find_output_segments(&segments);
+    }
+    else
+    {
+        add_output_segment(&segments, context->first_output_elem, 0, TRUE, TRUE);
+    }
+
+    struct OutputElement *failed_output_elem = NULL;
+    int result = third_pass(&segments, &failed_output_elem);
+    add_trace_span("compile", "pass 3", NULL, 0, trace_start);
+    if (result)
+    {
+        write_output_before_error(failed_output_elem);
+        free(segments.segments);
+        free(segments.output_files);
+        return 1;
+    }
+
+    // The listing is printed from the resolved output while it is being written
+    struct Thread *listing_thread = NULL;
+    if (context->fp_list != NULL)
+    {
+        listing_thread = create_thread(fprint_listing, context->fp_list);
+        if (listing_thread == NULL)
+        {
+            fprint_listing(context->fp_list);
+        }
+    }
+
+    int res = write_output(&segments);
+    free(segments.segments);
+    free(segments.output_files);
+
+    if (listing_thread != NULL)
+    {
+        join_thread(listing_thread);
+    }
+
+    if (res)
+    {
+        return 1;
+    }
+
+    write_debug("Compiler end", 0);
+
+    printf("%d bytes generated\n", context->bytes_saved);
 
     return 0;
 }
@@ -1863,66 +2711,108 @@ int compile(struct ASTNode *first_node)
     write_debug("Compiler start", 0);
 
     printf("pass 1...\n");
+    uint64_t trace_start = start_trace_span();
 
     int length = 0;
-    cpu_type = initial_cpu_type;
-    if (recursive_first_pass(first_node, &length))
+    BOOL assemble_all = context->assemble_all;
+    context->cpu_type = context->initial_cpu_type;
+    if (context->thread_count > 1)
+    {
+        lower_functions(first_node);
+    }
+    int result = recursive_first_pass(first_node, &length);
+    free_lowered_functions();
+    add_trace_span("compile", "pass 1", NULL, 0, trace_start);
+    if (result)
     {
         return 1;
     }
 
     #if DEBUG == 1
-    FILE *fp_AST = fopen("output_ast_after_first_pass.json", "w");
-    fprint_ast(fp_AST, first_node);
-    fclose(fp_AST);
+    FILE *fp_IR = fopen("output_ir_after_first_pass.json", "w");
+    fprintf(fp_IR, "[");
+    for(int i = 0; i < context->ir_elements_count; i++)
+    {
+        if (i > 0) { fprintf(fp_IR, ",\n"); }
+        fprint_ast(fp_IR, context->ir_elements[i].node);
+    }
+    fprintf(fp_IR, "]");
+    fclose(fp_IR);
     #endif
 
     printf("pass 2...\n");
+    trace_start = start_trace_span();
 
-    cpu_type = initial_cpu_type;
-    if (second_pass(first_node))
+    context->cpu_type = context->initial_cpu_type;
+    struct EncodedOp *encoded_ops = context->thread_count > 1 ? encode_ops() : NULL;
+    if (context->object_filename != NULL)
     {
-        return 1;
+        start_object_file(assemble_all);
     }
-
-    printf("pass 3...\n");
-
-    int res = 0;
-    res = third_pass(first_node);
-    if (compiler_fp_output != NULL)
+    result = second_pass(encoded_ops);
+    free_encoded_ops(encoded_ops);
+    add_trace_span("compile", "pass 2", NULL, 0, trace_start);
+    if (result)
     {
-        fclose(compiler_fp_output);
+        finish_object_file();
+        return 1;
     }
 
-    if (res)
+    // An object file has the output as it is after the second pass, the third one is done when it is linked
+    if (context->object_filename != NULL)
     {
-        if (remove(compiler_output_filename))
+        trace_start = start_trace_span();
+        result = save_object_file(context->object_filename);
+        finish_object_file();
+        add_trace_span("write", "write", context->object_filename, (int)strlen(context->object_filename), trace_start);
+        if (!result)
         {
-            write_error("Unable to remove file \"%s\"", compiler_output_filename);
+            printf("%d bytes generated\n", context->output_bytes);
         }
-        return 1;
+        return result;
     }
 
-    write_debug("Compiler end", 0);
+    return resolve_and_write_output();
+}
 
-    printf("%d bytes generated\n", bytes_saved);
+// Appends an element of the output read from an object file, values are not copied
+void add_linked_output_element(uint8_t value, uint8_t *values, int size, struct ASTNode *node, BOOL final, BOOL set_address)
+{
+    inner_add_output_element(value, node, final, set_address);
+    if (size > 1)
+    {
+        context->last_output_elem->values = values;
+        context->last_output_elem->size = size;
+        context->output_bytes += size - 1;
+    }
+}
 
-    return 0;
+// Resolves and writes the output of the object files linked
+int link_output()
+{
+    return resolve_and_write_output();
 }
 
 void fprint_output(FILE *fp)
 {
-    struct OutputElement *elem = first_output_elem;
+    struct OutputElement *elem = context->first_output_elem;
 
     fprintf(fp, "[");
 
-    for(int i = 0; i < output_length; i++)
+    for(int i = 0; i < context->output_length; i++)
     {
         if (i > 0)
         {
             fprintf(fp, ",");
         }
-        if (elem->node == NULL)
+        if (elem->node == NULL && elem->size > 1)
+        {
+            for(int j = 0; j < elem->size; j++)
+            {
+                fprintf(fp, j > 0 ? ",%d" : "%d", elem->values != NULL ? elem->values[j] : 0);
+            }
+        }
+        else if (elem->node == NULL)
         {
             fprintf(fp, "%d", elem->value);
         }
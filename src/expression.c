@@ -243,7 +243,16 @@ int resolve_expression(struct ASTNode *node, int64_t *result)
             }
             case '$':
             {
-                *result = (int64_t) compiler_current_address;
+                *result = (int64_t) context->compiler_current_address;
+                break;
+            }
+            case '@':
+            {
+                if (get_generated_label((int)node->num_value, result))
+                {
+                    write_compiler_error(node->filename, node->file_line, "Generated label %"PRId64" not found", node->num_value);
+                    return 1;
+                }
                 break;
             }
             case '.':
@@ -533,7 +542,7 @@ int resolve_expression(struct ASTNode *node, int64_t *result)
     }
     else if (node->type == NODE_TYPE_EXPRESSION_8_REL_CUR_ADDRESS)
     {
-        *result = *result - compiler_current_address;
+        *result = *result - context->compiler_current_address;
         if (*result > UINT8_MAX || *result < INT8_MIN)
         {
             write_compiler_error(node->filename, node->file_line, "Expression value %"PRId64" is an invalid 8-bit value", *result);
@@ -0,0 +1,254 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "z80hla.h"
+
+// The build database is kept next to the output file, it holds a digest of the options, the files read
+// with the digest of their content and the files written with the digest of what was written.
+// When all of them are the same the files written are up to date and nothing is compiled.
+// Otherwise the whole program is compiled again, as the addresses of everything depend on every file,
+// but the included files that did not change are read precompiled from a directory next to the database.
+
+#define BUILD_DATABASE_HEADER   "z80hla build database 3 v" Z80HLA_VERSION_HI "." Z80HLA_VERSION_LO
+#define DIGEST_TEXT_SIZE        (SHA256_SIZE * 2 + 1)
+
+struct WrittenFiles
+{
+    char database_path[256]; // taken before compiling, #output_file changes the output file
+    char **paths;
+    int count;
+    int capacity;
+};
+
+static void get_build_database_path(char *dst)
+{
+    get_output_path(dst, context->compiler_output_filename);
+    strcat(dst, ".z80db");
+}
+
+static void digest_string(struct Sha256 *sha256, char *str)
+{
+    if (str != NULL)
+    {
+        update_sha256(sha256, str, strlen(str) + 1);
+    }
+    else
+    {
+        update_sha256(sha256, "", 0);
+    }
+}
+
+// Digest of everything given to the compilation that is not in the files read, taken before parsing
+// since the define identifiers are also the ones defined by the files
+static void get_options_digest(uint8_t *digest)
+{
+    struct Sha256 sha256;
+    init_sha256(&sha256);
+    digest_string(&sha256, BUILD_DATABASE_HEADER);
+    digest_string(&sha256, context->input_filename);
+    digest_string(&sha256, context->compiler_output_filename);
+    digest_string(&sha256, context->symbol_filename);
+    digest_string(&sha256, context->listing_filename);
+    digest_string(&sha256, context->output_directory);
+    digest_string(&sha256, context->object_filename);
+    digest_string(&sha256, context->deps_filename);
+    update_sha256(&sha256, &context->include_generated_labels, sizeof(context->include_generated_labels));
+    update_sha256(&sha256, &context->assemble_all, sizeof(context->assemble_all));
+    update_sha256(&sha256, &context->jr_in_loops, sizeof(context->jr_in_loops));
+    update_sha256(&sha256, &context->initial_cpu_type, sizeof(context->initial_cpu_type));
+    digest_include_paths(&sha256);
+    digest_define_identifiers(&sha256);
+    finish_sha256(&sha256, digest);
+}
+
+static BOOL is_file_digest(char *filename, BOOL binary, char *digest)
+{
+    uint8_t current_digest[SHA256_SIZE];
+    char current_digest_text[DIGEST_TEXT_SIZE];
+    if (!digest_file(filename, binary, current_digest)) { return FALSE; }
+    sprint_digest(current_digest_text, current_digest);
+
+    return !strcmp(digest, current_digest_text);
+}
+
+// Lines are "options DIGEST", "read t|b DIGEST FILE" and "written DIGEST FILE"
+static BOOL is_build_database_up_to_date(FILE *fp)
+{
+    char line[1024], options_digest[DIGEST_TEXT_SIZE], digest_text[DIGEST_TEXT_SIZE];
+    BOOL has_options = FALSE, has_written = FALSE;
+
+    if (fgets(line, sizeof(line), fp) == NULL || strncmp(line, BUILD_DATABASE_HEADER "\n", sizeof(line))) { return FALSE; }
+
+    sprint_digest(options_digest, context->build_options_digest);
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        int name_start = 0;
+        char mode = 0;
+        line[strcspn(line, "\r\n")] = 0;
+
+        if (sscanf(line, "options %64s", digest_text) == 1)
+        {
+            if (strcmp(digest_text, options_digest)) { return FALSE; }
+            has_options = TRUE;
+        }
+        else if (sscanf(line, "read %c %64s %n", &mode, digest_text, &name_start) == 2 && name_start > 0)
+        {
+            if (!is_file_digest(line + name_start, mode == 'b', digest_text)) { return FALSE; }
+        }
+        else if (sscanf(line, "written %64s %n", digest_text, &name_start) == 1 && name_start > 0)
+        {
+            if (!is_file_digest(line + name_start, TRUE, digest_text)) { return FALSE; }
+            has_written = TRUE;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+
+    return has_options && has_written;
+}
+
+// TRUE when the files written by the last compilation are up to date and there is nothing to compile,
+// otherwise the build database is removed so a compilation with errors leaves none
+BOOL start_incremental_build()
+{
+    char path[256];
+
+    // The files written are also kept for the build cache and the dependency file
+    if (!context->incremental && context->cache_directory == NULL && context->deps_filename == NULL) { return FALSE; }
+
+    get_options_digest(context->build_options_digest);
+
+    if (context->incremental)
+    {
+        get_build_database_path(path);
+        FILE *fp = fopen(path, "r");
+        if (fp != NULL)
+        {
+            BOOL up_to_date = is_build_database_up_to_date(fp);
+            fclose(fp);
+
+            if (up_to_date) { return TRUE; }
+
+            remove(path);
+        }
+
+        // Without --pch the included files are kept precompiled next to the database
+        if (context->precompiled_directory == NULL)
+        {
+            get_output_path(path, context->compiler_output_filename);
+            strcat(path, ".z80pch");
+            context->precompiled_directory = (char *)allocate_context_memory(strlen(path) + 1);
+            strcpy(context->precompiled_directory, path);
+        }
+    }
+
+    context->written_files = (struct WrittenFiles *)calloc(1, sizeof(struct WrittenFiles));
+    get_build_database_path(context->written_files->database_path);
+
+    return FALSE;
+}
+
+// Output files are written by worker threads when there are several
+void add_written_file(char *path)
+{
+    struct WrittenFiles *written_files = context->written_files;
+    if (written_files == NULL) { return; }
+
+    lock_mutex(context->tables_mutex);
+    if (written_files->count == written_files->capacity)
+    {
+        written_files->capacity = MAX(16, written_files->capacity * 2);
+        written_files->paths = (char **)realloc(written_files->paths, sizeof(char *) * written_files->capacity);
+    }
+    written_files->paths[written_files->count] = (char *)malloc(strlen(path) + 1);
+    strcpy(written_files->paths[written_files->count++], path);
+    unlock_mutex(context->tables_mutex);
+}
+
+void for_each_written_file(void (*function)(char *path, void *argument), void *argument)
+{
+    struct WrittenFiles *written_files = context->written_files;
+    if (written_files == NULL) { return; }
+
+    for(int i = 0; i < written_files->count; i++)
+    {
+        function(written_files->paths[i], argument);
+    }
+}
+
+static void write_read_file(char *filename, BOOL binary, uint8_t *digest, void *argument)
+{
+    char digest_text[DIGEST_TEXT_SIZE];
+    sprint_digest(digest_text, digest);
+    fprintf((FILE *)argument, "read %c %s %s\n", binary ? 'b' : 't', digest_text, filename);
+}
+
+void finish_incremental_build(BOOL successful)
+{
+    struct WrittenFiles *written_files = context->written_files;
+    if (written_files == NULL) { return; }
+
+    char *path = written_files->database_path;
+
+    FILE *fp = successful && context->incremental ? fopen(path, "w") : NULL;
+    if (fp != NULL)
+    {
+        fprintf(fp, BUILD_DATABASE_HEADER "\n");
+        char options_digest[DIGEST_TEXT_SIZE];
+        sprint_digest(options_digest, context->build_options_digest);
+        fprintf(fp, "options %s\n", options_digest);
+        for_each_cached_file(write_read_file, fp);
+
+        BOOL written = TRUE;
+        for(int i = 0; i < written_files->count; i++)
+        {
+            uint8_t digest[SHA256_SIZE];
+            char digest_text[DIGEST_TEXT_SIZE];
+            written = written && digest_file(written_files->paths[i], TRUE, digest);
+            if (written)
+            {
+                sprint_digest(digest_text, digest);
+                fprintf(fp, "written %s %s\n", digest_text, written_files->paths[i]);
+            }
+        }
+
+        if (fclose(fp) || !written)
+        {
+            remove(path);
+        }
+    }
+
+    for(int i = 0; i < written_files->count; i++)
+    {
+        free(written_files->paths[i]);
+    }
+    free(written_files->paths);
+    free(written_files);
+    context->written_files = NULL;
+}
@@ -28,50 +28,35 @@
 
 int init_lexer(struct Lexer *lexer, char *filename)
 {
-    char *content = NULL;
-
-    content = get_content_from_cache(filename);
+    int error = 0;
+    char *content = read_file_to_cache(filename, FALSE, NULL, &error, NULL);
 
     if (content == NULL)
     {
-        FILE *fp = fopen(filename, "r");
-        if (!fp)
+        if (error == FILE_ERROR_OPEN)
         {
             write_error("Can't open file \"%s\".", filename);
-            return 1;
         }
-        fseek(fp, 0, SEEK_END);
-        long file_size = ftell(fp);
-        fseek(fp, 0, SEEK_SET);        
-        lexer->buffer_start = (char *)malloc((size_t)file_size + 1);
-        size_t read_size = fread(lexer->buffer_start, sizeof(char), (size_t)file_size, fp);
-        if (read_size != file_size)
+        else
         {
             write_error("Error reading file \"%s\".", filename);
-            return 1;
         }
-        write_debug("Opened file \"%s\" with the size of %ld bytes.", filename, file_size);
-        lexer->buffer_start[file_size] = 0;
-        lexer->buffer_at = lexer->buffer_start;
-        fclose(fp);
-
-        add_content_to_cache(filename, lexer->buffer_start);
-    }
-    else
-    {
-        write_debug("Using content from cache for file \"%s\"", filename);
-        lexer->buffer_start = lexer->buffer_at = content;
+        return 1;
     }
 
+    lexer->buffer_start = lexer->buffer_at = content;
     lexer->filename = filename;
     lexer->current_line = 1;
+    lexer->ifdef_stack = &context->ifdef_stack;
+    lexer->token_queue = NULL;
 
     return 0;
 }
 
+// The content belongs to the file cache, it is freed with the context
 int destroy_lexer(struct Lexer *lexer)
 {
-    free(lexer->buffer_start);
+    lexer->buffer_start = lexer->buffer_at = NULL;
 
     return 0;
 }
@@ -113,7 +98,7 @@ static int skip_characters(struct Lexer *lexer, BOOL skip_newline, BOOL rewind)
     
     if (rewind)
     {
-        save_duplicate_all_ifdef_expect();
+        save_duplicate_all_ifdef_expect(lexer->ifdef_stack);
     }
 
     while(TRUE)
@@ -173,7 +158,7 @@ static int skip_characters(struct Lexer *lexer, BOOL skip_newline, BOOL rewind)
             if ((has_identifier && check_defined) || (!has_identifier && !check_defined))
             {
                 // ignore next #else and wait for #endif
-                push_ifdef_expect(IFDEF_EXPECT_ELSE);
+                push_ifdef_expect(lexer->ifdef_stack, IFDEF_EXPECT_ELSE);
                 ifdef_push_count++;
             }
             else
@@ -184,18 +169,18 @@ static int skip_characters(struct Lexer *lexer, BOOL skip_newline, BOOL rewind)
                 if (token.type == TOKEN_TYPE_IFDEF_ELSE)
                 {
                     // wait until #endif
-                    push_ifdef_expect(IFDEF_EXPECT_ENDIF);
+                    push_ifdef_expect(lexer->ifdef_stack, IFDEF_EXPECT_ENDIF);
                     ifdef_push_count++;
                 }
             }
         }
         else if (token.type == TOKEN_TYPE_IFDEF_ELSE)
         {
-            if (peek_ifdef_expect() == IFDEF_EXPECT_ELSE)
+            if (peek_ifdef_expect(lexer->ifdef_stack) == IFDEF_EXPECT_ELSE)
             {
                 if (get_token(lexer, &token, skip_newline, FALSE, FALSE)) { return 1; }
 
-                pop_ifdef_expect();
+                pop_ifdef_expect(lexer->ifdef_stack);
                 ifdef_push_count--;
 
                 // wait until #endif
@@ -208,12 +193,12 @@ static int skip_characters(struct Lexer *lexer, BOOL skip_newline, BOOL rewind)
         }
         else if (token.type == TOKEN_TYPE_IFDEF_ENDIF)
         {
-            enum IfdefExpectType ifdef_expected_result = peek_ifdef_expect();
+            enum IfdefExpectType ifdef_expected_result = peek_ifdef_expect(lexer->ifdef_stack);
             if (ifdef_expected_result == IFDEF_EXPECT_ENDIF || ifdef_expected_result == IFDEF_EXPECT_ELSE)
             {
                 if (get_token(lexer, &token, skip_newline, FALSE, FALSE)) { return 1; }
 
-                pop_ifdef_expect();
+                pop_ifdef_expect(lexer->ifdef_stack);
                 ifdef_push_count--;
             }
             else
@@ -229,7 +214,7 @@ static int skip_characters(struct Lexer *lexer, BOOL skip_newline, BOOL rewind)
 
     if (rewind)
     {
-        revert_to_duplicate_ifdef_expect();
+        revert_to_duplicate_ifdef_expect(lexer->ifdef_stack);
     }
 
     return 0;
@@ -855,12 +840,206 @@ static int get_token(struct Lexer *lexer, struct Token *token, BOOL skip_newline
     return 0;
 }
 
+// *************
+// Lexer thread
+// *************
+
+#define TOKEN_QUEUE_SIZE 1024
+
+struct QueuedToken
+{
+    struct Token token;
+    int line;
+    int result;
+    char *messages;
+
+    // String literals are different when peeked, their escape characters are left as they are
+    BOOL has_peek_token;
+    struct Token peek_token;
+    int peek_result;
+};
+
+// Tokens of a file lexed ahead by another thread, the lexer thread only writes "written"
+// and the parser only writes "read" so the ring is used without locking
+struct TokenQueue
+{
+    struct QueuedToken ring[TOKEN_QUEUE_SIZE];
+    volatile int written;
+    volatile int read;
+    volatile int stop;
+
+    struct Lexer lexer;
+    struct Thread *thread;
+
+    // Tokens taken from the ring by the parser that were only peeked
+    struct QueuedToken *lookahead;
+    int lookahead_start;
+    int lookahead_count;
+    int lookahead_capacity;
+    BOOL finished;
+};
+
+static int run_lexer_thread(void *argument)
+{
+    struct TokenQueue *queue = (struct TokenQueue *)argument;
+    int written = 0;
+    uint64_t trace_start = start_trace_span();
+
+    // Errors are written by the parser when it gets to them
+    hold_messages(TRUE);
+
+    while (TRUE)
+    {
+        while (written - load_acquire(&queue->read) == TOKEN_QUEUE_SIZE)
+        {
+            if (load_acquire(&queue->stop)) { return 0; }
+            yield_thread();
+        }
+
+        // Newlines are always lexed, the parser skips them when asked to
+        struct QueuedToken *queued = &queue->ring[written % TOKEN_QUEUE_SIZE];
+        skip_characters(&queue->lexer, FALSE, FALSE);
+        queued->has_peek_token = queue->lexer.buffer_at[0] == '"';
+        if (queued->has_peek_token)
+        {
+            queued->peek_result = get_token(&queue->lexer, &queued->peek_token, FALSE, TRUE, FALSE);
+        }
+        queued->result = get_token(&queue->lexer, &queued->token, FALSE, FALSE, FALSE);
+        queued->line = queue->lexer.current_line;
+        queued->messages = take_held_messages();
+
+        store_release(&queue->written, ++written);
+
+        // After an error the lexer goes on from where it stopped, the same as when not in a thread
+        if (queued->token.type == TOKEN_TYPE_END && !queued->result) { break; }
+    }
+    add_trace_span("parse", "lex", queue->lexer.filename, (int)strlen(queue->lexer.filename), trace_start);
+
+    return 0;
+}
+
+// Returns the token at an index after the ones already used, taking tokens from the ring when needed
+static struct QueuedToken *get_queued_token(struct TokenQueue *queue, int index)
+{
+    index += queue->lookahead_start;
+
+    while (index >= queue->lookahead_count)
+    {
+        // The last token is repeated after the end
+        if (queue->finished) { return &queue->lookahead[queue->lookahead_count - 1]; }
+
+        int read = queue->read;
+        while (load_acquire(&queue->written) == read) { yield_thread(); }
+
+        if (queue->lookahead_count == queue->lookahead_capacity)
+        {
+            queue->lookahead_capacity = MAX(16, queue->lookahead_capacity * 2);
+            queue->lookahead = (struct QueuedToken *)realloc(queue->lookahead, sizeof(struct QueuedToken) * queue->lookahead_capacity);
+        }
+
+        struct QueuedToken *queued = &queue->lookahead[queue->lookahead_count++];
+        *queued = queue->ring[read % TOKEN_QUEUE_SIZE];
+        store_release(&queue->read, read + 1);
+
+        queue->finished = queued->token.type == TOKEN_TYPE_END && !queued->result;
+    }
+
+    struct QueuedToken *queued = &queue->lookahead[index];
+    if (queued->messages != NULL)
+    {
+        write_print("%s", queued->messages);
+        free(queued->messages);
+        queued->messages = NULL;
+    }
+
+    return queued;
+}
+
+static int get_token_from_queue(struct Lexer *lexer, struct Token *token, BOOL skip_newline, BOOL rewind)
+{
+    struct TokenQueue *queue = lexer->token_queue;
+    int index = 0;
+
+    struct QueuedToken *queued = get_queued_token(queue, index);
+    while (skip_newline && !queued->result && queued->token.type == TOKEN_TYPE_NEWLINE)
+    {
+        queued = get_queued_token(queue, ++index);
+    }
+
+    if (rewind && queued->has_peek_token)
+    {
+        *token = queued->peek_token;
+        return queued->peek_result;
+    }
+
+    *token = queued->token;
+    if (!rewind)
+    {
+        lexer->current_line = queued->line;
+
+        queue->lookahead_start += (token->type == TOKEN_TYPE_END && !queued->result) ? index : index + 1;
+        if (queue->lookahead_start == queue->lookahead_count)
+        {
+            queue->lookahead_start = queue->lookahead_count = 0;
+        }
+    }
+
+    return queued->result;
+}
+
+// Lexes the rest of a file in another thread while it is parsed, only for files where
+// #ifdef can be resolved ahead, that is when no #define is found while parsing
+void start_lexer_thread(struct Lexer *lexer)
+{
+    struct TokenQueue *queue = (struct TokenQueue *)malloc(sizeof(struct TokenQueue));
+    queue->written = queue->read = queue->stop = 0;
+    queue->lexer = *lexer;
+    queue->lookahead = NULL;
+    queue->lookahead_start = queue->lookahead_count = queue->lookahead_capacity = 0;
+    queue->finished = FALSE;
+
+    queue->thread = create_thread(run_lexer_thread, queue);
+    if (queue->thread == NULL)
+    {
+        free(queue);
+        return;
+    }
+
+    lexer->token_queue = queue;
+}
+
+void finish_lexer_thread(struct Lexer *lexer)
+{
+    struct TokenQueue *queue = lexer->token_queue;
+    if (queue == NULL) { return; }
+
+    store_release(&queue->stop, 1);
+    join_thread(queue->thread);
+
+    for(int i = queue->lookahead_start; i < queue->lookahead_count; i++)
+    {
+        free(queue->lookahead[i].messages);
+    }
+    free(queue->lookahead);
+    free(queue);
+
+    lexer->token_queue = NULL;
+}
+
 int get_next_token(struct Lexer *lexer, struct Token *token, BOOL skip_newline)
 {
+    if (lexer->token_queue != NULL)
+    {
+        return get_token_from_queue(lexer, token, skip_newline, FALSE);
+    }
     return get_token(lexer, token, skip_newline, FALSE, TRUE);
 }
 
 int peek_next_token(struct Lexer *lexer, struct Token *token, BOOL skip_newline)
 {
+    if (lexer->token_queue != NULL)
+    {
+        return get_token_from_queue(lexer, token, skip_newline, TRUE);
+    }
     return get_token(lexer, token, skip_newline, TRUE, TRUE);
 }
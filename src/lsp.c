@@ -0,0 +1,1244 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "z80hla.h"
+
+// Language server, JSON-RPC on the standard input and output (Language Server Protocol).
+// The documents open in the editor are kept here and the input file is compiled with them in a
+// child process every time they change, with nothing written. It sends back the messages, that
+// become diagnostics, and the symbols declared with where they are and their values, that answer
+// go to definition, hover and completion.
+
+#ifdef _WIN32
+
+int serve_language_server(char *input_filename, struct Z80HLAContext *(*create_build_context)(void *argument), void *argument)
+{
+    printf("Error: --lsp is not supported on Windows\n");
+    return 1;
+}
+
+#else
+
+#include <errno.h>
+#include <limits.h>
+#include <sys/select.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// *************
+// JSON
+// *************
+
+enum JsonType
+{
+    JSON_NULL,
+    JSON_FALSE,
+    JSON_TRUE,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT
+};
+
+struct JsonValue
+{
+    enum JsonType type;
+    char *key; // of a member of an object
+    char *string;
+    int string_size;
+    double number;
+
+    struct JsonValue *first_child, *next;
+};
+
+static void skip_json_spaces(char **at)
+{
+    while (**at == ' ' || **at == '\t' || **at == '\r' || **at == '\n') { (*at)++; }
+}
+
+static void add_utf8(char *dst, int *size, unsigned int code)
+{
+    if (code < 0x80)
+    {
+        dst[(*size)++] = (char)code;
+    }
+    else if (code < 0x800)
+    {
+        dst[(*size)++] = (char)(0xc0 | (code >> 6));
+        dst[(*size)++] = (char)(0x80 | (code & 0x3f));
+    }
+    else
+    {
+        dst[(*size)++] = (char)(0xe0 | (code >> 12));
+        dst[(*size)++] = (char)(0x80 | ((code >> 6) & 0x3f));
+        dst[(*size)++] = (char)(0x80 | (code & 0x3f));
+    }
+}
+
+// Strings are never longer than in the JSON text, the escapes are decoded in a buffer of that size
+static char *parse_json_string(char **at, int *size)
+{
+    char *start = ++(*at);
+    while (**at != '"' && **at != 0)
+    {
+        if (**at == '\\' && (*at)[1] != 0) { (*at)++; }
+        (*at)++;
+    }
+    if (**at != '"') { return NULL; }
+
+    char *string = (char *)malloc(*at - start + 1);
+    *size = 0;
+    for(char *c = start; c < *at; c++)
+    {
+        if (*c != '\\')
+        {
+            string[(*size)++] = *c;
+            continue;
+        }
+
+        c++;
+        switch (*c)
+        {
+            case 'n': string[(*size)++] = '\n'; break;
+            case 'r': string[(*size)++] = '\r'; break;
+            case 't': string[(*size)++] = '\t'; break;
+            case 'b': string[(*size)++] = '\b'; break;
+            case 'f': string[(*size)++] = '\f'; break;
+            case 'u':
+            {
+                unsigned int code = 0;
+                if (sscanf(c + 1, "%4x", &code) == 1 && c + 4 < *at) { c += 4; }
+                add_utf8(string, size, code);
+                break;
+            }
+            default: string[(*size)++] = *c; break;
+        }
+    }
+    string[*size] = 0;
+    (*at)++;
+
+    return string;
+}
+
+static void free_json(struct JsonValue *value)
+{
+    while (value != NULL)
+    {
+        struct JsonValue *next = value->next;
+        free_json(value->first_child);
+        free(value->key);
+        free(value->string);
+        free(value);
+        value = next;
+    }
+}
+
+static struct JsonValue *parse_json(char **at)
+{
+    skip_json_spaces(at);
+
+    struct JsonValue *value = (struct JsonValue *)calloc(1, sizeof(struct JsonValue));
+
+    if (**at == '{' || **at == '[')
+    {
+        BOOL is_object = **at == '{';
+        char end = is_object ? '}' : ']';
+        struct JsonValue *last_child = NULL;
+
+        value->type = is_object ? JSON_OBJECT : JSON_ARRAY;
+        (*at)++;
+        skip_json_spaces(at);
+        while (**at != end)
+        {
+            char *key = NULL;
+            int key_size;
+            if (is_object)
+            {
+                if (**at != '"' || (key = parse_json_string(at, &key_size)) == NULL) { free_json(value); return NULL; }
+                skip_json_spaces(at);
+                if (**at != ':') { free(key); free_json(value); return NULL; }
+                (*at)++;
+            }
+
+            struct JsonValue *child = parse_json(at);
+            if (child == NULL) { free(key); free_json(value); return NULL; }
+            child->key = key;
+            if (last_child == NULL) { value->first_child = child; } else { last_child->next = child; }
+            last_child = child;
+
+            skip_json_spaces(at);
+            if (**at == ',') { (*at)++; skip_json_spaces(at); }
+            else if (**at != end) { free_json(value); return NULL; }
+        }
+        (*at)++;
+    }
+    else if (**at == '"')
+    {
+        value->type = JSON_STRING;
+        if ((value->string = parse_json_string(at, &value->string_size)) == NULL) { free_json(value); return NULL; }
+    }
+    else if (!strncmp(*at, "true", 4)) { value->type = JSON_TRUE; *at += 4; }
+    else if (!strncmp(*at, "false", 5)) { value->type = JSON_FALSE; *at += 5; }
+    else if (!strncmp(*at, "null", 4)) { value->type = JSON_NULL; *at += 4; }
+    else
+    {
+        char *end;
+        value->type = JSON_NUMBER;
+        value->number = strtod(*at, &end);
+        if (end == *at) { free_json(value); return NULL; }
+        *at = end;
+    }
+
+    return value;
+}
+
+// Member of an object following a path like "textDocument.uri", NULL if any is missing
+static struct JsonValue *get_json_member(struct JsonValue *value, char *path)
+{
+    while (value != NULL && *path != 0)
+    {
+        char *dot = strchr(path, '.');
+        int key_size = dot != NULL ? (int)(dot - path) : (int)strlen(path);
+
+        struct JsonValue *child = value->type == JSON_OBJECT ? value->first_child : NULL;
+        while (child != NULL && !is_str_equal(path, key_size, child->key)) { child = child->next; }
+
+        value = child;
+        path += key_size + (dot != NULL ? 1 : 0);
+    }
+
+    return value;
+}
+
+static char *get_json_string(struct JsonValue *value, char *path)
+{
+    struct JsonValue *member = get_json_member(value, path);
+    return member != NULL && member->type == JSON_STRING ? member->string : NULL;
+}
+
+static int get_json_int(struct JsonValue *value, char *path)
+{
+    struct JsonValue *member = get_json_member(value, path);
+    return member != NULL && member->type == JSON_NUMBER ? (int)member->number : -1;
+}
+
+struct Text
+{
+    char *data;
+    int size;
+    int capacity;
+};
+
+static void add_text(struct Text *text, char *fmt, ...)
+{
+    va_list arg_ptr, arg_ptr_copy;
+
+    va_start(arg_ptr, fmt);
+    va_copy(arg_ptr_copy, arg_ptr);
+    int size = vsnprintf(NULL, 0, fmt, arg_ptr_copy);
+    va_end(arg_ptr_copy);
+
+    if (text->size + size + 1 > text->capacity)
+    {
+        text->capacity = MAX(text->capacity * 2, MAX(text->size + size + 1, 1024));
+        text->data = (char *)realloc(text->data, text->capacity);
+    }
+    vsprintf(text->data + text->size, fmt, arg_ptr);
+    text->size += size;
+    va_end(arg_ptr);
+}
+
+static void add_json_string(struct Text *text, char *string, int size)
+{
+    add_text(text, "\"");
+    for(int i = 0; i < size; i++)
+    {
+        unsigned char c = (unsigned char)string[i];
+        if (c == '"' || c == '\\') { add_text(text, "\\%c", c); }
+        else if (c == '\n') { add_text(text, "\\n"); }
+        else if (c < 0x20) { add_text(text, "\\u%04x", c); }
+        else { add_text(text, "%c", c); }
+    }
+    add_text(text, "\"");
+}
+
+// *************
+// Messages
+// *************
+
+struct MessageReader
+{
+    char *buffer;
+    int size;
+    int capacity;
+};
+
+static BOOL fill_message_reader(struct MessageReader *reader)
+{
+    if (reader->size + 65536 > reader->capacity)
+    {
+        reader->capacity = MAX(reader->capacity * 2, reader->size + 65536);
+        reader->buffer = (char *)realloc(reader->buffer, reader->capacity);
+    }
+
+    ssize_t read_size;
+    while ((read_size = read(STDIN_FILENO, reader->buffer + reader->size, reader->capacity - reader->size - 1)) < 0 && errno == EINTR) {}
+    if (read_size <= 0) { return FALSE; }
+
+    reader->size += (int)read_size;
+    reader->buffer[reader->size] = 0;
+
+    return TRUE;
+}
+
+// Reads the body of the next message, NULL when the input ended
+static char *read_message(struct MessageReader *reader)
+{
+    while (TRUE)
+    {
+        char *headers_end = reader->size > 0 ? strstr(reader->buffer, "\r\n\r\n") : NULL;
+        if (headers_end != NULL)
+        {
+            char *length = strstr(reader->buffer, "Content-Length:");
+            int headers_size = (int)(headers_end - reader->buffer) + 4;
+            int body_size = length != NULL && length < headers_end ? atoi(length + 15) : 0;
+
+            if (reader->size >= headers_size + body_size)
+            {
+                char *body = (char *)malloc(body_size + 1);
+                memcpy(body, reader->buffer + headers_size, body_size);
+                body[body_size] = 0;
+
+                reader->size -= headers_size + body_size;
+                memmove(reader->buffer, reader->buffer + headers_size + body_size, reader->size);
+                reader->buffer[reader->size] = 0;
+
+                return body;
+            }
+        }
+
+        if (!fill_message_reader(reader)) { return NULL; }
+    }
+}
+
+// Changes are checked after the messages already sent are read, so typing does not compile every key
+static BOOL has_pending_message(struct MessageReader *reader)
+{
+    if (reader->size > 0) { return TRUE; }
+
+    fd_set read_fds;
+    struct timeval timeout = { 0, 0 };
+    FD_ZERO(&read_fds);
+    FD_SET(STDIN_FILENO, &read_fds);
+
+    return select(STDIN_FILENO + 1, &read_fds, NULL, NULL, &timeout) > 0;
+}
+
+static void send_message(struct Text *body)
+{
+    printf("Content-Length: %d\r\n\r\n", body->size);
+    fwrite(body->data, 1, body->size, stdout);
+    fflush(stdout);
+    body->size = 0;
+}
+
+static void send_response(struct Text *body, struct JsonValue *id, char *result)
+{
+    add_text(body, "{\"jsonrpc\":\"2.0\",\"id\":");
+    if (id->type == JSON_STRING) { add_json_string(body, id->string, id->string_size); } else { add_text(body, "%.0f", id->number); }
+    add_text(body, ",\"result\":%s}", result);
+    send_message(body);
+}
+
+// *************
+// Documents
+// *************
+
+struct Document
+{
+    char *uri;
+    char *path;
+    char *text;
+    int text_size;
+};
+
+struct LanguageServer
+{
+    char *input_filename;
+    struct Z80HLAContext *(*create_build_context)(void *argument);
+    void *argument;
+
+    struct Document *documents;
+    int documents_count;
+    int documents_capacity;
+    char *last_changed_path;
+    BOOL changed;
+
+    struct LspSymbol *symbols;
+    int symbols_count;
+    int symbols_capacity;
+    int *symbols_index; // hash of the name to the first symbol with it, -1 if none
+    int symbols_index_capacity;
+
+    char **published_uris; // with diagnostics, they are cleared when they have none
+    int published_uris_count;
+};
+
+static char *uri_to_path(char *uri)
+{
+    char *path = (char *)malloc(strlen(uri) + 1);
+    int size = 0;
+
+    if (!strncmp(uri, "file://", 7)) { uri += 7; }
+    for(char *c = uri; *c != 0; c++)
+    {
+        unsigned int code;
+        if (*c == '%' && sscanf(c + 1, "%2x", &code) == 1)
+        {
+            path[size++] = (char)code;
+            c += 2;
+        }
+        else
+        {
+            path[size++] = *c;
+        }
+    }
+    path[size] = 0;
+
+    return path;
+}
+
+static void add_path_uri(struct Text *text, char *path)
+{
+    char real_path[PATH_MAX];
+    struct Text uri = { 0 };
+
+    if (realpath(path, real_path) != NULL) { path = real_path; }
+    add_text(&uri, "file://");
+    for(unsigned char *c = (unsigned char *)path; *c != 0; c++)
+    {
+        if (isalnum(*c) || strchr("/._-~", *c) != NULL) { add_text(&uri, "%c", *c); } else { add_text(&uri, "%%%02X", *c); }
+    }
+    add_json_string(text, uri.data, uri.size);
+    free(uri.data);
+}
+
+// Paths of messages and of documents are compared once they are absolute and without "." or ".."
+static BOOL is_same_path(char *path1, char *path2)
+{
+    char real_path1[PATH_MAX], real_path2[PATH_MAX];
+
+    if (!strcmp(path1, path2)) { return TRUE; }
+    if (realpath(path1, real_path1) == NULL || realpath(path2, real_path2) == NULL) { return FALSE; }
+
+    return !strcmp(real_path1, real_path2);
+}
+
+static struct Document *get_document(struct LanguageServer *server, char *uri)
+{
+    for(int i = 0; uri != NULL && i < server->documents_count; i++)
+    {
+        if (!strcmp(server->documents[i].uri, uri)) { return &server->documents[i]; }
+    }
+
+    return NULL;
+}
+
+static void set_document(struct LanguageServer *server, char *uri, char *text, int text_size)
+{
+    struct Document *document = get_document(server, uri);
+    if (document == NULL)
+    {
+        if (server->documents_count == server->documents_capacity)
+        {
+            server->documents_capacity = MAX(16, server->documents_capacity * 2);
+            server->documents = (struct Document *)realloc(server->documents, sizeof(struct Document) * server->documents_capacity);
+        }
+        document = &server->documents[server->documents_count++];
+        document->uri = (char *)malloc(strlen(uri) + 1);
+        strcpy(document->uri, uri);
+        document->path = uri_to_path(uri);
+        document->text = NULL;
+    }
+
+    free(document->text);
+    document->text = (char *)malloc(text_size + 1);
+    memcpy(document->text, text, text_size);
+    document->text[text_size] = 0;
+    document->text_size = text_size;
+
+    server->last_changed_path = document->path;
+    server->changed = TRUE;
+}
+
+static void close_document(struct LanguageServer *server, char *uri)
+{
+    struct Document *document = get_document(server, uri);
+    if (document == NULL) { return; }
+
+    if (server->last_changed_path == document->path) { server->last_changed_path = NULL; }
+    free(document->uri);
+    free(document->path);
+    free(document->text);
+    *document = server->documents[--server->documents_count];
+}
+
+// *************
+// Symbols
+// *************
+
+enum LspSymbolKind
+{
+    LSP_SYMBOL_LABEL,
+    LSP_SYMBOL_FUNCTION,
+    LSP_SYMBOL_INTERRUPT,
+    LSP_SYMBOL_DATA,
+    LSP_SYMBOL_CONST,
+    LSP_SYMBOL_STRUCT,
+    LSP_SYMBOL_UNION,
+    LSP_SYMBOL_INLINE
+};
+
+static char *lsp_symbol_kind_names[] = { "label", "function", "interrupt", "data", "const", "struct", "union", "inline" };
+static int lsp_completion_kinds[] = { 6, 3, 3, 6, 21, 22, 22, 15 };
+
+struct LspSymbol
+{
+    enum LspSymbolKind kind;
+    char *name;
+    char *library_name;
+    char *path;
+    int line;
+    BOOL has_value;
+    int64_t value;
+    int size; // of data and structured types, -1 when it is not known
+
+    int next; // with the same hash
+};
+
+static unsigned int hash_symbol_name(char *name, int name_size)
+{
+    return (unsigned int)hash_bytes(HASH_INITIAL_VALUE, name, (size_t)name_size);
+}
+
+static void clear_symbols(struct LanguageServer *server)
+{
+    for(int i = 0; i < server->symbols_count; i++)
+    {
+        free(server->symbols[i].name);
+        free(server->symbols[i].library_name);
+        free(server->symbols[i].path);
+    }
+    server->symbols_count = 0;
+}
+
+static void index_symbols(struct LanguageServer *server)
+{
+    free(server->symbols_index);
+    server->symbols_index_capacity = 1024;
+    while (server->symbols_index_capacity < server->symbols_count * 2) { server->symbols_index_capacity *= 2; }
+    server->symbols_index = (int *)malloc(sizeof(int) * server->symbols_index_capacity);
+    memset(server->symbols_index, 0xff, sizeof(int) * server->symbols_index_capacity);
+
+    // Added backwards so the first symbol declared is the first found
+    for(int i = server->symbols_count - 1; i >= 0; i--)
+    {
+        unsigned int slot = hash_symbol_name(server->symbols[i].name, (int)strlen(server->symbols[i].name)) & (server->symbols_index_capacity - 1);
+        server->symbols[i].next = server->symbols_index[slot];
+        server->symbols_index[slot] = i;
+    }
+}
+
+// A symbol of the library given, or without library, or of any library
+static struct LspSymbol *find_symbol(struct LanguageServer *server, char *name, int name_size, char *library_name, int library_name_size)
+{
+    if (server->symbols_index == NULL) { return NULL; }
+
+    struct LspSymbol *found = NULL;
+    unsigned int slot = hash_symbol_name(name, name_size) & (server->symbols_index_capacity - 1);
+    for(int i = server->symbols_index[slot]; i >= 0; i = server->symbols[i].next)
+    {
+        struct LspSymbol *symbol = &server->symbols[i];
+        if (!is_str_equal(name, name_size, symbol->name)) { continue; }
+
+        if (library_name_size > 0)
+        {
+            if (is_str_equal(library_name, library_name_size, symbol->library_name)) { return symbol; }
+        }
+        else if (symbol->library_name[0] == 0)
+        {
+            return symbol;
+        }
+        else if (found == NULL)
+        {
+            found = symbol;
+        }
+    }
+
+    return library_name_size > 0 ? NULL : found;
+}
+
+static BOOL is_identifier_char(char c)
+{
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+// The identifier at a position of a document, "Library::name" gives both
+static BOOL get_identifier_at(struct Document *document, int line, int character, char **name, int *name_size, char **library_name, int *library_name_size)
+{
+    char *at = document->text, *end = document->text + document->text_size;
+    for(int i = 0; i < line && at < end; at++)
+    {
+        if (*at == '\n') { i++; }
+    }
+    char *line_end = at;
+    while (line_end < end && *line_end != '\n') { line_end++; }
+    if (character < 0 || at + character > line_end) { return FALSE; }
+
+    char *start = at + character, *stop = at + character;
+    while (start > at && (is_identifier_char(start[-1]) || (start[-1] == ':' && start - 1 > at && start[-2] == ':')))
+    {
+        start -= start[-1] == ':' ? 2 : 1;
+    }
+    while (stop < line_end && (is_identifier_char(*stop) || (*stop == ':' && stop + 1 < line_end && stop[1] == ':' && stop + 2 < line_end && is_identifier_char(stop[2]))))
+    {
+        stop += *stop == ':' ? 2 : 1;
+    }
+    while (start < stop && *start == ':') { start++; }
+    if (start == stop) { return FALSE; }
+
+    char *separator = NULL;
+    for(char *c = start; c + 1 < stop; c++)
+    {
+        if (c[0] == ':' && c[1] == ':') { separator = c; }
+    }
+
+    if (separator != NULL)
+    {
+        *library_name = start;
+        *library_name_size = (int)(separator - start);
+        *name = separator + 2;
+        *name_size = (int)(stop - separator - 2);
+    }
+    else
+    {
+        *library_name = "";
+        *library_name_size = 0;
+        *name = start;
+        *name_size = (int)(stop - start);
+    }
+
+    return *name_size > 0;
+}
+
+static struct LspSymbol *get_symbol_at(struct LanguageServer *server, struct JsonValue *params)
+{
+    char *name, *library_name;
+    int name_size, library_name_size;
+
+    struct Document *document = get_document(server, get_json_string(params, "textDocument.uri"));
+    if (document == NULL ||
+        !get_identifier_at(document, get_json_int(params, "position.line"), get_json_int(params, "position.character"), &name, &name_size, &library_name, &library_name_size))
+    {
+        return NULL;
+    }
+
+    return find_symbol(server, name, name_size, library_name, library_name_size);
+}
+
+// *************
+// Compilation
+// *************
+
+// The child process writes its messages and then one line for each symbol starting with this
+#define SYMBOL_LINE_START   '\x1e'
+
+struct ParsedSymbols
+{
+    struct ParsedSymbol
+    {
+        enum LspSymbolKind kind;
+        char *name;
+        int name_size;
+        char *library_name;
+        int library_name_size;
+        char *filename;
+        int line;
+    } *symbols;
+    int count;
+    int capacity;
+};
+
+static void add_parsed_symbol(struct ParsedSymbols *symbols, enum LspSymbolKind kind, char *name, int name_size, char *library_name, int library_name_size, char *filename, int line)
+{
+    if (symbols->count == symbols->capacity)
+    {
+        symbols->capacity = MAX(1024, symbols->capacity * 2);
+        symbols->symbols = (struct ParsedSymbol *)realloc(symbols->symbols, sizeof(struct ParsedSymbol) * symbols->capacity);
+    }
+
+    struct ParsedSymbol *symbol = &symbols->symbols[symbols->count++];
+    symbol->kind = kind;
+    symbol->name = name;
+    symbol->name_size = name_size;
+    symbol->library_name = library_name;
+    symbol->library_name_size = library_name_size;
+    symbol->filename = filename;
+    symbol->line = line;
+}
+
+// Every declaration in the nodes, the compiler changes some of them (functions become labels)
+static void find_parsed_symbols(struct ASTNode *first_node, void *argument)
+{
+    struct ParsedSymbols *symbols = (struct ParsedSymbols *)argument;
+    int stack_capacity = 1024, stack_size = 0;
+    struct ASTNode **stack = (struct ASTNode **)malloc(sizeof(struct ASTNode *) * stack_capacity);
+    stack[stack_size++] = first_node;
+
+    while (stack_size > 0)
+    {
+        struct ASTNode *node = stack[--stack_size];
+        int kind = -1;
+
+        switch (node->type)
+        {
+            case NODE_TYPE_LABEL: kind = LSP_SYMBOL_LABEL; break;
+            case NODE_TYPE_FUNCTION: kind = LSP_SYMBOL_FUNCTION; break;
+            case NODE_TYPE_INTERRUPT: kind = LSP_SYMBOL_INTERRUPT; break;
+            case NODE_TYPE_DATA: kind = LSP_SYMBOL_DATA; break;
+            case NODE_TYPE_CONST: kind = LSP_SYMBOL_CONST; break;
+            case NODE_TYPE_STRUCT: kind = LSP_SYMBOL_STRUCT; break;
+            case NODE_TYPE_UNION: kind = LSP_SYMBOL_UNION; break;
+            default: break;
+        }
+        if (kind >= 0 && node->str_size > 0 && node->filename != NULL)
+        {
+            add_parsed_symbol(symbols, (enum LspSymbolKind)kind, node->str_value, node->str_size, node->str_value2, node->str_size2, node->filename, node->file_line);
+        }
+
+        if (stack_size + node->children_count > stack_capacity)
+        {
+            stack_capacity = MAX(stack_capacity * 2, stack_size + node->children_count);
+            stack = (struct ASTNode **)realloc(stack, sizeof(struct ASTNode *) * stack_capacity);
+        }
+        for(int i = node->children_count - 1; i >= 0; i--)
+        {
+            if (node->children[i] != NULL) { stack[stack_size++] = node->children[i]; }
+        }
+    }
+
+    free(stack);
+}
+
+static void write_symbol_line(struct ParsedSymbol *symbol)
+{
+    BOOL has_value = FALSE;
+    int64_t value = 0;
+    int size = -1;
+
+    if (symbol->kind == LSP_SYMBOL_STRUCT || symbol->kind == LSP_SYMBOL_UNION)
+    {
+        struct StructuredType *structured_type = get_structured_type(symbol->name, symbol->name_size, symbol->library_name, symbol->library_name_size);
+        if (structured_type != NULL) { size = structured_type->struct_size; }
+    }
+    else if (symbol->kind != LSP_SYMBOL_INLINE)
+    {
+        has_value = !get_constant(symbol->library_name, symbol->library_name_size, symbol->name, symbol->name_size, &value);
+    }
+    if (symbol->kind == LSP_SYMBOL_DATA)
+    {
+        struct DataSymbol *data_symbol = get_data_symbol(symbol->name, symbol->name_size, symbol->library_name, symbol->library_name_size);
+        if (data_symbol != NULL) { size = data_symbol->size_of_type * data_symbol->length; }
+    }
+
+    printf("%c%d\t%d\t%d\t%" PRId64 "\t%d\t%.*s\t%.*s\t%s\n", SYMBOL_LINE_START, (int)symbol->kind, symbol->line, has_value, value, size,
+        symbol->library_name_size, symbol->library_name_size > 0 ? symbol->library_name : "", symbol->name_size, symbol->name, symbol->filename);
+}
+
+// Runs in the child process with the standard output going to the language server
+static int compile_documents(struct LanguageServer *server, char *input_filename)
+{
+    // The documents have absolute paths, the files included are found with the same paths when the input has one too
+    char real_input_filename[PATH_MAX];
+    struct Z80HLAContext *compile_context = server->create_build_context(server->argument);
+    compile_context->input_filename = realpath(input_filename, real_input_filename) != NULL ? real_input_filename : input_filename;
+
+    context = compile_context;
+    for(int i = 0; i < server->documents_count; i++)
+    {
+        add_file_to_cache(server->documents[i].path, server->documents[i].text, server->documents[i].text_size);
+    }
+    context = NULL;
+
+    struct ParsedSymbols symbols = { 0 };
+    int result = check(compile_context, find_parsed_symbols, &symbols);
+
+    context = compile_context;
+    for(struct InlineSymbol *inline_symbol = context->first_inline_symbol; inline_symbol != NULL; inline_symbol = inline_symbol->next)
+    {
+        if (inline_symbol->node->filename == NULL) { continue; }
+        add_parsed_symbol(&symbols, LSP_SYMBOL_INLINE, inline_symbol->name, inline_symbol->name_size, inline_symbol->library_name, inline_symbol->library_name_size, inline_symbol->node->filename, inline_symbol->node->file_line);
+    }
+    for(int i = 0; i < symbols.count; i++)
+    {
+        write_symbol_line(&symbols.symbols[i]);
+    }
+    fflush(stdout);
+
+    return result;
+}
+
+struct Diagnostic
+{
+    char *path;
+    int line;
+    char *message;
+    BOOL has_line;
+};
+
+// "[ERROR] file:line: message" or "[ERROR] message"
+static void get_diagnostic(char *line, char *input_filename, struct Diagnostic *diagnostic)
+{
+    char *message = line + 8;
+    diagnostic->path = input_filename;
+    diagnostic->line = 1;
+    diagnostic->message = message;
+    diagnostic->has_line = FALSE;
+
+    for(char *c = message; *c != 0; c++)
+    {
+        if (c[0] != ':' || !isdigit((unsigned char)c[1])) { continue; }
+
+        char *end = c + 1;
+        while (isdigit((unsigned char)*end)) { end++; }
+        if (end[0] == ':' && end[1] == ' ')
+        {
+            *c = 0;
+            diagnostic->path = message;
+            diagnostic->line = MAX(1, atoi(c + 1));
+            diagnostic->message = end + 2;
+            diagnostic->has_line = TRUE;
+            return;
+        }
+    }
+}
+
+static void add_diagnostics(struct Text *body, char *uri_path, struct Diagnostic *diagnostics, int count, BOOL *used)
+{
+    add_text(body, "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":");
+    add_path_uri(body, uri_path);
+    add_text(body, ",\"diagnostics\":[");
+
+    BOOL first = TRUE;
+    for(int i = 0; i < count; i++)
+    {
+        if (used[i] || !is_same_path(diagnostics[i].path, uri_path)) { continue; }
+        used[i] = TRUE;
+
+        add_text(body, "%s{\"range\":{\"start\":{\"line\":%d,\"character\":0},\"end\":{\"line\":%d,\"character\":1000}},\"severity\":1,\"source\":\"z80hla\",\"message\":",
+            first ? "" : ",", diagnostics[i].line - 1, diagnostics[i].line - 1);
+        add_json_string(body, diagnostics[i].message, (int)strlen(diagnostics[i].message));
+        add_text(body, "}");
+        first = FALSE;
+    }
+
+    add_text(body, "]}}");
+}
+
+static void publish_diagnostics(struct LanguageServer *server, struct Text *body, char *input_filename, char *output)
+{
+    struct Diagnostic *diagnostics = NULL;
+    int count = 0;
+
+    for(char *line = strtok(output, "\n"); line != NULL; line = strtok(NULL, "\n"))
+    {
+        if (strncmp(line, "[ERROR] ", 8)) { continue; }
+        diagnostics = (struct Diagnostic *)realloc(diagnostics, sizeof(struct Diagnostic) * (count + 1));
+        get_diagnostic(line, input_filename, &diagnostics[count++]);
+    }
+
+    // The last message ("Error compiling") only says there were others, unless they had no line
+    int with_line_count = 0;
+    for(int i = 0; i < count; i++)
+    {
+        if (diagnostics[i].has_line) { diagnostics[with_line_count++] = diagnostics[i]; }
+    }
+    if (with_line_count > 0) { count = with_line_count; }
+
+    // Every document and every file published before get theirs, even when there are none now
+    int paths_count = server->documents_count + server->published_uris_count + count;
+    char **paths = (char **)malloc(sizeof(char *) * (paths_count + 1));
+    for(int i = 0; i < server->documents_count; i++) { paths[i] = server->documents[i].path; }
+    for(int i = 0; i < server->published_uris_count; i++) { paths[server->documents_count + i] = server->published_uris[i]; }
+    for(int i = 0; i < count; i++) { paths[server->documents_count + server->published_uris_count + i] = diagnostics[i].path; }
+
+    BOOL *used = (BOOL *)calloc(count + 1, sizeof(BOOL));
+    char **published_uris = (char **)malloc(sizeof(char *) * (paths_count + 1));
+    int published_uris_count = 0;
+
+    for(int i = 0; i < paths_count; i++)
+    {
+        BOOL already_published = FALSE;
+        for(int j = 0; j < i && !already_published; j++)
+        {
+            already_published = is_same_path(paths[j], paths[i]);
+        }
+        if (already_published) { continue; }
+
+        int used_count = 0;
+        for(int j = 0; j < count; j++) { used_count -= used[j]; }
+        add_diagnostics(body, paths[i], diagnostics, count, used);
+        send_message(body);
+        for(int j = 0; j < count; j++) { used_count += used[j]; }
+
+        if (used_count > 0)
+        {
+            published_uris[published_uris_count] = (char *)malloc(strlen(paths[i]) + 1);
+            strcpy(published_uris[published_uris_count++], paths[i]);
+        }
+    }
+
+    for(int i = 0; i < server->published_uris_count; i++) { free(server->published_uris[i]); }
+    free(server->published_uris);
+    server->published_uris = published_uris;
+    server->published_uris_count = published_uris_count;
+
+    free(paths);
+    free(used);
+    free(diagnostics);
+}
+
+static void read_symbols(struct LanguageServer *server, char *output)
+{
+    clear_symbols(server);
+
+    for(char *line = output; line != NULL && *line != 0; )
+    {
+        char *next_line = strchr(line, '\n');
+        if (next_line != NULL) { *next_line++ = 0; }
+
+        // kind, line, has value, value, size, library, name and path separated by tabs
+        char *fields[8];
+        int fields_count = 0;
+        if (line[0] == SYMBOL_LINE_START)
+        {
+            fields[fields_count++] = line + 1;
+            for(char *c = line + 1; *c != 0 && fields_count < 8; c++)
+            {
+                if (*c == '\t')
+                {
+                    *c = 0;
+                    fields[fields_count++] = c + 1;
+                }
+            }
+        }
+
+        if (fields_count == 8)
+        {
+            if (server->symbols_count == server->symbols_capacity)
+            {
+                server->symbols_capacity = MAX(1024, server->symbols_capacity * 2);
+                server->symbols = (struct LspSymbol *)realloc(server->symbols, sizeof(struct LspSymbol) * server->symbols_capacity);
+            }
+            struct LspSymbol *symbol = &server->symbols[server->symbols_count++];
+            symbol->kind = (enum LspSymbolKind)atoi(fields[0]);
+            symbol->line = atoi(fields[1]);
+            symbol->has_value = atoi(fields[2]);
+            symbol->value = strtoll(fields[3], NULL, 10);
+            symbol->size = atoi(fields[4]);
+            symbol->library_name = (char *)malloc(strlen(fields[5]) + 1);
+            strcpy(symbol->library_name, fields[5]);
+            symbol->name = (char *)malloc(strlen(fields[6]) + 1);
+            strcpy(symbol->name, fields[6]);
+            symbol->path = (char *)malloc(strlen(fields[7]) + 1);
+            strcpy(symbol->path, fields[7]);
+        }
+
+        line = next_line;
+    }
+
+    index_symbols(server);
+}
+
+// Compiles in a child process, so whatever a compilation leaves in memory is gone with it
+static void compile_changed_documents(struct LanguageServer *server, struct Text *body)
+{
+    char *input_filename = server->input_filename != NULL ? server->input_filename : server->last_changed_path;
+    server->changed = FALSE;
+    if (input_filename == NULL) { return; }
+
+    int output_pipe[2];
+    if (pipe(output_pipe)) { return; }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(output_pipe[0]);
+        close(output_pipe[1]);
+        return;
+    }
+    if (pid == 0)
+    {
+        close(output_pipe[0]);
+        dup2(output_pipe[1], STDOUT_FILENO);
+        dup2(output_pipe[1], STDERR_FILENO);
+        _exit(compile_documents(server, input_filename));
+    }
+    close(output_pipe[1]);
+
+    struct Text output = { 0 };
+    add_text(&output, "");
+    while (TRUE)
+    {
+        if (output.size + 65536 > output.capacity)
+        {
+            output.capacity = MAX(output.capacity * 2, output.size + 65536);
+            output.data = (char *)realloc(output.data, output.capacity);
+        }
+        ssize_t read_size = read(output_pipe[0], output.data + output.size, output.capacity - output.size - 1);
+        if (read_size < 0 && errno == EINTR) { continue; }
+        if (read_size <= 0) { break; }
+        output.size += (int)read_size;
+    }
+    output.data[output.size] = 0;
+    close(output_pipe[0]);
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+
+    char *messages = (char *)malloc(output.size + 1);
+    memcpy(messages, output.data, output.size + 1);
+    publish_diagnostics(server, body, input_filename, messages);
+    // While the files can't be parsed the symbols found before are kept
+    if (strchr(output.data, SYMBOL_LINE_START) != NULL)
+    {
+        read_symbols(server, output.data);
+    }
+
+    free(messages);
+    free(output.data);
+}
+
+// *************
+// Requests
+// *************
+
+static void add_symbol_description(struct Text *text, struct LspSymbol *symbol)
+{
+    add_text(text, "%s %s%s%s", lsp_symbol_kind_names[symbol->kind], symbol->library_name, symbol->library_name[0] != 0 ? "::" : "", symbol->name);
+    if (symbol->has_value)
+    {
+        if (symbol->kind == LSP_SYMBOL_CONST)
+        {
+            add_text(text, " = %" PRId64, symbol->value);
+        }
+        else
+        {
+            add_text(text, " at 0x%04" PRIX64, (uint64_t)symbol->value & 0xffff);
+        }
+    }
+    if (symbol->size >= 0)
+    {
+        add_text(text, ", sizeof %d", symbol->size);
+    }
+}
+
+static void answer_request(struct LanguageServer *server, struct Text *body, char *method, struct JsonValue *id, struct JsonValue *params)
+{
+    struct Text result = { 0 };
+    add_text(&result, "null");
+
+    if (!strcmp(method, "initialize"))
+    {
+        result.size = 0;
+        add_text(&result, "{\"capabilities\":{\"textDocumentSync\":1,\"definitionProvider\":true,\"hoverProvider\":true,"
+            "\"completionProvider\":{\"triggerCharacters\":[\":\"]}},\"serverInfo\":{\"name\":\"z80hla\",\"version\":\"" Z80HLA_VERSION_HI "." Z80HLA_VERSION_LO "\"}}");
+    }
+    else if (!strcmp(method, "textDocument/definition"))
+    {
+        struct LspSymbol *symbol = get_symbol_at(server, params);
+        if (symbol != NULL)
+        {
+            result.size = 0;
+            add_text(&result, "{\"uri\":");
+            add_path_uri(&result, symbol->path);
+            add_text(&result, ",\"range\":{\"start\":{\"line\":%d,\"character\":0},\"end\":{\"line\":%d,\"character\":0}}}", symbol->line - 1, symbol->line - 1);
+        }
+    }
+    else if (!strcmp(method, "textDocument/hover"))
+    {
+        struct LspSymbol *symbol = get_symbol_at(server, params);
+        if (symbol != NULL)
+        {
+            struct Text description = { 0 };
+            add_symbol_description(&description, symbol);
+            result.size = 0;
+            add_text(&result, "{\"contents\":{\"kind\":\"plaintext\",\"value\":");
+            add_json_string(&result, description.data, description.size);
+            add_text(&result, "}}");
+            free(description.data);
+        }
+    }
+    else if (!strcmp(method, "textDocument/completion"))
+    {
+        result.size = 0;
+        add_text(&result, "[");
+        for(int i = 0; i < server->symbols_count; i++)
+        {
+            struct LspSymbol *symbol = &server->symbols[i];
+            struct Text label = { 0 }, description = { 0 };
+            add_text(&label, "%s%s%s", symbol->library_name, symbol->library_name[0] != 0 ? "::" : "", symbol->name);
+            add_symbol_description(&description, symbol);
+
+            add_text(&result, "%s{\"label\":", i > 0 ? "," : "");
+            add_json_string(&result, label.data, label.size);
+            add_text(&result, ",\"kind\":%d,\"detail\":", lsp_completion_kinds[symbol->kind]);
+            add_json_string(&result, description.data, description.size);
+            add_text(&result, "}");
+
+            free(label.data);
+            free(description.data);
+        }
+        add_text(&result, "]");
+    }
+    else if (strcmp(method, "shutdown"))
+    {
+        add_text(body, "{\"jsonrpc\":\"2.0\",\"id\":");
+        if (id->type == JSON_STRING) { add_json_string(body, id->string, id->string_size); } else { add_text(body, "%.0f", id->number); }
+        add_text(body, ",\"error\":{\"code\":-32601,\"message\":\"Method not found\"}}");
+        send_message(body);
+        free(result.data);
+        return;
+    }
+
+    send_response(body, id, result.data);
+    free(result.data);
+}
+
+static void handle_notification(struct LanguageServer *server, char *method, struct JsonValue *params)
+{
+    if (!strcmp(method, "textDocument/didOpen"))
+    {
+        struct JsonValue *text = get_json_member(params, "textDocument.text");
+        char *uri = get_json_string(params, "textDocument.uri");
+        if (uri != NULL && text != NULL && text->type == JSON_STRING)
+        {
+            set_document(server, uri, text->string, text->string_size);
+        }
+    }
+    else if (!strcmp(method, "textDocument/didChange"))
+    {
+        // Full document synchronization, the last change has all the text
+        struct JsonValue *changes = get_json_member(params, "contentChanges");
+        struct JsonValue *change = changes != NULL ? changes->first_child : NULL;
+        while (change != NULL && change->next != NULL) { change = change->next; }
+
+        struct JsonValue *text = get_json_member(change, "text");
+        char *uri = get_json_string(params, "textDocument.uri");
+        if (uri != NULL && text != NULL && text->type == JSON_STRING)
+        {
+            set_document(server, uri, text->string, text->string_size);
+        }
+    }
+    else if (!strcmp(method, "textDocument/didSave"))
+    {
+        server->changed = TRUE;
+    }
+    else if (!strcmp(method, "textDocument/didClose"))
+    {
+        close_document(server, get_json_string(params, "textDocument.uri"));
+        server->changed = TRUE;
+    }
+}
+
+// Answers until the client sends "exit", input_filename is the file compiled (with the files it includes),
+// when it is NULL the last document changed is compiled
+int serve_language_server(char *input_filename, struct Z80HLAContext *(*create_build_context)(void *argument), void *argument)
+{
+    struct LanguageServer server;
+    memset(&server, 0, sizeof(server));
+    server.input_filename = input_filename;
+    server.create_build_context = create_build_context;
+    server.argument = argument;
+
+    struct MessageReader reader = { 0 };
+    struct Text body = { 0 };
+    BOOL shutdown = FALSE;
+    char *message;
+
+    while ((message = read_message(&reader)) != NULL)
+    {
+        char *at = message;
+        struct JsonValue *request = parse_json(&at);
+        char *method = get_json_string(request, "method");
+        struct JsonValue *id = get_json_member(request, "id");
+        struct JsonValue *params = get_json_member(request, "params");
+
+        if (method != NULL && !strcmp(method, "exit"))
+        {
+            free_json(request);
+            free(message);
+            break;
+        }
+
+        if (method != NULL && id != NULL)
+        {
+            // The answer has to see the changes made before the request
+            if (server.changed) { compile_changed_documents(&server, &body); }
+
+            shutdown = shutdown || !strcmp(method, "shutdown");
+            answer_request(&server, &body, method, id, params);
+        }
+        else if (method != NULL)
+        {
+            handle_notification(&server, method, params);
+        }
+
+        free_json(request);
+        free(message);
+
+        if (server.changed && !has_pending_message(&reader))
+        {
+            compile_changed_documents(&server, &body);
+        }
+    }
+
+    clear_symbols(&server);
+    free(server.symbols);
+    free(server.symbols_index);
+    while (server.documents_count > 0)
+    {
+        close_document(&server, server.documents[0].uri);
+    }
+    free(server.documents);
+    free(reader.buffer);
+    free(body.data);
+
+    return shutdown ? 0 : 1;
+}
+
+#endif
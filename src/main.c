@@ -0,0 +1,537 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "z80hla.h"
+
+void print_usage()
+{
+	printf("Usage: z80hla [options] input_file\n");
+	printf("       z80hla [options] --link object_file...\n\n");
+	printf("Options:\n");
+	printf("-h\t--help\t\t\tShow this information.\n");
+	printf("-o\t--output FILE\t\tSet the default output file.\n");
+	printf("-i\t--include PATH\t\tAdd include path.\n");
+	printf("-c\t--cpu CPU_TYPE\t\tSet CPU type: \"z80\" (default), \"gb\", \"msx\" / \"r800\"\n");
+	printf("-d\t--define IDENTIFIER\tAdd define identifier\n");
+	printf("-a\t--assembleall\t\tAssemble all library symbols and not just the ones referenced\n");
+	printf("-j\t--jrloop\t\tGenerate jr instead of jp when possible in loops\n");
+	printf("-s\t--symbols FILE\t\tOutput symbols JSON file\n");
+	printf("-g\t--generatedlabels\tInclude labels generated for control structures in the symbols file\n");
+	printf("-l\t--list FILE\t\tOutput listing of instructions without high-level constructs\n");
+	printf("-M\t--deps FILE\t\tOutput a Makefile rule with the files written depending on the files read\n");
+	printf("\t--time-trace FILE\tOutput the time spent in each phase as a Chrome trace event JSON file (Perfetto, chrome://tracing)\n");
+	printf("\t--stats FILE\t\tOutput counters of nodes, output elements, lookups, tables, files read and memory as a JSON\n\t\t\t\tfile (\"-\" for the standard output)\n");
+	printf("-t\t--threads COUNT\t\tSet the number of threads used (default is the number of CPUs)\n");
+	printf("-p\t--pipelinelexer\t\tLex the input file in a separate thread while it is parsed\n");
+	printf("\t--pch DIRECTORY\t\tKeep included files parsed as precompiled files (.z80pch) in DIRECTORY and read them\n\t\t\t\tinstead of parsing the files again when they have not changed\n");
+	printf("\t--incremental\t\tKeep a build database next to the output file and compile only when the files read,\n\t\t\t\tthe files written or the options changed\n");
+	printf("\t--cache DIRECTORY\tKeep the files written in the build cache DIRECTORY under a hash of the options and the files\n\t\t\t\tread, a compilation with the same ones copies them from it instead\n");
+	printf("-w\t--watch\t\t\tCompile again every time a file read by the last compilation changes\n");
+	printf("\t--serve SOCKET\t\tCompile when asked by a client on the Unix domain socket SOCKET (with --watch also when a file changes)\n");
+	printf("\t--client SOCKET\t\tAsk the server on SOCKET to compile, its messages and exit status are the ones of the compilation\n");
+	printf("\t--object\t\tCompile the input file to an object file (.z80o) to be linked with others, -o sets its name\n");
+	printf("\t--link\t\t\tLink the object files given into the output files\n");
+	printf("\t--lsp\t\t\tLanguage server on the standard input and output, the input file (if any) is the one checked\n");
+	printf("\t--config NAME:CPU_TYPE:IDENTIFIERS\tAdd a configuration with its CPU type and define identifiers separated by \",\",\n\t\t\t\tits output files are written to the directory NAME\n");
+	printf("\n");
+}
+
+static BOOL get_cpu_type(char *name, enum CPUType *cpu_type)
+{
+	if (!strcmp(name, "z80"))
+	{
+		*cpu_type = CPU_TYPE_Z80;
+	}
+	else if (!strcmp(name, "gb"))
+	{
+		*cpu_type = CPU_TYPE_GB;
+	}
+	else if (!strcmp(name, "msx") || !strcmp(name, "r800"))
+	{
+		*cpu_type = CPU_TYPE_MSX;
+	}
+	else
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+// Options given to every build, the include paths and define identifiers are kept to be added to new contexts
+struct BuildOptions
+{
+	struct Z80HLAContext *compile_context;
+	char **include_paths;
+	int include_paths_count;
+	char **define_identifiers;
+	int define_identifiers_count;
+};
+
+static struct Z80HLAContext *create_build_context(void *argument)
+{
+	struct BuildOptions *options = (struct BuildOptions *)argument;
+	struct Z80HLAContext *compile_context = options->compile_context;
+
+	struct Z80HLAContext *build_context = create_context();
+	build_context->input_filename = compile_context->input_filename;
+	build_context->symbol_filename = compile_context->symbol_filename;
+	build_context->listing_filename = compile_context->listing_filename;
+	build_context->compiler_output_filename = compile_context->compiler_output_filename;
+	build_context->include_generated_labels = compile_context->include_generated_labels;
+	build_context->assemble_all = compile_context->assemble_all;
+	build_context->jr_in_loops = compile_context->jr_in_loops;
+	build_context->thread_count = compile_context->thread_count;
+	build_context->lexer_thread = compile_context->lexer_thread;
+	build_context->precompiled_directory = compile_context->precompiled_directory;
+	build_context->incremental = compile_context->incremental;
+	build_context->cache_directory = compile_context->cache_directory;
+	build_context->deps_filename = compile_context->deps_filename;
+	build_context->time_trace_filename = compile_context->time_trace_filename;
+	build_context->stats_filename = compile_context->stats_filename;
+	build_context->initial_cpu_type = build_context->cpu_type = compile_context->initial_cpu_type;
+
+	for(int i = 0; i < options->include_paths_count; i++)
+	{
+		add_context_include_path(build_context, options->include_paths[i]);
+	}
+	for(int i = 0; i < options->define_identifiers_count; i++)
+	{
+		add_context_define_identifier(build_context, options->define_identifiers[i]);
+	}
+
+	return build_context;
+}
+
+// A configuration is compiled with the options given to every configuration, the ones in
+// "name:cpu:identifiers" are added to them
+static struct Z80HLAContext *create_configuration_context(struct BuildOptions *options, char *configuration)
+{
+	char *cpu_name = strchr(configuration, ':');
+	char *identifiers = cpu_name != NULL ? strchr(cpu_name + 1, ':') : NULL;
+	if (identifiers == NULL || cpu_name == configuration)
+	{
+		printf("Error: Invalid configuration \"%s\"\n", configuration);
+		return NULL;
+	}
+	*cpu_name++ = 0;
+	*identifiers++ = 0;
+
+	struct Z80HLAContext *configuration_context = create_build_context(options);
+	configuration_context->name = configuration;
+	configuration_context->output_directory = configuration;
+	configuration_context->incremental = FALSE;
+	configuration_context->cache_directory = NULL;
+	configuration_context->deps_filename = NULL;
+	configuration_context->time_trace_filename = NULL;
+	configuration_context->stats_filename = NULL;
+
+	if (!get_cpu_type(cpu_name, &configuration_context->cpu_type))
+	{
+		printf("Error: Invalid CPU type \"%s\"\n", cpu_name);
+		destroy_context(configuration_context);
+		return NULL;
+	}
+	configuration_context->initial_cpu_type = configuration_context->cpu_type;
+
+	for(char *identifier = strtok(identifiers, ","); identifier != NULL; identifier = strtok(NULL, ","))
+	{
+		add_context_define_identifier(configuration_context, identifier);
+	}
+
+	return configuration_context;
+}
+
+// The input file with the extension .z80o
+static char *get_object_filename(char *input_filename)
+{
+	char *object_filename = (char *)malloc(strlen(input_filename) + 6);
+	strcpy(object_filename, input_filename);
+
+	char *extension = strrchr(object_filename, '.');
+	if (extension == NULL || strchr(extension, '/') != NULL || strchr(extension, '\\') != NULL)
+	{
+		extension = object_filename + strlen(object_filename);
+	}
+	strcpy(extension, ".z80o");
+
+	return object_filename;
+}
+
+int main(int argc, char *argv[])
+{
+	// The standard output of the language server only has its messages
+	BOOL print_banner = TRUE;
+	for (int i = 1; i < argc; i++)
+	{
+		print_banner = print_banner && strcmp(argv[i], "--lsp");
+	}
+
+	if (print_banner)
+	{
+		printf("Z80 high-level assembler v"Z80HLA_VERSION_HI"."Z80HLA_VERSION_LO"\n");
+		printf("Copyright (C) Sérgio Vieira 2023 <internalregister@gmail.com>\n\n");
+	}
+
+	if (argc == 1)
+	{
+		print_usage();
+		return 0;
+	}
+
+	struct Z80HLAContext *compile_context = create_context();
+
+	char **include_paths = (char **)malloc(sizeof(char *) * argc);
+	char **define_identifiers = (char **)malloc(sizeof(char *) * argc);
+	char **configurations = (char **)malloc(sizeof(char *) * argc);
+	char **input_filenames = (char **)malloc(sizeof(char *) * argc);
+	int include_paths_count = 0, define_identifiers_count = 0, configurations_count = 0, input_filenames_count = 0;
+	char *serve_socket_path = NULL, *client_socket_path = NULL;
+	BOOL watch = FALSE, language_server = FALSE, compile_object = FALSE, link_object_files = FALSE, output_given = FALSE;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-o") || !strcmp(argv[i], "--output"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+			compile_context->compiler_output_filename = argv[i];
+			output_given = TRUE;
+		}
+		else if (!strcmp(argv[i], "-i") || !strcmp(argv[i], "--include"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+			add_context_include_path(compile_context, argv[i]);
+			include_paths[include_paths_count++] = argv[i];
+		}
+		else if (!strcmp(argv[i], "-c") || !strcmp(argv[i], "--cpu"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			if (!get_cpu_type(argv[i], &compile_context->cpu_type))
+			{
+				printf("Error: Invalid CPU type \"%s\"\n", argv[i]);
+				return 1;
+			}
+			compile_context->initial_cpu_type = compile_context->cpu_type;
+		}
+		else if (!strcmp(argv[i], "-d") || !strcmp(argv[i], "--define"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			add_context_define_identifier(compile_context, argv[i]);			
+			define_identifiers[define_identifiers_count++] = argv[i];
+		}
+		else if (!strcmp(argv[i], "-s") || !strcmp(argv[i], "--symbols"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			compile_context->symbol_filename = argv[i];
+		}
+		else if (!strcmp(argv[i], "-g") || !strcmp(argv[i], "--generatedlabels"))
+		{
+			compile_context->include_generated_labels = TRUE;
+		}
+		else if (!strcmp(argv[i], "-l") || !strcmp(argv[i], "--list"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			compile_context->listing_filename = argv[i];			
+		}
+		else if (!strcmp(argv[i], "-M") || !strcmp(argv[i], "--deps"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			compile_context->deps_filename = argv[i];
+		}
+		else if (!strcmp(argv[i], "--time-trace"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			compile_context->time_trace_filename = argv[i];
+		}
+		else if (!strcmp(argv[i], "--stats"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			compile_context->stats_filename = argv[i];
+		}
+		else if (!strcmp(argv[i], "-t") || !strcmp(argv[i], "--threads"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			compile_context->thread_count = atoi(argv[i]);
+			if (compile_context->thread_count <= 0)
+			{
+				printf("Error: Invalid thread count \"%s\"\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (!strcmp(argv[i], "-p") || !strcmp(argv[i], "--pipelinelexer"))
+		{
+			compile_context->lexer_thread = TRUE;
+		}
+		else if (!strcmp(argv[i], "--pch"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			compile_context->precompiled_directory = argv[i];
+		}
+		else if (!strcmp(argv[i], "--cache"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			compile_context->cache_directory = argv[i];
+		}
+		else if (!strcmp(argv[i], "--incremental"))
+		{
+			compile_context->incremental = TRUE;
+		}
+		else if (!strcmp(argv[i], "-w") || !strcmp(argv[i], "--watch"))
+		{
+			watch = TRUE;
+		}
+		else if (!strcmp(argv[i], "--object"))
+		{
+			compile_object = TRUE;
+		}
+		else if (!strcmp(argv[i], "--link"))
+		{
+			link_object_files = TRUE;
+		}
+		else if (!strcmp(argv[i], "--lsp"))
+		{
+			language_server = TRUE;
+		}
+		else if (!strcmp(argv[i], "--serve") || !strcmp(argv[i], "--client"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			if (!strcmp(argv[i-1], "--serve"))
+			{
+				serve_socket_path = argv[i];
+			}
+			else
+			{
+				client_socket_path = argv[i];
+			}
+		}
+		else if (!strcmp(argv[i], "--config"))
+		{
+			i++;
+			if (i == argc)
+			{
+				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
+				return 1;
+			}
+
+			configurations[configurations_count++] = argv[i];
+		}
+		else if (!strcmp(argv[i], "-a") || !strcmp(argv[i], "--assembleall"))
+		{
+			compile_context->assemble_all = TRUE;
+		}
+		else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help"))
+		{
+			print_usage();
+			return 0;
+		}
+		else if (!strcmp(argv[i], "-j") || !strcmp(argv[i], "--jrloop"))
+		{
+			compile_context->jr_in_loops = TRUE;
+		}
+		else
+		{
+			if (argv[i][0] == '-')
+			{
+				printf("Error: Invalid option \"%s\"\n", argv[i]);
+				return 1;
+			}
+			
+			compile_context->input_filename = argv[i];
+			input_filenames[input_filenames_count++] = argv[i];
+		}
+	}
+
+	if (client_socket_path != NULL)
+	{
+		return request_build(client_socket_path);
+	}
+
+	if ((watch || serve_socket_path != NULL || language_server) && configurations_count > 0)
+	{
+		printf("Error: --config can't be used with --watch, --serve or --lsp\n");
+		return 1;
+	}
+
+	if (compile_object || link_object_files)
+	{
+		if (compile_object && link_object_files)
+		{
+			printf("Error: --object can't be used with --link\n");
+			return 1;
+		}
+		if (watch || serve_socket_path != NULL || language_server || configurations_count > 0 || compile_context->listing_filename != NULL)
+		{
+			printf("Error: --object and --link can't be used with --watch, --serve, --lsp, --config or --list\n");
+			return 1;
+		}
+	}
+
+	struct BuildOptions options;
+	options.compile_context = compile_context;
+	options.include_paths = include_paths;
+	options.include_paths_count = include_paths_count;
+	options.define_identifiers = define_identifiers;
+	options.define_identifiers_count = define_identifiers_count;
+
+	if (language_server)
+	{
+		return serve_language_server(compile_context->input_filename, create_build_context, &options);
+	}
+
+	if (compile_context->input_filename == NULL)
+	{
+		printf("Error: No input file\n");
+		return 1;
+	}
+
+	int result = 0;
+	if (link_object_files)
+	{
+		result = link_objects(compile_context, input_filenames, input_filenames_count);
+	}
+	else if (compile_object)
+	{
+		compile_context->object_filename = output_given ? compile_context->compiler_output_filename : get_object_filename(compile_context->input_filename);
+		result = assemble(compile_context);
+	}
+	else if (serve_socket_path != NULL)
+	{
+		result = serve(serve_socket_path, watch, compile_context->input_filename, create_build_context, &options);
+	}
+	else if (watch)
+	{
+		result = watch_input(compile_context->input_filename, create_build_context, &options);
+	}
+	else if (configurations_count == 0)
+	{
+		result = assemble(compile_context);
+	}
+	else
+	{
+		struct Z80HLAContext **compile_contexts = (struct Z80HLAContext **)malloc(sizeof(struct Z80HLAContext *) * configurations_count);
+		for(int i = 0; i < configurations_count; i++)
+		{
+			compile_contexts[i] = create_configuration_context(&options, configurations[i]);
+			if (compile_contexts[i] == NULL)
+			{
+				return 1;
+			}
+		}
+
+		int thread_count = compile_context->thread_count > 0 ? compile_context->thread_count : get_cpu_count();
+		result = assemble_configurations(compile_contexts, configurations_count, thread_count);
+
+		for(int i = 0; i < configurations_count; i++)
+		{
+			destroy_context(compile_contexts[i]);
+		}
+		free(compile_contexts);
+	}
+	destroy_context(compile_context);
+
+	free(include_paths);
+	free(define_identifiers);
+	free(configurations);
+	free(input_filenames);
+
+	return result;
+}
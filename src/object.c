@@ -0,0 +1,1106 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "z80hla.h"
+
+// An object file (.z80o) holds a module compiled on its own, the output as it is after the second pass.
+// The output is split in sections, the code and data of each library symbol is a section and the rest of
+// the module is in sections that end at every #origin. Labels are kept as offsets in their sections and the
+// values left to resolve keep their expressions, reduced to the labels, the symbols of other modules, the
+// generated labels and the current address ("$") they refer to.
+// Linking places the sections one after the other, leaving out the library symbols nothing refers to (and
+// all but the first copy of the ones in more than one module), and does the third pass.
+
+#define OBJECT_MAGIC        "Z80OBJ1"
+
+enum ObjectElementFlags
+{
+    OBJECT_ELEMENT_FINAL = 1,
+    OBJECT_ELEMENT_SET_ADDRESS = 2,
+    OBJECT_ELEMENT_NODE = 4,
+    OBJECT_ELEMENT_RUN = 8,
+    OBJECT_ELEMENT_RUN_VALUES = 16
+};
+
+struct ObjectSection
+{
+    char *library_name; // of the library symbol in it, the rest of a module has none
+    int library_name_size;
+    char *name;
+    int name_size;
+    BOOL keep; // linked even when nothing refers to it (#assembleall)
+    int first_element; // index in the output
+    int address; // where it starts when the module is compiled
+};
+
+struct ObjectSymbol
+{
+    char *library_name;
+    int library_name_size;
+    char *name;
+    int name_size;
+    int section; // -1 for constants
+    int64_t value; // offset in the section or value of a constant
+    int next; // with the same hash
+};
+
+struct ObjectGeneratedLabel
+{
+    int label;
+    int section;
+    int offset;
+};
+
+struct ObjectFile
+{
+    BOOL assemble_all;
+
+    struct ObjectSection *sections;
+    int sections_count;
+    int sections_capacity;
+
+    struct ObjectSymbol *symbols;
+    int symbols_count;
+    int symbols_capacity;
+    int *symbols_index; // hash of the name to the last symbol with it, -1 if none
+    int symbols_index_capacity;
+
+    struct ObjectGeneratedLabel *generated_labels;
+    int generated_labels_count;
+    int generated_labels_capacity;
+};
+
+static unsigned int hash_object_symbol(char *library_name, int library_name_size, char *name, int name_size)
+{
+    uint64_t hash = hash_bytes(HASH_INITIAL_VALUE, library_name, (size_t)library_name_size);
+    return (unsigned int)hash_bytes(hash, name, (size_t)name_size);
+}
+
+static struct ObjectSymbol *find_object_symbol(struct ObjectSymbol *symbols, int *symbols_index, int symbols_index_capacity,
+    char *library_name, int library_name_size, char *name, int name_size)
+{
+    unsigned int slot = hash_object_symbol(library_name, library_name_size, name, name_size) & (symbols_index_capacity - 1);
+    for(int i = symbols_index[slot]; i >= 0; i = symbols[i].next)
+    {
+        if (is_str_equal2(symbols[i].name, symbols[i].name_size, name, name_size) &&
+            is_str_equal2(symbols[i].library_name, symbols[i].library_name_size, library_name, library_name_size))
+        {
+            return &symbols[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void add_to_symbols_index(struct ObjectSymbol *symbols, int i, int *symbols_index, int symbols_index_capacity)
+{
+    unsigned int slot = hash_object_symbol(symbols[i].library_name, symbols[i].library_name_size, symbols[i].name, symbols[i].name_size) & (symbols_index_capacity - 1);
+    symbols[i].next = symbols_index[slot];
+    symbols_index[slot] = i;
+}
+
+// Sized for count symbols, the first ones given are indexed
+static void index_object_symbols(struct ObjectSymbol *symbols, int count, int indexed_count, int **symbols_index, int *symbols_index_capacity)
+{
+    *symbols_index_capacity = 256;
+    while (*symbols_index_capacity < count * 2) { *symbols_index_capacity *= 2; }
+    *symbols_index = (int *)realloc(*symbols_index, sizeof(int) * *symbols_index_capacity);
+    memset(*symbols_index, 0xff, sizeof(int) * *symbols_index_capacity);
+
+    for(int i = 0; i < indexed_count; i++)
+    {
+        add_to_symbols_index(symbols, i, *symbols_index, *symbols_index_capacity);
+    }
+}
+
+// *************
+// Compiling
+// *************
+
+void start_object_file(BOOL assemble_all)
+{
+    context->object = (struct ObjectFile *)calloc(1, sizeof(struct ObjectFile));
+    context->object->assemble_all = assemble_all;
+    add_object_section(NULL, 0, NULL, 0);
+}
+
+void finish_object_file()
+{
+    struct ObjectFile *object = context->object;
+    if (object == NULL) { return; }
+
+    free(object->sections);
+    free(object->symbols);
+    free(object->symbols_index);
+    free(object->generated_labels);
+    free(object);
+    context->object = NULL;
+}
+
+// Starts a section at the next element of the output, of a library symbol or of the rest of the module
+void add_object_section(char *library_name, int library_name_size, char *name, int name_size)
+{
+    struct ObjectFile *object = context->object;
+    if (object == NULL) { return; }
+
+    if (object->sections_count == object->sections_capacity)
+    {
+        object->sections_capacity = MAX(16, object->sections_capacity * 2);
+        object->sections = (struct ObjectSection *)realloc(object->sections, sizeof(struct ObjectSection) * object->sections_capacity);
+    }
+
+    struct ObjectSection *section = &object->sections[object->sections_count++];
+    section->library_name = library_name;
+    section->library_name_size = library_name_size;
+    section->name = name;
+    section->name_size = name_size;
+    section->keep = library_name_size == 0 || object->assemble_all || context->assemble_all;
+    section->first_element = context->output_length;
+    section->address = context->compiler_current_address;
+}
+
+// Labels are offsets in the section they are in, constants keep their values
+void add_object_symbol(char *library_name, int library_name_size, char *name, int name_size, BOOL is_label, int64_t value)
+{
+    struct ObjectFile *object = context->object;
+    if (object == NULL) { return; }
+
+    if (object->symbols_count == object->symbols_capacity)
+    {
+        object->symbols_capacity = MAX(256, object->symbols_capacity * 2);
+        object->symbols = (struct ObjectSymbol *)realloc(object->symbols, sizeof(struct ObjectSymbol) * object->symbols_capacity);
+    }
+
+    struct ObjectSymbol *symbol = &object->symbols[object->symbols_count++];
+    symbol->library_name = library_name;
+    symbol->library_name_size = library_name_size;
+    symbol->name = name;
+    symbol->name_size = name_size;
+    symbol->section = is_label ? object->sections_count - 1 : -1;
+    symbol->value = is_label ? value - object->sections[object->sections_count - 1].address : value;
+}
+
+void add_object_generated_label(int label, int address)
+{
+    struct ObjectFile *object = context->object;
+    if (object == NULL) { return; }
+
+    if (object->generated_labels_count == object->generated_labels_capacity)
+    {
+        object->generated_labels_capacity = MAX(256, object->generated_labels_capacity * 2);
+        object->generated_labels = (struct ObjectGeneratedLabel *)realloc(object->generated_labels, sizeof(struct ObjectGeneratedLabel) * object->generated_labels_capacity);
+    }
+
+    struct ObjectGeneratedLabel *generated_label = &object->generated_labels[object->generated_labels_count++];
+    generated_label->label = label;
+    generated_label->section = object->sections_count - 1;
+    generated_label->offset = address - object->sections[object->sections_count - 1].address;
+}
+
+static BOOL is_object_label(char *library_name, int library_name_size, char *name, int name_size)
+{
+    struct ObjectFile *object = context->object;
+    struct ObjectSymbol *symbol = find_object_symbol(object->symbols, object->symbols_index, object->symbols_index_capacity, library_name, library_name_size, name, name_size);
+
+    return symbol != NULL && symbol->section >= 0;
+}
+
+// The node becomes a number with the value of its expression
+static int reduce_to_number(struct ASTNode *node)
+{
+    struct ASTNode expression = *node;
+    int64_t value;
+
+    expression.type = NODE_TYPE_EXPRESSION;
+    if (resolve_expression(&expression, &value)) { return 1; }
+
+    node->str_size = 0;
+    node->str_size2 = 0;
+    node->children_count = 0;
+    node->num_value = value;
+
+    return 0;
+}
+
+// The node becomes the label it refers to plus the offset of the element or index of it
+static int reduce_to_label_offset(struct ASTNode *node, struct ASTNode *label_node)
+{
+    struct ASTNode expression = *node;
+    int64_t value, address;
+
+    expression.type = NODE_TYPE_EXPRESSION;
+    if (resolve_expression(&expression, &value)) { return 1; }
+    get_constant(label_node->str_value2, label_node->str_size2, label_node->str_value, label_node->str_size, &address);
+
+    struct ASTNode *label_expression = create_node(NODE_TYPE_EXPRESSION, NULL);
+    label_expression->str_value = label_node->str_value;
+    label_expression->str_size = label_node->str_size;
+    label_expression->str_value2 = label_node->str_value2;
+    label_expression->str_size2 = label_node->str_size2;
+    label_expression->filename = label_node->filename;
+    label_expression->file_line = label_node->file_line;
+
+    struct ASTNode *offset_expression = create_node(NODE_TYPE_EXPRESSION, NULL);
+    offset_expression->num_value = value - address;
+    offset_expression->filename = node->filename;
+    offset_expression->file_line = node->file_line;
+
+    node->str_value = "+";
+    node->str_size = 1;
+    node->str_size2 = 0;
+    node->children[0] = label_expression;
+    node->children[1] = offset_expression;
+    node->children_count = 2;
+
+    return 0;
+}
+
+static BOOL is_identifier_node(struct ASTNode *node)
+{
+    return node->str_size > 0 && strchr("+-*/%&|~^<>$@.", node->str_value[0]) == NULL &&
+        !((is_str_equal(node->str_value, node->str_size, "sizeof") || is_str_equal(node->str_value, node->str_size, "length")) && node->str_size2 == 0);
+}
+
+// What can be resolved when the object file is written becomes a number, what is left only refers to labels,
+// symbols of other modules, generated labels and the current address
+static int reduce_expression(struct ASTNode *node, BOOL *is_number)
+{
+    *is_number = FALSE;
+
+    if (node->str_size == 0)
+    {
+        *is_number = TRUE;
+        return 0;
+    }
+
+    if (node->str_value[0] == '$' || node->str_value[0] == '@')
+    {
+        return 0;
+    }
+
+    if (node->str_value[0] == '.')
+    {
+        // Elements of data in the module are offsets from their labels, elements of types are numbers
+        struct ASTNode *first_identifier_node = node->children[0];
+        if (is_object_label(first_identifier_node->str_value2, first_identifier_node->str_size2, first_identifier_node->str_value, first_identifier_node->str_size))
+        {
+            return reduce_to_label_offset(node, first_identifier_node);
+        }
+        *is_number = TRUE;
+        return reduce_to_number(node);
+    }
+
+    if (is_identifier_node(node))
+    {
+        if (is_object_label(node->str_value2, node->str_size2, node->str_value, node->str_size))
+        {
+            return node->children_count > 0 ? reduce_to_label_offset(node, node) : 0;
+        }
+
+        if (is_constant_present(node->str_value2, node->str_size2, node->str_value, node->str_size))
+        {
+            *is_number = TRUE;
+            return reduce_to_number(node);
+        }
+
+        // Symbol of another module
+        if (node->children_count > 0)
+        {
+            write_compiler_error(node->filename, node->file_line, "Indexed data symbol \"%.*s\" not in the module", node->str_size, node->str_value);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (node->str_value[0] != 's' && node->str_value[0] != 'l')
+    {
+        // Operators
+        BOOL are_numbers = TRUE;
+        for(int i = 0; i < node->children_count; i++)
+        {
+            BOOL is_child_number;
+            if (reduce_expression(node->children[i], &is_child_number)) { return 1; }
+            are_numbers = are_numbers && is_child_number;
+        }
+        if (!are_numbers) { return 0; }
+    }
+
+    // Operators of numbers, sizeof and length
+    *is_number = TRUE;
+    return reduce_to_number(node);
+}
+
+static int reduce_output_expressions(struct ASTNode *node)
+{
+    BOOL is_number;
+
+    switch(node->type)
+    {
+        case NODE_TYPE_EXPRESSION:
+        case NODE_TYPE_EXPRESSION_3:
+        case NODE_TYPE_EXPRESSION_8:
+        case NODE_TYPE_EXPRESSION_8c:
+        case NODE_TYPE_EXPRESSION_16:
+        case NODE_TYPE_EXPRESSION_32:
+        case NODE_TYPE_EXPRESSION_8_REL_CUR_ADDRESS:
+            return reduce_expression(node, &is_number);
+        case NODE_TYPE_MATCH_LIST:
+            return reduce_expression(node->children[1], &is_number);
+        case NODE_TYPE_GB_IO_HI_RAM:
+            return reduce_expression(node->children[0], &is_number);
+        case NODE_TYPE_PRINT:
+        {
+            for(struct ASTNode *data_node = node->children[0]; data_node != NULL; data_node = data_node->children[1])
+            {
+                if (data_node->children[0] != NULL && reduce_expression(data_node->children[0], &is_number)) { return 1; }
+            }
+            return 0;
+        }
+        case NODE_TYPE_ORIGIN:
+        {
+            // Sections are placed knowing where each #origin is
+            struct ASTNode *origin_expression_node = node->children[0];
+            int64_t value;
+            if (resolve_expression(origin_expression_node, &value)) { return 1; }
+            node->children[0] = create_node(NODE_TYPE_EXPRESSION_16, NULL);
+            node->children[0]->num_value = value;
+            node->children[0]->filename = origin_expression_node->filename;
+            node->children[0]->file_line = origin_expression_node->file_line;
+            return 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+struct ObjectWriter
+{
+    uint8_t *data;
+    int size;
+    int capacity;
+
+    char **filenames; // of the nodes, written as indexes
+    int filenames_count;
+    int filenames_capacity;
+};
+
+static void put_bytes(struct ObjectWriter *writer, void *bytes, int size)
+{
+    if (writer->size + size > writer->capacity)
+    {
+        writer->capacity = MAX(writer->capacity * 2, MAX(writer->size + size, 65536));
+        writer->data = (uint8_t *)realloc(writer->data, writer->capacity);
+    }
+    memcpy(writer->data + writer->size, bytes, size);
+    writer->size += size;
+}
+
+static void put_int(struct ObjectWriter *writer, int64_t value, int size)
+{
+    uint8_t bytes[8];
+    for(int i = 0; i < size; i++)
+    {
+        bytes[i] = (uint8_t)(value >> (i * 8));
+    }
+    put_bytes(writer, bytes, size);
+}
+
+static void set_int_at(struct ObjectWriter *writer, int position, int value)
+{
+    for(int i = 0; i < 4; i++)
+    {
+        writer->data[position + i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+static void put_string(struct ObjectWriter *writer, char *string, int size)
+{
+    put_int(writer, size, 4);
+    if (size > 0)
+    {
+        put_bytes(writer, string, size);
+    }
+}
+
+static int get_filename_index(struct ObjectWriter *writer, char *filename)
+{
+    if (filename == NULL) { return -1; }
+
+    for(int i = writer->filenames_count - 1; i >= 0; i--)
+    {
+        if (writer->filenames[i] == filename || !strcmp(writer->filenames[i], filename)) { return i; }
+    }
+
+    if (writer->filenames_count == writer->filenames_capacity)
+    {
+        writer->filenames_capacity = MAX(16, writer->filenames_capacity * 2);
+        writer->filenames = (char **)realloc(writer->filenames, sizeof(char *) * writer->filenames_capacity);
+    }
+    writer->filenames[writer->filenames_count] = filename;
+
+    return writer->filenames_count++;
+}
+
+static void put_node(struct ObjectWriter *writer, struct ASTNode *node)
+{
+    put_int(writer, node->type, 4);
+    put_int(writer, node->num_value, 8);
+    put_int(writer, node->num_value2, 8);
+    put_string(writer, node->str_value, node->str_size);
+    put_string(writer, node->str_value2, node->str_size2);
+    put_int(writer, get_filename_index(writer, node->filename), 4);
+    put_int(writer, node->file_line, 4);
+    put_int(writer, node->children_count, 4);
+    for(int i = 0; i < node->children_count; i++)
+    {
+        put_int(writer, node->children[i] != NULL, 1);
+        if (node->children[i] != NULL)
+        {
+            put_node(writer, node->children[i]);
+        }
+    }
+}
+
+// Writes the object file, the expressions in the output are reduced first
+int save_object_file(char *filename)
+{
+    struct ObjectFile *object = context->object;
+    char object_path[256];
+
+    index_object_symbols(object->symbols, object->symbols_count, object->symbols_count, &object->symbols_index, &object->symbols_index_capacity);
+
+    struct ObjectWriter writer;
+    memset(&writer, 0, sizeof(writer));
+
+    // Elements of the sections, each section starts with the number of elements in it
+    struct ObjectWriter elements;
+    memset(&elements, 0, sizeof(elements));
+    int section = 0, elements_count = 0, count_position = 0;
+    struct OutputElement *element = context->first_output_elem;
+    for(int i = 0; i <= context->output_length; i++)
+    {
+        while (section < object->sections_count && object->sections[section].first_element == i)
+        {
+            if (section > 0)
+            {
+                set_int_at(&elements, count_position, elements_count);
+            }
+            put_string(&elements, object->sections[section].library_name, object->sections[section].library_name_size);
+            put_string(&elements, object->sections[section].name, object->sections[section].name_size);
+            put_int(&elements, object->sections[section].keep, 1);
+            count_position = elements.size;
+            put_int(&elements, 0, 4);
+            elements_count = 0;
+            section++;
+        }
+        if (i == context->output_length) { break; }
+
+        int flags = (element->final ? OBJECT_ELEMENT_FINAL : 0) | (element->set_address ? OBJECT_ELEMENT_SET_ADDRESS : 0);
+        if (element->node != NULL)
+        {
+            if (reduce_output_expressions(element->node))
+            {
+                free(elements.data);
+                free(elements.filenames);
+                return 1;
+            }
+            flags |= OBJECT_ELEMENT_NODE;
+        }
+        if (element->size > 1)
+        {
+            flags |= OBJECT_ELEMENT_RUN | (element->values != NULL ? OBJECT_ELEMENT_RUN_VALUES : 0);
+        }
+
+        put_int(&elements, flags, 1);
+        put_int(&elements, element->value, 1);
+        if (element->size > 1)
+        {
+            put_int(&elements, element->size, 4);
+            if (element->values != NULL)
+            {
+                put_bytes(&elements, element->values, element->size);
+            }
+        }
+        if (element->node != NULL)
+        {
+            put_node(&elements, element->node);
+        }
+        elements_count++;
+
+        element = element->next;
+    }
+    set_int_at(&elements, count_position, elements_count);
+
+    put_bytes(&writer, OBJECT_MAGIC, 8);
+    put_int(&writer, context->new_label_count, 4);
+    put_int(&writer, elements.filenames_count, 4);
+    for(int i = 0; i < elements.filenames_count; i++)
+    {
+        put_string(&writer, elements.filenames[i], (int)strlen(elements.filenames[i]));
+    }
+    put_int(&writer, object->sections_count, 4);
+    put_bytes(&writer, elements.data, elements.size);
+    put_int(&writer, object->symbols_count, 4);
+    for(int i = 0; i < object->symbols_count; i++)
+    {
+        put_string(&writer, object->symbols[i].library_name, object->symbols[i].library_name_size);
+        put_string(&writer, object->symbols[i].name, object->symbols[i].name_size);
+        put_int(&writer, object->symbols[i].section, 4);
+        put_int(&writer, object->symbols[i].value, 8);
+    }
+    put_int(&writer, object->generated_labels_count, 4);
+    for(int i = 0; i < object->generated_labels_count; i++)
+    {
+        put_int(&writer, object->generated_labels[i].label, 4);
+        put_int(&writer, object->generated_labels[i].section, 4);
+        put_int(&writer, object->generated_labels[i].offset, 4);
+    }
+    free(elements.data);
+    free(elements.filenames);
+
+    get_output_path(object_path, filename);
+    FILE *fp = fopen(object_path, "wb");
+    if (fp == NULL || fwrite(writer.data, 1, writer.size, fp) != (size_t)writer.size)
+    {
+        write_error("Unable to write object file \"%s\"", object_path);
+        if (fp != NULL) { fclose(fp); }
+        free(writer.data);
+        return 1;
+    }
+    fclose(fp);
+    add_written_file(object_path);
+    free(writer.data);
+
+    return 0;
+}
+
+// *************
+// Linking
+// *************
+
+struct LinkedElement
+{
+    uint8_t value;
+    uint8_t *values;
+    int size;
+    struct ASTNode *node;
+    int flags;
+};
+
+struct LinkedReference
+{
+    char *library_name;
+    int library_name_size;
+    char *name;
+    int name_size;
+};
+
+struct LinkedSection
+{
+    int module;
+    char *library_name;
+    int library_name_size;
+    char *name;
+    int name_size;
+    BOOL keep;
+    BOOL linked;
+    int address;
+
+    struct LinkedElement *elements;
+    int elements_count;
+    struct LinkedReference *references; // symbols its expressions refer to
+    int references_count;
+    int references_capacity;
+};
+
+struct Linker
+{
+    char **filenames; // of the modules
+    int *first_generated_labels; // of each module, generated labels are numbered one module after the other
+
+    struct LinkedSection *sections;
+    int sections_count;
+    int sections_capacity;
+
+    struct ObjectSymbol *symbols; // sections are indexes in the linker
+    int *symbol_modules;
+    int symbols_count;
+    int symbols_capacity;
+    int *symbols_index;
+    int symbols_index_capacity;
+
+    struct ObjectGeneratedLabel *generated_labels; // labels numbered for the linker
+    int generated_labels_count;
+    int generated_labels_capacity;
+};
+
+struct ObjectReader
+{
+    uint8_t *at, *end;
+    BOOL error;
+
+    char **filenames;
+    int filenames_count;
+    int first_generated_label;
+    struct LinkedSection *section;
+};
+
+static int64_t get_int(struct ObjectReader *reader, int size)
+{
+    int64_t value = 0;
+
+    if (reader->end - reader->at < size)
+    {
+        reader->error = TRUE;
+        return 0;
+    }
+    for(int i = 0; i < size; i++)
+    {
+        value |= (int64_t)reader->at[i] << (i * 8);
+    }
+    reader->at += size;
+
+    // Sign of the 4 byte values
+    if (size == 4) { value = (int32_t)(uint32_t)value; }
+
+    return value;
+}
+
+static uint8_t *get_bytes(struct ObjectReader *reader, int size)
+{
+    if (size < 0 || reader->end - reader->at < size)
+    {
+        reader->error = TRUE;
+        return NULL;
+    }
+
+    uint8_t *bytes = (uint8_t *)allocate_context_memory(size + 1);
+    memcpy(bytes, reader->at, size);
+    reader->at += size;
+
+    return bytes;
+}
+
+static char *get_string(struct ObjectReader *reader, int *size)
+{
+    *size = (int)get_int(reader, 4);
+    char *string = (char *)get_bytes(reader, *size);
+    if (string == NULL)
+    {
+        *size = 0;
+        return "";
+    }
+    string[*size] = 0;
+
+    return string;
+}
+
+static void add_linked_reference(struct LinkedSection *section, struct ASTNode *node)
+{
+    if (section->references_count == section->references_capacity)
+    {
+        section->references_capacity = MAX(16, section->references_capacity * 2);
+        section->references = (struct LinkedReference *)realloc(section->references, sizeof(struct LinkedReference) * section->references_capacity);
+    }
+
+    struct LinkedReference *reference = &section->references[section->references_count++];
+    reference->library_name = node->str_value2;
+    reference->library_name_size = node->str_size2;
+    reference->name = node->str_value;
+    reference->name_size = node->str_size;
+}
+
+static struct ASTNode *get_node(struct ObjectReader *reader)
+{
+    struct ASTNode *node = create_node((enum NodeType)get_int(reader, 4), NULL);
+    node->num_value = get_int(reader, 8);
+    node->num_value2 = get_int(reader, 8);
+    node->str_value = get_string(reader, &node->str_size);
+    node->str_value2 = get_string(reader, &node->str_size2);
+    int filename = (int)get_int(reader, 4);
+    node->filename = filename >= 0 && filename < reader->filenames_count ? reader->filenames[filename] : NULL;
+    node->file_line = (int)get_int(reader, 4);
+    node->children_count = (int)get_int(reader, 4);
+    if (node->children_count < 0 || node->children_count > MAX_AST_NODE_CHILDREN)
+    {
+        reader->error = TRUE;
+        node->children_count = 0;
+    }
+
+    for(int i = 0; i < node->children_count && !reader->error; i++)
+    {
+        node->children[i] = get_int(reader, 1) ? get_node(reader) : NULL;
+    }
+
+    if (is_node_expression(node) && node->str_size > 0)
+    {
+        if (node->str_value[0] == '@')
+        {
+            node->num_value += reader->first_generated_label;
+        }
+        else if (is_identifier_node(node))
+        {
+            add_linked_reference(reader->section, node);
+        }
+    }
+
+    return node;
+}
+
+static void add_linked_symbol(struct Linker *linker, int module, char *library_name, int library_name_size, char *name, int name_size, int section, int64_t value)
+{
+    if (linker->symbols_count == linker->symbols_capacity)
+    {
+        linker->symbols_capacity = MAX(256, linker->symbols_capacity * 2);
+        linker->symbols = (struct ObjectSymbol *)realloc(linker->symbols, sizeof(struct ObjectSymbol) * linker->symbols_capacity);
+        linker->symbol_modules = (int *)realloc(linker->symbol_modules, sizeof(int) * linker->symbols_capacity);
+    }
+
+    struct ObjectSymbol *symbol = &linker->symbols[linker->symbols_count];
+    symbol->library_name = library_name;
+    symbol->library_name_size = library_name_size;
+    symbol->name = name;
+    symbol->name_size = name_size;
+    symbol->section = section;
+    symbol->value = value;
+    linker->symbol_modules[linker->symbols_count++] = module;
+}
+
+static int read_object_file(struct Linker *linker, int module)
+{
+    char *filename = linker->filenames[module];
+    long size = 0;
+    int error = 0;
+
+    uint8_t *content = (uint8_t *)read_file_to_cache(filename, TRUE, &size, &error, NULL);
+    if (content == NULL)
+    {
+        write_error("Unable to read object file \"%s\"", filename);
+        return 1;
+    }
+
+    struct ObjectReader reader;
+    memset(&reader, 0, sizeof(reader));
+    reader.at = content;
+    reader.end = content + size;
+
+    if (size < 8 || memcmp(content, OBJECT_MAGIC, 8))
+    {
+        write_error("File \"%s\" is not an object file", filename);
+        return 1;
+    }
+    reader.at += 8;
+
+    reader.first_generated_label = linker->first_generated_labels[module];
+    linker->first_generated_labels[module + 1] = reader.first_generated_label + (int)get_int(&reader, 4);
+
+    reader.filenames_count = (int)get_int(&reader, 4);
+    reader.filenames = (char **)malloc(sizeof(char *) * MAX(1, reader.filenames_count));
+    for(int i = 0; i < reader.filenames_count && !reader.error; i++)
+    {
+        int filename_size;
+        reader.filenames[i] = get_string(&reader, &filename_size);
+    }
+
+    int first_section = linker->sections_count;
+    int sections_count = (int)get_int(&reader, 4);
+    for(int i = 0; i < sections_count && !reader.error; i++)
+    {
+        if (linker->sections_count == linker->sections_capacity)
+        {
+            linker->sections_capacity = MAX(64, linker->sections_capacity * 2);
+            linker->sections = (struct LinkedSection *)realloc(linker->sections, sizeof(struct LinkedSection) * linker->sections_capacity);
+        }
+
+        struct LinkedSection *section = &linker->sections[linker->sections_count++];
+        memset(section, 0, sizeof(struct LinkedSection));
+        section->module = module;
+        section->library_name = get_string(&reader, &section->library_name_size);
+        section->name = get_string(&reader, &section->name_size);
+        section->keep = (BOOL)get_int(&reader, 1);
+        section->elements_count = (int)get_int(&reader, 4);
+        if (section->elements_count < 0 || section->elements_count > reader.end - reader.at)
+        {
+            reader.error = TRUE;
+            break;
+        }
+        section->elements = (struct LinkedElement *)malloc(sizeof(struct LinkedElement) * MAX(1, section->elements_count));
+        reader.section = section;
+
+        for(int j = 0; j < section->elements_count && !reader.error; j++)
+        {
+            struct LinkedElement *element = &section->elements[j];
+            element->flags = (int)get_int(&reader, 1);
+            element->value = (uint8_t)get_int(&reader, 1);
+            element->size = 1;
+            element->values = NULL;
+            element->node = NULL;
+            if (element->flags & OBJECT_ELEMENT_RUN)
+            {
+                element->size = (int)get_int(&reader, 4);
+                if (element->flags & OBJECT_ELEMENT_RUN_VALUES)
+                {
+                    element->values = get_bytes(&reader, element->size);
+                }
+            }
+            if (element->flags & OBJECT_ELEMENT_NODE)
+            {
+                element->node = get_node(&reader);
+            }
+        }
+    }
+
+    int symbols_count = (int)get_int(&reader, 4);
+    for(int i = 0; i < symbols_count && !reader.error; i++)
+    {
+        int library_name_size, name_size;
+        char *library_name = get_string(&reader, &library_name_size);
+        char *name = get_string(&reader, &name_size);
+        int section = (int)get_int(&reader, 4);
+        int64_t value = get_int(&reader, 8);
+        if (section >= sections_count) { reader.error = TRUE; }
+        add_linked_symbol(linker, module, library_name, library_name_size, name, name_size, section >= 0 ? first_section + section : -1, value);
+    }
+
+    int generated_labels_count = (int)get_int(&reader, 4);
+    for(int i = 0; i < generated_labels_count && !reader.error; i++)
+    {
+        if (linker->generated_labels_count == linker->generated_labels_capacity)
+        {
+            linker->generated_labels_capacity = MAX(256, linker->generated_labels_capacity * 2);
+            linker->generated_labels = (struct ObjectGeneratedLabel *)realloc(linker->generated_labels, sizeof(struct ObjectGeneratedLabel) * linker->generated_labels_capacity);
+        }
+
+        struct ObjectGeneratedLabel *generated_label = &linker->generated_labels[linker->generated_labels_count++];
+        generated_label->label = reader.first_generated_label + (int)get_int(&reader, 4);
+        generated_label->section = first_section + (int)get_int(&reader, 4);
+        generated_label->offset = (int)get_int(&reader, 4);
+        if (generated_label->section >= linker->sections_count) { reader.error = TRUE; }
+    }
+
+    if (reader.error)
+    {
+        write_error("Object file \"%s\" is not valid", filename);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Only the first copy of a library symbol is linked, the symbols of the others are left out
+static void find_duplicated_sections(struct Linker *linker)
+{
+    int *index = NULL, index_capacity = 0;
+    struct ObjectSymbol *library_symbols = (struct ObjectSymbol *)malloc(sizeof(struct ObjectSymbol) * MAX(1, linker->sections_count));
+    int library_symbols_count = 0;
+
+    index_object_symbols(library_symbols, linker->sections_count, 0, &index, &index_capacity);
+    for(int i = 0; i < linker->sections_count; i++)
+    {
+        struct LinkedSection *section = &linker->sections[i];
+        if (section->library_name_size == 0) { continue; }
+
+        if (find_object_symbol(library_symbols, index, index_capacity, section->library_name, section->library_name_size, section->name, section->name_size) != NULL)
+        {
+            section->keep = FALSE;
+            section->address = -1;
+            continue;
+        }
+
+        struct ObjectSymbol *library_symbol = &library_symbols[library_symbols_count];
+        library_symbol->library_name = section->library_name;
+        library_symbol->library_name_size = section->library_name_size;
+        library_symbol->name = section->name;
+        library_symbol->name_size = section->name_size;
+        add_to_symbols_index(library_symbols, library_symbols_count++, index, index_capacity);
+    }
+
+    free(index);
+    free(library_symbols);
+}
+
+// Symbols of every module in one table, a label defined in two modules is an error and so is a constant
+// with different values
+static int index_linked_symbols(struct Linker *linker)
+{
+    int count = 0;
+
+    index_object_symbols(linker->symbols, linker->symbols_count, 0, &linker->symbols_index, &linker->symbols_index_capacity);
+    for(int i = 0; i < linker->symbols_count; i++)
+    {
+        struct ObjectSymbol *symbol = &linker->symbols[i];
+        if (symbol->section >= 0 && linker->sections[symbol->section].address < 0) { continue; }
+
+        struct ObjectSymbol *defined = find_object_symbol(linker->symbols, linker->symbols_index, linker->symbols_index_capacity,
+            symbol->library_name, symbol->library_name_size, symbol->name, symbol->name_size);
+        if (defined != NULL)
+        {
+            if (defined->section < 0 && symbol->section < 0 && defined->value == symbol->value) { continue; }
+
+            char *first_filename = linker->filenames[linker->symbol_modules[defined - linker->symbols]];
+            char *second_filename = linker->filenames[linker->symbol_modules[i]];
+            if (symbol->library_name_size > 0)
+            {
+                write_error("Symbol \"%s::%s\" defined in \"%s\" and \"%s\"", symbol->library_name, symbol->name, first_filename, second_filename);
+            }
+            else
+            {
+                write_error("Symbol \"%s\" defined in \"%s\" and \"%s\"", symbol->name, first_filename, second_filename);
+            }
+            return 1;
+        }
+
+        linker->symbol_modules[count] = linker->symbol_modules[i];
+        linker->symbols[count] = *symbol;
+        add_to_symbols_index(linker->symbols, count++, linker->symbols_index, linker->symbols_index_capacity);
+    }
+    linker->symbols_count = count;
+
+    return 0;
+}
+
+// The rest of each module and the library symbols with #assembleall are linked, and the library symbols
+// they refer to, and the ones those refer to
+static void find_linked_sections(struct Linker *linker)
+{
+    int *stack = (int *)malloc(sizeof(int) * MAX(1, linker->sections_count));
+    int stack_size = 0;
+
+    for(int i = 0; i < linker->sections_count; i++)
+    {
+        if (linker->sections[i].keep)
+        {
+            linker->sections[i].linked = TRUE;
+            stack[stack_size++] = i;
+        }
+    }
+
+    while (stack_size > 0)
+    {
+        struct LinkedSection *section = &linker->sections[stack[--stack_size]];
+
+        for(int i = 0; i < section->references_count; i++)
+        {
+            struct LinkedReference *reference = &section->references[i];
+            struct ObjectSymbol *symbol = find_object_symbol(linker->symbols, linker->symbols_index, linker->symbols_index_capacity,
+                reference->library_name, reference->library_name_size, reference->name, reference->name_size);
+            if (symbol != NULL && symbol->section >= 0 && !linker->sections[symbol->section].linked)
+            {
+                linker->sections[symbol->section].linked = TRUE;
+                stack[stack_size++] = symbol->section;
+            }
+        }
+    }
+
+    free(stack);
+}
+
+static void free_linker(struct Linker *linker)
+{
+    for(int i = 0; i < linker->sections_count; i++)
+    {
+        free(linker->sections[i].elements);
+        free(linker->sections[i].references);
+    }
+    free(linker->sections);
+    free(linker->symbols);
+    free(linker->symbol_modules);
+    free(linker->symbols_index);
+    free(linker->generated_labels);
+    free(linker->first_generated_labels);
+}
+
+// Reads the object files and fills the tables and the output, placing the sections linked one after the other
+int load_object_files(char **filenames, int count)
+{
+    struct Linker linker;
+    memset(&linker, 0, sizeof(linker));
+    linker.filenames = filenames;
+    linker.first_generated_labels = (int *)calloc(count + 1, sizeof(int));
+
+    for(int i = 0; i < count; i++)
+    {
+        if (read_object_file(&linker, i))
+        {
+            free_linker(&linker);
+            return 1;
+        }
+    }
+
+    find_duplicated_sections(&linker);
+    if (index_linked_symbols(&linker))
+    {
+        free_linker(&linker);
+        return 1;
+    }
+    find_linked_sections(&linker);
+
+    int address = 0;
+    for(int i = 0; i < linker.sections_count; i++)
+    {
+        struct LinkedSection *section = &linker.sections[i];
+        if (!section->linked) { continue; }
+
+        section->address = address;
+        for(int j = 0; j < section->elements_count; j++)
+        {
+            struct LinkedElement *element = &section->elements[j];
+            if (element->flags & OBJECT_ELEMENT_FINAL)
+            {
+                address += element->size;
+            }
+            else if (element->node != NULL && element->node->type == NODE_TYPE_ORIGIN)
+            {
+                address = (int)element->node->children[0]->num_value;
+            }
+
+            add_linked_output_element(element->value, element->values, element->size, element->node,
+                (element->flags & OBJECT_ELEMENT_FINAL) != 0, (element->flags & OBJECT_ELEMENT_SET_ADDRESS) != 0);
+        }
+    }
+
+    for(int i = 0; i < linker.symbols_count; i++)
+    {
+        struct ObjectSymbol *symbol = &linker.symbols[i];
+        if (symbol->section >= 0 && !linker.sections[symbol->section].linked) { continue; }
+
+        set_constant(symbol->library_name, symbol->library_name_size, symbol->name, symbol->name_size,
+            symbol->section >= 0 ? linker.sections[symbol->section].address + symbol->value : symbol->value);
+    }
+
+    for(int i = 0; i < linker.generated_labels_count; i++)
+    {
+        struct ObjectGeneratedLabel *generated_label = &linker.generated_labels[i];
+        if (!linker.sections[generated_label->section].linked) { continue; }
+
+        set_generated_label(generated_label->label, (uint16_t)(linker.sections[generated_label->section].address + generated_label->offset));
+    }
+    context->new_label_count = linker.first_generated_labels[count];
+
+    free_linker(&linker);
+
+    return 0;
+}
@@ -445,7 +445,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // adc a, (ix +/- o)
             if (add_to_output)
@@ -459,7 +459,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // adc a, (iy +/- o)
             if (add_to_output)
@@ -476,7 +476,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         else if (is_op_operand1_register(node, "a") && is_op_operand2_register_type(node))
         {
             // adc a, r
-            if (is_op_operand2_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+            if (is_op_operand2_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -486,7 +486,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -496,7 +496,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -506,7 +506,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -529,7 +529,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         else if (is_op_operand1_register(node, "hl") && is_op_operand2_register_type(node))
         {
             // adc hl, r
-            if (is_op_operand2_register(node, "bc") && cpu_type != CPU_TYPE_GB)
+            if (is_op_operand2_register(node, "bc") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -539,7 +539,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "de") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "de") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -549,7 +549,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "hl") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "hl") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -559,7 +559,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "sp") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "sp") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -583,7 +583,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && (is_op_operand2_paren_index_register(node, "ix")) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && (is_op_operand2_paren_index_register(node, "ix")) && context->cpu_type != CPU_TYPE_GB)
         {
             // add a, (ix +/- o)
             if (add_to_output)
@@ -597,7 +597,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // add a, (iy +/- o)
             if (add_to_output)
@@ -624,6 +624,50 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
+        {
+            // add a, ixl
+            if (add_to_output)
+            {
+                add_output_element(0xDD, NULL);
+                add_output_element(0x80 + 5, NULL);
+            }
+            *length = 2;
+            return 0;
+        }
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
+        {
+            // add a, ixh
+            if (add_to_output)
+            {
+                add_output_element(0xDD, NULL);
+                add_output_element(0x80 + 4, NULL);
+            }
+            *length = 2;
+            return 0;
+        }
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
+        {
+            // add a, iyl
+            if (add_to_output)
+            {
+                add_output_element(0xFD, NULL);
+                add_output_element(0x80 + 5, NULL);
+            }
+            *length = 2;
+            return 0;
+        }
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
+        {
+            // add a, iyh
+            if (add_to_output)
+            {
+                add_output_element(0xFD, NULL);
+                add_output_element(0x80 + 4, NULL);
+            }
+            *length = 2;
+            return 0;
+        }
         else if (is_op_operand1_register(node, "a") && is_op_operand2_r_value(node))
         {
             // add a, r
@@ -674,7 +718,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ix") && is_op_operand2_register(node, "bc") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ix") && is_op_operand2_register(node, "bc") && context->cpu_type != CPU_TYPE_GB)
         {
             // add ix, bc
             if (add_to_output)
@@ -685,7 +729,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ix") && is_op_operand2_register(node, "de") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ix") && is_op_operand2_register(node, "de") && context->cpu_type != CPU_TYPE_GB)
         {
             // add ix, de
             if (add_to_output)
@@ -696,7 +740,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ix") && is_op_operand2_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ix") && is_op_operand2_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // add ix, ix
             if (add_to_output)
@@ -707,7 +751,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ix") && is_op_operand2_register(node, "sp") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ix") && is_op_operand2_register(node, "sp") && context->cpu_type != CPU_TYPE_GB)
         {
             // add ix, sp
             if (add_to_output)
@@ -718,7 +762,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iy") && is_op_operand2_register(node, "bc") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iy") && is_op_operand2_register(node, "bc") && context->cpu_type != CPU_TYPE_GB)
         {
             // add iy, bc
             if (add_to_output)
@@ -729,7 +773,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iy") && is_op_operand2_register(node, "de") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iy") && is_op_operand2_register(node, "de") && context->cpu_type != CPU_TYPE_GB)
         {
             // add iy, de
             if (add_to_output)
@@ -740,7 +784,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iy") && is_op_operand2_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iy") && is_op_operand2_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // add iy, iy
             if (add_to_output)
@@ -751,7 +795,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iy") && is_op_operand2_register(node, "sp") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iy") && is_op_operand2_register(node, "sp") && context->cpu_type != CPU_TYPE_GB)
         {
             // add iy, sp
             if (add_to_output)
@@ -762,7 +806,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "sp") && is_op_operand2_number(node) && cpu_type == CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "sp") && is_op_operand2_number(node) && context->cpu_type == CPU_TYPE_GB)
         {
             // add sp, n
             if (add_to_output)
@@ -788,7 +832,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // and (ix +/- o)
             if (add_to_output)
@@ -802,7 +846,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // and (iy +/- o)
             if (add_to_output)
@@ -839,7 +883,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
         {
             // and ixl
             if (add_to_output)
@@ -850,7 +894,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
         {
             // and ixh
             if (add_to_output)
@@ -861,7 +905,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
         {
             // and iyl
             if (add_to_output)
@@ -872,7 +916,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
         {
             // and iyh
             if (add_to_output)
@@ -913,7 +957,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // bit b, (ix +/- o)
             if (add_to_output)
@@ -944,7 +988,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // bit b, (iy +/- o)
             if (add_to_output)
@@ -1042,7 +1086,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_cond(node, "m") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_cond(node, "m") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -1081,7 +1125,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_cond(node, "p") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_cond(node, "p") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -1094,7 +1138,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_cond(node, "pe") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_cond(node, "pe") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -1107,7 +1151,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_cond(node, "po") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_cond(node, "po") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -1159,7 +1203,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "ix") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "ix") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // cp (ix +/- o)
             if (add_to_output)
@@ -1173,7 +1217,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "iy") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "iy") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // cp (iy +/- o)
             if (add_to_output)
@@ -1210,7 +1254,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixl") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixl") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // cp ixl
             if (add_to_output)
@@ -1221,7 +1265,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixh") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixh") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // cp ixh
             if (add_to_output)
@@ -1232,7 +1276,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyl") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyl") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // cp iyl
             if (add_to_output)
@@ -1243,7 +1287,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyh") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyh") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // cp iyh
             if (add_to_output)
@@ -1257,7 +1301,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     }
     else if (is_op_name(node, "cpd"))
     {
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -1270,7 +1314,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     }
     else if (is_op_name(node, "cpdr"))
     {
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -1283,7 +1327,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     }
     else if (is_op_name(node, "cpi"))
     {
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -1296,7 +1340,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     }
     else if (is_op_name(node, "cpir"))
     {
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -1343,7 +1387,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "ix") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "ix") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // dec (ix +/- o)
             if (add_to_output)
@@ -1357,7 +1401,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "iy") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "iy") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // dec (iy +/- o)
             if (add_to_output)
@@ -1461,7 +1505,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ix") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ix") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // dec ix
             if (add_to_output)
@@ -1472,7 +1516,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iy") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iy") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // dec iy
             if (add_to_output)
@@ -1483,7 +1527,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixl") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixl") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // dec ixl
             if (add_to_output)
@@ -1494,7 +1538,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixh") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixh") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // dec ixh
             if (add_to_output)
@@ -1505,7 +1549,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyl") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyl") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // dec iyl
             if (add_to_output)
@@ -1516,7 +1560,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyh") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyh") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // dec iyh
             if (add_to_output)
@@ -1561,7 +1605,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "djnz") && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "djnz") && context->cpu_type != CPU_TYPE_GB)
     {
         // djnz n
         if (is_op_operand1_number(node))
@@ -1590,9 +1634,9 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "ex") && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "ex") && context->cpu_type != CPU_TYPE_GB)
     {
-        if (is_op_operand1_paren_register(node, "sp") && is_op_operand2_register(node, "hl") && cpu_type != CPU_TYPE_GB)
+        if (is_op_operand1_paren_register(node, "sp") && is_op_operand2_register(node, "hl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ex (sp), hl
             if (add_to_output)
@@ -1602,7 +1646,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_paren_register(node, "sp") && is_op_operand2_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_register(node, "sp") && is_op_operand2_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ex (sp), ix
             if (add_to_output)
@@ -1613,7 +1657,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_paren_register(node, "sp") && is_op_operand2_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_register(node, "sp") && is_op_operand2_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ex (sp), iy
             if (add_to_output)
@@ -1624,7 +1668,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "af") && is_op_operand2_register(node, "af'") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "af") && is_op_operand2_register(node, "af'") && context->cpu_type != CPU_TYPE_GB)
         {
             // ex af, af'
             if (add_to_output)
@@ -1634,7 +1678,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "de") && is_op_operand2_register(node, "hl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "de") && is_op_operand2_register(node, "hl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ex de, hl'
             if (add_to_output)
@@ -1645,7 +1689,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "exx"))
+    else if (is_op_name(node, "exx") && context->cpu_type != CPU_TYPE_GB)
     {
         // exx
         if (get_op_operand_count(node) == 0)
@@ -1674,7 +1718,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     else if (is_op_name(node, "im"))
     {
         // im n
-        if (get_op_operand_count(node) == 1 && is_op_operand1_number(node) && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 1 && is_op_operand1_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -1700,7 +1744,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "in") && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "in") && context->cpu_type != CPU_TYPE_GB)
     {
         if (is_op_operand1_register(node, "a") && is_op_operand2_paren_register(node, "c"))
         {
@@ -1816,7 +1860,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "ix") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "ix") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // inc (ix +/- o)
             if (add_to_output)
@@ -1830,7 +1874,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "iy") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "iy") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // inc (iy +/- o)
             if (add_to_output)
@@ -1934,7 +1978,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ix") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ix") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // inc ix
             if (add_to_output)
@@ -1945,7 +1989,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iy") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iy") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // inc iy
             if (add_to_output)
@@ -1956,7 +2000,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixl") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixl") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // inc ixl
             if (add_to_output)
@@ -1967,7 +2011,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixh") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixh") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // inc ixh
             if (add_to_output)
@@ -1978,7 +2022,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyl") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyl") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // inc iyl
             if (add_to_output)
@@ -1989,7 +2033,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyh") && get_op_operand_count(node) == 1 && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyh") && get_op_operand_count(node) == 1 && context->cpu_type != CPU_TYPE_GB)
         {
             // inc iyh
             if (add_to_output)
@@ -2024,7 +2068,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     else if (is_op_name(node, "ind"))
     {
         // ind
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -2038,7 +2082,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     else if (is_op_name(node, "indr"))
     {
         // indr
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -2052,7 +2096,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     else if (is_op_name(node, "ini"))
     {
         // ini
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -2066,7 +2110,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     else if (is_op_name(node, "inir"))
     {
         // inir
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             if (add_to_output)
             {
@@ -2093,6 +2137,38 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_register(node, "hl"))
+        {
+            // jp (hl)
+            if (add_to_output)
+            {
+                add_output_element(0xE9, NULL);
+            }
+            *length = 1;
+            return 0;
+        }
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
+        {
+            // jp (ix)
+            if (add_to_output)
+            {
+                add_output_element(0xDD, NULL);
+                add_output_element(0xE9, NULL);
+            }
+            *length = 2;
+            return 0;
+        }
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
+        {
+            // jp (iy)
+            if (add_to_output)
+            {
+                add_output_element(0xFD, NULL);
+                add_output_element(0xE9, NULL);
+            }
+            *length = 2;
+            return 0;
+        }
         else if (is_op_operand1_cond(node, "z") && is_op_operand2_number(node))
         {
             // jp z, n
@@ -2149,7 +2225,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_cond(node, "p") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_cond(node, "p") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // jp p, n
             if (add_to_output)
@@ -2163,7 +2239,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_cond(node, "m") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_cond(node, "m") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // jp m, n
             if (add_to_output)
@@ -2177,7 +2253,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_cond(node, "pe") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_cond(node, "pe") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // jp pe, n
             if (add_to_output)
@@ -2191,7 +2267,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_cond(node, "po") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_cond(node, "po") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // jp po, n
             if (add_to_output)
@@ -2319,7 +2395,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "ix") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "ix") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld (ix +/- o), n
             if (add_to_output)
@@ -2336,7 +2412,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "ix") && is_op_operand2_r_value(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "ix") && is_op_operand2_r_value(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld (ix +/- o), r
             if (add_to_output)
@@ -2350,7 +2426,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "iy") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "iy") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld (iy +/- o), n
             if (add_to_output)
@@ -2367,7 +2443,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_paren_index_register(node, "iy") && is_op_operand2_r_value(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_index_register(node, "iy") && is_op_operand2_r_value(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld (iy +/- o), r
             if (add_to_output)
@@ -2386,7 +2462,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             // ld (n), a
             if (add_to_output)
             {
-                if (cpu_type == CPU_TYPE_GB)
+                if (context->cpu_type == CPU_TYPE_GB)
                 {
                     add_output_element(0xEA, NULL);
                 }
@@ -2402,7 +2478,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "bc") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "bc") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld (n), bc
             if (add_to_output)
@@ -2417,7 +2493,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "de") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "de") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld (n), de
             if (add_to_output)
@@ -2432,7 +2508,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "hl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "hl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld (n), hl
             if (add_to_output)
@@ -2446,7 +2522,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld (n), ix
             if (add_to_output)
@@ -2461,7 +2537,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_paren_number(node) && is_op_operand2_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld (n), iy
             if (add_to_output)
@@ -2482,7 +2558,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             // ld (n), sp
             if (add_to_output)
             {
-                if (cpu_type == CPU_TYPE_GB)
+                if (context->cpu_type == CPU_TYPE_GB)
                 {
                     add_output_element(0x08, NULL);
                 }
@@ -2496,7 +2572,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 add_output_element(0, exp_node);
                 add_output_element(0, NULL);
             }
-            *length = (cpu_type == CPU_TYPE_GB) ? 3 : 4;
+            *length = (context->cpu_type == CPU_TYPE_GB) ? 3 : 4;
             return 0;
         }
         else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_register(node, "bc"))
@@ -2529,7 +2605,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld a, (ix +/- o)
             if (add_to_output)
@@ -2543,7 +2619,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld a, (iy +/- o)
             if (add_to_output)
@@ -2562,7 +2638,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             // ld a, (n)
             if (add_to_output)
             {
-                if (cpu_type == CPU_TYPE_GB)
+                if (context->cpu_type == CPU_TYPE_GB)
                 {
                     add_output_element(0xFA, NULL);
                 }
@@ -2601,7 +2677,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld a, ixl
             if (add_to_output)
@@ -2612,7 +2688,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld a, ixh
             if (add_to_output)
@@ -2623,7 +2699,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld a, iyl
             if (add_to_output)
@@ -2634,7 +2710,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld a, iyh
             if (add_to_output)
@@ -2645,7 +2721,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "i") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "i") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld a, i
             if (add_to_output)
@@ -2656,7 +2732,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "r") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_register(node, "r") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld a, r
             if (add_to_output)
@@ -2667,7 +2743,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "b") && is_op_operand2_paren_register(node, "hl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "b") && is_op_operand2_paren_register(node, "hl"))
         {
             // ld b, (hl)
             if (add_to_output)
@@ -2677,7 +2753,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "b") && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "b") && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld b, (ix +/- o)
             if (add_to_output)
@@ -2691,7 +2767,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "b") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "b") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld b, (iy +/- o)
             if (add_to_output)
@@ -2728,7 +2804,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "b") && is_op_operand2_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "b") && is_op_operand2_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld b, ixl
             if (add_to_output)
@@ -2739,7 +2815,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "b") && is_op_operand2_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "b") && is_op_operand2_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld b, ixh
             if (add_to_output)
@@ -2750,7 +2826,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "b") && is_op_operand2_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "b") && is_op_operand2_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld b, iyl
             if (add_to_output)
@@ -2761,7 +2837,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "b") && is_op_operand2_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "b") && is_op_operand2_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld b, iyh
             if (add_to_output)
@@ -2772,7 +2848,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "bc") && is_op_operand2_paren_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "bc") && is_op_operand2_paren_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld bc, (n)
             if (add_to_output)
@@ -2811,7 +2887,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "c") && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "c") && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld c, (ix +/- o)
             if (add_to_output)
@@ -2825,7 +2901,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "c") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "c") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld c, (iy +/- o)
             if (add_to_output)
@@ -2862,7 +2938,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "c") && is_op_operand2_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "c") && is_op_operand2_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld c, ixl
             if (add_to_output)
@@ -2873,7 +2949,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "c") && is_op_operand2_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "c") && is_op_operand2_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld c, ixh
             if (add_to_output)
@@ -2884,7 +2960,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "c") && is_op_operand2_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "c") && is_op_operand2_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld c, iyl
             if (add_to_output)
@@ -2895,7 +2971,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "c") && is_op_operand2_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "c") && is_op_operand2_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld c, iyh
             if (add_to_output)
@@ -2916,7 +2992,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "d") && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "d") && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld d, (ix +/- o)
             if (add_to_output)
@@ -2930,7 +3006,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "d") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "d") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld d, (iy +/- o)
             if (add_to_output)
@@ -2967,7 +3043,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "d") && is_op_operand2_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "d") && is_op_operand2_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld d, ixl
             if (add_to_output)
@@ -2978,7 +3054,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "d") && is_op_operand2_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "d") && is_op_operand2_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld d, ixh
             if (add_to_output)
@@ -2989,7 +3065,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "d") && is_op_operand2_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "d") && is_op_operand2_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld d, iyl
             if (add_to_output)
@@ -3000,7 +3076,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "d") && is_op_operand2_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "d") && is_op_operand2_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld d, iyh
             if (add_to_output)
@@ -3011,7 +3087,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "de") && is_op_operand2_paren_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "de") && is_op_operand2_paren_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld de, (n)
             if (add_to_output)
@@ -3050,7 +3126,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "e") && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "e") && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld e, (ix +/- o)
             if (add_to_output)
@@ -3064,7 +3140,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "e") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "e") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld e, (iy +/- o)
             if (add_to_output)
@@ -3101,7 +3177,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "e") && is_op_operand2_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "e") && is_op_operand2_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld e, ixl
             if (add_to_output)
@@ -3112,7 +3188,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "e") && is_op_operand2_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "e") && is_op_operand2_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld e, ixh
             if (add_to_output)
@@ -3123,7 +3199,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "e") && is_op_operand2_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "e") && is_op_operand2_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld e, iyl
             if (add_to_output)
@@ -3134,7 +3210,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "e") && is_op_operand2_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "e") && is_op_operand2_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld e, iyh
             if (add_to_output)
@@ -3155,7 +3231,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "h") && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "h") && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld h, (ix +/- o)
             if (add_to_output)
@@ -3169,7 +3245,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "h") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "h") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld h, (iy +/- o)
             if (add_to_output)
@@ -3206,7 +3282,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "hl") && is_op_operand2_paren_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "hl") && is_op_operand2_paren_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld hl, (n)
             if (add_to_output)
@@ -3234,7 +3310,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "i") && is_op_operand2_register(node, "a") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "i") && is_op_operand2_register(node, "a") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld i, a
             if (add_to_output)
@@ -3245,7 +3321,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ix") && is_op_operand2_paren_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ix") && is_op_operand2_paren_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld ix, (n)
             if (add_to_output)
@@ -3260,7 +3336,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ix") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ix") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld ix, n
             if (add_to_output)
@@ -3275,7 +3351,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixh") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixh") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld ixh, n
             if (add_to_output)
@@ -3289,7 +3365,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixh") && is_op_operand2_p_value(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixh") && is_op_operand2_p_value(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld ixh, p
             if (add_to_output)
@@ -3300,7 +3376,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixl") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixl") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld ixl, n
             if (add_to_output)
@@ -3314,7 +3390,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "ixl") && is_op_operand2_p_value(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "ixl") && is_op_operand2_p_value(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld ixl, p
             if (add_to_output)
@@ -3325,7 +3401,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iy") && is_op_operand2_paren_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iy") && is_op_operand2_paren_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld iy, (n)
             if (add_to_output)
@@ -3340,7 +3416,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iy") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iy") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld iy, n
             if (add_to_output)
@@ -3355,7 +3431,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyh") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyh") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld iyh, n
             if (add_to_output)
@@ -3369,7 +3445,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyh") && is_op_operand2_q_value(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyh") && is_op_operand2_q_value(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld iyh, q
             if (add_to_output)
@@ -3380,7 +3456,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyl") && is_op_operand2_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyl") && is_op_operand2_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld iyl, n
             if (add_to_output)
@@ -3394,7 +3470,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "iyl") && is_op_operand2_q_value(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "iyl") && is_op_operand2_q_value(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld iyl, q
             if (add_to_output)
@@ -3415,7 +3491,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "l") && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "l") && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld l, (ix +/- o)
             if (add_to_output)
@@ -3429,7 +3505,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "l") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "l") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld l, (iy +/- o)
             if (add_to_output)
@@ -3466,7 +3542,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "r") && is_op_operand2_register(node, "a") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "r") && is_op_operand2_register(node, "a") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld r, a
             if (add_to_output)
@@ -3477,7 +3553,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "sp") && is_op_operand2_paren_number(node) && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "sp") && is_op_operand2_paren_number(node) && context->cpu_type != CPU_TYPE_GB)
         {
             // ld sp, (n)
             if (add_to_output)
@@ -3502,7 +3578,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand1_register(node, "sp") && is_op_operand2_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "sp") && is_op_operand2_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld sp, ix
             if (add_to_output)
@@ -3513,7 +3589,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "sp") && is_op_operand2_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "sp") && is_op_operand2_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // ld sp, iy
             if (add_to_output)
@@ -3538,7 +3614,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_register(node, "c"))
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_register(node, "c") && context->cpu_type == CPU_TYPE_GB)
         {
             // ld a, (c)
             if (add_to_output)
@@ -3548,7 +3624,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (is_op_operand2_register(node, "a") && is_op_operand1_paren_register(node, "c"))
+        else if (is_op_operand2_register(node, "a") && is_op_operand1_paren_register(node, "c") && context->cpu_type == CPU_TYPE_GB)
         {
             // ld (c), a
             if (add_to_output)
@@ -3561,7 +3637,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     }
     else if (is_op_name(node, "ldd"))
     {
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             // ldd
             if (add_to_output)
@@ -3572,28 +3648,28 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if(is_op_operand1_paren_register(node, "hl") && is_op_operand2_register(node, "a") && cpu_type == CPU_TYPE_GB)
+        else if(is_op_operand1_paren_register(node, "hl") && is_op_operand2_register(node, "a") && context->cpu_type == CPU_TYPE_GB)
         {
             // ldd (hl), a
             if (add_to_output)
             {
                 add_output_element(0x32, NULL);
             }
-            *length = 2;
+            *length = 1;
             return 0;
         }
-        else if(is_op_operand2_paren_register(node, "hl") && is_op_operand1_register(node, "a") && cpu_type == CPU_TYPE_GB)
+        else if(is_op_operand2_paren_register(node, "hl") && is_op_operand1_register(node, "a") && context->cpu_type == CPU_TYPE_GB)
         {
             // ldd a, (hl)
             if (add_to_output)
             {
                 add_output_element(0x3A, NULL);
             }
-            *length = 2;
+            *length = 1;
             return 0;
         }
     }
-    else if (is_op_name(node, "lddr") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "lddr") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         if (add_to_output)
         {
@@ -3603,7 +3679,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         *length = 2;
         return 0;
     }
-    else if (is_op_name(node, "ldh") && cpu_type == CPU_TYPE_GB)
+    else if (is_op_name(node, "ldh") && context->cpu_type == CPU_TYPE_GB)
     {
         if (is_op_operand1_register(node, "a") && is_op_operand2_paren_number(node))
         {
@@ -3638,20 +3714,17 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "ldhl") && cpu_type == CPU_TYPE_GB)
+    else if (is_op_name(node, "ldhl") && context->cpu_type == CPU_TYPE_GB)
     {
         if (is_op_operand1_register(node, "sp") && is_op_operand2_number(node))
         {
-            // ldh sp, n
+            // ldhl sp, n
             if (add_to_output)
             {
                 add_output_element(0xF8, NULL);
-                struct ASTNode *exp_node = get_op_operand1_paren_number(node);
-                exp_node->type = NODE_TYPE_EXPRESSION_16;
-                struct ASTNode *gb_node = create_node(NODE_TYPE_GB_IO_HI_RAM, NULL);
-                gb_node->children_count = 1;
-                gb_node->children[0] = exp_node;
-                add_output_element(0, gb_node);
+                struct ASTNode *exp_node = get_op_operand2_number(node);
+                exp_node->type = NODE_TYPE_EXPRESSION_8;
+                add_output_element(0, exp_node);
             }
             *length = 2;
             return 0;
@@ -3659,7 +3732,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
     }
     else if (is_op_name(node, "ldi"))
     {
-        if (get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+        if (get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
         {
             // ldi
             if (add_to_output)
@@ -3670,28 +3743,28 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if(is_op_operand1_paren_register(node, "hl") && is_op_operand2_register(node, "a") && cpu_type == CPU_TYPE_GB)
+        else if(is_op_operand1_paren_register(node, "hl") && is_op_operand2_register(node, "a") && context->cpu_type == CPU_TYPE_GB)
         {
             // ldi (hl), a
             if (add_to_output)
             {
                 add_output_element(0x22, NULL);
             }
-            *length = 2;
+            *length = 1;
             return 0;
         }
-        else if(is_op_operand2_paren_register(node, "hl") && is_op_operand1_register(node, "a") && cpu_type == CPU_TYPE_GB)
+        else if(is_op_operand2_paren_register(node, "hl") && is_op_operand1_register(node, "a") && context->cpu_type == CPU_TYPE_GB)
         {
             // ldi a, (hl)
             if (add_to_output)
             {
                 add_output_element(0x2A, NULL);
             }
-            *length = 2;
+            *length = 1;
             return 0;
         }
     }
-    else if (is_op_name(node, "ldir") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "ldir") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         if (add_to_output)
         {
@@ -3701,7 +3774,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         *length = 2;
         return 0;
     }
-    else if (is_op_name(node, "mulub") && cpu_type == CPU_TYPE_MSX)
+    else if (is_op_name(node, "mulub") && context->cpu_type == CPU_TYPE_MSX)
     {
         if (is_op_operand1_register(node, "a") && is_op_operand2_r_value(node))
         {
@@ -3709,26 +3782,13 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             if (add_to_output)
             {
                 add_output_element(0xED, NULL);
-                struct ASTNode *exp_node = create_node_str(NODE_TYPE_EXPRESSION_8, NULL, "+", 1);
-                exp_node->children_count = 2;
-                exp_node->children[0] = create_node_str(NODE_TYPE_EXPRESSION, NULL, "+", 1);
-                exp_node->children[0]->children_count = 2;
-                exp_node->children[0]->children[0] = create_node_num(NODE_TYPE_EXPRESSION, NULL, 0xC1);
-                exp_node->children[0]->children[1] = create_node_str(NODE_TYPE_EXPRESSION, NULL, "*", 1);
-                exp_node->children[0]->children[1]->children_count = 2;
-                exp_node->children[0]->children[1]->children[0] = create_node_num(NODE_TYPE_EXPRESSION, NULL, 8);
-                exp_node->children[0]->children[1]->children[1] = get_op_operand1_number(node);
-                exp_node->children[0]->children[1]->children[1]->type = NODE_TYPE_EXPRESSION_3;
-                exp_node->children[1] = create_node(NODE_TYPE_EXPRESSION, NULL);
-                exp_node->children[1]->str_size = 0;
-                exp_node->children[1]->num_value = get_op_operand2_r_value(node);
-                add_output_element(0, exp_node);
+                add_output_element(0xC1 + 8 * get_op_operand2_r_value(node), NULL);
             }
             *length = 2;
             return 0;
         }
     }
-    else if (is_op_name(node, "muluw") && cpu_type == CPU_TYPE_MSX)
+    else if (is_op_name(node, "muluw") && context->cpu_type == CPU_TYPE_MSX)
     {
         if (is_op_operand1_register(node, "hl") && is_op_operand2_register(node, "bc"))
         {
@@ -3743,7 +3803,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         }
         else if (is_op_operand1_register(node, "hl") && is_op_operand2_register(node, "sp"))
         {
-            // muluw hl, bc
+            // muluw hl, sp
             if (add_to_output)
             {
                 add_output_element(0xED, NULL);
@@ -3753,7 +3813,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "neg") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "neg") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         if (add_to_output)
         {
@@ -3784,7 +3844,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // or (ix +/- o)
             if (add_to_output)
@@ -3798,7 +3858,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // or (iy +/- o)
             if (add_to_output)
@@ -3835,7 +3895,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
         {
             // or ixl
             if (add_to_output)
@@ -3846,7 +3906,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
         {
             // or ixh
             if (add_to_output)
@@ -3857,7 +3917,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
         {
             // or iyl
             if (add_to_output)
@@ -3868,7 +3928,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
         {
             // or iyh
             if (add_to_output)
@@ -3880,7 +3940,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "otdr") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "otdr") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         // otdr
         if (add_to_output)
@@ -3891,7 +3951,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         *length = 2;
         return 0;
     }
-    else if (is_op_name(node, "otir") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "otir") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         // otdr
         if (add_to_output)
@@ -3902,7 +3962,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         *length = 2;
         return 0;
     }
-    else if (is_op_name(node, "out") && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "out") && context->cpu_type != CPU_TYPE_GB)
     {
         if (is_op_operand2_register(node, "a") && is_op_operand1_paren_register(node, "c"))
         {
@@ -3995,7 +4055,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "outd") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "outd") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         // outd
         if (add_to_output)
@@ -4006,7 +4066,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         *length = 2;
         return 0;
     }
-    else if (is_op_name(node, "outi") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "outi") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         // outi
         if (add_to_output)
@@ -4059,7 +4119,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // pop ix
             if (add_to_output)
@@ -4070,7 +4130,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // pop iy
             if (add_to_output)
@@ -4124,7 +4184,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // push ix
             if (add_to_output)
@@ -4135,7 +4195,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // push iy
             if (add_to_output)
@@ -4168,7 +4228,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // res n, (ix +/- o)
             if (add_to_output)
@@ -4191,7 +4251,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // res n, (iy +/- o)
             if (add_to_output)
@@ -4261,7 +4321,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_cond(node, "m") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_cond(node, "m") && context->cpu_type != CPU_TYPE_GB)
         {
             // ret m
             if (add_to_output)
@@ -4291,7 +4351,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_cond(node, "p") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_cond(node, "p") && context->cpu_type != CPU_TYPE_GB)
         {
             // ret p
             if (add_to_output)
@@ -4301,7 +4361,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_cond(node, "pe") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_cond(node, "pe") && context->cpu_type != CPU_TYPE_GB)
         {
             // ret pe
             if (add_to_output)
@@ -4311,7 +4371,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_cond(node, "po") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_cond(node, "po") && context->cpu_type != CPU_TYPE_GB)
         {
             // ret po
             if (add_to_output)
@@ -4337,7 +4397,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         // reti
         if (add_to_output)
         {
-            if (cpu_type == CPU_TYPE_GB)
+            if (context->cpu_type == CPU_TYPE_GB)
             {
                 add_output_element(0xD9, NULL);
             }
@@ -4347,10 +4407,10 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 add_output_element(0x4D, NULL);
             }
         }
-        *length = (cpu_type == CPU_TYPE_GB) ? 1 : 2;
+        *length = (context->cpu_type == CPU_TYPE_GB) ? 1 : 2;
         return 0;
     }
-    else if (is_op_name(node, "retn") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "retn") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         // retn
         if (add_to_output)
@@ -4374,7 +4434,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // rl (ix +/- o)
             if (add_to_output)
@@ -4389,7 +4449,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // rl (iy +/- o)
             if (add_to_output)
@@ -4439,7 +4499,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // rlc (ix +/- o)
             if (add_to_output)
@@ -4454,7 +4514,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // rlc (iy +/- o)
             if (add_to_output)
@@ -4491,7 +4551,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         *length = 1;
         return 0;
     }
-    else if (is_op_name(node, "rld") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "rld") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         // rld
         if (add_to_output)
@@ -4515,7 +4575,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // rr (ix +/- o)
             if (add_to_output)
@@ -4530,7 +4590,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // rr (iy +/- o)
             if (add_to_output)
@@ -4580,7 +4640,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // rrc (ix +/- o)
             if (add_to_output)
@@ -4595,7 +4655,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // rrc (iy +/- o)
             if (add_to_output)
@@ -4632,7 +4692,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         *length = 1;
         return 0;
     }
-    else if (is_op_name(node, "rrd") && get_op_operand_count(node) == 0 && cpu_type != CPU_TYPE_GB)
+    else if (is_op_name(node, "rrd") && get_op_operand_count(node) == 0 && context->cpu_type != CPU_TYPE_GB)
     {
         // rrd
         if (add_to_output)
@@ -4698,7 +4758,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // sbc a, (ix +/- o)
             if (add_to_output)
@@ -4712,7 +4772,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (is_op_operand1_register(node, "a") && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // sbc a, (iy +/- o)
             if (add_to_output)
@@ -4729,7 +4789,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         else if (get_op_operand_count(node) == 2 && is_op_operand1_register(node, "a") && is_op_operand2_register_type(node))
         {
             // sbc a, r
-            if (is_op_operand2_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+            if (is_op_operand2_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -4739,7 +4799,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -4749,7 +4809,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -4759,7 +4819,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -4782,7 +4842,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
         else if (get_op_operand_count(node) == 2 && is_op_operand1_register(node, "hl") && is_op_operand2_register_type(node))
         {
             // sbc hl, r
-            if (is_op_operand2_register(node, "bc") && cpu_type != CPU_TYPE_GB)
+            if (is_op_operand2_register(node, "bc") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -4792,7 +4852,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "de") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "de") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -4802,7 +4862,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "hl") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "hl") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -4812,7 +4872,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
                 *length = 2;
                 return 0;
             }
-            else if (is_op_operand2_register(node, "sp") && cpu_type != CPU_TYPE_GB)
+            else if (is_op_operand2_register(node, "sp") && context->cpu_type != CPU_TYPE_GB)
             {
                 if (add_to_output)
                 {
@@ -4855,7 +4915,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 2 && is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "ix"))
+        else if (get_op_operand_count(node) == 2 && is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // set n, (ix +/- o)
             if (add_to_output)
@@ -4878,7 +4938,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (get_op_operand_count(node) == 2 && is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "iy"))
+        else if (get_op_operand_count(node) == 2 && is_op_operand1_number(node) && is_op_operand2_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // set n, (iy +/- o)
             if (add_to_output)
@@ -4937,7 +4997,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // sla (ix +/- o)
             if (add_to_output)
@@ -4952,7 +5012,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // sla (iy +/- o)
             if (add_to_output)
@@ -4979,7 +5039,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "sll") && cpu_type == CPU_TYPE_Z80)
+    else if (is_op_name(node, "sll") && context->cpu_type == CPU_TYPE_Z80)
     {
         if (get_op_operand_count(node) == 1 && is_op_operand1_paren_register(node, "hl"))
         {
@@ -4992,7 +5052,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // sll (ix +/- o)
             if (add_to_output)
@@ -5007,7 +5067,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // sll (iy +/- o)
             if (add_to_output)
@@ -5047,7 +5107,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // sra (ix +/- o)
             if (add_to_output)
@@ -5062,7 +5122,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // sra (iy +/- o)
             if (add_to_output)
@@ -5102,7 +5162,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // srl (ix +/- o)
             if (add_to_output)
@@ -5117,7 +5177,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 4;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // srl (iy +/- o)
             if (add_to_output)
@@ -5144,11 +5204,18 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "stop") && cpu_type == CPU_TYPE_GB)
+    else if (is_op_name(node, "stop") && context->cpu_type == CPU_TYPE_GB)
     {
         if (get_op_operand_count(node) == 0)
         {
-            add_output_element(0x10, NULL);
+            // stop
+            if (add_to_output)
+            {
+                add_output_element(0x10, NULL);
+                add_output_element(0x00, NULL);
+            }
+            *length = 2;
+            return 0;
         }
     }
     else if (is_op_name(node, "sub"))
@@ -5163,7 +5230,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // sub (ix +/- o)
             if (add_to_output)
@@ -5177,7 +5244,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // sub (iy +/- o)
             if (add_to_output)
@@ -5214,7 +5281,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
         {
             // sub ixl
             if (add_to_output)
@@ -5225,7 +5292,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
         {
             // sub ixh
             if (add_to_output)
@@ -5236,7 +5303,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
         {
             // sub iyl
             if (add_to_output)
@@ -5247,7 +5314,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
         {
             // sub iyh
             if (add_to_output)
@@ -5259,7 +5326,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             return 0;
         }
     }
-    else if (is_op_name(node, "swap") && cpu_type == CPU_TYPE_GB)
+    else if (is_op_name(node, "swap") && context->cpu_type == CPU_TYPE_GB)
     {
         if (get_op_operand_count(node) == 1 && is_op_operand1_paren_register(node, "hl"))
         {
@@ -5296,7 +5363,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "ix") && context->cpu_type != CPU_TYPE_GB)
         {
             // xor (ix +/- o)
             if (add_to_output)
@@ -5310,7 +5377,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 3;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_paren_index_register(node, "iy") && context->cpu_type != CPU_TYPE_GB)
         {
             // xor (iy +/- o)
             if (add_to_output)
@@ -5347,7 +5414,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 1;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixl") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixl") && context->cpu_type != CPU_TYPE_GB)
         {
             // xor ixl
             if (add_to_output)
@@ -5358,7 +5425,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixh") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "ixh") && context->cpu_type != CPU_TYPE_GB)
         {
             // xor ixh
             if (add_to_output)
@@ -5369,7 +5436,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyl") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyl") && context->cpu_type != CPU_TYPE_GB)
         {
             // xor iyl
             if (add_to_output)
@@ -5380,7 +5447,7 @@ int compile_op(struct ASTNode *node, BOOL add_to_output, int *length)
             *length = 2;
             return 0;
         }
-        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyh") && cpu_type != CPU_TYPE_GB)
+        else if (get_op_operand_count(node) == 1 && is_op_operand1_register(node, "iyh") && context->cpu_type != CPU_TYPE_GB)
         {
             // xor iyh
             if (add_to_output)
@@ -5436,7 +5503,11 @@ void fprint_operand_node(FILE *fp, struct ASTNode *node, BOOL top_node)
         {
             if (node->children_count == 0)
             {
-                if (node->str_size > 0)
+                if (is_str_equal(node->str_value, node->str_size, "@"))
+                {
+                    fprintf(fp, "@l_%"PRId64"", node->num_value);
+                }
+                else if (node->str_size > 0)
                 {
                     if (node->str_size2 > 0)
                     {
@@ -26,16 +26,26 @@
 
 #include "z80hla.h"
 
-static BOOL in_library = FALSE;
-static char *current_library_name = NULL;
-static int current_library_name_size = 0;
-static BOOL in_symbol = FALSE;
-static char *current_symbol_name = NULL;
-static int current_symbol_name_size = 0;
+// Included files can be parsed at the same time in different threads
+static THREAD_LOCAL BOOL in_library = FALSE;
+static THREAD_LOCAL char *current_library_name = NULL;
+static THREAD_LOCAL int current_library_name_size = 0;
+static THREAD_LOCAL BOOL in_symbol = FALSE;
+static THREAD_LOCAL char *current_symbol_name = NULL;
+static THREAD_LOCAL int current_symbol_name_size = 0;
+
+// Clears what a compilation that stopped with an error may have left in this thread
+void init_parser()
+{
+    in_library = in_symbol = FALSE;
+    current_library_name = current_symbol_name = NULL;
+    current_library_name_size = current_symbol_name_size = 0;
+}
 
 struct ASTNode *create_node(enum NodeType type, struct Lexer *lexer)
 {
-    struct ASTNode *node = (struct ASTNode *)malloc(sizeof(struct ASTNode));
+    struct ASTNode *node = (struct ASTNode *)allocate_context_memory(sizeof(struct ASTNode));
+    COUNT_STAT(nodes_created[type]);
     node->type = type;
     node->children[0] = NULL;
     node->children[1] = NULL;
@@ -98,7 +108,8 @@ struct ASTNode *create_node_num2(enum NodeType type, struct Lexer *lexer, int64_
 
 struct ASTNode *duplicate_node(struct ASTNode *node_to_duplicate)
 {
-    struct ASTNode *node = (struct ASTNode *)malloc(sizeof(struct ASTNode));
+    struct ASTNode *node = (struct ASTNode *)allocate_context_memory(sizeof(struct ASTNode));
+    COUNT_STAT(nodes_duplicated[node_to_duplicate->type]);
     node->type = node_to_duplicate->type;
     for (int i = 0; i < MAX_AST_NODE_CHILDREN; i++)
     {
@@ -117,6 +128,33 @@ struct ASTNode *duplicate_node(struct ASTNode *node_to_duplicate)
     return node;
 }
 
+// Copies a node and all the nodes under it, the last child is followed in a loop as it can be a long list
+struct ASTNode *duplicate_node_deep(struct ASTNode *node_to_duplicate)
+{
+    struct ASTNode *first_node = NULL, **node_slot = &first_node;
+
+    while (node_to_duplicate != NULL)
+    {
+        struct ASTNode *node = duplicate_node(node_to_duplicate);
+        *node_slot = node;
+
+        if (node->children_count == 0) { break; }
+
+        for(int i = 0; i < node->children_count - 1; i++)
+        {
+            if (node->children[i] != NULL)
+            {
+                node->children[i] = duplicate_node_deep(node->children[i]);
+            }
+        }
+
+        node_slot = &node->children[node->children_count - 1];
+        node_to_duplicate = node_to_duplicate->children[node->children_count - 1];
+    }
+
+    return first_node;
+}
+
 struct ASTNode *duplicate_node_and_replace_deep(struct ASTNode *node_to_duplicate, struct InlineSymbol *inline_symbol, struct ASTNode *node_arguments)
 {
     assert(node_to_duplicate != NULL);
@@ -196,6 +234,7 @@ char *node_type_names[] = {
     "NODE_TYPE_DATA_VALUE",
     "NODE_TYPE_DATA_SIZE",
     "NODE_TYPE_DATA_FROM",
+    "NODE_TYPE_DATA_PACKED",
     "NODE_TYPE_CONST",
     "NODE_TYPE_STRUCT",
     "NODE_TYPE_STRUCT_ELEMENT",
@@ -227,7 +266,8 @@ char *node_type_names[] = {
     "NODE_TYPE_ARGUMENT",
     "NODE_TYPE_CONTINUE",
     "NODE_TYPE_CONTINUEIF",
-    "NODE_TYPE_GB_IO_HI_RAM"
+    "NODE_TYPE_GB_IO_HI_RAM",
+    "NODE_TYPE_GENERATED_LABEL"
 };
 
 void fprint_ast(FILE *fp, struct ASTNode *node)
@@ -241,7 +281,7 @@ void fprint_ast(FILE *fp, struct ASTNode *node)
     fprintf(fp, "{\"type\": \"%s\",", node_type_names[node->type]);
     fprintf(fp, "\"filename\": \"%s\",", (node->filename == NULL ? "(N/A)" : node->filename));
     fprintf(fp, "\"file_line\": \"%d\",", node->file_line);
-    fprintf(fp, "\"str_value\": \"%.*s\",", node->str_size, node->str_value);
+    fprintf(fp, "\"str_value\": \"%.*s\",", node->type == NODE_TYPE_DATA_PACKED ? 0 : node->str_size, node->str_value);
     fprintf(fp, "\"str_value2\": \"%.*s\",", node->str_size2, node->str_value2);
     fprintf(fp, "\"num_value\": %"PRId64",", node->num_value);
     fprintf(fp, "\"num_value2\": %"PRId64",", node->num_value2);
@@ -1995,8 +2035,9 @@ static int parse_data_init(struct Lexer *lexer, struct ASTNode **expression_node
     }
     else if (token.type == TOKEN_TYPE_STRING)
     {
+        // The string is taken from the token read and not the one peeked, escape characters are only replaced when read
+        if (get_next_token(lexer, &token, FALSE)) { return 1; }
         *expression_node = create_node_str(NODE_TYPE_STRING, lexer, token.value, token.size);
-        get_next_token(lexer, &token, FALSE);
     }
     else
     {
@@ -2011,6 +2052,63 @@ static int parse_data_init(struct Lexer *lexer, struct ASTNode **expression_node
     return 0;
 }
 
+// Literals and strings of native type data are packed at parse time into the bytes they produce
+static BOOL pack_data_value(struct ASTNode *packed_node, int *packed_capacity, struct ASTNode *expression_node, int size_of_type)
+{
+    int64_t value = 0;
+    int size = size_of_type;
+
+    if (expression_node->type == NODE_TYPE_STRING)
+    {
+        if (size_of_type != 1) { return FALSE; }
+        size = expression_node->str_size;
+    }
+    else if (is_node_literal(expression_node))
+    {
+        value = expression_node->num_value;
+        if ((size_of_type == 1 && (value > UINT8_MAX || value < INT8_MIN)) ||
+            (size_of_type == 2 && (value > UINT16_MAX || value < INT16_MIN)) ||
+            (size_of_type == 4 && (value > UINT32_MAX || value < INT32_MIN)))
+        {
+            // Left as an expression so the error is reported when compiling
+            return FALSE;
+        }
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    if (packed_node->str_size + size > *packed_capacity)
+    {
+        *packed_capacity = MAX(*packed_capacity * 2, packed_node->str_size + size);
+        char *packed_bytes = (char *)allocate_context_memory(*packed_capacity);
+        if (packed_node->str_size > 0)
+        {
+            memcpy(packed_bytes, packed_node->str_value, packed_node->str_size);
+        }
+        packed_node->str_value = packed_bytes;
+    }
+
+    uint8_t *bytes = (uint8_t *)packed_node->str_value + packed_node->str_size;
+    if (expression_node->type == NODE_TYPE_STRING)
+    {
+        memcpy(bytes, expression_node->str_value, size);
+        packed_node->num_value += size;
+    }
+    else
+    {
+        for(int i = 0; i < size; i++)
+        {
+            bytes[i] = (value >> (i * 8)) & 0xFF;
+        }
+        packed_node->num_value++;
+    }
+    packed_node->str_size += size;
+
+    return TRUE;
+}
+
 static int parse_data(struct Lexer *lexer, struct ASTNode *data_node)
 {
     struct Token token;
@@ -2073,24 +2171,53 @@ static int parse_data(struct Lexer *lexer, struct ASTNode *data_node)
     {
         // Initialized data
         struct ASTNode *expression_node = NULL, *data_value_node = NULL, *last_data_value_node = NULL;
+        struct ASTNode *packed_node = NULL;
+        int packed_capacity = 0;
+        int size_of_type = data_type_node->str_size2 == 0 ? get_native_type_size(data_type_node->str_value, data_type_node->str_size) : -1;
         do
         {
             if (parse_data_init(lexer, &expression_node)) { return 1; }
 
-            data_value_node = create_node(NODE_TYPE_DATA_VALUE, lexer);
-            data_value_node->children_count = 2;
-            data_value_node->children[0] = expression_node;
-            data_value_node->children[1] = NULL;
-
-            if (last_data_value_node != NULL)
+            if (size_of_type > 0 && packed_node != NULL && pack_data_value(packed_node, &packed_capacity, expression_node, size_of_type))
             {
-                last_data_value_node->children[1] = data_value_node;
+                expression_node = NULL;
+            }
+            else if (size_of_type > 0 && (expression_node->type == NODE_TYPE_STRING || is_node_literal(expression_node)))
+            {
+                packed_node = create_node(NODE_TYPE_DATA_PACKED, lexer);
+                packed_node->num_value2 = size_of_type;
+                packed_capacity = 0;
+                if (pack_data_value(packed_node, &packed_capacity, expression_node, size_of_type))
+                {
+                    expression_node = packed_node;
+                }
+                else
+                {
+                    packed_node = NULL;
+                }
             }
             else
             {
-                data_node->children[1] = data_value_node;
+                packed_node = NULL;
+            }
+
+            if (expression_node != NULL)
+            {
+                data_value_node = create_node(NODE_TYPE_DATA_VALUE, lexer);
+                data_value_node->children_count = 2;
+                data_value_node->children[0] = expression_node;
+                data_value_node->children[1] = NULL;
+
+                if (last_data_value_node != NULL)
+                {
+                    last_data_value_node->children[1] = data_value_node;
+                }
+                else
+                {
+                    data_node->children[1] = data_value_node;
+                }
+                last_data_value_node = data_value_node;
             }
-            last_data_value_node = data_value_node;
 
             if (get_next_token(lexer, &token, FALSE)) { return 1; }
             if (token.type == TOKEN_TYPE_NEWLINE)
@@ -2523,7 +2650,695 @@ static int parse_struct(struct Lexer *lexer, struct ASTNode *struct_node, BOOL w
     return 1;
 }
 
-struct ASTNode *parse(struct Lexer *lexer, struct ASTNode *parent_node, struct ASTNode **last_node)
+// *************
+// Included files parsed in parallel
+// *************
+
+// An included file found before parsing, it is parsed by a worker thread and spliced after
+struct IncludeJob
+{
+    char *filename;
+    char *content;
+
+    int parent; // job including this file, -1 for the main file
+    char *include_filename;
+    int include_line;
+    char *include_name;
+    BOOL reached; // set when the parser of the including file gets to the #include
+
+    struct ASTNode *first_node, *last_node;
+    char *messages; // written while parsing, held until the files are reported in order
+};
+
+static int find_include_job(char *filename)
+{
+    for(int i = 0; i < context->include_jobs_count; i++)
+    {
+        if (!strcmp(context->include_jobs[i].filename, filename))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+#define SCAN_IFDEF_MAX  64
+
+enum ScanIfdefResult
+{
+    SCAN_IFDEF_END,
+    SCAN_IFDEF_ELSE,
+    SCAN_IFDEF_ENDIF
+};
+
+// Moves to the next directive following the lexer rules, comments are not skipped inside a false #ifdef.
+// With with_from the keyword "from" of data statements is also found.
+static BOOL scan_next_directive(char **at, int *line, BOOL skipping, BOOL with_from, char **word, int *word_size)
+{
+    char *c = *at;
+
+    while (c[0] != 0)
+    {
+        if (c[0] == '\n')
+        {
+            (*line)++;
+            c++;
+        }
+        else if (!skipping && (c[0] == ';' || (c[0] == '/' && c[1] == '/')))
+        {
+            while (c[0] != '\n' && c[0] != 0) { c++; }
+        }
+        else if (!skipping && c[0] == '/' && c[1] == '*')
+        {
+            while (!(c[0] == '*' && c[1] == '/') && c[0] != 0)
+            {
+                if (c[0] == '\n') { (*line)++; }
+                c++;
+            }
+            if (c[0] == '*') { c += 2; }
+        }
+        else if (c[0] == '"')
+        {
+            do
+            {
+                if (c[0] == '\\' && c[1] != 0) { c++; }
+                c++;
+            } while (c[0] != '"' && c[0] != '\n' && c[0] != 0);
+            if (c[0] != '"') { return FALSE; }
+            c++;
+        }
+        else if (c[0] == '\'')
+        {
+            int size = (c[1] == '\\' ? 4 : 3);
+            if (c[1] == 0 || c[2] == 0 || c[size - 1] != '\'') { return FALSE; }
+            c += size;
+        }
+        else if (isalpha((unsigned char)c[0]) || c[0] == '_')
+        {
+            char *start = c;
+            while (isalnum((unsigned char)c[0]) || c[0] == '_') { c++; }
+            if (c[0] == '\'' && c - start == 2 && start[0] == 'a' && start[1] == 'f') { c++; }
+            if (with_from && is_str_equal(start, (int)(c - start), "from"))
+            {
+                *word = start;
+                *word_size = 4;
+                *at = c;
+                return TRUE;
+            }
+        }
+        else if (c[0] == '#')
+        {
+            *word = c;
+            do
+            {
+                c++;
+            } while (isalnum((unsigned char)c[0]) || c[0] == '_');
+            *word_size = (int)(c - *word);
+            *at = c;
+            return TRUE;
+        }
+        else
+        {
+            c++;
+        }
+    }
+
+    *at = c;
+    return FALSE;
+}
+
+// Reads the string with a file name after a directive, NULL if it's not a plain string
+static char *scan_file_name(char **at, int *line)
+{
+    char *c = *at;
+
+    while (c[0] == ' ' || c[0] == '\t' || c[0] == '\r' || c[0] == '\n')
+    {
+        if (c[0] == '\n') { (*line)++; }
+        c++;
+    }
+    if (c[0] != '"') { return NULL; }
+
+    char *name_start = ++c;
+    while (c[0] != '"' && c[0] != '\\' && c[0] != '\n' && c[0] != 0) { c++; }
+    if (c[0] != '"') { return NULL; }
+
+    int name_size = (int)(c - name_start);
+    *at = c + 1;
+
+    char *name = (char*)malloc((size_t)name_size + 1);
+    memcpy(name, name_start, (size_t)name_size);
+    name[name_size] = 0;
+
+    return name;
+}
+
+// Skips the lines of a false #ifdef until its #else or #endif
+static enum ScanIfdefResult scan_skip_ifdef(char **at, int *line, BOOL break_on_else)
+{
+    int nested_ifdefs = 0;
+    char *word;
+    int word_size;
+
+    while (scan_next_directive(at, line, TRUE, FALSE, &word, &word_size))
+    {
+        if (is_str_equal(word, word_size, "#ifdef") || is_str_equal(word, word_size, "#ifndef"))
+        {
+            nested_ifdefs++;
+        }
+        else if (is_str_equal(word, word_size, "#endif"))
+        {
+            if (nested_ifdefs == 0)
+            {
+                return SCAN_IFDEF_ENDIF;
+            }
+            nested_ifdefs--;
+        }
+        else if (is_str_equal(word, word_size, "#else") && nested_ifdefs == 0 && break_on_else)
+        {
+            return SCAN_IFDEF_ELSE;
+        }
+    }
+
+    return SCAN_IFDEF_END;
+}
+
+// Finds the files included by a file without parsing it.
+// Returns FALSE if they can't be parsed apart from the file that includes them, when a #define
+// can change what is included, a file is included more than once or anything unexpected is found.
+static BOOL scan_includes(char *filename, char *content, int parent, int depth)
+{
+    char *at = content, *word;
+    int line = 1, word_size;
+    enum ScanIfdefResult ifdef_expect[SCAN_IFDEF_MAX];
+    int ifdef_count = 0;
+
+    while (scan_next_directive(&at, &line, FALSE, FALSE, &word, &word_size))
+    {
+        if (is_str_equal(word, word_size, "#define"))
+        {
+            return FALSE;
+        }
+        else if (is_str_equal(word, word_size, "#ifdef") || is_str_equal(word, word_size, "#ifndef"))
+        {
+            BOOL check_defined = is_str_equal(word, word_size, "#ifdef");
+
+            while (at[0] == ' ' || at[0] == '\t' || at[0] == '\r') { at++; }
+            char *identifier = at;
+            while (isalnum((unsigned char)at[0]) || at[0] == '_') { at++; }
+            if (at == identifier || ifdef_count == SCAN_IFDEF_MAX) { return FALSE; }
+
+            if (has_define_identifier(identifier, (int)(at - identifier)) == check_defined)
+            {
+                ifdef_expect[ifdef_count++] = SCAN_IFDEF_ELSE;
+            }
+            else
+            {
+                enum ScanIfdefResult result = scan_skip_ifdef(&at, &line, TRUE);
+                if (result == SCAN_IFDEF_END) { return FALSE; }
+                if (result == SCAN_IFDEF_ELSE)
+                {
+                    ifdef_expect[ifdef_count++] = SCAN_IFDEF_ENDIF;
+                }
+            }
+        }
+        else if (is_str_equal(word, word_size, "#else"))
+        {
+            if (ifdef_count == 0 || ifdef_expect[ifdef_count - 1] != SCAN_IFDEF_ELSE) { return FALSE; }
+            ifdef_count--;
+            if (scan_skip_ifdef(&at, &line, FALSE) != SCAN_IFDEF_ENDIF) { return FALSE; }
+        }
+        else if (is_str_equal(word, word_size, "#endif"))
+        {
+            if (ifdef_count == 0) { return FALSE; }
+            ifdef_count--;
+        }
+        else if (is_str_equal(word, word_size, "#include"))
+        {
+            char *include_name = scan_file_name(&at, &line);
+            if (include_name == NULL || depth >= INCLUDE_STACK_MAX)
+            {
+                free(include_name);
+                return FALSE;
+            }
+
+            char *new_filename = (char*)allocate_context_memory(256);
+            if (!get_file_include_path(new_filename, include_name, filename) ||
+                find_include_job(new_filename) >= 0 || !strcmp(new_filename, context->include_main_filename))
+            {
+                free(include_name);
+                return FALSE;
+            }
+
+            struct Lexer lexer_include;
+            if (init_lexer(&lexer_include, new_filename))
+            {
+                free(include_name);
+                return FALSE;
+            }
+
+            if (context->include_jobs_count == context->include_jobs_capacity)
+            {
+                context->include_jobs_capacity = MAX(16, context->include_jobs_capacity * 2);
+                context->include_jobs = (struct IncludeJob *)realloc(context->include_jobs, sizeof(struct IncludeJob) * context->include_jobs_capacity);
+            }
+
+            int job = context->include_jobs_count++;
+            context->include_jobs[job].filename = new_filename;
+            context->include_jobs[job].content = lexer_include.buffer_start;
+            context->include_jobs[job].parent = parent;
+            context->include_jobs[job].include_filename = filename;
+            context->include_jobs[job].include_line = line;
+            context->include_jobs[job].include_name = include_name;
+            context->include_jobs[job].reached = FALSE;
+            context->include_jobs[job].first_node = context->include_jobs[job].last_node = NULL;
+            context->include_jobs[job].messages = NULL;
+
+            if (!scan_includes(new_filename, lexer_include.buffer_start, job, depth + 1)) { return FALSE; }
+        }
+    }
+
+    return ifdef_count == 0 && at[0] == 0;
+}
+
+// Removes the jobs found by a scan that was given up, their file names are kept by the file cache
+static void clear_include_jobs()
+{
+    for(int i = 0; i < context->include_jobs_count; i++)
+    {
+        free(context->include_jobs[i].include_name);
+    }
+    context->include_jobs_count = 0;
+}
+
+// Identifiers checked by #ifdef and #ifndef anywhere in some files, comments and strings included
+struct IfdefIdentifiers
+{
+    char **names;
+    int count;
+    int capacity;
+
+    char **files;
+    int files_count;
+    int files_capacity;
+};
+
+static BOOL is_directive_at(char *at, char *directive)
+{
+    int size = (int)strlen(directive);
+    return !strncmp(at, directive, size) && !isalnum((unsigned char)at[size]) && at[size] != '_';
+}
+
+static void add_ifdef_identifier(struct IfdefIdentifiers *identifiers, char *name, int name_size)
+{
+    for(int i = 0; i < identifiers->count; i++)
+    {
+        if (is_str_equal(name, name_size, identifiers->names[i])) { return; }
+    }
+
+    if (identifiers->count == identifiers->capacity)
+    {
+        identifiers->capacity = MAX(16, identifiers->capacity * 2);
+        identifiers->names = (char **)realloc(identifiers->names, sizeof(char *) * identifiers->capacity);
+    }
+
+    char *new_name = (char *)malloc((size_t)name_size + 1);
+    memcpy(new_name, name, (size_t)name_size);
+    new_name[name_size] = 0;
+    identifiers->names[identifiers->count++] = new_name;
+}
+
+// Looks for every directive in the text of a file, even the ones inside comments, so none that the
+// lexer may find is missed. A #define doesn't matter, it is found the same way while the identifiers
+// checked before it have the same values.
+static void scan_ifdef_identifiers(char *filename, struct IfdefIdentifiers *identifiers)
+{
+    for(int i = 0; i < identifiers->files_count; i++)
+    {
+        if (!strcmp(identifiers->files[i], filename)) { return; }
+    }
+
+    if (identifiers->files_count == identifiers->files_capacity)
+    {
+        identifiers->files_capacity = MAX(16, identifiers->files_capacity * 2);
+        identifiers->files = (char **)realloc(identifiers->files, sizeof(char *) * identifiers->files_capacity);
+    }
+    identifiers->files[identifiers->files_count++] = filename;
+
+    // A file that can't be read is reported when it is parsed
+    int error = 0;
+    char *at = read_file_to_cache(filename, FALSE, NULL, &error, NULL);
+    if (at == NULL) { return; }
+
+    int line = 1;
+    while ((at = strchr(at, '#')) != NULL)
+    {
+        if (is_directive_at(at, "#ifdef") || is_directive_at(at, "#ifndef"))
+        {
+            at += is_directive_at(at, "#ifdef") ? 6 : 7;
+            while (at[0] == ' ' || at[0] == '\t' || at[0] == '\r') { at++; }
+            char *identifier = at;
+            while (isalnum((unsigned char)at[0]) || at[0] == '_') { at++; }
+            if (at > identifier)
+            {
+                add_ifdef_identifier(identifiers, identifier, (int)(at - identifier));
+            }
+        }
+        else if (is_directive_at(at, "#include"))
+        {
+            at += 8;
+            char *include_name = scan_file_name(&at, &line);
+            if (include_name != NULL)
+            {
+                char *new_filename = (char*)allocate_context_memory(256);
+                if (get_file_include_path(new_filename, include_name, filename))
+                {
+                    scan_ifdef_identifiers(new_filename, identifiers);
+                }
+                free(include_name);
+            }
+        }
+        else
+        {
+            at++;
+        }
+    }
+}
+
+// Returns the identifiers that #ifdef and #ifndef may check while parsing a file and the files it includes
+char **find_ifdef_identifiers(char *filename, int *count)
+{
+    struct IfdefIdentifiers identifiers;
+    memset(&identifiers, 0, sizeof(identifiers));
+
+    scan_ifdef_identifiers(filename, &identifiers);
+    free(identifiers.files);
+
+    *count = identifiers.count;
+    return identifiers.count > 0 ? identifiers.names : (char **)calloc(1, sizeof(char *));
+}
+
+static void inner_parse_include_job(struct IncludeJob *job)
+{
+    struct Lexer lexer;
+    uint8_t precompiled_key[SHA256_SIZE];
+
+    if (is_precompiling())
+    {
+        get_precompiled_key(job->filename, job->content, precompiled_key);
+        if (load_precompiled_file(job->filename, precompiled_key, find_include_job, &job->first_node, &job->last_node)) { return; }
+
+        start_precompiled_recording();
+    }
+
+    if (init_lexer(&lexer, job->filename)) { finish_precompiled_recording(); return; }
+
+    // Files parsed at the same time each have their own #ifdef stack
+    struct IfdefStack ifdef_stack;
+    memset(&ifdef_stack, 0, sizeof(ifdef_stack));
+    lexer.ifdef_stack = &ifdef_stack;
+
+    job->first_node = parse(&lexer, NULL, &job->last_node);
+    clear_ifdef_stack(&ifdef_stack);
+
+    if (job->first_node != NULL && is_precompiling())
+    {
+        save_precompiled_file(job->filename, precompiled_key, job->first_node, job->last_node);
+    }
+    finish_precompiled_recording();
+}
+
+static int parse_include_job(void *argument, int index)
+{
+    struct IncludeJob *job = &context->include_jobs[index];
+
+    hold_messages(TRUE);
+    inner_parse_include_job(job);
+    job->messages = take_held_messages();
+    hold_messages(FALSE);
+
+    return job->first_node == NULL;
+}
+
+// Writes the messages of a file and of the files it includes in the order they would have been written
+// parsing each included file when it is reached, until the first file with errors the parser got to.
+// A file that failed only got to the files it marked as reached, the others are never reported.
+// Returns TRUE if the file or any file it includes failed.
+static BOOL report_include_jobs(int parent, BOOL failed, char *messages)
+{
+    for(int i = parent + 1; i < context->include_jobs_count; i++)
+    {
+        struct IncludeJob *job = &context->include_jobs[i];
+        if (job->parent != parent || (failed && !job->reached)) { continue; }
+
+        if (report_include_jobs(i, job->first_node == NULL, job->messages))
+        {
+            write_compiler_error(job->include_filename, job->include_line, "Error including file \"%s\"", job->include_name);
+            return TRUE;
+        }
+    }
+
+    if (messages != NULL)
+    {
+        printf("%s", messages);
+    }
+
+    return failed;
+}
+
+// Parses a file with the files it includes parsed at the same time by worker threads,
+// when that is not possible it is just parsed with each included file parsed when it is reached.
+// With a single thread the included files are still parsed as jobs when they are precompiled.
+struct ASTNode *parse_with_includes(struct Lexer *lexer)
+{
+    context->include_jobs_count = 0;
+    context->include_main_filename = lexer->filename;
+    BOOL scanned = FALSE;
+    if (context->thread_count > 1 || is_precompiling())
+    {
+        // Files that can't be read are reported by the parser when it gets to them
+        hold_messages(TRUE);
+        scanned = scan_includes(lexer->filename, lexer->buffer_at, -1, 1);
+        free(take_held_messages());
+        hold_messages(FALSE);
+    }
+    if (!scanned)
+    {
+        clear_include_jobs();
+        return parse(lexer, NULL, NULL);
+    }
+
+    // Without any #define the file can be lexed ahead of the parser
+    if (context->lexer_thread)
+    {
+        start_lexer_thread(lexer);
+    }
+
+    if (context->include_jobs_count == 0)
+    {
+        struct ASTNode *first_node = parse(lexer, NULL, NULL);
+        finish_lexer_thread(lexer);
+        return first_node;
+    }
+
+    write_debug("Parsing %d included files with %d threads", context->include_jobs_count, context->thread_count);
+
+    struct WorkerPool *pool = start_workers(context->include_jobs_count, context->thread_count - 1, parse_include_job, NULL);
+    hold_messages(TRUE);
+    struct ASTNode *first_node = parse(lexer, NULL, NULL);
+    finish_lexer_thread(lexer);
+    char *messages = take_held_messages();
+    hold_messages(FALSE);
+    finish_workers(pool);
+
+    BOOL failed = report_include_jobs(-1, first_node == NULL, messages);
+    free(messages);
+    for(int i = 0; i < context->include_jobs_count; i++)
+    {
+        free(context->include_jobs[i].messages);
+        context->include_jobs[i].messages = NULL;
+    }
+
+    if (failed)
+    {
+        return NULL;
+    }
+
+    // Splice the parsed files after their #include, the ones spliced are walked next
+    struct ASTNode *current_node = first_node;
+    while (current_node != NULL && current_node->children_count > 0)
+    {
+        struct ASTNode *node = current_node->children[0];
+        if (node->type == NODE_TYPE_INCLUDE)
+        {
+            struct IncludeJob *job = &context->include_jobs[node->num_value];
+            if (job->first_node != job->last_node)
+            {
+                struct ASTNode *before_last_node = job->first_node;
+                while (before_last_node->children[1] != job->last_node)
+                {
+                    before_last_node = before_last_node->children[1];
+                }
+
+                before_last_node->children[1] = current_node->children[1];
+                current_node->children[1] = job->first_node;
+            }
+        }
+
+        current_node = current_node->children[1];
+    }
+
+    return first_node;
+}
+
+// *************
+// Prefetching of included files
+// *************
+
+// Files referred by #include, #include_binary and data from, read ahead by worker threads
+// so they are in the cache when the parser or the compiler gets to them
+struct PrefetchFile
+{
+    char *filename;
+    BOOL binary;
+};
+
+static void add_prefetch_file(char *name, char *origin_filename, BOOL binary)
+{
+    char *filename = (char*)malloc(256);
+    if (!get_file_include_path(filename, name, origin_filename))
+    {
+        free(filename);
+        return;
+    }
+
+    lock_mutex(context->prefetch_mutex);
+
+    for(int i = 0; i < context->prefetch_files_count; i++)
+    {
+        if (context->prefetch_files[i].binary == binary && !strcmp(context->prefetch_files[i].filename, filename))
+        {
+            unlock_mutex(context->prefetch_mutex);
+            free(filename);
+            return;
+        }
+    }
+
+    if (context->prefetch_files_count == context->prefetch_files_capacity)
+    {
+        context->prefetch_files_capacity = MAX(16, context->prefetch_files_capacity * 2);
+        context->prefetch_files = (struct PrefetchFile *)realloc(context->prefetch_files, sizeof(struct PrefetchFile) * context->prefetch_files_capacity);
+    }
+    context->prefetch_files[context->prefetch_files_count].filename = filename;
+    context->prefetch_files[context->prefetch_files_count].binary = binary;
+    context->prefetch_files_count++;
+
+    unlock_mutex(context->prefetch_mutex);
+}
+
+// Finds the files referred by a source file, the ones in a false #ifdef too
+static void scan_prefetch_files(char *filename, char *content)
+{
+    char *at = content, *word;
+    int line = 1, word_size;
+
+    while (scan_next_directive(&at, &line, FALSE, TRUE, &word, &word_size))
+    {
+        BOOL binary = FALSE;
+        if (is_str_equal(word, word_size, "#include_binary") || is_str_equal(word, word_size, "from"))
+        {
+            binary = TRUE;
+        }
+        else if (!is_str_equal(word, word_size, "#include"))
+        {
+            continue;
+        }
+
+        char *name = scan_file_name(&at, &line);
+        if (name != NULL)
+        {
+            add_prefetch_file(name, filename, binary);
+            free(name);
+        }
+    }
+}
+
+static int prefetch_job(void *argument, int index)
+{
+    index += *(int *)argument;
+
+    lock_mutex(context->prefetch_mutex);
+    struct PrefetchFile file = context->prefetch_files[index];
+    unlock_mutex(context->prefetch_mutex);
+
+    // The files referred by a source file are found while nobody else is using it
+    read_file_to_cache(file.filename, file.binary, NULL, NULL, file.binary ? NULL : scan_prefetch_files);
+
+    return 0;
+}
+
+// Reads the files found in turns, each turn reads the files found in the last one
+static int run_prefetch(void *argument)
+{
+    int start = 0;
+
+    while (TRUE)
+    {
+        lock_mutex(context->prefetch_mutex);
+        int end = context->prefetch_files_count;
+        unlock_mutex(context->prefetch_mutex);
+
+        if (start == end) { break; }
+
+        write_debug("Prefetching %d files", end - start);
+        run_workers(end - start, context->thread_count, prefetch_job, &start);
+        start = end;
+    }
+
+    return 0;
+}
+
+void start_prefetch(char *filename, char *content)
+{
+    context->prefetch_mutex = create_mutex();
+    scan_prefetch_files(filename, content);
+
+    if (context->prefetch_files_count > 0)
+    {
+        context->prefetch_thread = create_thread(run_prefetch, NULL);
+    }
+}
+
+void finish_prefetch()
+{
+    if (context->prefetch_thread != NULL)
+    {
+        join_thread(context->prefetch_thread);
+        context->prefetch_thread = NULL;
+    }
+}
+
+// Frees the include jobs and the files prefetched, the nodes parsed are in the memory of the context
+void free_parser()
+{
+    finish_prefetch();
+
+    clear_include_jobs();
+    free(context->include_jobs);
+
+    for(int i = 0; i < context->prefetch_files_count; i++)
+    {
+        free(context->prefetch_files[i].filename);
+    }
+    free(context->prefetch_files);
+    if (context->prefetch_mutex != NULL)
+    {
+        destroy_mutex(context->prefetch_mutex);
+    }
+}
+
+static struct ASTNode *inner_parse(struct Lexer *lexer, struct ASTNode *parent_node, struct ASTNode **last_node)
 {
     struct Token token;
     struct ASTNode *ast_node_main = NULL, *first_node, *temp_node;    
@@ -2585,13 +3400,29 @@ struct ASTNode *parse(struct Lexer *lexer, struct ASTNode *parent_node, struct A
                             struct Lexer lexer_include;
                             int include_result;
 
-                            char *new_filename = (char*)malloc(256);
+                            char *new_filename = (char*)allocate_context_memory(256);
                             if (!get_file_include_path(new_filename, token.value, lexer->filename))
                             {
                                 write_compiler_error(lexer->filename, lexer->current_line, "Error including file \"%s\"", token.value);
                                 return NULL;
                             }
 
+                            int include_job = find_include_job(new_filename);
+                            if (include_job >= 0)
+                            {
+                                // Already being parsed by a worker thread, it is spliced here later
+                                context->include_jobs[include_job].reached = TRUE;
+                                struct ASTNode *ast_node = create_node_str(NODE_TYPE_INCLUDE, lexer, new_filename, (int)strlen(new_filename));
+                                ast_node->num_value = include_job;
+
+                                ast_node_main->children[0] = ast_node;
+                                ast_node_main->children[1] = create_node(NODE_TYPE_MAIN, lexer);
+                                ast_node_main->children_count = 2;
+                                ast_node_main = ast_node_main->children[1];
+
+                                break;
+                            }
+
                             if ((include_result = push_include_file(new_filename)))
                             {
                                 switch (include_result)
@@ -2874,3 +3705,13 @@ struct ASTNode *parse(struct Lexer *lexer, struct ASTNode *parent_node, struct A
 
     return NULL;
 }
+
+// Lexes and parses a file
+struct ASTNode *parse(struct Lexer *lexer, struct ASTNode *parent_node, struct ASTNode **last_node)
+{
+    uint64_t trace_start = start_trace_span();
+    struct ASTNode *first_node = inner_parse(lexer, parent_node, last_node);
+    add_trace_span("parse", "parse", lexer->filename, (int)strlen(lexer->filename), trace_start);
+
+    return first_node;
+}
@@ -0,0 +1,715 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "z80hla.h"
+
+// A precompiled file (.z80pch) holds the nodes parsed from an included file and what parsing it added
+// to the tables (inline symbols and library symbol dependencies), so the next compilation reads it
+// instead of parsing the file again.
+// It is a single block: the header, the nodes, the records of the tables and the strings, every pointer
+// in it is stored as an offset from the start of the block and turned back into a pointer when it is read.
+
+#define PRECOMPILED_MAGIC   "Z80PCH2"
+
+struct PrecompiledHeader
+{
+    char magic[8];
+    uint8_t key[SHA256_SIZE];
+    int size;
+    int node_size;
+    int nodes_count;
+    int inline_symbols_count;
+    int arguments_count;
+    int dependencies_count; // pairs of symbols, the symbol and the one it depends on
+    int symbols_used_count;
+    struct ASTNode *first_node, *last_node;
+    char *filename;
+};
+
+struct PrecompiledSymbol
+{
+    char *library_name;
+    int library_name_size;
+    char *name;
+    int name_size;
+};
+
+struct PrecompiledInline
+{
+    char *name;
+    int name_size;
+    char *library_name;
+    int library_name_size;
+    struct ASTNode *node;
+    int argument_count;
+    int first_argument;
+};
+
+struct PrecompiledArgument
+{
+    char *name;
+    int name_size;
+};
+
+// What parsing a file added to the tables, recorded by the thread parsing it
+struct PrecompiledRecording
+{
+    struct InlineSymbol **inline_symbols;
+    int inline_symbols_count;
+    int inline_symbols_capacity;
+    struct PrecompiledSymbol *dependencies;
+    int dependencies_count;
+    int dependencies_capacity;
+    struct PrecompiledSymbol *symbols_used;
+    int symbols_used_count;
+    int symbols_used_capacity;
+};
+
+static THREAD_LOCAL struct PrecompiledRecording *recording = NULL;
+
+void start_precompiled_recording()
+{
+    recording = (struct PrecompiledRecording *)calloc(1, sizeof(struct PrecompiledRecording));
+}
+
+void finish_precompiled_recording()
+{
+    if (recording == NULL) { return; }
+
+    free(recording->inline_symbols);
+    free(recording->dependencies);
+    free(recording->symbols_used);
+    free(recording);
+    recording = NULL;
+}
+
+static struct PrecompiledSymbol *add_recorded_symbol(struct PrecompiledSymbol **symbols, int *count, int *capacity)
+{
+    if (*count == *capacity)
+    {
+        *capacity = MAX(16, *capacity * 2);
+        *symbols = (struct PrecompiledSymbol *)realloc(*symbols, sizeof(struct PrecompiledSymbol) * *capacity);
+    }
+
+    return &(*symbols)[(*count)++];
+}
+
+void record_inline_symbol(struct InlineSymbol *inline_symbol)
+{
+    if (recording == NULL || inline_symbol == NULL) { return; }
+
+    if (recording->inline_symbols_count == recording->inline_symbols_capacity)
+    {
+        recording->inline_symbols_capacity = MAX(16, recording->inline_symbols_capacity * 2);
+        recording->inline_symbols = (struct InlineSymbol **)realloc(recording->inline_symbols, sizeof(struct InlineSymbol *) * recording->inline_symbols_capacity);
+    }
+
+    recording->inline_symbols[recording->inline_symbols_count++] = inline_symbol;
+}
+
+void record_library_symbol_dependency(char *library_name, int library_size, char *symbol_name, int symbol_name_size,
+    char *library_dependency_name, int library_dependency_name_size, char *symbol_dependency_name, int symbol_dependency_name_size)
+{
+    if (recording == NULL) { return; }
+
+    struct PrecompiledSymbol *symbol = add_recorded_symbol(&recording->dependencies, &recording->dependencies_count, &recording->dependencies_capacity);
+    symbol->library_name = library_name;
+    symbol->library_name_size = library_size;
+    symbol->name = symbol_name;
+    symbol->name_size = symbol_name_size;
+
+    symbol = add_recorded_symbol(&recording->dependencies, &recording->dependencies_count, &recording->dependencies_capacity);
+    symbol->library_name = library_dependency_name;
+    symbol->library_name_size = library_dependency_name_size;
+    symbol->name = symbol_dependency_name;
+    symbol->name_size = symbol_dependency_name_size;
+}
+
+void record_library_symbol_used(char *library_name, int library_size, char *symbol_name, int symbol_name_size)
+{
+    if (recording == NULL) { return; }
+
+    struct PrecompiledSymbol *symbol = add_recorded_symbol(&recording->symbols_used, &recording->symbols_used_count, &recording->symbols_used_capacity);
+    symbol->library_name = library_name;
+    symbol->library_name_size = library_size;
+    symbol->name = symbol_name;
+    symbol->name_size = symbol_name_size;
+}
+
+// Included files are precompiled when there is a precompiled directory or a server keeping them between builds
+BOOL is_precompiling()
+{
+    return context->precompiled_directory != NULL || is_warm_cache_used();
+}
+
+// The key changes with anything that changes what parsing the file gives, the CPU type is not
+// one of them as it only matters when compiling.
+// The content is changed by the lexer, it has to be digested before the file is parsed
+void get_precompiled_key(char *filename, char *content, uint8_t *key)
+{
+    char *version = PRECOMPILED_MAGIC " v" Z80HLA_VERSION_HI "." Z80HLA_VERSION_LO;
+    struct Sha256 sha256;
+
+    init_sha256(&sha256);
+    update_sha256(&sha256, version, strlen(version) + 1);
+    update_sha256(&sha256, filename, strlen(filename) + 1);
+    update_sha256(&sha256, content, strlen(content) + 1);
+    digest_define_identifiers(&sha256);
+    finish_sha256(&sha256, key);
+}
+
+static void get_precompiled_path(char *dst, char *filename, uint8_t *key)
+{
+    char key_text[SHA256_SIZE * 2 + 1];
+
+    char *name = filename;
+    for(char *at = filename; *at != 0; at++)
+    {
+        if (*at == '/' || *at == '\\') { name = at + 1; }
+    }
+
+    sprint_digest(key_text, key);
+    sprintf(dst, "%s/%s-%s.z80pch", context->precompiled_directory, name, key_text);
+}
+
+// *************
+// Writing
+// *************
+
+// Pointers already written and their offsets, nodes are shared by the main list and the inline symbols
+struct PointerMap
+{
+    void **pointers;
+    intptr_t *offsets;
+    int *sizes;
+    int count;
+    int capacity;
+};
+
+static int find_pointer_slot(struct PointerMap *map, void *pointer)
+{
+    int slot = (int)((((uintptr_t)pointer) >> 3) * 2654435761u) & (map->capacity - 1);
+    while (map->pointers[slot] != NULL && map->pointers[slot] != pointer)
+    {
+        slot = (slot + 1) & (map->capacity - 1);
+    }
+    return slot;
+}
+
+static void add_pointer(struct PointerMap *map, void *pointer, intptr_t offset, int size)
+{
+    if ((map->count + 1) * 2 > map->capacity)
+    {
+        struct PointerMap old_map = *map;
+        map->capacity = MAX(1024, map->capacity * 2);
+        map->pointers = (void **)calloc(map->capacity, sizeof(void *));
+        map->offsets = (intptr_t *)malloc(sizeof(intptr_t) * map->capacity);
+        map->sizes = (int *)malloc(sizeof(int) * map->capacity);
+        for(int i = 0; i < old_map.capacity; i++)
+        {
+            if (old_map.pointers[i] == NULL) { continue; }
+            int slot = find_pointer_slot(map, old_map.pointers[i]);
+            map->pointers[slot] = old_map.pointers[i];
+            map->offsets[slot] = old_map.offsets[i];
+            map->sizes[slot] = old_map.sizes[i];
+        }
+        free(old_map.pointers);
+        free(old_map.offsets);
+        free(old_map.sizes);
+    }
+
+    int slot = find_pointer_slot(map, pointer);
+    map->pointers[slot] = pointer;
+    map->offsets[slot] = offset;
+    map->sizes[slot] = size;
+    map->count++;
+}
+
+static BOOL get_pointer(struct PointerMap *map, void *pointer, int size, intptr_t *offset)
+{
+    if (map->capacity == 0) { return FALSE; }
+
+    int slot = find_pointer_slot(map, pointer);
+    if (map->pointers[slot] == NULL || map->sizes[slot] != size) { return FALSE; }
+
+    *offset = map->offsets[slot];
+    return TRUE;
+}
+
+static void free_pointer_map(struct PointerMap *map)
+{
+    free(map->pointers);
+    free(map->offsets);
+    free(map->sizes);
+}
+
+struct PrecompiledWriter
+{
+    struct ASTNode **nodes;
+    int nodes_count;
+    int nodes_capacity;
+    struct PointerMap node_offsets;
+    intptr_t nodes_start;
+
+    char *strings;
+    int strings_size;
+    int strings_capacity;
+    struct PointerMap string_offsets;
+    intptr_t strings_start;
+};
+
+static void add_writer_node(struct PrecompiledWriter *writer, struct ASTNode *node)
+{
+    intptr_t offset;
+    if (node == NULL || get_pointer(&writer->node_offsets, node, 0, &offset)) { return; }
+
+    if (writer->nodes_count == writer->nodes_capacity)
+    {
+        writer->nodes_capacity = MAX(1024, writer->nodes_capacity * 2);
+        writer->nodes = (struct ASTNode **)realloc(writer->nodes, sizeof(struct ASTNode *) * writer->nodes_capacity);
+    }
+
+    add_pointer(&writer->node_offsets, node, writer->nodes_start + sizeof(struct ASTNode) * writer->nodes_count, 0);
+    writer->nodes[writer->nodes_count++] = node;
+}
+
+// Finds every node reachable from the root, a node is numbered the first time it is reached
+static void add_writer_nodes(struct PrecompiledWriter *writer, struct ASTNode *root)
+{
+    int first = writer->nodes_count;
+    add_writer_node(writer, root);
+
+    for(int i = first; i < writer->nodes_count; i++)
+    {
+        struct ASTNode *node = writer->nodes[i];
+        // A node always has its first three children set (NULL by create_node) and some nodes use them
+        // without counting them in children_count, the children after them are only set up to children_count
+        int children_count = MAX(node->children_count, 3);
+        for(int j = 0; j < children_count; j++)
+        {
+            add_writer_node(writer, node->children[j]);
+        }
+    }
+}
+
+// Strings are written with a terminator as some are used as C strings,
+// a string with no size is written as an empty one as its pointer may not be set
+static char *get_writer_string(struct PrecompiledWriter *writer, char *str, int size)
+{
+    intptr_t offset;
+
+    if (size == 0)
+    {
+        return (char *)writer->strings_start;
+    }
+    if (get_pointer(&writer->string_offsets, str, size, &offset))
+    {
+        return (char *)offset;
+    }
+
+    if (writer->strings_size + size + 1 > writer->strings_capacity)
+    {
+        writer->strings_capacity = MAX(writer->strings_size + size + 1, MAX(4096, writer->strings_capacity * 2));
+        writer->strings = (char *)realloc(writer->strings, writer->strings_capacity);
+    }
+
+    offset = writer->strings_start + writer->strings_size;
+    memcpy(writer->strings + writer->strings_size, str, size);
+    writer->strings[writer->strings_size + size] = 0;
+    writer->strings_size += size + 1;
+
+    add_pointer(&writer->string_offsets, str, offset, size);
+
+    return (char *)offset;
+}
+
+static struct ASTNode *get_writer_node(struct PrecompiledWriter *writer, struct ASTNode *node)
+{
+    intptr_t offset = 0;
+
+    if (node != NULL)
+    {
+        get_pointer(&writer->node_offsets, node, 0, &offset);
+    }
+
+    return (struct ASTNode *)offset;
+}
+
+static struct PrecompiledSymbol get_writer_symbol(struct PrecompiledWriter *writer, struct PrecompiledSymbol *symbol)
+{
+    struct PrecompiledSymbol written_symbol;
+    written_symbol.library_name = get_writer_string(writer, symbol->library_name, symbol->library_name_size);
+    written_symbol.library_name_size = symbol->library_name_size;
+    written_symbol.name = get_writer_string(writer, symbol->name, symbol->name_size);
+    written_symbol.name_size = symbol->name_size;
+    return written_symbol;
+}
+
+// Writes the nodes parsed from a file with what was recorded while parsing it,
+// it is not written when a node comes from another file as that file is not part of the key
+// Written to a temporary file first so a file being read is always complete
+static void write_precompiled_block(char *filename, char *block, int size)
+{
+    char path[512], temporary_path[520];
+    get_precompiled_path(path, filename, ((struct PrecompiledHeader *)block)->key);
+    sprintf(temporary_path, "%s.tmp", path);
+
+    FILE *fp = fopen(temporary_path, "wb");
+    if (fp == NULL) { return; }
+
+    BOOL written = fwrite(block, 1, size, fp) == size;
+    written = fclose(fp) == 0 && written;
+
+    remove(path);
+    if (!written || rename(temporary_path, path))
+    {
+        remove(temporary_path);
+    }
+    else
+    {
+        write_debug("Precompiled \"%s\" to \"%s\"", filename, path);
+    }
+}
+
+// The block of an included file is kept by the server between builds (when there is one) and written
+// to the precompiled directory (when there is one)
+void save_precompiled_file(char *filename, uint8_t *key, struct ASTNode *first_node, struct ASTNode *last_node)
+{
+    if (recording == NULL) { return; }
+
+    struct PrecompiledWriter writer;
+    memset(&writer, 0, sizeof(writer));
+
+    int arguments_count = 0;
+    for(int i = 0; i < recording->inline_symbols_count; i++)
+    {
+        arguments_count += recording->inline_symbols[i]->argument_count;
+    }
+
+    writer.nodes_start = sizeof(struct PrecompiledHeader);
+    add_writer_nodes(&writer, first_node);
+    for(int i = 0; i < recording->inline_symbols_count; i++)
+    {
+        add_writer_nodes(&writer, recording->inline_symbols[i]->node);
+    }
+
+    for(int i = 0; i < writer.nodes_count; i++)
+    {
+        if (writer.nodes[i]->filename != NULL && strcmp(writer.nodes[i]->filename, filename))
+        {
+            write_debug("Not precompiling \"%s\", it has nodes from \"%s\"", filename, writer.nodes[i]->filename);
+            free(writer.nodes);
+            free_pointer_map(&writer.node_offsets);
+            return;
+        }
+    }
+
+    intptr_t inline_symbols_start = writer.nodes_start + sizeof(struct ASTNode) * writer.nodes_count;
+    intptr_t arguments_start = inline_symbols_start + sizeof(struct PrecompiledInline) * recording->inline_symbols_count;
+    intptr_t dependencies_start = arguments_start + sizeof(struct PrecompiledArgument) * arguments_count;
+    intptr_t symbols_used_start = dependencies_start + sizeof(struct PrecompiledSymbol) * recording->dependencies_count;
+    writer.strings_start = symbols_used_start + sizeof(struct PrecompiledSymbol) * recording->symbols_used_count;
+
+    // The empty string is always the first one
+    writer.strings = (char *)malloc(4096);
+    writer.strings_capacity = 4096;
+    writer.strings[0] = 0;
+    writer.strings_size = 1;
+
+    struct PrecompiledHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PRECOMPILED_MAGIC, sizeof(header.magic));
+    memcpy(header.key, key, SHA256_SIZE);
+    header.node_size = sizeof(struct ASTNode);
+    header.nodes_count = writer.nodes_count;
+    header.inline_symbols_count = recording->inline_symbols_count;
+    header.arguments_count = arguments_count;
+    header.dependencies_count = recording->dependencies_count / 2;
+    header.symbols_used_count = recording->symbols_used_count;
+    header.first_node = get_writer_node(&writer, first_node);
+    header.last_node = get_writer_node(&writer, last_node);
+    header.filename = get_writer_string(&writer, filename, (int)strlen(filename));
+
+    struct ASTNode *nodes = (struct ASTNode *)calloc(MAX(writer.nodes_count, 1), sizeof(struct ASTNode));
+    for(int i = 0; i < writer.nodes_count; i++)
+    {
+        struct ASTNode *node = writer.nodes[i];
+        nodes[i].type = node->type;
+        nodes[i].children_count = node->children_count;
+        // The same children as add_writer_nodes, the first three are always set
+        for(int j = 0; j < MAX(node->children_count, 3); j++)
+        {
+            nodes[i].children[j] = get_writer_node(&writer, node->children[j]);
+        }
+        nodes[i].str_value = get_writer_string(&writer, node->str_value, node->str_size);
+        nodes[i].str_size = node->str_size;
+        nodes[i].num_value = node->num_value;
+        nodes[i].num_value2 = node->num_value2;
+        nodes[i].str_value2 = get_writer_string(&writer, node->str_value2, node->str_size2);
+        nodes[i].str_size2 = node->str_size2;
+        nodes[i].filename = node->filename != NULL ? header.filename : NULL;
+        nodes[i].file_line = node->file_line;
+    }
+
+    struct PrecompiledInline *inline_symbols = (struct PrecompiledInline *)calloc(MAX(recording->inline_symbols_count, 1), sizeof(struct PrecompiledInline));
+    struct PrecompiledArgument *arguments = (struct PrecompiledArgument *)calloc(MAX(arguments_count, 1), sizeof(struct PrecompiledArgument));
+    int argument = 0;
+    for(int i = 0; i < recording->inline_symbols_count; i++)
+    {
+        struct InlineSymbol *inline_symbol = recording->inline_symbols[i];
+        inline_symbols[i].name = get_writer_string(&writer, inline_symbol->name, inline_symbol->name_size);
+        inline_symbols[i].name_size = inline_symbol->name_size;
+        inline_symbols[i].library_name = get_writer_string(&writer, inline_symbol->library_name, inline_symbol->library_name_size);
+        inline_symbols[i].library_name_size = inline_symbol->library_name_size;
+        inline_symbols[i].node = get_writer_node(&writer, inline_symbol->node);
+        inline_symbols[i].argument_count = inline_symbol->argument_count;
+        inline_symbols[i].first_argument = argument;
+
+        for(struct InlineArgument *current_argument = inline_symbol->arguments; current_argument != NULL; current_argument = current_argument->next)
+        {
+            arguments[argument].name = get_writer_string(&writer, current_argument->name, current_argument->name_size);
+            arguments[argument].name_size = current_argument->name_size;
+            argument++;
+        }
+    }
+
+    struct PrecompiledSymbol *dependencies = (struct PrecompiledSymbol *)calloc(MAX(recording->dependencies_count, 1), sizeof(struct PrecompiledSymbol));
+    for(int i = 0; i < recording->dependencies_count; i++)
+    {
+        dependencies[i] = get_writer_symbol(&writer, &recording->dependencies[i]);
+    }
+    struct PrecompiledSymbol *symbols_used = (struct PrecompiledSymbol *)calloc(MAX(recording->symbols_used_count, 1), sizeof(struct PrecompiledSymbol));
+    for(int i = 0; i < recording->symbols_used_count; i++)
+    {
+        symbols_used[i] = get_writer_symbol(&writer, &recording->symbols_used[i]);
+    }
+
+    header.size = (int)(writer.strings_start + writer.strings_size);
+
+    char *block = (char *)malloc(header.size);
+    memcpy(block, &header, sizeof(header));
+    memcpy(block + writer.nodes_start, nodes, sizeof(struct ASTNode) * writer.nodes_count);
+    memcpy(block + inline_symbols_start, inline_symbols, sizeof(struct PrecompiledInline) * recording->inline_symbols_count);
+    memcpy(block + arguments_start, arguments, sizeof(struct PrecompiledArgument) * arguments_count);
+    memcpy(block + dependencies_start, dependencies, sizeof(struct PrecompiledSymbol) * recording->dependencies_count);
+    memcpy(block + symbols_used_start, symbols_used, sizeof(struct PrecompiledSymbol) * recording->symbols_used_count);
+    memcpy(block + writer.strings_start, writer.strings, writer.strings_size);
+
+    if (context->precompiled_directory != NULL)
+    {
+        write_precompiled_block(filename, block, header.size);
+    }
+    add_warm_precompiled(filename, key, block, header.size);
+
+    free(block);
+    free(nodes);
+    free(inline_symbols);
+    free(arguments);
+    free(dependencies);
+    free(symbols_used);
+    free(writer.nodes);
+    free(writer.strings);
+    free_pointer_map(&writer.node_offsets);
+    free_pointer_map(&writer.string_offsets);
+}
+
+// *************
+// Reading
+// *************
+
+// Turns an offset back into a pointer in the block, FALSE when it is outside of it
+static BOOL relocate(char *block, int size, void **pointer)
+{
+    intptr_t offset = (intptr_t)*pointer;
+
+    if (offset < 0 || offset >= size) { return FALSE; }
+    if (offset != 0)
+    {
+        *pointer = block + offset;
+    }
+
+    return TRUE;
+}
+
+static BOOL relocate_symbol(char *block, int size, struct PrecompiledSymbol *symbol)
+{
+    return relocate(block, size, (void **)&symbol->library_name) && relocate(block, size, (void **)&symbol->name);
+}
+
+static BOOL is_precompiled_header_valid(struct PrecompiledHeader *header, uint8_t *key)
+{
+    return !memcmp(header->magic, PRECOMPILED_MAGIC, sizeof(header->magic)) &&
+        !memcmp(header->key, key, SHA256_SIZE) && header->node_size == sizeof(struct ASTNode) && header->size >= (int)sizeof(*header);
+}
+
+// The block kept by the server is used before the precompiled file, NULL when there is none
+static char *read_precompiled_block(char *filename, uint8_t *key, char *path)
+{
+    char *block = get_warm_precompiled(filename, key);
+    if (block != NULL || context->precompiled_directory == NULL)
+    {
+        strcpy(path, filename);
+        return block;
+    }
+
+    get_precompiled_path(path, filename, key);
+
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) { return NULL; }
+
+    struct PrecompiledHeader header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || !is_precompiled_header_valid(&header, key))
+    {
+        fclose(fp);
+        return NULL;
+    }
+
+    block = (char *)malloc(header.size);
+    memcpy(block, &header, sizeof(header));
+    BOOL read = fread(block + sizeof(header), 1, header.size - sizeof(header), fp) == header.size - sizeof(header);
+    fclose(fp);
+
+    if (!read)
+    {
+        free(block);
+        return NULL;
+    }
+
+    return block;
+}
+
+// Reads the precompiled block of an included file, its nodes are used as they are in the block read,
+// FALSE when there is none for its content and options and the file has to be parsed
+BOOL load_precompiled_file(char *filename, uint8_t *key, int (*find_include_job)(char *filename), struct ASTNode **first_node, struct ASTNode **last_node)
+{
+    char path[512];
+    char *block = read_precompiled_block(filename, key, path);
+    if (block == NULL) { return FALSE; }
+
+    struct PrecompiledHeader header;
+    memcpy(&header, block, sizeof(header));
+    BOOL read = is_precompiled_header_valid(&header, key);
+
+    struct ASTNode *nodes = (struct ASTNode *)(block + sizeof(header));
+    struct PrecompiledInline *inline_symbols = (struct PrecompiledInline *)(nodes + header.nodes_count);
+    struct PrecompiledArgument *arguments = (struct PrecompiledArgument *)(inline_symbols + header.inline_symbols_count);
+    struct PrecompiledSymbol *dependencies = (struct PrecompiledSymbol *)(arguments + header.arguments_count);
+    struct PrecompiledSymbol *symbols_used = dependencies + header.dependencies_count * 2;
+
+    read = read &&
+        (char *)(symbols_used + header.symbols_used_count) <= block + header.size &&
+        relocate(block, header.size, (void **)&header.first_node) &&
+        relocate(block, header.size, (void **)&header.last_node) &&
+        relocate(block, header.size, (void **)&header.filename);
+
+    for(int i = 0; read && i < header.nodes_count; i++)
+    {
+        struct ASTNode *node = &nodes[i];
+        for(int j = 0; read && j < MAX_AST_NODE_CHILDREN; j++)
+        {
+            read = relocate(block, header.size, (void **)&node->children[j]);
+        }
+        read = read &&
+            relocate(block, header.size, (void **)&node->str_value) &&
+            relocate(block, header.size, (void **)&node->str_value2) &&
+            relocate(block, header.size, (void **)&node->filename);
+
+        if (!read) { break; }
+
+        if (node->filename == header.filename)
+        {
+            node->filename = filename;
+        }
+
+        // The files included are parsed by other jobs, the job numbers are the ones of this compilation
+        if (node->type == NODE_TYPE_INCLUDE)
+        {
+            node->num_value = find_include_job(node->str_value);
+            read = node->num_value >= 0;
+        }
+    }
+
+    for(int i = 0; read && i < header.inline_symbols_count; i++)
+    {
+        read =
+            relocate(block, header.size, (void **)&inline_symbols[i].name) &&
+            relocate(block, header.size, (void **)&inline_symbols[i].library_name) &&
+            relocate(block, header.size, (void **)&inline_symbols[i].node) &&
+            inline_symbols[i].first_argument + inline_symbols[i].argument_count <= header.arguments_count &&
+            get_inline_symbol(inline_symbols[i].name, inline_symbols[i].name_size, inline_symbols[i].library_name, inline_symbols[i].library_name_size) == NULL;
+    }
+    for(int i = 0; read && i < header.arguments_count; i++)
+    {
+        read = relocate(block, header.size, (void **)&arguments[i].name);
+    }
+    for(int i = 0; read && i < header.dependencies_count * 2; i++)
+    {
+        read = relocate_symbol(block, header.size, &dependencies[i]);
+    }
+    for(int i = 0; read && i < header.symbols_used_count; i++)
+    {
+        read = relocate_symbol(block, header.size, &symbols_used[i]);
+    }
+
+    // A file defining an inline symbol already defined is parsed, so the error is the one parsing gives
+    if (!read)
+    {
+        write_debug("Precompiled file \"%s\" not used", path);
+        free(block);
+        return FALSE;
+    }
+
+    for(int i = 0; i < header.inline_symbols_count; i++)
+    {
+        struct InlineSymbol *inline_symbol = add_inline_symbol(inline_symbols[i].name, inline_symbols[i].name_size, inline_symbols[i].library_name, inline_symbols[i].library_name_size, inline_symbols[i].node);
+        for(int j = 0; inline_symbol != NULL && j < inline_symbols[i].argument_count; j++)
+        {
+            struct PrecompiledArgument *argument = &arguments[inline_symbols[i].first_argument + j];
+            add_inline_symbol_argument(inline_symbol, argument->name, argument->name_size);
+        }
+    }
+    for(int i = 0; i < header.dependencies_count; i++)
+    {
+        struct PrecompiledSymbol *symbol = &dependencies[i * 2], *dependency = &dependencies[i * 2 + 1];
+        add_library_symbol_dependency(
+            symbol->library_name, symbol->library_name_size, symbol->name, symbol->name_size,
+            dependency->library_name, dependency->library_name_size, dependency->name, dependency->name_size);
+    }
+    for(int i = 0; i < header.symbols_used_count; i++)
+    {
+        add_library_symbol_used(symbols_used[i].library_name, symbols_used[i].library_name_size, symbols_used[i].name, symbols_used[i].name_size);
+    }
+
+    write_debug("Read precompiled file \"%s\"", path);
+
+    // The nodes stay in the block, it is freed with the context
+    keep_context_memory(block);
+
+    *first_node = header.first_node;
+    *last_node = header.last_node;
+
+    return TRUE;
+}
@@ -0,0 +1,799 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "z80hla.h"
+#include <sys/stat.h>
+#ifdef __linux__
+#include <errno.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Watch and serve modes compile the input file again and again, each build starts from a new
+// context. Where processes can be forked each build runs in its own process, so whatever a
+// build leaves in memory is gone after it and the diagnostics are written where they are wanted.
+// The server keeps the content of the files read and the included files parsed (as precompiled
+// blocks) between builds, each build process gets them when it is forked.
+// Where the system tells when a file changes (inotify) the files are only compared after it does,
+// elsewhere they are compared every WATCH_INTERVAL milliseconds.
+
+#define WATCH_INTERVAL  20
+#define WATCH_EVENTS    (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ATTRIB)
+
+// A file read by the last build, it is built again when one of them changes
+struct WatchedFile
+{
+    char *filename;
+    BOOL exists;
+    time_t modified;
+    long modified_nanoseconds; // where it is known, two changes in the same second are not missed
+    long long size;
+};
+
+struct WatchedFiles
+{
+    struct WatchedFile *files;
+    int count;
+    int capacity;
+    int notify_fd; // inotify descriptor, -1 when the files are polled
+};
+
+static void get_watched_file_state(struct WatchedFile *file)
+{
+    struct stat file_stat;
+
+    file->exists = stat(file->filename, &file_stat) == 0;
+    file->modified = file->exists ? file_stat.st_mtime : 0;
+#ifdef __linux__
+    file->modified_nanoseconds = file->exists ? file_stat.st_mtim.tv_nsec : 0;
+#else
+    file->modified_nanoseconds = 0;
+#endif
+    file->size = file->exists ? (long long)file_stat.st_size : 0;
+}
+
+static void add_watched_file(struct WatchedFiles *files, char *filename)
+{
+    for(int i = 0; i < files->count; i++)
+    {
+        if (!strcmp(files->files[i].filename, filename)) { return; }
+    }
+
+    if (files->count == files->capacity)
+    {
+        files->capacity = MAX(16, files->capacity * 2);
+        files->files = (struct WatchedFile *)realloc(files->files, sizeof(struct WatchedFile) * files->capacity);
+    }
+
+    struct WatchedFile *file = &files->files[files->count++];
+    file->filename = (char *)malloc(strlen(filename) + 1);
+    strcpy(file->filename, filename);
+    get_watched_file_state(file);
+}
+
+static BOOL is_watched_file_state_equal(struct WatchedFile *file1, struct WatchedFile *file2)
+{
+    return file1->exists == file2->exists && file1->modified == file2->modified &&
+        file1->modified_nanoseconds == file2->modified_nanoseconds && file1->size == file2->size;
+}
+
+static BOOL has_watched_file_changed(struct WatchedFiles *files)
+{
+    for(int i = 0; i < files->count; i++)
+    {
+        struct WatchedFile file = files->files[i];
+        get_watched_file_state(&file);
+        if (!is_watched_file_state_equal(&file, &files->files[i]))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static void free_watched_files(struct WatchedFiles *files)
+{
+    for(int i = 0; i < files->count; i++)
+    {
+        free(files->files[i].filename);
+    }
+    free(files->files);
+    files->files = NULL;
+    files->count = files->capacity = 0;
+}
+
+// The directories of the files are watched, an editor saving a file may replace it with a new one.
+// The descriptor is kept between builds so a change made during a build is not missed, a directory
+// that can't be watched makes the files polled.
+static void start_watch_notifications(struct WatchedFiles *files)
+{
+#ifdef __linux__
+    if (files->notify_fd < 0)
+    {
+        files->notify_fd = inotify_init1(IN_CLOEXEC);
+    }
+
+    for(int i = 0; files->notify_fd >= 0 && i < files->count; i++)
+    {
+        char directory[512];
+        char *filename = files->files[i].filename;
+        char *separator = strrchr(filename, '/');
+        if (separator == NULL)
+        {
+            strcpy(directory, ".");
+        }
+        else
+        {
+            snprintf(directory, sizeof(directory), "%.*s", separator == filename ? 1 : (int)(separator - filename), filename);
+        }
+
+        // A directory already watched gives the same watch
+        if (inotify_add_watch(files->notify_fd, directory, WATCH_EVENTS) < 0)
+        {
+            close(files->notify_fd);
+            files->notify_fd = -1;
+        }
+    }
+#endif
+}
+
+static void stop_watch_notifications(struct WatchedFiles *files)
+{
+#ifdef __linux__
+    if (files->notify_fd >= 0)
+    {
+        close(files->notify_fd);
+    }
+#endif
+    files->notify_fd = -1;
+}
+
+// Takes the changes notified, waiting for one when there is none. The changes are to any file in the
+// directories watched, the files are compared after them.
+static void take_watch_notifications(struct WatchedFiles *files)
+{
+#ifdef __linux__
+    char events[4096];
+    if (read(files->notify_fd, events, sizeof(events)) < 0 && errno != EINTR)
+    {
+        stop_watch_notifications(files);
+    }
+#endif
+}
+
+static void wait_for_watched_file_change(struct WatchedFiles *files)
+{
+    do
+    {
+        if (files->notify_fd >= 0)
+        {
+            take_watch_notifications(files);
+        }
+        else
+        {
+            sleep_thread(WATCH_INTERVAL);
+        }
+    } while (!has_watched_file_changed(files));
+}
+
+#ifdef _WIN32
+
+static void add_read_file(char *filename, BOOL binary, uint8_t *digest, void *argument)
+{
+    add_watched_file((struct WatchedFiles *)argument, filename);
+}
+
+// Without processes to throw away the build runs here, destroying its context gives its memory back
+static int build(struct Z80HLAContext *(*create_build_context)(void *argument), void *argument, int output_fd, struct WatchedFiles *files)
+{
+    struct Z80HLAContext *compile_context = create_build_context(argument);
+    int result = assemble(compile_context);
+
+    struct Z80HLAContext *previous_context = context;
+    context = compile_context;
+    for_each_cached_file(add_read_file, files);
+    context = previous_context;
+
+    destroy_context(compile_context);
+
+    return result;
+}
+
+int serve(char *socket_path, BOOL watch, char *input_filename, struct Z80HLAContext *(*create_build_context)(void *argument), void *argument)
+{
+    printf("Error: --serve is not supported on Windows\n");
+    return 1;
+}
+
+int request_build(char *socket_path)
+{
+    printf("Error: --client is not supported on Windows\n");
+    return 1;
+}
+
+BOOL is_warm_cache_used()
+{
+    return FALSE;
+}
+
+char *read_warm_file(char *filename, BOOL binary, long *size)
+{
+    return NULL;
+}
+
+char *get_warm_precompiled(char *filename, uint8_t *key)
+{
+    return NULL;
+}
+
+void add_warm_precompiled(char *filename, uint8_t *key, char *block, int size)
+{
+}
+
+#else
+
+#include <errno.h>
+#include <signal.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// A file read by the last build with its content, the content is kept while the file is unchanged
+struct WarmFile
+{
+    struct WatchedFile state;
+    BOOL binary;
+    BOOL read; // by the last build
+    char *content;
+    long size;
+};
+
+// The precompiled block of an included file, only the last one of each file is kept
+struct WarmPrecompiled
+{
+    char *filename;
+    uint8_t key[SHA256_SIZE];
+    char *block;
+    int size;
+};
+
+struct WarmCache
+{
+    struct WarmFile *files;
+    int files_count;
+    int files_capacity;
+    struct WarmPrecompiled *precompiled;
+    int precompiled_count;
+    int precompiled_capacity;
+
+    // Blocks of the files parsed by a build, sent back to the server when it finishes
+    struct WarmPrecompiled *added;
+    int added_count;
+    int added_capacity;
+    struct Mutex *added_mutex;
+};
+
+// Only set in the server, the build processes have their own copy
+static struct WarmCache *warm_cache = NULL;
+
+BOOL is_warm_cache_used()
+{
+    return warm_cache != NULL;
+}
+
+static struct WarmFile *find_warm_file(char *filename, BOOL binary)
+{
+    for(int i = 0; i < warm_cache->files_count; i++)
+    {
+        if (warm_cache->files[i].binary == binary && !strcmp(warm_cache->files[i].state.filename, filename))
+        {
+            return &warm_cache->files[i];
+        }
+    }
+
+    return NULL;
+}
+
+// A copy of the content kept for a file still unchanged (the lexer changes the content), NULL if there is none
+char *read_warm_file(char *filename, BOOL binary, long *size)
+{
+    if (warm_cache == NULL) { return NULL; }
+
+    struct WarmFile *file = find_warm_file(filename, binary);
+    if (file == NULL || file->content == NULL) { return NULL; }
+
+    struct WatchedFile state = file->state;
+    get_watched_file_state(&state);
+    if (!is_watched_file_state_equal(&state, &file->state)) { return NULL; }
+
+    char *content = (char *)malloc((size_t)file->size + 1);
+    memcpy(content, file->content, (size_t)file->size + 1);
+    *size = file->size;
+
+    return content;
+}
+
+// A copy of the precompiled block kept for the content and options of an included file, NULL if there is none
+char *get_warm_precompiled(char *filename, uint8_t *key)
+{
+    if (warm_cache == NULL) { return NULL; }
+
+    for(int i = 0; i < warm_cache->precompiled_count; i++)
+    {
+        struct WarmPrecompiled *precompiled = &warm_cache->precompiled[i];
+        if (!memcmp(precompiled->key, key, SHA256_SIZE) && !strcmp(precompiled->filename, filename))
+        {
+            char *block = (char *)malloc(precompiled->size);
+            memcpy(block, precompiled->block, precompiled->size);
+            return block;
+        }
+    }
+
+    return NULL;
+}
+
+static void add_precompiled(struct WarmPrecompiled **precompiled, int *count, int *capacity, char *filename, uint8_t *key, char *block, int size)
+{
+    if (*count == *capacity)
+    {
+        *capacity = MAX(16, *capacity * 2);
+        *precompiled = (struct WarmPrecompiled *)realloc(*precompiled, sizeof(struct WarmPrecompiled) * *capacity);
+    }
+
+    struct WarmPrecompiled *new_precompiled = &(*precompiled)[(*count)++];
+    new_precompiled->filename = (char *)malloc(strlen(filename) + 1);
+    strcpy(new_precompiled->filename, filename);
+    memcpy(new_precompiled->key, key, SHA256_SIZE);
+    new_precompiled->block = (char *)malloc(size);
+    memcpy(new_precompiled->block, block, size);
+    new_precompiled->size = size;
+}
+
+// Called by the threads of a build parsing the included files
+void add_warm_precompiled(char *filename, uint8_t *key, char *block, int size)
+{
+    if (warm_cache == NULL) { return; }
+
+    lock_mutex(warm_cache->added_mutex);
+    add_precompiled(&warm_cache->added, &warm_cache->added_count, &warm_cache->added_capacity, filename, key, block, size);
+    unlock_mutex(warm_cache->added_mutex);
+}
+
+static void free_precompiled(struct WarmPrecompiled *precompiled)
+{
+    free(precompiled->filename);
+    free(precompiled->block);
+}
+
+// The block replaces the one kept for the same file
+static void keep_precompiled(char *filename, uint8_t *key, char *block, int size)
+{
+    for(int i = 0; i < warm_cache->precompiled_count; i++)
+    {
+        if (!strcmp(warm_cache->precompiled[i].filename, filename))
+        {
+            free_precompiled(&warm_cache->precompiled[i]);
+            warm_cache->precompiled[i] = warm_cache->precompiled[--warm_cache->precompiled_count];
+            break;
+        }
+    }
+
+    add_precompiled(&warm_cache->precompiled, &warm_cache->precompiled_count, &warm_cache->precompiled_capacity, filename, key, block, size);
+}
+
+static void set_warm_file_read(char *filename, BOOL binary)
+{
+    struct WarmFile *file = find_warm_file(filename, binary);
+    if (file == NULL)
+    {
+        if (warm_cache->files_count == warm_cache->files_capacity)
+        {
+            warm_cache->files_capacity = MAX(16, warm_cache->files_capacity * 2);
+            warm_cache->files = (struct WarmFile *)realloc(warm_cache->files, sizeof(struct WarmFile) * warm_cache->files_capacity);
+        }
+        file = &warm_cache->files[warm_cache->files_count++];
+        memset(file, 0, sizeof(*file));
+        file->state.filename = (char *)malloc(strlen(filename) + 1);
+        strcpy(file->state.filename, filename);
+        file->binary = binary;
+    }
+    file->read = TRUE;
+}
+
+static BOOL is_warm_file_read(char *filename)
+{
+    for(int i = 0; i < warm_cache->files_count; i++)
+    {
+        if (!strcmp(warm_cache->files[i].state.filename, filename)) { return TRUE; }
+    }
+
+    return FALSE;
+}
+
+// After a build, while no client waits, the files it read that changed are read again and the ones it
+// did not read are dropped with their precompiled blocks. A file changing while it is read is not kept.
+static void update_warm_cache()
+{
+    for(int i = 0; i < warm_cache->files_count; i++)
+    {
+        struct WarmFile *file = &warm_cache->files[i];
+        if (!file->read)
+        {
+            free(file->state.filename);
+            free(file->content);
+            warm_cache->files[i--] = warm_cache->files[--warm_cache->files_count];
+            continue;
+        }
+
+        struct WatchedFile state = file->state;
+        get_watched_file_state(&state);
+        if (file->content != NULL && is_watched_file_state_equal(&state, &file->state)) { continue; }
+
+        free(file->content);
+        file->content = NULL;
+
+        FILE *fp = state.exists ? fopen(file->state.filename, file->binary ? "rb" : "r") : NULL;
+        if (fp == NULL) { continue; }
+
+        char *content = (char *)malloc((size_t)state.size + 1);
+        size_t read_size = fread(content, 1, (size_t)state.size + 1, fp);
+        fclose(fp);
+
+        struct WatchedFile read_state = state;
+        get_watched_file_state(&read_state);
+        if (read_size != (size_t)state.size || !is_watched_file_state_equal(&state, &read_state))
+        {
+            free(content);
+            continue;
+        }
+
+        content[read_size] = 0;
+        file->content = content;
+        file->size = (long)read_size;
+        file->state = state;
+    }
+
+    for(int i = 0; i < warm_cache->precompiled_count; i++)
+    {
+        if (!is_warm_file_read(warm_cache->precompiled[i].filename))
+        {
+            free_precompiled(&warm_cache->precompiled[i]);
+            warm_cache->precompiled[i--] = warm_cache->precompiled[--warm_cache->precompiled_count];
+        }
+    }
+}
+
+static void write_read_file(char *filename, BOOL binary, uint8_t *digest, void *argument)
+{
+    fprintf((FILE *)argument, "%c %s\n", binary ? 'b' : 't', filename);
+}
+
+// Lines are "t|b FILE" for each file read and "precompiled KEY SIZE FILE" followed by the block
+static void write_build_files(FILE *fp)
+{
+    for_each_cached_file(write_read_file, fp);
+
+    for(int i = 0; warm_cache != NULL && i < warm_cache->added_count; i++)
+    {
+        struct WarmPrecompiled *precompiled = &warm_cache->added[i];
+        char key_text[SHA256_SIZE * 2 + 1];
+        sprint_digest(key_text, precompiled->key);
+        fprintf(fp, "precompiled %s %d %s\n", key_text, precompiled->size, precompiled->filename);
+        fwrite(precompiled->block, 1, precompiled->size, fp);
+    }
+}
+
+static void read_build_files(FILE *fp, struct WatchedFiles *files)
+{
+    char line[1024], key_text[SHA256_SIZE * 2 + 1];
+    uint8_t key[SHA256_SIZE];
+    int size, name_start = 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        line[strcspn(line, "\n")] = 0;
+
+        if (sscanf(line, "precompiled %64s %d %n", key_text, &size, &name_start) == 2 && name_start > 0 && size > 0)
+        {
+            char *block = (char *)malloc(size);
+            if (fread(block, 1, size, fp) == (size_t)size && warm_cache != NULL && sscan_digest(key_text, key))
+            {
+                keep_precompiled(line + name_start, key, block, size);
+            }
+            free(block);
+        }
+        else if ((line[0] == 't' || line[0] == 'b') && line[1] == ' ')
+        {
+            add_watched_file(files, line + 2);
+            if (warm_cache != NULL)
+            {
+                set_warm_file_read(line + 2, line[0] == 'b');
+            }
+        }
+    }
+}
+
+// The build runs in a child process writing its messages to output_fd (when it is not -1),
+// the files it read and the included files it parsed are sent back through a pipe
+static int build(struct Z80HLAContext *(*create_build_context)(void *argument), void *argument, int output_fd, struct WatchedFiles *files)
+{
+    int files_pipe[2];
+    if (pipe(files_pipe))
+    {
+        write_error("Unable to create a pipe");
+        return 1;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(files_pipe[0]);
+        close(files_pipe[1]);
+        write_error("Unable to create a process");
+        return 1;
+    }
+
+    if (pid == 0)
+    {
+        close(files_pipe[0]);
+        if (output_fd >= 0)
+        {
+            dup2(output_fd, STDOUT_FILENO);
+            dup2(output_fd, STDERR_FILENO);
+        }
+
+        struct Z80HLAContext *compile_context = create_build_context(argument);
+        int result = assemble(compile_context);
+        fflush(stdout);
+
+        FILE *fp = fdopen(files_pipe[1], "w");
+        context = compile_context;
+        write_build_files(fp);
+        fclose(fp);
+
+        _exit(result);
+    }
+
+    close(files_pipe[1]);
+
+    for(int i = 0; warm_cache != NULL && i < warm_cache->files_count; i++)
+    {
+        warm_cache->files[i].read = FALSE;
+    }
+
+    FILE *fp = fdopen(files_pipe[0], "r");
+    read_build_files(fp, files);
+    fclose(fp);
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+static BOOL get_socket_address(struct sockaddr_un *address, char *socket_path)
+{
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address->sun_path))
+    {
+        printf("Error: Socket path too long \"%s\"\n", socket_path);
+        return FALSE;
+    }
+    strcpy(address->sun_path, socket_path);
+
+    return TRUE;
+}
+
+static void write_all(int fd, char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written <= 0) { return; }
+        data += written;
+        size -= (size_t)written;
+    }
+}
+
+// A client sends "build" and gets the messages of the build, a 0 and the exit status.
+// With watch the input file is also built when a file read by the last build changes.
+int serve(char *socket_path, BOOL watch, char *input_filename, struct Z80HLAContext *(*create_build_context)(void *argument), void *argument)
+{
+    struct sockaddr_un address;
+    if (!get_socket_address(&address, socket_path)) { return 1; }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path);
+    if (server_fd < 0 || bind(server_fd, (struct sockaddr *)&address, sizeof(address)) || listen(server_fd, 16))
+    {
+        printf("Error: Unable to listen on \"%s\"\n", socket_path);
+        return 1;
+    }
+
+    printf("Serving builds on \"%s\"\n", socket_path);
+
+    warm_cache = (struct WarmCache *)calloc(1, sizeof(struct WarmCache));
+    warm_cache->added_mutex = create_mutex();
+
+    struct WatchedFiles files = { NULL, 0, 0, -1 };
+    if (watch)
+    {
+        add_watched_file(&files, input_filename);
+        build(create_build_context, argument, -1, &files);
+        start_watch_notifications(&files);
+        update_warm_cache();
+    }
+
+    while (TRUE)
+    {
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        FD_SET(server_fd, &read_fds);
+        BOOL notified = watch && files.notify_fd >= 0;
+        if (notified)
+        {
+            FD_SET(files.notify_fd, &read_fds);
+        }
+        struct timeval timeout = { 0, WATCH_INTERVAL * 1000 };
+
+        int ready = select(MAX(server_fd, files.notify_fd) + 1, &read_fds, NULL, NULL, watch && !notified ? &timeout : NULL);
+        if (ready < 0 && errno != EINTR) { break; }
+
+        if (ready > 0 && FD_ISSET(server_fd, &read_fds))
+        {
+            int client_fd = accept(server_fd, NULL, NULL);
+            if (client_fd < 0) { continue; }
+
+            char request[64];
+            ssize_t request_size = read(client_fd, request, sizeof(request) - 1);
+            request[MAX(request_size, 0)] = 0;
+
+            BOOL built = !strncmp(request, "build", 5);
+            if (built)
+            {
+                free_watched_files(&files);
+                add_watched_file(&files, input_filename);
+
+                char status[16];
+                int result = build(create_build_context, argument, client_fd, &files);
+                if (watch)
+                {
+                    start_watch_notifications(&files);
+                }
+                status[0] = 0;
+                sprintf(status + 1, "%d\n", result);
+                write_all(client_fd, status, strlen(status + 1) + 1);
+            }
+            close(client_fd);
+
+            // The client has its answer before the files read are kept
+            if (built)
+            {
+                update_warm_cache();
+            }
+        }
+        else if (watch)
+        {
+            if (ready > 0)
+            {
+                take_watch_notifications(&files);
+            }
+            if (has_watched_file_changed(&files))
+            {
+                free_watched_files(&files);
+                add_watched_file(&files, input_filename);
+                build(create_build_context, argument, -1, &files);
+                start_watch_notifications(&files);
+                update_warm_cache();
+            }
+        }
+    }
+
+    stop_watch_notifications(&files);
+    free_watched_files(&files);
+    close(server_fd);
+    unlink(socket_path);
+
+    return 1;
+}
+
+// Asks a server for a build, its messages are written here and its exit status returned
+int request_build(char *socket_path)
+{
+    struct sockaddr_un address;
+    if (!get_socket_address(&address, socket_path)) { return 1; }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)))
+    {
+        printf("Error: Unable to connect to \"%s\"\n", socket_path);
+        return 1;
+    }
+
+    write_all(fd, "build\n", 6);
+
+    char *response = NULL;
+    size_t response_size = 0, response_capacity = 0;
+    ssize_t read_size;
+    do
+    {
+        if (response_size + 4096 > response_capacity)
+        {
+            response_capacity = MAX(65536, response_capacity * 2);
+            response = (char *)realloc(response, response_capacity);
+        }
+        read_size = read(fd, response + response_size, response_capacity - response_size - 1);
+        response_size += read_size > 0 ? (size_t)read_size : 0;
+    } while (read_size > 0 || (read_size < 0 && errno == EINTR));
+    close(fd);
+
+    // The messages end with a 0 followed by the exit status
+    size_t end = response_size;
+    while (end > 0 && response[end - 1] != 0) { end--; }
+    if (end == 0)
+    {
+        fwrite(response, 1, response_size, stdout);
+        free(response);
+        printf("Error: Build interrupted\n");
+        return 1;
+    }
+
+    response[response_size] = 0;
+    fwrite(response, 1, end - 1, stdout);
+    int result = atoi(response + end);
+    free(response);
+
+    return result;
+}
+
+#endif
+
+// Builds the input file every time a file read by the last build changes
+int watch_input(char *input_filename, struct Z80HLAContext *(*create_build_context)(void *argument), void *argument)
+{
+    struct WatchedFiles files = { NULL, 0, 0, -1 };
+
+    while (TRUE)
+    {
+        add_watched_file(&files, input_filename);
+        int result = build(create_build_context, argument, -1, &files);
+        start_watch_notifications(&files);
+        printf("Build finished with exit status %d, watching %d files\n\n", result, files.count);
+        fflush(stdout);
+
+        wait_for_watched_file_change(&files);
+        free_watched_files(&files);
+    }
+
+    return 0;
+}
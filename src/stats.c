@@ -0,0 +1,166 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "z80hla.h"
+
+// Counters of what a compilation does, to compare the memory and the lookups of different versions
+// on the same files. Each thread counts in its own counters so counting is just an increment.
+
+struct Stats
+{
+    struct Mutex *mutex;
+    uint64_t start;
+    struct StatsCounters *first_counters;
+};
+
+static THREAD_LOCAL struct Stats *thread_stats = NULL;
+static THREAD_LOCAL uint64_t thread_stats_start = 0;
+static THREAD_LOCAL struct StatsCounters *thread_counters = NULL;
+
+void start_stats()
+{
+    if (context->stats_filename == NULL) { return; }
+
+    context->stats = (struct Stats *)calloc(1, sizeof(struct Stats));
+    context->stats->mutex = create_mutex();
+    context->stats->start = get_time_nanoseconds();
+}
+
+// Counters of the calling thread, added to the list the first time
+struct StatsCounters *get_stats_counters()
+{
+    struct Stats *stats = context->stats;
+
+    if (thread_stats != stats || thread_stats_start != stats->start)
+    {
+        thread_counters = (struct StatsCounters *)calloc(1, sizeof(struct StatsCounters));
+        thread_stats = stats;
+        thread_stats_start = stats->start;
+
+        lock_mutex(stats->mutex);
+        thread_counters->next = stats->first_counters;
+        stats->first_counters = thread_counters;
+        unlock_mutex(stats->mutex);
+    }
+
+    return thread_counters;
+}
+
+// Counts of the node types that were counted
+static void fprint_node_type_counts(FILE *fp, uint64_t *counts)
+{
+    uint64_t total = 0;
+    for(int i = 0; i < NODE_TYPE_COUNT; i++)
+    {
+        total += counts[i];
+    }
+
+    fprintf(fp, "{\"total\":%" PRIu64, total);
+    for(int i = 0; i < NODE_TYPE_COUNT; i++)
+    {
+        if (counts[i] > 0)
+        {
+            fprintf(fp, ",\"%s\":%" PRIu64, node_type_names[i], counts[i]);
+        }
+    }
+    fprintf(fp, "}");
+}
+
+static void fprint_stats(FILE *fp, struct StatsCounters *counters)
+{
+    fprintf(fp, "{\n\"nodes_created\":");
+    fprint_node_type_counts(fp, counters->nodes_created);
+    fprintf(fp, ",\n\"nodes_duplicated\":");
+    fprint_node_type_counts(fp, counters->nodes_duplicated);
+    fprintf(fp, ",\n\"output_elements\":%" PRIu64, counters->output_elements);
+    fprintf(fp, ",\n\"output_fixups\":");
+    fprint_node_type_counts(fp, counters->output_fixups);
+    fprintf(fp, ",\n\"lookups\":{\"constants\":%" PRIu64 ",\"data_symbols\":%" PRIu64 ",\"structured_types\":%" PRIu64 ",\"inline_symbols\":%" PRIu64 ",\"library_symbols\":%" PRIu64 "}",
+        counters->constant_lookups, counters->data_symbol_lookups, counters->structured_type_lookups, counters->inline_symbol_lookups, counters->library_symbol_lookups);
+    fprintf(fp, ",\n\"string_compares\":%" PRIu64, counters->string_compares);
+    fprintf(fp, ",\n");
+    fprint_tables_stats(fp);
+    fprintf(fp, ",\n\"generated_labels\":%d", context->new_label_count);
+    fprintf(fp, ",\n\"peak_memory\":%" PRIu64 "\n}\n", get_peak_memory());
+}
+
+// Writes the counters of every thread added together and frees them
+int finish_stats()
+{
+    struct Stats *stats = context->stats;
+    struct StatsCounters counters;
+    char stats_path[256];
+    int result = 0;
+
+    if (stats == NULL) { return 0; }
+
+    memset(&counters, 0, sizeof(counters));
+    for(struct StatsCounters *thread_counters = stats->first_counters; thread_counters != NULL; )
+    {
+        for(int i = 0; i < NODE_TYPE_COUNT; i++)
+        {
+            counters.nodes_created[i] += thread_counters->nodes_created[i];
+            counters.nodes_duplicated[i] += thread_counters->nodes_duplicated[i];
+            counters.output_fixups[i] += thread_counters->output_fixups[i];
+        }
+        counters.output_elements += thread_counters->output_elements;
+        counters.constant_lookups += thread_counters->constant_lookups;
+        counters.data_symbol_lookups += thread_counters->data_symbol_lookups;
+        counters.structured_type_lookups += thread_counters->structured_type_lookups;
+        counters.inline_symbol_lookups += thread_counters->inline_symbol_lookups;
+        counters.library_symbol_lookups += thread_counters->library_symbol_lookups;
+        counters.string_compares += thread_counters->string_compares;
+
+        struct StatsCounters *next_counters = thread_counters->next;
+        free(thread_counters);
+        thread_counters = next_counters;
+    }
+    context->stats = NULL;
+    destroy_mutex(stats->mutex);
+    free(stats);
+
+    if (!strcmp(context->stats_filename, "-"))
+    {
+        fprint_stats(stdout, &counters);
+        return 0;
+    }
+
+    get_output_path(stats_path, context->stats_filename);
+    FILE *fp = fopen(stats_path, "w");
+    if (fp == NULL)
+    {
+        write_error("Unable to write statistics file \"%s\"", stats_path);
+        result = 1;
+    }
+    else
+    {
+        fprint_stats(fp, &counters);
+        fclose(fp);
+    }
+
+    return result;
+}
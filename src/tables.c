@@ -39,18 +39,16 @@ struct ConstantList
 	struct ConstantList *next;
 };
 
-struct ConstantList *first_constant = NULL;
-
 void fprint_constants(FILE *fp)
 {
-	struct ConstantList *current_constant = first_constant;
-	BOOL first_constant = TRUE;
+	struct ConstantList *current_constant = context->first_constant;
+	BOOL is_first_constant = TRUE;
 
 	fprintf(fp, "{\n");
 
 	while(current_constant != NULL)
 	{
-		if (!first_constant)
+		if (!is_first_constant)
 		{
 			fprintf(fp, ",\n");
 		}
@@ -62,23 +60,23 @@ void fprint_constants(FILE *fp)
 		{
 			fprintf(fp, "\t\"%.*s::%.*s\":%"PRId64"", current_constant->library_size, current_constant->library_name, current_constant->name_size, current_constant->name, current_constant->value);
 		}
-		first_constant = FALSE;
+		is_first_constant = FALSE;
 		current_constant = current_constant->next;
 	}
 
 	fprintf(fp, "}");
 }
 
-void fprintf_output_symbols(FILE *fp)
+void fprintf_output_symbols(FILE *fp, BOOL include_generated_labels)
 {
-	struct ConstantList *current_constant = first_constant;
-	BOOL first_constant = TRUE;
+	struct ConstantList *current_constant = context->first_constant;
+	BOOL is_first_constant = TRUE;
 
 	fprintf(fp, "{\n");
 
 	while(current_constant != NULL)
 	{
-		if (!first_constant)
+		if (!is_first_constant)
 		{
 			fprintf(fp, ",\n");
 		}
@@ -90,16 +88,31 @@ void fprintf_output_symbols(FILE *fp)
 		{
 			fprintf(fp, "\t\"%.*s::%.*s\":%"PRId64"", current_constant->library_size, current_constant->library_name, current_constant->name_size, current_constant->name, current_constant->value);
 		}
-		first_constant = FALSE;
+		is_first_constant = FALSE;
 		current_constant = current_constant->next;
 	}
 
+	if (include_generated_labels)
+	{
+		for(int i = 0; i < context->generated_labels_capacity; i++)
+		{
+			if (context->generated_labels[i] < 0) { continue; }
+
+			if (!is_first_constant)
+			{
+				fprintf(fp, ",\n");
+			}
+			fprintf(fp, "\t\"@l_%d\":%"PRId32"", i, context->generated_labels[i]);
+			is_first_constant = FALSE;
+		}
+	}
+
 	fprintf(fp, "}");
 }
 
 int set_constant(char *library_name, int library_size, char *name, int name_size, int64_t value)
 {
-	struct ConstantList *current_constant = first_constant, *prev_constant = NULL;	
+	struct ConstantList *current_constant = context->first_constant, *prev_constant = NULL;	
 	struct ConstantList *new_constant = NULL;
 
 	while(current_constant != NULL)
@@ -126,7 +139,7 @@ int set_constant(char *library_name, int library_size, char *name, int name_size
 
 	if (prev_constant == NULL)
 	{
-		first_constant = new_constant;
+		context->first_constant = new_constant;
 	}
 	else
 	{
@@ -138,7 +151,9 @@ int set_constant(char *library_name, int library_size, char *name, int name_size
 
 int get_constant(char *library_name, int library_size, char *name, int name_size, int64_t *value)
 {
-	struct ConstantList *current_constant = first_constant;
+	struct ConstantList *current_constant = context->first_constant;
+
+	COUNT_STAT(constant_lookups);
 
 	while(current_constant != NULL)
 	{
@@ -173,20 +188,17 @@ struct IncludeFileStack
 	struct IncludeFileStack *next_element, *last_element;
 };
 
-struct IncludeFileStack *start_include_stack = NULL, *end_include_stack = NULL;
-int include_stack_size = 0;
-
 int push_include_file(char *filename)
 {
 	struct IncludeFileStack *element;	
 
-	if (include_stack_size >= INCLUDE_STACK_MAX)
+	if (context->include_stack_size >= INCLUDE_STACK_MAX)
 	{
 		return INCLUDE_ERROR_OVER_MAX_STACK;
 	}
 
 	// Look for this filename in the stack
-	element = start_include_stack;
+	element = context->start_include_stack;
 	while(element != NULL)
 	{
 		if (!strcmp(element->filename, filename))
@@ -200,19 +212,19 @@ int push_include_file(char *filename)
 	element->filename = filename;
 	element->next_element = NULL;
 
-	if (end_include_stack == NULL)
+	if (context->end_include_stack == NULL)
 	{
-		start_include_stack = end_include_stack = element;
-		start_include_stack->last_element = NULL;
+		context->start_include_stack = context->end_include_stack = element;
+		context->start_include_stack->last_element = NULL;
 	}
 	else
 	{
-		element->last_element = end_include_stack;
-		end_include_stack->next_element = element;
-		end_include_stack = element;		
+		element->last_element = context->end_include_stack;
+		context->end_include_stack->next_element = element;
+		context->end_include_stack = element;		
 	}
 
-	include_stack_size++;
+	context->include_stack_size++;
 
 	write_debug("Pushed include file \"%s\" to the stack", filename);
 
@@ -222,75 +234,233 @@ int push_include_file(char *filename)
 void pop_include_file()
 {
 	struct IncludeFileStack *element;
-	element = end_include_stack;
-	if (end_include_stack != NULL)
+	element = context->end_include_stack;
+	if (context->end_include_stack != NULL)
 	{
-		if (end_include_stack->last_element != NULL)
+		if (context->end_include_stack->last_element != NULL)
 		{
-			end_include_stack->last_element->next_element = NULL;
-			end_include_stack = end_include_stack->last_element;
+			context->end_include_stack->last_element->next_element = NULL;
+			context->end_include_stack = context->end_include_stack->last_element;
 		}
 		else
 		{
-			start_include_stack = end_include_stack = NULL;
+			context->start_include_stack = context->end_include_stack = NULL;
 		}
 
 		write_debug("Popped include file \"%s\" to the stack", element->filename);
 
 		free(element);
 
-		include_stack_size--;		
+		context->include_stack_size--;		
 	}
 }
 
 // *************
-// Source cache
+// File cache
 // *************
 
 struct ContentCache
 {
 	char *filename;
+	BOOL binary;
+
 	char *content;
+	long size;
+	int error;
+	uint8_t digest[SHA256_SIZE]; // SHA-256 of the content as it was read, for incremental builds and the build cache
+
+	struct Mutex *loading; // held by the thread reading the file
 
 	struct ContentCache *next_element;
 };
 
-struct ContentCache *first_content_cache_element = NULL, *last_content_cache_element = NULL;
+static void digest_content(uint8_t *digest, char *content, size_t size)
+{
+	struct Sha256 sha256;
+	init_sha256(&sha256);
+	update_sha256(&sha256, content, size);
+	finish_sha256(&sha256, digest);
+}
+
+static char *read_file_from_disk(struct ContentCache *element, long *size)
+{
+	FILE *fp = fopen(element->filename, element->binary ? "rb" : "r");
+	if (!fp)
+	{
+		element->error = FILE_ERROR_OPEN;
+		return NULL;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	long file_size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	char *content = (char *)malloc((size_t)file_size + 1);
+	size_t read_size = fread(content, sizeof(char), (size_t)file_size, fp);
+	fclose(fp);
 
-char *get_content_from_cache(char *filename)
+	if (read_size != file_size)
+	{
+		free(content);
+		element->error = FILE_ERROR_READ;
+		return NULL;
+	}
+
+	content[file_size] = 0;
+	*size = file_size;
+	return content;
+}
+
+// A file unchanged since the server kept it is not read again
+static void read_file_content(struct ContentCache *element)
 {
-	struct ContentCache *current_element = first_content_cache_element;	
+	long file_size = 0;
+	char *content = read_warm_file(element->filename, element->binary, &file_size);
+	if (content == NULL)
+	{
+		content = read_file_from_disk(element, &file_size);
+		if (content == NULL) { return; }
+	}
 
+	element->content = content;
+	element->size = file_size;
+	if (context->incremental || context->cache_directory != NULL)
+	{
+		digest_content(element->digest, content, (size_t)file_size);
+	}
+	write_debug("Read file \"%s\" with the size of %ld bytes.", element->filename, file_size);
+}
+
+// Returns the content of a file, it is only read the first time and other threads
+// wanting it at the same time wait for it. When it was read by this call, on_read
+// is called with the content before any other thread can use it.
+char *read_file_to_cache(char *filename, BOOL binary, long *size, int *error, void (*on_read)(char *filename, char *content))
+{
+	struct ContentCache *current_element;
+	BOOL read_here = FALSE;
+
+	lock_mutex(context->tables_mutex);
+
+	current_element = context->first_content_cache_element;
 	while(current_element != NULL)
 	{
-		if (!strcmp(current_element->filename, filename))
+		if (current_element->binary == binary && !strcmp(current_element->filename, filename))
 		{
-			return current_element->content;
+			break;
 		}
 		current_element = current_element->next_element;
 	}
 
-	return NULL;
+	if (current_element == NULL)
+	{
+		current_element = (struct ContentCache*)malloc(sizeof(struct ContentCache));
+		current_element->filename = filename;
+		current_element->binary = binary;
+		current_element->content = NULL;
+		current_element->size = 0;
+		current_element->error = 0;
+		current_element->loading = create_mutex();
+		current_element->next_element = NULL;
+		lock_mutex(current_element->loading);
+
+		if (context->last_content_cache_element == NULL)
+		{
+			context->first_content_cache_element = context->last_content_cache_element = current_element;
+		}
+		else
+		{
+			context->last_content_cache_element->next_element = current_element;
+			context->last_content_cache_element = current_element;
+		}
+
+		read_here = TRUE;
+	}
+
+	unlock_mutex(context->tables_mutex);
+
+	if (read_here)
+	{
+		read_file_content(current_element);
+		if (current_element->content != NULL && on_read != NULL)
+		{
+			on_read(filename, current_element->content);
+		}
+	}
+	else
+	{
+		write_debug("Using content from cache for file \"%s\"", filename);
+		lock_mutex(current_element->loading);
+	}
+	unlock_mutex(current_element->loading);
+
+	if (size != NULL) { *size = current_element->size; }
+	if (error != NULL) { *error = current_element->error; }
+
+	return current_element->content;
 }
 
-void add_content_to_cache(char *filename, char *content)
+// Puts the content of a file in the cache as if it was read, so the content given is used instead
+// of the one in the file (documents being edited and not saved)
+void add_file_to_cache(char *filename, char *content, long size)
 {
-	struct ContentCache *new_element;
-
-	new_element = (struct ContentCache*)malloc(sizeof(struct ContentCache));
+	struct ContentCache *new_element = (struct ContentCache*)malloc(sizeof(struct ContentCache));
 	new_element->filename = filename;
-	new_element->content = content;
+	new_element->binary = FALSE;
+	new_element->content = (char *)malloc((size_t)size + 1);
+	memcpy(new_element->content, content, (size_t)size);
+	new_element->content[size] = 0;
+	new_element->size = size;
+	new_element->error = 0;
+	if (context->incremental || context->cache_directory != NULL)
+	{
+		digest_content(new_element->digest, content, (size_t)size);
+	}
+	new_element->loading = create_mutex();
 	new_element->next_element = NULL;
 
-	if (last_content_cache_element == NULL)
+	lock_mutex(context->tables_mutex);
+	if (context->last_content_cache_element == NULL)
 	{
-		first_content_cache_element = last_content_cache_element = new_element;
+		context->first_content_cache_element = context->last_content_cache_element = new_element;
 	}
 	else
 	{
-		last_content_cache_element->next_element = new_element;
-		last_content_cache_element = new_element;
+		context->last_content_cache_element->next_element = new_element;
+		context->last_content_cache_element = new_element;
+	}
+	unlock_mutex(context->tables_mutex);
+}
+
+// Calls function for every file read, with the digest of its content when building incrementally or with the build cache
+void for_each_cached_file(void (*function)(char *filename, BOOL binary, uint8_t *digest, void *argument), void *argument)
+{
+	struct ContentCache *current_element = context->first_content_cache_element;
+
+	while(current_element != NULL)
+	{
+		if (current_element->content != NULL)
+		{
+			function(current_element->filename, current_element->binary, current_element->digest, argument);
+		}
+		current_element = current_element->next_element;
+	}
+}
+
+// Bytes read from each file, for the statistics
+static void fprint_files_read(FILE *fp)
+{
+	BOOL is_first_file = TRUE;
+
+	fprintf(fp, "\"files_read\":{");
+	for(struct ContentCache *current_element = context->first_content_cache_element; current_element != NULL; current_element = current_element->next_element)
+	{
+		if (current_element->content == NULL) { continue; }
+
+		if (!is_first_file) { fprintf(fp, ","); }
+		fprint_json_string(fp, current_element->filename);
+		fprintf(fp, ":%ld", current_element->size);
+		is_first_file = FALSE;
 	}
+	fprintf(fp, "}");
 }
 
 // *************
@@ -321,13 +491,10 @@ struct SymbolDependencies
 	struct SymbolDependencies *next;
 };
 
-static struct SymbolDependencies *library_symbol_dependencies = NULL;
-static struct SymbolList *library_symbols_used = NULL;
-
-void add_library_symbol_dependency(char *library_name, int library_size, char *symbol_name, int symbol_name_size,
+static void inner_add_library_symbol_dependency(char *library_name, int library_size, char *symbol_name, int symbol_name_size,
 	char *library_dependency_name, int library_dependency_name_size, char *symbol_dependency_name, int symbol_dependency_name_size)
 {
-	struct SymbolDependencies *current_symbol = library_symbol_dependencies, *last_symbol = library_symbol_dependencies;
+	struct SymbolDependencies *current_symbol = context->library_symbol_dependencies, *last_symbol = context->library_symbol_dependencies;
 
 	while(current_symbol != NULL)
 	{
@@ -388,9 +555,9 @@ void add_library_symbol_dependency(char *library_name, int library_size, char *s
 
 	new_dependency->dependencies = new_symbol;
 	
-	if (library_symbol_dependencies == NULL)
+	if (context->library_symbol_dependencies == NULL)
 	{
-		library_symbol_dependencies = new_dependency;
+		context->library_symbol_dependencies = new_dependency;
 	}
 	else
 	{
@@ -398,9 +565,21 @@ void add_library_symbol_dependency(char *library_name, int library_size, char *s
 	}
 }
 
+void add_library_symbol_dependency(char *library_name, int library_size, char *symbol_name, int symbol_name_size,
+	char *library_dependency_name, int library_dependency_name_size, char *symbol_dependency_name, int symbol_dependency_name_size)
+{
+	lock_mutex(context->tables_mutex);
+	inner_add_library_symbol_dependency(library_name, library_size, symbol_name, symbol_name_size,
+		library_dependency_name, library_dependency_name_size, symbol_dependency_name, symbol_dependency_name_size);
+	unlock_mutex(context->tables_mutex);
+
+	record_library_symbol_dependency(library_name, library_size, symbol_name, symbol_name_size,
+		library_dependency_name, library_dependency_name_size, symbol_dependency_name, symbol_dependency_name_size);
+}
+
 void fprint_library_symbol_dependencies(FILE *fp)
 {
-	struct SymbolDependencies *current_symbol = library_symbol_dependencies;
+	struct SymbolDependencies *current_symbol = context->library_symbol_dependencies;
 	BOOL first_symbol = TRUE, first_dependency = TRUE;
 
 	fprintf(fp, "[");
@@ -441,9 +620,9 @@ void fprint_library_symbol_dependencies(FILE *fp)
 	fprintf(fp, "]");
 }
 
-void add_library_symbol_used(char *library_name, int library_size, char *symbol_name, int symbol_name_size)
+static void inner_add_library_symbol_used(char *library_name, int library_size, char *symbol_name, int symbol_name_size)
 {
-	struct SymbolList *current_symbol = library_symbols_used, *last_symbol = library_symbols_used;
+	struct SymbolList *current_symbol = context->library_symbols_used, *last_symbol = context->library_symbols_used;
 
 	while(current_symbol != NULL)
 	{
@@ -466,7 +645,7 @@ void add_library_symbol_used(char *library_name, int library_size, char *symbol_
 
 	if (last_symbol == NULL)
 	{
-		library_symbols_used = new_symbol;
+		context->library_symbols_used = new_symbol;
 	}
 	else
 	{
@@ -474,9 +653,18 @@ void add_library_symbol_used(char *library_name, int library_size, char *symbol_
 	}
 }
 
+void add_library_symbol_used(char *library_name, int library_size, char *symbol_name, int symbol_name_size)
+{
+	lock_mutex(context->tables_mutex);
+	inner_add_library_symbol_used(library_name, library_size, symbol_name, symbol_name_size);
+	unlock_mutex(context->tables_mutex);
+
+	record_library_symbol_used(library_name, library_size, symbol_name, symbol_name_size);
+}
+
 void fprint_library_symbols_used(FILE *fp)
 {
-	struct SymbolList *current_symbol = library_symbols_used;
+	struct SymbolList *current_symbol = context->library_symbols_used;
 	BOOL first_symbol = TRUE;
 
 	fprintf(fp, "[");
@@ -500,11 +688,11 @@ void fprint_library_symbols_used(FILE *fp)
 
 void fill_library_symbols_used_with_dependencies()
 {
-	struct SymbolList *current_symbol = library_symbols_used;
+	struct SymbolList *current_symbol = context->library_symbols_used;
 
 	while(current_symbol != NULL)
 	{
-		struct SymbolDependencies *current_symbol2 = library_symbol_dependencies;
+		struct SymbolDependencies *current_symbol2 = context->library_symbol_dependencies;
 
 		while(current_symbol2 != NULL)
 		{
@@ -533,9 +721,12 @@ void fill_library_symbols_used_with_dependencies()
 
 BOOL is_library_symbol_needed(char *library_name, int library_size, char *symbol_name, int symbol_name_size)
 {
-	struct SymbolList *current_symbol = library_symbols_used;
+	struct SymbolList *current_symbol = context->library_symbols_used;
+
+	COUNT_STAT(library_symbol_lookups);
 
-	if (assemble_all)
+	// Object files have every library symbol, the linker finds the ones needed
+	if (context->assemble_all || context->object_filename != NULL)
 	{
 		return TRUE;
 	}
@@ -558,11 +749,9 @@ BOOL is_library_symbol_needed(char *library_name, int library_size, char *symbol
 //  Structs and Unions
 // *************************
 
-struct StructuredType *first_structured_type = NULL;
-
 struct StructuredType *create_structured_type(char *name, int name_size, char *library_name, int library_name_size, enum StructuredTypeType type)
 {
-	struct StructuredType *current_type = first_structured_type;
+	struct StructuredType *current_type = context->first_structured_type;
 
 	while(current_type != NULL)
 	{
@@ -590,7 +779,7 @@ struct StructuredType *create_structured_type(char *name, int name_size, char *l
 
 struct StructuredType *add_structured_type(struct StructuredType *new_type)
 {
-	struct StructuredType *current_type = first_structured_type, *last_type = NULL;
+	struct StructuredType *current_type = context->first_structured_type, *last_type = NULL;
 
 	while(current_type != NULL)
 	{
@@ -606,7 +795,7 @@ struct StructuredType *add_structured_type(struct StructuredType *new_type)
 
 	if (last_type == NULL)
 	{
-		first_structured_type = new_type;
+		context->first_structured_type = new_type;
 	}
 	else
 	{
@@ -618,7 +807,9 @@ struct StructuredType *add_structured_type(struct StructuredType *new_type)
 
 struct StructuredType *get_structured_type(char *name, int name_size, char *library_name, int library_name_size)
 {
-	struct StructuredType *current_type = first_structured_type;
+	struct StructuredType *current_type = context->first_structured_type;
+
+	COUNT_STAT(structured_type_lookups);
 
 	while(current_type != NULL)
 	{
@@ -732,7 +923,7 @@ int add_element_to_structured_type(struct StructuredType *structured_type, char
 
 void fprint_structured_types(FILE *fp)
 {
-	struct StructuredType *current_structured_type = first_structured_type;
+	struct StructuredType *current_structured_type = context->first_structured_type;
 	BOOL is_first_structured_type = TRUE;
 
 	fprintf(fp, "[");
@@ -793,56 +984,69 @@ struct StructElement *get_struct_element(struct StructuredType *structured_type,
 	return NULL;
 }
 
-struct ASTNode **struct_bytes = NULL;
+void clear_struct_init_values()
+{
+	context->struct_init_values_count = 0;
+}
 
-void clear_struct_bytes(int size)
+// Values are kept sorted by offset, a value replaces any previous value it overlaps
+int add_struct_init_value(int offset, struct StructElement *struct_element, int index, struct ASTNode *node)
 {
-	if (struct_bytes == NULL)
+	int size = struct_element->size_of_type;
+	int value_offset = offset + struct_element->position + index * size;
+
+	switch(size)
 	{
-		struct_bytes = (struct ASTNode **)malloc(sizeof(struct ASTNode *) * 65536);
+		case 1: node->type = NODE_TYPE_EXPRESSION_8; break;
+		case 2: node->type = NODE_TYPE_EXPRESSION_16; break;
+		case 4: node->type = NODE_TYPE_EXPRESSION_32; break;
+		default: return 1;
 	}
 
-	assert(size > 0 && size <= 65536);
-
-	memset(struct_bytes, 0, size * sizeof(struct ASTNode *));
-}
-
-int set_struct_bytes(struct StructuredType *structured_type, int offset, struct StructElement *struct_element, int index, struct ASTNode *node)
-{
-	assert(struct_bytes != NULL);
-	
-	if (is_str_equal(struct_element->type, struct_element->type_size, "byte") && is_str_equal(struct_element->type_library, struct_element->type_library_size, ""))
+	int position = context->struct_init_values_count;
+	while (position > 0 && context->struct_init_values[position - 1].offset + context->struct_init_values[position - 1].size > value_offset)
 	{
-		node->type = NODE_TYPE_EXPRESSION_8;
-		struct_bytes[offset + struct_element->position + index] = node;
+		position--;
 	}
-	else if (is_str_equal(struct_element->type, struct_element->type_size, "word") && is_str_equal(struct_element->type_library, struct_element->type_library_size, ""))
+
+	int position_end = position;
+	while (position_end < context->struct_init_values_count && context->struct_init_values[position_end].offset < value_offset + size)
 	{
-		node->type = NODE_TYPE_EXPRESSION_16;
-		struct_bytes[offset + struct_element->position + index * 2] = node;
-		struct_bytes[offset + struct_element->position + index * 2 + 1] = NULL;
+		position_end++;
 	}
-	else if (is_str_equal(struct_element->type, struct_element->type_size, "dword") && is_str_equal(struct_element->type_library, struct_element->type_library_size, ""))
+
+	if (position_end == position)
 	{
-		node->type = NODE_TYPE_EXPRESSION_32;
-		struct_bytes[offset + struct_element->position + index * 4] = node;
-		struct_bytes[offset + struct_element->position + index * 4 + 1] = NULL;
-		struct_bytes[offset + struct_element->position + index * 4 + 2] = NULL;
-		struct_bytes[offset + struct_element->position + index * 4 + 3] = NULL;
+		if (context->struct_init_values_count == context->struct_init_values_capacity)
+		{
+			context->struct_init_values_capacity = context->struct_init_values_capacity == 0 ? 64 : context->struct_init_values_capacity * 2;
+			context->struct_init_values = (struct StructInitValue *)realloc(context->struct_init_values, sizeof(struct StructInitValue) * context->struct_init_values_capacity);
+		}
+		memmove(&context->struct_init_values[position + 1], &context->struct_init_values[position], sizeof(struct StructInitValue) * (context->struct_init_values_count - position));
+		context->struct_init_values_count++;
 	}
-	else
+	else if (position_end > position + 1)
 	{
-		return 1;
+		memmove(&context->struct_init_values[position + 1], &context->struct_init_values[position_end], sizeof(struct StructInitValue) * (context->struct_init_values_count - position_end));
+		context->struct_init_values_count -= position_end - position - 1;
 	}
 
+	context->struct_init_values[position].offset = value_offset;
+	context->struct_init_values[position].size = size;
+	context->struct_init_values[position].node = node;
+
 	return 0;
 }
 
-struct DataSymbol *first_data_symbol = NULL, *last_data_symbol = NULL;
+struct StructInitValue *get_struct_init_values(int *count)
+{
+	*count = context->struct_init_values_count;
+	return context->struct_init_values;
+}
 
 int add_data_symbol(char *name, int name_size, char *library_name, int library_name_size, char *type, int type_size, char *library_type, int library_type_size, int length)
 {
-	struct DataSymbol *current_data_symbol = first_data_symbol, *last_current_data_symbol = NULL;
+	struct DataSymbol *current_data_symbol = context->first_data_symbol, *last_current_data_symbol = NULL;
 
 	while(current_data_symbol != NULL)
 	{
@@ -903,21 +1107,23 @@ int add_data_symbol(char *name, int name_size, char *library_name, int library_n
 
 	if (last_current_data_symbol == NULL)
 	{
-		first_data_symbol = new_data_symbol;
+		context->first_data_symbol = new_data_symbol;
 	}
 	else
 	{
 		last_current_data_symbol->next = new_data_symbol;
 	}
 
-	last_data_symbol = new_data_symbol;
+	context->last_data_symbol = new_data_symbol;
 
 	return 0;
 }
 
 struct DataSymbol *get_data_symbol(char *name, int name_size, char *library_name, int library_name_size)
 {
-	struct DataSymbol *current_data_symbol = first_data_symbol;
+	struct DataSymbol *current_data_symbol = context->first_data_symbol;
+
+	COUNT_STAT(data_symbol_lookups);
 
 	while(current_data_symbol != NULL)
 	{
@@ -935,12 +1141,12 @@ struct DataSymbol *get_data_symbol(char *name, int name_size, char *library_name
 
 struct DataSymbol *get_last_data_symbol()
 {
-	return last_data_symbol;
+	return context->last_data_symbol;
 }
 
 void fprintf_data_symbols(FILE *fp)
 {
-	struct DataSymbol *current_data_symbol = first_data_symbol;
+	struct DataSymbol *current_data_symbol = context->first_data_symbol;
 	fprintf(fp, "[");
 
 	BOOL first = TRUE;
@@ -982,11 +1188,9 @@ void fprintf_data_symbols(FILE *fp)
 	fprintf(fp, "]");
 }
 
-static struct InlineSymbol *first_inline_symbol = NULL;
-
-struct InlineSymbol *add_inline_symbol(char *name, int name_size, char *library_name, int library_name_size, struct ASTNode *node)
+static struct InlineSymbol *inner_add_inline_symbol(char *name, int name_size, char *library_name, int library_name_size, struct ASTNode *node)
 {
-	struct InlineSymbol *current_inline = first_inline_symbol, *last_inline = NULL;
+	struct InlineSymbol *current_inline = context->first_inline_symbol, *last_inline = NULL;
 
 	while(current_inline != NULL)
 	{
@@ -1012,7 +1216,7 @@ struct InlineSymbol *add_inline_symbol(char *name, int name_size, char *library_
 
 	if (last_inline == NULL)
 	{
-		first_inline_symbol = new_inline;
+		context->first_inline_symbol = new_inline;
 	}
 	else
 	{
@@ -1022,9 +1226,22 @@ struct InlineSymbol *add_inline_symbol(char *name, int name_size, char *library_
 	return new_inline;
 }
 
+struct InlineSymbol *add_inline_symbol(char *name, int name_size, char *library_name, int library_name_size, struct ASTNode *node)
+{
+	lock_mutex(context->tables_mutex);
+	struct InlineSymbol *result = inner_add_inline_symbol(name, name_size, library_name, library_name_size, node);
+	unlock_mutex(context->tables_mutex);
+
+	record_inline_symbol(result);
+
+	return result;
+}
+
 struct InlineSymbol *get_inline_symbol(char *name, int name_size, char *library_name, int library_name_size)
 {
-	struct InlineSymbol *current_inline = first_inline_symbol;
+	struct InlineSymbol *current_inline = context->first_inline_symbol;
+
+	COUNT_STAT(inline_symbol_lookups);
 
 	while(current_inline != NULL)
 	{
@@ -1095,73 +1312,98 @@ int get_inline_symbol_argument_index(struct InlineSymbol *inline_symbol, char *n
 
 struct LoopLabel
 {
-	char *label_start;
-	char *label_end;	
+	int label_start;
+	int label_end;	
 
 	struct LoopLabel *next, *prev;
 };
 
-static struct LoopLabel *first_loop_label = NULL, *last_loop_label = NULL;
-
-void push_loop_label(char *label_start, char *label_end)
+void push_loop_label(int label_start, int label_end)
 {
 	struct LoopLabel *new_label = (struct LoopLabel*)malloc(sizeof(struct LoopLabel));
 	new_label->label_start = label_start;
 	new_label->label_end = label_end;
 	new_label->next = NULL;
-	new_label->prev = last_loop_label;
+	new_label->prev = context->last_loop_label;
 
-	if (first_loop_label == NULL)
+	if (context->first_loop_label == NULL)
 	{
-		first_loop_label = new_label;
+		context->first_loop_label = new_label;
 	}
 	else
 	{
-		first_loop_label->next = new_label;
+		context->first_loop_label->next = new_label;
 	}
 
-	last_loop_label = new_label;
+	context->last_loop_label = new_label;
 }
 
-char *peek_loop_label_start()
+int peek_loop_label_start()
 {
-	if (last_loop_label == NULL)
+	if (context->last_loop_label == NULL)
 	{
-		return NULL;
+		return -1;
 	}
 
-	return last_loop_label->label_start;
+	return context->last_loop_label->label_start;
 }
 
-char *peek_loop_label_end()
+int peek_loop_label_end()
 {
-	if (last_loop_label == NULL)
+	if (context->last_loop_label == NULL)
 	{
-		return NULL;
+		return -1;
 	}
 
-	return last_loop_label->label_end;
+	return context->last_loop_label->label_end;
 }
 
 void pop_loop_label()
 {
-	if (last_loop_label == NULL)
+	if (context->last_loop_label == NULL)
 	{
 		return;
 	}
 
-	struct LoopLabel *new_last_label = last_loop_label->prev;
+	struct LoopLabel *new_last_label = context->last_loop_label->prev;
 
-	free(last_loop_label);
+	free(context->last_loop_label);
 
-	if (last_loop_label == first_loop_label)
+	if (context->last_loop_label == context->first_loop_label)
 	{
-		first_loop_label = last_loop_label = NULL;
+		context->first_loop_label = context->last_loop_label = NULL;
 		return;
 	}
 
 	new_last_label->next = NULL;
-	last_loop_label = new_last_label;	
+	context->last_loop_label = new_last_label;	
+}
+
+void set_generated_label(int label, uint16_t address)
+{
+	if (label >= context->generated_labels_capacity)
+	{
+		int new_capacity = MAX(label + 1, MAX(256, context->generated_labels_capacity * 2));
+		context->generated_labels = (int32_t *)realloc(context->generated_labels, sizeof(int32_t) * new_capacity);
+		for(int i = context->generated_labels_capacity; i < new_capacity; i++)
+		{
+			context->generated_labels[i] = -1;
+		}
+		context->generated_labels_capacity = new_capacity;
+	}
+
+	context->generated_labels[label] = address;
+}
+
+int get_generated_label(int label, int64_t *value)
+{
+	if (label < 0 || label >= context->generated_labels_capacity || context->generated_labels[label] < 0)
+	{
+		return 1;
+	}
+
+	*value = context->generated_labels[label];
+	return 0;
 }
 
 struct InlineSymbolStack
@@ -1174,8 +1416,6 @@ struct InlineSymbolStack
 	struct InlineSymbolStack *next, *prev;
 };
 
-static struct InlineSymbolStack *first_inline_symbol_stack = NULL, *last_inline_symbol_stack = NULL;
-
 void push_inline_symbol_stack(char *inline_symbol, int inline_symbol_size, char *library_name, int library_name_size)
 {
 	struct InlineSymbolStack *new_inline_symbol_stack = (struct InlineSymbolStack*)malloc(sizeof(struct InlineSymbolStack));
@@ -1184,23 +1424,23 @@ void push_inline_symbol_stack(char *inline_symbol, int inline_symbol_size, char
 	new_inline_symbol_stack->name = inline_symbol;
 	new_inline_symbol_stack->name_size = inline_symbol_size;
 	new_inline_symbol_stack->next = NULL;
-	new_inline_symbol_stack->prev = last_inline_symbol_stack;
+	new_inline_symbol_stack->prev = context->last_inline_symbol_stack;
 
-	if (first_inline_symbol_stack == NULL)
+	if (context->first_inline_symbol_stack == NULL)
 	{
-		first_inline_symbol_stack = new_inline_symbol_stack;
+		context->first_inline_symbol_stack = new_inline_symbol_stack;
 	}
 	else
 	{
-		first_inline_symbol_stack->next = new_inline_symbol_stack;
+		context->first_inline_symbol_stack->next = new_inline_symbol_stack;
 	}
 
-	last_inline_symbol_stack = new_inline_symbol_stack;
+	context->last_inline_symbol_stack = new_inline_symbol_stack;
 }
 
 BOOL is_inline_symbol_in_stack(char *name, int name_size, char *library_name, int library_name_size)
 {
-	struct InlineSymbolStack *current_inline_symbol_stack = first_inline_symbol_stack;
+	struct InlineSymbolStack *current_inline_symbol_stack = context->first_inline_symbol_stack;
 
 	while (current_inline_symbol_stack != NULL)
 	{
@@ -1218,23 +1458,23 @@ BOOL is_inline_symbol_in_stack(char *name, int name_size, char *library_name, in
 
 void pop_inline_symbol_stack()
 {
-	if (last_inline_symbol_stack == NULL)
+	if (context->last_inline_symbol_stack == NULL)
 	{
 		return;
 	}
 
-	struct InlineSymbolStack *new_last_inline_symbol_stack = last_inline_symbol_stack->prev;
+	struct InlineSymbolStack *new_last_inline_symbol_stack = context->last_inline_symbol_stack->prev;
 
-	free(last_inline_symbol_stack);
+	free(context->last_inline_symbol_stack);
 
-	if (last_inline_symbol_stack == first_inline_symbol_stack)
+	if (context->last_inline_symbol_stack == context->first_inline_symbol_stack)
 	{
-		first_inline_symbol_stack = last_inline_symbol_stack = NULL;
+		context->first_inline_symbol_stack = context->last_inline_symbol_stack = NULL;
 		return;
 	}
 
 	new_last_inline_symbol_stack->next = NULL;
-	last_inline_symbol_stack = new_last_inline_symbol_stack;	
+	context->last_inline_symbol_stack = new_last_inline_symbol_stack;	
 }
 
 struct IncludePath
@@ -1244,8 +1484,6 @@ struct IncludePath
 	struct IncludePath *next_element;
 };
 
-struct IncludePath *first_include_path, *last_include_path;
-
 void add_include_path(char *path)
 {
 	struct IncludePath *new_element;
@@ -1254,21 +1492,21 @@ void add_include_path(char *path)
 	new_element->path = path;
 	new_element->next_element = NULL;
 
-	if (last_include_path == NULL)
+	if (context->last_include_path == NULL)
 	{
-		first_include_path = last_include_path = new_element;
+		context->first_include_path = context->last_include_path = new_element;
 	}
 	else
 	{
-		last_include_path->next_element = new_element;
-		last_include_path = new_element;
+		context->last_include_path->next_element = new_element;
+		context->last_include_path = new_element;
 	}
 }
 
 BOOL get_file_include_path(char *output_file_path, char *file_path, char* origin_file_path)
 {
 	FILE *fp = NULL;
-	struct IncludePath *current_include_path = first_include_path;
+	struct IncludePath *current_include_path = context->first_include_path;
 
 	char temp_str_path[256];
 
@@ -1296,6 +1534,33 @@ BOOL get_file_include_path(char *output_file_path, char *file_path, char* origin
 	return FALSE;
 }
 
+BOOL has_same_include_paths(struct Z80HLAContext *context1, struct Z80HLAContext *context2)
+{
+	struct IncludePath *include_path1 = context1->first_include_path, *include_path2 = context2->first_include_path;
+
+	while (include_path1 != NULL && include_path2 != NULL)
+	{
+		if (strcmp(include_path1->path, include_path2->path))
+		{
+			return FALSE;
+		}
+
+		include_path1 = include_path1->next_element;
+		include_path2 = include_path2->next_element;
+	}
+
+	return include_path1 == include_path2;
+}
+
+// The order of the include paths matters, it is the order files are searched in
+void digest_include_paths(struct Sha256 *sha256)
+{
+	for(struct IncludePath *current_include_path = context->first_include_path; current_include_path != NULL; current_include_path = current_include_path->next_element)
+	{
+		update_sha256(sha256, current_include_path->path, strlen(current_include_path->path) + 1);
+	}
+}
+
 struct DefineIdentifier
 {
 	char *identifier;
@@ -1304,11 +1569,9 @@ struct DefineIdentifier
 	struct DefineIdentifier *next_element;
 };
 
-struct DefineIdentifier *first_define_identifier = NULL;
-
 BOOL has_define_identifier(char *identifier, int identifier_size)
 {
-	struct DefineIdentifier *current_element = first_define_identifier;
+	struct DefineIdentifier *current_element = context->first_define_identifier;
 
 	while(current_element != NULL)
 	{
@@ -1322,7 +1585,7 @@ BOOL has_define_identifier(char *identifier, int identifier_size)
 	return FALSE;
 }
 
-void add_define_identifier(char *identifier, int identifier_size)
+static void inner_add_define_identifier(char *identifier, int identifier_size)
 {
 	struct DefineIdentifier *new_element;
 
@@ -1333,12 +1596,52 @@ void add_define_identifier(char *identifier, int identifier_size)
 	new_element->identifier_size = identifier_size;
 	new_element->next_element = NULL;
 
-	if (first_define_identifier != NULL)
+	if (context->first_define_identifier != NULL)
+	{
+		new_element->next_element = context->first_define_identifier;
+	}
+
+	context->first_define_identifier = new_element;	
+}
+
+void add_define_identifier(char *identifier, int identifier_size)
+{
+	lock_mutex(context->tables_mutex);
+	inner_add_define_identifier(identifier, identifier_size);
+	unlock_mutex(context->tables_mutex);
+}
+
+static int compare_define_identifiers(const void *element1, const void *element2)
+{
+	struct DefineIdentifier *identifier1 = *(struct DefineIdentifier **)element1, *identifier2 = *(struct DefineIdentifier **)element2;
+	int result = memcmp(identifier1->identifier, identifier2->identifier, (size_t)MIN(identifier1->identifier_size, identifier2->identifier_size));
+
+	return result != 0 ? result : identifier1->identifier_size - identifier2->identifier_size;
+}
+
+// The identifiers are sorted so the digest is the same whatever the order they were added in
+void digest_define_identifiers(struct Sha256 *sha256)
+{
+	int count = 0;
+	for(struct DefineIdentifier *current_element = context->first_define_identifier; current_element != NULL; current_element = current_element->next_element)
+	{
+		count++;
+	}
+
+	struct DefineIdentifier **identifiers = (struct DefineIdentifier **)malloc(sizeof(struct DefineIdentifier *) * (size_t)MAX(count, 1));
+	count = 0;
+	for(struct DefineIdentifier *current_element = context->first_define_identifier; current_element != NULL; current_element = current_element->next_element)
 	{
-		new_element->next_element = first_define_identifier;
+		identifiers[count++] = current_element;
 	}
+	qsort(identifiers, (size_t)count, sizeof(struct DefineIdentifier *), compare_define_identifiers);
 
-	first_define_identifier = new_element;	
+	for(int i = 0; i < count; i++)
+	{
+		update_sha256(sha256, identifiers[i]->identifier, (size_t)identifiers[i]->identifier_size);
+		update_sha256(sha256, "", 1);
+	}
+	free(identifiers);
 }
 
 struct IfdefExpect
@@ -1348,62 +1651,70 @@ struct IfdefExpect
 	struct IfdefExpect *next, *prev;
 };
 
-static struct IfdefExpect *first_ifdef_expect = NULL, *last_ifdef_expect = NULL;
-static struct IfdefExpect *dup_first_ifdef_expect = NULL, *dup_last_ifdef_expect = NULL;
+// Frees the elements of a stack from the last one, only the links to the previous ones are kept up to date
+static void free_ifdef_expects(struct IfdefExpect *last_ifdef_expect)
+{
+	while(last_ifdef_expect != NULL)
+	{
+		struct IfdefExpect *prev_ifdef_expect = last_ifdef_expect->prev;
+		free(last_ifdef_expect);
+		last_ifdef_expect = prev_ifdef_expect;
+	}
+}
 
-void push_ifdef_expect(int type)
+void push_ifdef_expect(struct IfdefStack *stack, int type)
 {
 	struct IfdefExpect *new_ifdef_expect = (struct IfdefExpect*)malloc(sizeof(struct IfdefExpect));
 	new_ifdef_expect->type = type;
 	new_ifdef_expect->next = NULL;
-	new_ifdef_expect->prev = last_ifdef_expect;
+	new_ifdef_expect->prev = stack->last_ifdef_expect;
 
-	if (first_ifdef_expect == NULL)
+	if (stack->first_ifdef_expect == NULL)
 	{
-		first_ifdef_expect = new_ifdef_expect;
+		stack->first_ifdef_expect = new_ifdef_expect;
 	}
 	else
 	{
-		first_ifdef_expect->next = new_ifdef_expect;
+		stack->first_ifdef_expect->next = new_ifdef_expect;
 	}
 
-	last_ifdef_expect = new_ifdef_expect;
+	stack->last_ifdef_expect = new_ifdef_expect;
 }
 
-enum IfdefExpectType peek_ifdef_expect()
+enum IfdefExpectType peek_ifdef_expect(struct IfdefStack *stack)
 {
-	if (last_ifdef_expect == NULL)
+	if (stack->last_ifdef_expect == NULL)
 	{
 		return IFDEF_EXPECT_UNKNOWN;
 	}
 
-	return last_ifdef_expect->type;
+	return stack->last_ifdef_expect->type;
 }
 
-void pop_ifdef_expect()
+void pop_ifdef_expect(struct IfdefStack *stack)
 {
-	if (last_ifdef_expect == NULL)
+	if (stack->last_ifdef_expect == NULL)
 	{
 		return;
 	}
 
-	struct IfdefExpect *new_ifdef_expect = last_ifdef_expect->prev;
+	struct IfdefExpect *new_ifdef_expect = stack->last_ifdef_expect->prev;
 
-	free(last_ifdef_expect);
+	free(stack->last_ifdef_expect);
 
-	if (last_ifdef_expect == first_ifdef_expect)
+	if (stack->last_ifdef_expect == stack->first_ifdef_expect)
 	{
-		first_ifdef_expect = last_ifdef_expect = NULL;
+		stack->first_ifdef_expect = stack->last_ifdef_expect = NULL;
 		return;
 	}
 
 	new_ifdef_expect->next = NULL;
-	last_ifdef_expect = new_ifdef_expect;	
+	stack->last_ifdef_expect = new_ifdef_expect;	
 }
 
-void save_duplicate_all_ifdef_expect()
+void save_duplicate_all_ifdef_expect(struct IfdefStack *stack)
 {
-	struct IfdefExpect *current_ifdef_expect = first_ifdef_expect;
+	struct IfdefExpect *current_ifdef_expect = stack->first_ifdef_expect;
 	struct IfdefExpect *dup_current_ifdef_expect = NULL;
 
 	while(current_ifdef_expect != NULL)
@@ -1415,31 +1726,151 @@ void save_duplicate_all_ifdef_expect()
 
 		if (dup_current_ifdef_expect == NULL)
 		{
-			dup_first_ifdef_expect = new_ifdef_expect;
+			stack->dup_first_ifdef_expect = new_ifdef_expect;
 		}
 		dup_current_ifdef_expect = new_ifdef_expect;
 
 		current_ifdef_expect = current_ifdef_expect->next;
 	}
 
-	dup_last_ifdef_expect = dup_current_ifdef_expect;
+	stack->dup_last_ifdef_expect = dup_current_ifdef_expect;
 }
 
-void revert_to_duplicate_ifdef_expect()
+void revert_to_duplicate_ifdef_expect(struct IfdefStack *stack)
 {
-	struct IfdefExpect *current_ifdef_expect = first_ifdef_expect;
-	struct IfdefExpect *next_ifdef_expect;
+	free_ifdef_expects(stack->last_ifdef_expect);
 
-	while(current_ifdef_expect != NULL)
+	stack->first_ifdef_expect = stack->dup_first_ifdef_expect;
+	stack->last_ifdef_expect = stack->dup_last_ifdef_expect;
+
+	stack->dup_first_ifdef_expect = NULL;
+	stack->dup_last_ifdef_expect = NULL;
+}
+
+// Frees what a lexer that stopped with an error may have left in the stack
+void clear_ifdef_stack(struct IfdefStack *stack)
+{
+	free_ifdef_expects(stack->last_ifdef_expect);
+	free_ifdef_expects(stack->dup_last_ifdef_expect);
+	memset(stack, 0, sizeof(struct IfdefStack));
+}
+
+static void clear_include_stack()
+{
+	while(context->end_include_stack != NULL)
 	{
-		next_ifdef_expect = current_ifdef_expect->next;
-		free(current_ifdef_expect);
-		current_ifdef_expect = next_ifdef_expect;
+		pop_include_file();
 	}
+}
+
+// Clears the stacks, a compilation that stopped with an error may have left them in use
+void init_tables()
+{
+	clear_include_stack();
+	clear_ifdef_stack(&context->ifdef_stack);
+}
+
+static void free_symbol_list(struct SymbolList *symbol)
+{
+	while(symbol != NULL)
+	{
+		struct SymbolList *next_symbol = symbol->next;
+		free(symbol);
+		symbol = next_symbol;
+	}
+}
+
+// Frees the tables of the context, the names in them belong to the files read and to the memory of the context
+void free_tables()
+{
+	clear_include_stack();
+	clear_ifdef_stack(&context->ifdef_stack);
+
+	for(struct ConstantList *current_constant = context->first_constant, *next_constant; current_constant != NULL; current_constant = next_constant)
+	{
+		next_constant = current_constant->next;
+		free(current_constant);
+	}
+	for(struct DataSymbol *current_data_symbol = context->first_data_symbol, *next_data_symbol; current_data_symbol != NULL; current_data_symbol = next_data_symbol)
+	{
+		next_data_symbol = current_data_symbol->next;
+		free(current_data_symbol);
+	}
+	for(struct StructuredType *current_type = context->first_structured_type, *next_type; current_type != NULL; current_type = next_type)
+	{
+		next_type = current_type->next;
+		for(struct StructElement *current_element = current_type->first_element, *next_element; current_element != NULL; current_element = next_element)
+		{
+			next_element = current_element->next;
+			free(current_element);
+		}
+		free(current_type);
+	}
+	free(context->struct_init_values);
+	free(context->generated_labels);
+	while(context->last_loop_label != NULL)
+	{
+		pop_loop_label();
+	}
+	while(context->last_inline_symbol_stack != NULL)
+	{
+		pop_inline_symbol_stack();
+	}
+
+	// A configuration sharing the files parsed by another one has its library and inline tables too
+	if (!context->shares_parsed_tables)
+	{
+		for(struct SymbolDependencies *current_symbol = context->library_symbol_dependencies, *next_symbol; current_symbol != NULL; current_symbol = next_symbol)
+		{
+			next_symbol = current_symbol->next;
+			free_symbol_list(current_symbol->dependencies);
+			free(current_symbol);
+		}
+		free_symbol_list(context->library_symbols_used);
+		for(struct InlineSymbol *current_inline = context->first_inline_symbol, *next_inline; current_inline != NULL; current_inline = next_inline)
+		{
+			next_inline = current_inline->next;
+			for(struct InlineArgument *current_argument = current_inline->arguments, *next_argument; current_argument != NULL; current_argument = next_argument)
+			{
+				next_argument = current_argument->next;
+				free(current_argument);
+			}
+			free(current_inline);
+		}
+	}
+
+	for(struct IncludePath *current_include_path = context->first_include_path, *next_include_path; current_include_path != NULL; current_include_path = next_include_path)
+	{
+		next_include_path = current_include_path->next_element;
+		free(current_include_path);
+	}
+	for(struct DefineIdentifier *current_element = context->first_define_identifier, *next_element; current_element != NULL; current_element = next_element)
+	{
+		next_element = current_element->next_element;
+		free(current_element);
+	}
+
+	for(struct ContentCache *current_element = context->first_content_cache_element, *next_element; current_element != NULL; current_element = next_element)
+	{
+		next_element = current_element->next_element;
+		free(current_element->content);
+		destroy_mutex(current_element->loading);
+		free(current_element);
+	}
+}
+
+// Sizes of the tables and the files read, for the statistics
+void fprint_tables_stats(FILE *fp)
+{
+	int constants_count = 0, data_symbols_count = 0, structured_types_count = 0, inline_symbols_count = 0, library_symbols_used_count = 0;
 
-	first_ifdef_expect = dup_first_ifdef_expect;
-	last_ifdef_expect = dup_last_ifdef_expect;
+	for(struct ConstantList *current_constant = context->first_constant; current_constant != NULL; current_constant = current_constant->next) { constants_count++; }
+	for(struct DataSymbol *current_data_symbol = context->first_data_symbol; current_data_symbol != NULL; current_data_symbol = current_data_symbol->next) { data_symbols_count++; }
+	for(struct StructuredType *current_type = context->first_structured_type; current_type != NULL; current_type = current_type->next) { structured_types_count++; }
+	for(struct InlineSymbol *current_inline = context->first_inline_symbol; current_inline != NULL; current_inline = current_inline->next) { inline_symbols_count++; }
+	for(struct SymbolList *current_symbol = context->library_symbols_used; current_symbol != NULL; current_symbol = current_symbol->next) { library_symbols_used_count++; }
 
-	dup_first_ifdef_expect = NULL;
-	dup_last_ifdef_expect = NULL;
+	fprintf(fp, "\"tables\":{\"constants\":%d,\"data_symbols\":%d,\"structured_types\":%d,\"inline_symbols\":%d,\"library_symbols_used\":%d},\n",
+		constants_count, data_symbols_count, structured_types_count, inline_symbols_count, library_symbols_used_count);
+	fprint_files_read(fp);
 }
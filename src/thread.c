@@ -0,0 +1,362 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "z80hla.h"
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <psapi.h>
+
+struct Thread
+{
+    HANDLE handle;
+    int (*function)(void *);
+    void *argument;
+    int result;
+    struct Z80HLAContext *context;
+};
+
+struct Mutex
+{
+    CRITICAL_SECTION critical_section;
+};
+
+static DWORD WINAPI thread_start(LPVOID parameter)
+{
+    struct Thread *thread = (struct Thread *)parameter;
+    context = thread->context; // threads work on the context of the thread creating them
+    thread->result = thread->function(thread->argument);
+    return 0;
+}
+
+struct Thread *create_thread(int (*function)(void *), void *argument)
+{
+    struct Thread *thread = (struct Thread *)malloc(sizeof(struct Thread));
+    thread->function = function;
+    thread->argument = argument;
+    thread->context = context;
+    thread->result = 0;
+    thread->handle = CreateThread(NULL, 0, thread_start, thread, 0, NULL);
+    if (thread->handle == NULL)
+    {
+        free(thread);
+        return NULL;
+    }
+    return thread;
+}
+
+int join_thread(struct Thread *thread)
+{
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    int result = thread->result;
+    free(thread);
+    return result;
+}
+
+struct Mutex *create_mutex()
+{
+    struct Mutex *mutex = (struct Mutex *)malloc(sizeof(struct Mutex));
+    InitializeCriticalSection(&mutex->critical_section);
+    return mutex;
+}
+
+void destroy_mutex(struct Mutex *mutex)
+{
+    DeleteCriticalSection(&mutex->critical_section);
+    free(mutex);
+}
+
+void lock_mutex(struct Mutex *mutex)
+{
+    EnterCriticalSection(&mutex->critical_section);
+}
+
+void unlock_mutex(struct Mutex *mutex)
+{
+    LeaveCriticalSection(&mutex->critical_section);
+}
+
+int get_cpu_count()
+{
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return MAX(1, (int)system_info.dwNumberOfProcessors);
+}
+
+int load_acquire(volatile int *value)
+{
+    int result = *value;
+    MemoryBarrier();
+    return result;
+}
+
+void store_release(volatile int *value, int new_value)
+{
+    MemoryBarrier();
+    *value = new_value;
+}
+
+void yield_thread()
+{
+    SwitchToThread();
+}
+
+void sleep_thread(int milliseconds)
+{
+    Sleep(milliseconds);
+}
+
+// Monotonic time
+uint64_t get_time_nanoseconds()
+{
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000ULL +
+        (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000ULL / (uint64_t)frequency.QuadPart;
+}
+
+// Peak resident memory of the process in bytes
+uint64_t get_peak_memory()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) { return 0; }
+    return (uint64_t)counters.PeakWorkingSetSize;
+}
+
+#else
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+struct Thread
+{
+    pthread_t handle;
+    int (*function)(void *);
+    void *argument;
+    int result;
+    struct Z80HLAContext *context;
+};
+
+struct Mutex
+{
+    pthread_mutex_t mutex;
+};
+
+static void *thread_start(void *parameter)
+{
+    struct Thread *thread = (struct Thread *)parameter;
+    context = thread->context; // threads work on the context of the thread creating them
+    thread->result = thread->function(thread->argument);
+    return NULL;
+}
+
+struct Thread *create_thread(int (*function)(void *), void *argument)
+{
+    struct Thread *thread = (struct Thread *)malloc(sizeof(struct Thread));
+    thread->function = function;
+    thread->argument = argument;
+    thread->context = context;
+    thread->result = 0;
+    if (pthread_create(&thread->handle, NULL, thread_start, thread))
+    {
+        free(thread);
+        return NULL;
+    }
+    return thread;
+}
+
+int join_thread(struct Thread *thread)
+{
+    pthread_join(thread->handle, NULL);
+    int result = thread->result;
+    free(thread);
+    return result;
+}
+
+struct Mutex *create_mutex()
+{
+    struct Mutex *mutex = (struct Mutex *)malloc(sizeof(struct Mutex));
+    pthread_mutex_init(&mutex->mutex, NULL);
+    return mutex;
+}
+
+void destroy_mutex(struct Mutex *mutex)
+{
+    pthread_mutex_destroy(&mutex->mutex);
+    free(mutex);
+}
+
+void lock_mutex(struct Mutex *mutex)
+{
+    pthread_mutex_lock(&mutex->mutex);
+}
+
+void unlock_mutex(struct Mutex *mutex)
+{
+    pthread_mutex_unlock(&mutex->mutex);
+}
+
+int get_cpu_count()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count < 1 ? 1 : (int)count;
+}
+
+int load_acquire(volatile int *value)
+{
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+void store_release(volatile int *value, int new_value)
+{
+    __atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+}
+
+void yield_thread()
+{
+    sched_yield();
+}
+
+void sleep_thread(int milliseconds)
+{
+    struct timespec duration;
+    duration.tv_sec = milliseconds / 1000;
+    duration.tv_nsec = (long)(milliseconds % 1000) * 1000000L;
+    nanosleep(&duration, NULL);
+}
+
+// Monotonic time
+uint64_t get_time_nanoseconds()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+}
+
+// Peak resident memory of the process in bytes
+uint64_t get_peak_memory()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) { return 0; }
+#ifdef __APPLE__
+    return (uint64_t)usage.ru_maxrss;
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+#endif
+
+// Pool of threads running a job for every index, each thread takes the next index left
+
+struct WorkerPool
+{
+    int (*job)(void *argument, int index);
+    void *argument;
+    int job_count;
+    int next_job;
+    int result;
+
+    struct Mutex *mutex;
+    struct Thread **threads;
+    int thread_count;
+};
+
+static int run_jobs(void *argument)
+{
+    struct WorkerPool *pool = (struct WorkerPool *)argument;
+
+    while (TRUE)
+    {
+        lock_mutex(pool->mutex);
+        int index = (pool->next_job < pool->job_count ? pool->next_job++ : -1);
+        unlock_mutex(pool->mutex);
+
+        if (index < 0) { break; }
+
+        if (pool->job(pool->argument, index))
+        {
+            lock_mutex(pool->mutex);
+            pool->result = 1;
+            unlock_mutex(pool->mutex);
+        }
+    }
+
+    return 0;
+}
+
+struct WorkerPool *start_workers(int job_count, int worker_count, int (*job)(void *argument, int index), void *argument)
+{
+    struct WorkerPool *pool = (struct WorkerPool *)malloc(sizeof(struct WorkerPool));
+    pool->job = job;
+    pool->argument = argument;
+    pool->job_count = job_count;
+    pool->next_job = 0;
+    pool->result = 0;
+    pool->mutex = create_mutex();
+
+    worker_count = MAX(0, MIN(worker_count, job_count));
+    pool->threads = (struct Thread **)malloc(sizeof(struct Thread *) * MAX(1, worker_count));
+    pool->thread_count = 0;
+    for(int i = 0; i < worker_count; i++)
+    {
+        struct Thread *thread = create_thread(run_jobs, pool);
+        if (thread == NULL) { break; }
+        pool->threads[pool->thread_count++] = thread;
+    }
+
+    return pool;
+}
+
+// The calling thread takes the jobs still left and then waits for the workers
+int finish_workers(struct WorkerPool *pool)
+{
+    run_jobs(pool);
+
+    for(int i = 0; i < pool->thread_count; i++)
+    {
+        join_thread(pool->threads[i]);
+    }
+
+    int result = pool->result;
+
+    destroy_mutex(pool->mutex);
+    free(pool->threads);
+    free(pool);
+
+    return result;
+}
+
+int run_workers(int job_count, int thread_count, int (*job)(void *argument, int index), void *argument)
+{
+    return finish_workers(start_workers(job_count, thread_count - 1, job, argument));
+}
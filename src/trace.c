@@ -0,0 +1,180 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "z80hla.h"
+
+// Spans of time of the phases of a compilation, written as Chrome trace events to be seen in Perfetto
+// or chrome://tracing. Every thread adds its spans to the trace of the context it works on.
+
+struct TraceSpan
+{
+    char *category;
+    char *name;
+    char *detail; // file or symbol the span is about, NULL if none
+    uint64_t start, duration;
+    int thread;
+};
+
+struct Trace
+{
+    struct Mutex *mutex;
+    uint64_t start;
+    int threads_count;
+
+    struct TraceSpan *spans;
+    int spans_count;
+    int spans_capacity;
+};
+
+// Threads are numbered in the order they add their first span to a trace
+static THREAD_LOCAL struct Trace *thread_trace = NULL;
+static THREAD_LOCAL uint64_t thread_trace_start = 0;
+static THREAD_LOCAL int thread_number = 0;
+
+static void number_thread(struct Trace *trace)
+{
+    if (thread_trace != trace || thread_trace_start != trace->start)
+    {
+        thread_trace = trace;
+        thread_trace_start = trace->start;
+        thread_number = ++trace->threads_count;
+    }
+}
+
+void start_trace()
+{
+    if (context->time_trace_filename == NULL) { return; }
+
+    context->trace = (struct Trace *)calloc(1, sizeof(struct Trace));
+    context->trace->mutex = create_mutex();
+    context->trace->start = get_time_nanoseconds();
+    number_thread(context->trace);
+}
+
+// Start of a span, 0 when there is no trace
+uint64_t start_trace_span()
+{
+    return context != NULL && context->trace != NULL ? get_time_nanoseconds() : 0;
+}
+
+void add_trace_span(char *category, char *name, char *detail, int detail_size, uint64_t start)
+{
+    if (context == NULL || context->trace == NULL) { return; }
+
+    struct Trace *trace = context->trace;
+    uint64_t end = get_time_nanoseconds();
+
+    lock_mutex(trace->mutex);
+    number_thread(trace);
+    if (trace->spans_count == trace->spans_capacity)
+    {
+        trace->spans_capacity = MAX(256, trace->spans_capacity * 2);
+        trace->spans = (struct TraceSpan *)realloc(trace->spans, sizeof(struct TraceSpan) * trace->spans_capacity);
+    }
+
+    struct TraceSpan *span = &trace->spans[trace->spans_count++];
+    span->category = category;
+    span->name = name;
+    span->detail = NULL;
+    if (detail != NULL)
+    {
+        span->detail = (char *)malloc(detail_size + 1);
+        memcpy(span->detail, detail, detail_size);
+        span->detail[detail_size] = 0;
+    }
+    span->start = start - trace->start;
+    span->duration = end - start;
+    span->thread = thread_number;
+    unlock_mutex(trace->mutex);
+}
+
+// Times are in microseconds
+static void fprint_trace(FILE *fp, struct Trace *trace)
+{
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for(int i = 1; i <= trace->threads_count; i++)
+    {
+        if (i == 1)
+        {
+            fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}},\n");
+        }
+        else
+        {
+            fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"worker %d\"}},\n", i, i - 1);
+        }
+    }
+    for(int i = 0; i < trace->spans_count; i++)
+    {
+        struct TraceSpan *span = &trace->spans[i];
+        fprintf(fp, "{\"name\":");
+        fprint_json_string(fp, span->name);
+        fprintf(fp, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%" PRIu64 ".%03d,\"dur\":%" PRIu64 ".%03d,\"pid\":1,\"tid\":%d",
+            span->category, span->start / 1000, (int)(span->start % 1000), span->duration / 1000, (int)(span->duration % 1000), span->thread);
+        if (span->detail != NULL)
+        {
+            fprintf(fp, ",\"args\":{\"detail\":");
+            fprint_json_string(fp, span->detail);
+            fprintf(fp, "}");
+        }
+        fprintf(fp, "}%s\n", i + 1 < trace->spans_count ? "," : "");
+    }
+    fprintf(fp, "]}\n");
+}
+
+// Writes the trace and frees it
+int finish_trace()
+{
+    struct Trace *trace = context->trace;
+    char trace_path[256];
+    int result = 0;
+
+    if (trace == NULL) { return 0; }
+    context->trace = NULL;
+
+    get_output_path(trace_path, context->time_trace_filename);
+    FILE *fp = fopen(trace_path, "w");
+    if (fp == NULL)
+    {
+        write_error("Unable to write time trace file \"%s\"", trace_path);
+        result = 1;
+    }
+    else
+    {
+        fprint_trace(fp, trace);
+        fclose(fp);
+    }
+
+    for(int i = 0; i < trace->spans_count; i++)
+    {
+        free(trace->spans[i].detail);
+    }
+    free(trace->spans);
+    destroy_mutex(trace->mutex);
+    free(trace);
+
+    return result;
+}
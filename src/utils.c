@@ -25,11 +25,20 @@
 */
 
 #include "z80hla.h"
+#include <errno.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 
 BOOL is_str_equal(char *str1, int str1_size, char *str2)
 {
     int c = 0;
 
+    COUNT_STAT(string_compares);
+
     if (str1_size == 0 && str2[0] == '\0')
     {
         return TRUE;
@@ -55,6 +64,8 @@ BOOL is_str_equal2(char *str1, int str1_size, char *str2, int str2_size)
 {
     int c = 0;
 
+    COUNT_STAT(string_compares);
+
     if (str1_size != str2_size)
     {
         return FALSE;
@@ -150,6 +161,192 @@ void filename_add_path(char *dst, char *filename, char *path)
     dst[0] = '\0';
 }
 
+// Writes a string as a JSON string
+void fprint_json_string(FILE *fp, char *str)
+{
+    fputc('"', fp);
+    for(unsigned char *c = (unsigned char *)str; *c != 0; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fprintf(fp, "\\%c", *c);
+        }
+        else if (*c < 0x20)
+        {
+            fprintf(fp, "\\u%04x", *c);
+        }
+        else
+        {
+            fputc(*c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+// Creates a directory, TRUE if it was created or already exists
+BOOL make_directory(char *path)
+{
+#ifdef _WIN32
+    return _mkdir(path) == 0 || errno == EEXIST;
+#else
+    return mkdir(path, 0777) == 0 || errno == EEXIST;
+#endif
+}
+
+// FNV-1a, the hash of several values is the hash of each one started with the previous hash
+uint64_t hash_bytes(uint64_t hash, void *data, size_t size)
+{
+    uint8_t *bytes = (uint8_t *)data;
+
+    for(size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+static const uint32_t sha256_constants[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTATE_RIGHT(x, n)  (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void process_sha256_block(struct Sha256 *sha256, uint8_t *block)
+{
+    uint32_t w[64], s[8];
+
+    for(int i = 0; i < 16; i++)
+    {
+        w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 | (uint32_t)block[i * 4 + 2] << 8 | block[i * 4 + 3];
+    }
+    for(int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = ROTATE_RIGHT(w[i - 15], 7) ^ ROTATE_RIGHT(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTATE_RIGHT(w[i - 2], 17) ^ ROTATE_RIGHT(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    memcpy(s, sha256->state, sizeof(s));
+    for(int i = 0; i < 64; i++)
+    {
+        uint32_t s1 = ROTATE_RIGHT(s[4], 6) ^ ROTATE_RIGHT(s[4], 11) ^ ROTATE_RIGHT(s[4], 25);
+        uint32_t t1 = s[7] + s1 + ((s[4] & s[5]) ^ (~s[4] & s[6])) + sha256_constants[i] + w[i];
+        uint32_t s0 = ROTATE_RIGHT(s[0], 2) ^ ROTATE_RIGHT(s[0], 13) ^ ROTATE_RIGHT(s[0], 22);
+        uint32_t t2 = s0 + ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+        memmove(s + 1, s, sizeof(uint32_t) * 7);
+        s[4] += t1;
+        s[0] = t1 + t2;
+    }
+    for(int i = 0; i < 8; i++)
+    {
+        sha256->state[i] += s[i];
+    }
+}
+
+// SHA-256, for the identity of files and builds where a collision would give wrong output files
+void init_sha256(struct Sha256 *sha256)
+{
+    static const uint32_t initial_state[8] =
+    {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    memcpy(sha256->state, initial_state, sizeof(initial_state));
+    sha256->size = 0;
+}
+
+void update_sha256(struct Sha256 *sha256, void *data, size_t size)
+{
+    uint8_t *bytes = (uint8_t *)data;
+
+    while (size > 0)
+    {
+        size_t block_used = (size_t)(sha256->size % 64);
+        size_t copy_size = MIN(size, 64 - block_used);
+        memcpy(sha256->block + block_used, bytes, copy_size);
+        sha256->size += copy_size;
+        bytes += copy_size;
+        size -= copy_size;
+        if (block_used + copy_size == 64)
+        {
+            process_sha256_block(sha256, sha256->block);
+        }
+    }
+}
+
+void finish_sha256(struct Sha256 *sha256, uint8_t *digest)
+{
+    uint64_t bit_size = sha256->size * 8;
+    uint8_t padding[72] = { 0x80 };
+    size_t padding_size = 64 - (size_t)((sha256->size + 8) % 64);
+
+    for(int i = 0; i < 8; i++)
+    {
+        padding[padding_size + i] = (uint8_t)(bit_size >> (56 - i * 8));
+    }
+    update_sha256(sha256, padding, padding_size + 8);
+
+    for(int i = 0; i < 32; i++)
+    {
+        digest[i] = (uint8_t)(sha256->state[i / 4] >> (24 - (i % 4) * 8));
+    }
+}
+
+// Writes the digest as hexadecimal digits, dst needs SHA256_SIZE * 2 + 1 characters
+void sprint_digest(char *dst, uint8_t *digest)
+{
+    for(int i = 0; i < SHA256_SIZE; i++)
+    {
+        sprintf(dst + i * 2, "%02x", digest[i]);
+    }
+}
+
+// Read the same way files are read to the file cache, so the digests are the same
+BOOL digest_file(char *filename, BOOL binary, uint8_t *digest)
+{
+    FILE *fp = fopen(filename, binary ? "rb" : "r");
+    if (!fp) { return FALSE; }
+
+    struct Sha256 sha256;
+    char buffer[16384];
+    size_t read_size;
+    init_sha256(&sha256);
+    while ((read_size = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    {
+        update_sha256(&sha256, buffer, read_size);
+    }
+    BOOL result = !ferror(fp);
+    fclose(fp);
+    finish_sha256(&sha256, digest);
+
+    return result;
+}
+
+// Reads a digest written by sprint_digest, FALSE when the text is not one
+BOOL sscan_digest(char *src, uint8_t *digest)
+{
+    for(int i = 0; i < SHA256_SIZE * 2; i++)
+    {
+        char c = src[i];
+        int value = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+        if (value < 0) { return FALSE; }
+
+        digest[i / 2] = (uint8_t)(i % 2 == 0 ? value << 4 : digest[i / 2] | value);
+    }
+
+    return src[SHA256_SIZE * 2] == 0;
+}
+
 BOOL is_node_expression_type(enum NodeType node_type)
 {
     return node_type == NODE_TYPE_EXPRESSION || node_type == NODE_TYPE_EXPRESSION_8 ||
@@ -158,6 +355,11 @@ BOOL is_node_expression_type(enum NodeType node_type)
         node_type == NODE_TYPE_EXPRESSION_3;
 }
 
+BOOL is_node_literal(struct ASTNode *node)
+{
+    return is_node_expression_type(node->type) && node->str_size == 0 && node->children_count == 0;
+}
+
 BOOL is_node_identifier_expression(struct ASTNode *node)
 {
     return
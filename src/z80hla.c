@@ -26,26 +26,88 @@
 
 #include "z80hla.h"
 
+// Messages written by a thread working ahead of the parser are held until the parser reaches them
+static THREAD_LOCAL BOOL messages_held = FALSE;
+static THREAD_LOCAL char *held_messages = NULL;
+static THREAD_LOCAL int held_messages_size = 0;
+static THREAD_LOCAL int held_messages_capacity = 0;
+
+static void write_message(char *prefix, char *fmt, va_list arg_ptr, BOOL new_line)
+{
+	if (!messages_held)
+	{
+		printf("%s", prefix);
+		vprintf(fmt, arg_ptr);
+		if (new_line) { printf("\n"); }
+		return;
+	}
+
+	va_list arg_ptr_copy;
+	va_copy(arg_ptr_copy, arg_ptr);
+	int size = (int)strlen(prefix) + vsnprintf(NULL, 0, fmt, arg_ptr_copy) + 1;
+	va_end(arg_ptr_copy);
+
+	if (held_messages_size + size + 1 > held_messages_capacity)
+	{
+		held_messages_capacity = MAX(held_messages_capacity * 2, held_messages_size + size + 1);
+		held_messages = (char *)realloc(held_messages, held_messages_capacity);
+	}
+
+	held_messages_size += sprintf(held_messages + held_messages_size, "%s", prefix);
+	held_messages_size += vsprintf(held_messages + held_messages_size, fmt, arg_ptr);
+	if (new_line)
+	{
+		held_messages_size += sprintf(held_messages + held_messages_size, "\n");
+	}
+}
+
+void hold_messages(BOOL hold)
+{
+	messages_held = hold;
+}
+
+// Returns the messages held since the last call or NULL, they are freed by the caller
+char *take_held_messages()
+{
+	if (held_messages_size == 0)
+	{
+		return NULL;
+	}
+
+	char *messages = held_messages;
+	held_messages = NULL;
+	held_messages_size = held_messages_capacity = 0;
+	return messages;
+}
+
 void write_error(char *fmt, ...)
 {
 	va_list arg_ptr;
 
-	printf("[ERROR] ");
 	va_start(arg_ptr, fmt);
-	vprintf(fmt, arg_ptr);
+	write_message("[ERROR] ", fmt, arg_ptr, TRUE);
 	va_end(arg_ptr);
-	printf("\n");
 }
 
 void write_compiler_error(char *filename, int current_line, char *fmt, ...)
 {
 	va_list arg_ptr;
+	char prefix[300];
 
-	printf("[ERROR] %s:%d: ", filename, current_line);
+	snprintf(prefix, sizeof(prefix), "[ERROR] %s:%d: ", filename, current_line);
 	va_start(arg_ptr, fmt);
-	vprintf(fmt, arg_ptr);
+	write_message(prefix, fmt, arg_ptr, TRUE);
+	va_end(arg_ptr);
+}
+
+// Output of print statements, held like the messages
+void write_print(char *fmt, ...)
+{
+	va_list arg_ptr;
+
+	va_start(arg_ptr, fmt);
+	write_message("", fmt, arg_ptr, FALSE);
 	va_end(arg_ptr);
-	printf("\n");
 }
 
 void write_debug_impl(char *fmt, ...)
@@ -59,257 +121,674 @@ void write_debug_impl(char *fmt, ...)
 	printf("\n");
 }
 
-void print_usage()
-{
-	printf("Usage: z80hla [options] input_file\n\n");
-	printf("Options:\n");
-	printf("-h\t--help\t\t\tShow this information.\n");
-	printf("-o\t--output FILE\t\tSet the default output file.\n");
-	printf("-i\t--include PATH\t\tAdd include path.\n");
-	printf("-c\t--cpu CPU_TYPE\t\tSet CPU type: \"z80\" (default), \"gb\", \"msx\" / \"r800\"\n");
-	printf("-d\t--define IDENTIFIER\tAdd define identifier\n");
-	printf("-a\t--assembleall\t\tAssemble all library symbols and not just the ones referenced\n");
-	printf("-j\t--jrloop\t\tGenerate jr instead of jp when possible in loops\n");
-	printf("-s\t--symbols FILE\t\tOutput symbols JSON file\n");
-	printf("-l\t--list FILE\t\tOutput listing of instructions without high-level constructs\n");
-	printf("\n");
-}
+THREAD_LOCAL struct Z80HLAContext *context = NULL;
+
+// Memory of the nodes and of what they point to, they are never freed one by one. Each thread allocates
+// from a block of its own so allocating is just moving a pointer, the blocks are freed with the context.
 
-enum CPUType cpu_type = CPU_TYPE_Z80, initial_cpu_type = CPU_TYPE_Z80;
-FILE *fp_list = NULL;
+#define CONTEXT_MEMORY_BLOCK_SIZE	(1 << 16)
+#define CONTEXT_MEMORY_ALIGNMENT	8
 
-int main(int argc, char *argv[])
+struct ContextMemoryBlock
 {
-	char *input_filename = NULL;	
-	char *symbol_filename = NULL;
-	char *listing_filename = NULL;
+	char *memory;
+	size_t size;
+	size_t used;
+	BOOL kept; // memory allocated by someone else and given to the context
 
-	printf("Z80 high-level assembler v"Z80HLA_VERSION_HI"."Z80HLA_VERSION_LO"\n");
-	printf("Copyright (C) Sérgio Vieira 2023 <internalregister@gmail.com>\n\n");
+	struct ContextMemoryBlock *next;
+};
+
+struct ContextMemory
+{
+	struct Mutex *mutex;
+	uint64_t start;
+	struct ContextMemoryBlock *first_block;
+};
 
-	if (argc == 1)
+static THREAD_LOCAL struct ContextMemory *thread_memory = NULL;
+static THREAD_LOCAL uint64_t thread_memory_start = 0;
+static THREAD_LOCAL struct ContextMemoryBlock *thread_memory_block = NULL;
+
+static struct ContextMemoryBlock *add_context_memory_block(char *memory, size_t size, BOOL kept)
+{
+	struct ContextMemoryBlock *block = (struct ContextMemoryBlock *)malloc(sizeof(struct ContextMemoryBlock) + (kept ? 0 : size));
+	block->memory = kept ? memory : (char *)(block + 1);
+	block->size = size;
+	block->used = 0;
+	block->kept = kept;
+
+	lock_mutex(context->memory->mutex);
+	block->next = context->memory->first_block;
+	context->memory->first_block = block;
+	unlock_mutex(context->memory->mutex);
+
+	return block;
+}
+
+void *allocate_context_memory(size_t size)
+{
+	struct ContextMemory *memory = context->memory;
+	size = (size + CONTEXT_MEMORY_ALIGNMENT - 1) & ~(size_t)(CONTEXT_MEMORY_ALIGNMENT - 1);
+
+	// Large allocations get a block of their own, the block of the thread is kept for the small ones
+	if (size > CONTEXT_MEMORY_BLOCK_SIZE / 4)
 	{
-		print_usage();
-		return 0;
+		return add_context_memory_block(NULL, size, FALSE)->memory;
+	}
+
+	struct ContextMemoryBlock *block = thread_memory_block;
+	if (thread_memory != memory || thread_memory_start != memory->start || block->used + size > block->size)
+	{
+		block = thread_memory_block = add_context_memory_block(NULL, CONTEXT_MEMORY_BLOCK_SIZE, FALSE);
+		thread_memory = memory;
+		thread_memory_start = memory->start;
 	}
 
-	compiler_output_filename = "output.bin";
+	void *result = block->memory + block->used;
+	block->used += size;
 
-	for (int i = 1; i < argc; i++)
+	return result;
+}
+
+// Memory allocated with malloc that is freed with the context from now on
+void keep_context_memory(void *memory)
+{
+	add_context_memory_block((char *)memory, 0, TRUE);
+}
+
+struct Z80HLAContext *create_context()
+{
+	struct Z80HLAContext *new_context = (struct Z80HLAContext *)calloc(1, sizeof(struct Z80HLAContext));
+
+	new_context->compiler_output_filename = "output.bin";
+	new_context->initial_cpu_type = new_context->cpu_type = CPU_TYPE_Z80;
+	new_context->tables_mutex = create_mutex();
+	new_context->memory = (struct ContextMemory *)calloc(1, sizeof(struct ContextMemory));
+	new_context->memory->mutex = create_mutex();
+	new_context->memory->start = get_time_nanoseconds();
+
+	return new_context;
+}
+
+// Frees everything a compilation filled, the options given to the context belong to the caller
+void destroy_context(struct Z80HLAContext *compile_context)
+{
+	struct Z80HLAContext *previous_context = context;
+	context = compile_context;
+
+	free_parser();
+	free_compiler();
+	free_tables();
+
+	for(struct ContextMemoryBlock *block = context->memory->first_block, *next_block; block != NULL; block = next_block)
 	{
-		if (!strcmp(argv[i], "-o") || !strcmp(argv[i], "--output"))
+		next_block = block->next;
+		if (block->kept)
 		{
-			i++;
-			if (i == argc)
-			{
-				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
-				return 1;
-			}
-			compiler_output_filename = argv[i];
-		}
-		else if (!strcmp(argv[i], "-i") || !strcmp(argv[i], "--include"))
-		{
-			i++;
-			if (i == argc)
-			{
-				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
-				return 1;
-			}
-			add_include_path(argv[i]);
+			free(block->memory);
 		}
-		else if (!strcmp(argv[i], "-c") || !strcmp(argv[i], "--cpu"))
-		{
-			i++;
-			if (i == argc)
-			{
-				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
-				return 1;
-			}
+		free(block);
+	}
+	destroy_mutex(context->memory->mutex);
+	free(context->memory);
 
-			if (!strcmp(argv[i], "z80"))
-			{
-				initial_cpu_type = cpu_type = CPU_TYPE_Z80;
-			}
-			else if (!strcmp(argv[i], "gb"))
-			{
-				initial_cpu_type = cpu_type = CPU_TYPE_GB;
-			}
-			else if (!strcmp(argv[i], "msx") || !strcmp(argv[i], "r800"))
-			{
-				initial_cpu_type = cpu_type = CPU_TYPE_MSX;
-			}
-			else
-			{
-				printf("Error: Invalid CPU type \"%s\"\n", argv[i]);
-				return 1;
-			}
-		}
-		else if (!strcmp(argv[i], "-d") || !strcmp(argv[i], "--define"))
-		{
-			i++;
-			if (i == argc)
-			{
-				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
-				return 1;
-			}
+	destroy_mutex(context->tables_mutex);
+	free(context);
 
-			add_define_identifier(argv[i], (int)strlen(argv[i]));			
-		}
-		else if (!strcmp(argv[i], "-s") || !strcmp(argv[i], "--symbols"))
-		{
-			i++;
-			if (i == argc)
-			{
-				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
-				return 1;
-			}
+	context = previous_context != compile_context ? previous_context : NULL;
+}
 
-			symbol_filename = argv[i];
-		}
-		else if (!strcmp(argv[i], "-l") || !strcmp(argv[i], "--list"))
-		{
-			i++;
-			if (i == argc)
-			{
-				printf("Error: Option requires an argument \"%s\"\n", argv[i-1]);
-				return 1;
-			}
+void add_context_include_path(struct Z80HLAContext *compile_context, char *path)
+{
+	struct Z80HLAContext *previous_context = context;
+	context = compile_context;
+	add_include_path(path);
+	context = previous_context;
+}
+
+void add_context_define_identifier(struct Z80HLAContext *compile_context, char *identifier)
+{
+	struct Z80HLAContext *previous_context = context;
+	context = compile_context;
+	add_define_identifier(identifier, (int)strlen(identifier));
+	context = previous_context;
+}
+
+#define LISTING_BUFFER_SIZE (1 << 16)
+
+// Parses the input file, returns 1 when it can't be read and leaves node NULL when it has errors
+static int parse_input(struct Lexer *lexer, struct ASTNode **node)
+{
+	if (context->thread_count == 0)
+	{
+		context->thread_count = get_cpu_count();
+	}
+
+	if (init_lexer(lexer, context->input_filename))
+	{
+		context->has_errors = TRUE;
+		return 1;
+	}
+	
+	if (context->thread_count > 1)
+	{
+		start_prefetch(lexer->filename, lexer->buffer_start);
+	}
+
+	// Without the directory the included files are just parsed
+	if (context->precompiled_directory != NULL && !make_directory(context->precompiled_directory))
+	{
+		context->precompiled_directory = NULL;
+	}
 
-			listing_filename = argv[i];			
+	printf("parsing...\n");
+	push_include_file(lexer->filename);
+	*node = parse_with_includes(lexer);
+	pop_include_file();
+
+	if (*node == NULL)
+	{
+		context->has_errors = TRUE;
+		return 0;
+	}
+
+	uint64_t trace_start = start_trace_span();
+	fill_library_symbols_used_with_dependencies();
+	add_trace_span("compile", "library dependencies", NULL, 0, trace_start);
+
+	#if DEBUG == 1
+	FILE *fp_AST = fopen("output_ast.json", "w");
+	fprint_ast(fp_AST, *node);
+	fclose(fp_AST);
+
+	FILE *fp_dependencies = fopen("output_dependencies.json", "w");
+	fprint_library_symbol_dependencies(fp_dependencies);
+	fclose(fp_dependencies);
+
+	FILE *fp_used_library_symbols = fopen("output_library_symbols_used.json", "w");
+	fprint_library_symbols_used(fp_used_library_symbols);
+	fclose(fp_used_library_symbols);
+	#endif
+
+	return 0;
+}
+
+static int write_symbol_file()
+{
+	char symbol_path[256];
+
+	if (context->symbol_filename != NULL)
+	{
+		get_output_path(symbol_path, context->symbol_filename);
+		FILE *fp_symbols = fopen(symbol_path, "w");
+		if (!fp_symbols)
+		{
+			printf("Cannot open file \"%s\" to write\n", symbol_path);
+			context->has_errors = TRUE;
+			return 1;
 		}
-		else if (!strcmp(argv[i], "-a") || !strcmp(argv[i], "--assembleall"))
+		uint64_t trace_start = start_trace_span();
+		fprintf_output_symbols(fp_symbols, context->include_generated_labels);
+		fclose(fp_symbols);
+		add_trace_span("write", "write", symbol_path, (int)strlen(symbol_path), trace_start);
+		add_written_file(symbol_path);
+	}
+
+	return 0;
+}
+
+struct DependencyFile
+{
+	FILE *fp;
+	int targets_count;
+};
+
+// Spaces, "#" and "$" are escaped the way make reads them
+static void fprint_make_filename(FILE *fp, char *filename)
+{
+	for(char *c = filename; *c != 0; c++)
+	{
+		if (*c == ' ' || *c == '#')
 		{
-			assemble_all = TRUE;
+			fputc('\\', fp);
 		}
-		else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help"))
+		else if (*c == '$')
 		{
-			print_usage();
-			return 0;
+			fputc('$', fp);
 		}
-		else if (!strcmp(argv[i], "-j") || !strcmp(argv[i], "--jrloop"))
+		fputc(*c, fp);
+	}
+}
+
+static void write_dependency_target(char *path, void *argument)
+{
+	struct DependencyFile *dependency_file = (struct DependencyFile *)argument;
+
+	if (dependency_file->targets_count++ > 0)
+	{
+		fprintf(dependency_file->fp, " ");
+	}
+	fprint_make_filename(dependency_file->fp, path);
+}
+
+static void write_dependency_prerequisite(char *filename, BOOL binary, uint8_t *digest, void *argument)
+{
+	fprintf(((struct DependencyFile *)argument)->fp, " \\\n  ");
+	fprint_make_filename(((struct DependencyFile *)argument)->fp, filename);
+}
+
+// Files read get a rule with no prerequisites, make does not fail when one of them is removed
+static void write_dependency_empty_rule(char *filename, BOOL binary, uint8_t *digest, void *argument)
+{
+	fprintf(((struct DependencyFile *)argument)->fp, "\n");
+	fprint_make_filename(((struct DependencyFile *)argument)->fp, filename);
+	fprintf(((struct DependencyFile *)argument)->fp, ":\n");
+}
+
+// Makefile rule with the files written by the compilation as targets and the files read (included
+// source files and binary files) as prerequisites
+static int write_dependency_file()
+{
+	char deps_path[256];
+	struct DependencyFile dependency_file;
+
+	if (context->deps_filename == NULL) { return 0; }
+
+	get_output_path(deps_path, context->deps_filename);
+	dependency_file.fp = fopen(deps_path, "w");
+	if (!dependency_file.fp)
+	{
+		printf("Cannot open file \"%s\" to write\n", deps_path);
+		context->has_errors = TRUE;
+		return 1;
+	}
+	dependency_file.targets_count = 0;
+
+	for_each_written_file(write_dependency_target, &dependency_file);
+	fprintf(dependency_file.fp, ":");
+	for_each_cached_file(write_dependency_prerequisite, &dependency_file);
+	fprintf(dependency_file.fp, "\n");
+	for_each_cached_file(write_dependency_empty_rule, &dependency_file);
+	fclose(dependency_file.fp);
+	add_written_file(deps_path);
+
+	return 0;
+}
+
+static int compile_input(struct ASTNode *node)
+{
+	char listing_path[256];
+
+	if (node == NULL)
+	{
+		write_error("Error parsing file");
+		return 0;
+	}
+
+	init_compiler();
+	if (context->listing_filename != NULL)
+	{
+		get_output_path(listing_path, context->listing_filename);
+		context->fp_list = fopen(listing_path, "wt");
+		if (!context->fp_list)
 		{
-			jr_in_loops = TRUE;
+			printf("Cannot open file \"%s\" to write\n", listing_path);
+			context->has_errors = TRUE;
+			return 1;
 		}
-		else
+		setvbuf(context->fp_list, NULL, _IOFBF, LISTING_BUFFER_SIZE);
+		add_written_file(listing_path);
+	}
+	if (compile(node))
+	{
+		write_error("Error compiling");
+		context->has_errors = TRUE;
+
+		if (context->fp_list)
 		{
-			if (argv[i][0] == '-')
+			fclose(context->fp_list);
+			if (remove(listing_path))
 			{
-				printf("Error: Invalid option \"%s\"\n", argv[i]);
-				return 1;
+				write_error("Unable to remove file \"%s\"", listing_path);
 			}
-			
-			input_filename = argv[i];
+			return 1;
+		}
+	}
+	else
+	{
+		#if DEBUG == 1			
+		FILE *fp_out = fopen("output_output.json", "w");
+		fprint_output(fp_out);
+		fclose(fp_out);
+		#endif
+
+		if (context->fp_list)
+		{
+			fclose(context->fp_list);
 		}
 	}
 
-	if (input_filename == NULL)
+	#if DEBUG == 1
+	FILE *fp_constants = fopen("output_constants.json", "w");
+	fprint_constants(fp_constants);
+	fclose(fp_constants);
+
+	FILE *fp_structs = fopen("output_structs.json", "w");
+	fprint_structured_types(fp_structs);
+	fclose(fp_structs);
+
+	FILE *fp_data = fopen("output_data.json", "w");
+	fprintf_data_symbols(fp_data);
+	fclose(fp_data);
+	#endif
+
+	if (write_symbol_file())
 	{
-		printf("Error: No input file\n");
 		return 1;
 	}
 
+	printf("Compilation successful\n");
+
+	return 0;
+}
+
+// Compiles the input file of a context in the calling thread, different contexts can be compiled
+// at the same time in different threads
+int assemble(struct Z80HLAContext *compile_context)
+{
+	struct Z80HLAContext *previous_context = context;
+	context = compile_context;
+
+	init_tables();
+	init_parser();
+
+	if (start_incremental_build())
+	{
+		printf("Output files are up to date\n");
+		context = previous_context;
+		return 0;
+	}
+	if (restore_cached_build())
+	{
+		printf("Output files restored from the build cache\n");
+		finish_incremental_build(FALSE);
+		context = previous_context;
+		return 0;
+	}
+	start_trace();
+	start_stats();
+
 	struct Lexer lexer;
-	if (init_lexer(&lexer, input_filename))
+	struct ASTNode *node = NULL;
+	int result = parse_input(&lexer, &node);
+	if (!result)
 	{
-		return 1;
+		result = compile_input(node);
+		finish_prefetch();
+		destroy_lexer(&lexer);
 	}
-	
-	printf("parsing...\n");
-	push_include_file(lexer.filename);
-	struct ASTNode *node = parse(&lexer, NULL, NULL);
-	pop_include_file();
+	if (!result && !context->has_errors)
+	{
+		result = write_dependency_file();
+	}
+	if (finish_trace())
+	{
+		result = 1;
+	}
+	if (finish_stats())
+	{
+		result = 1;
+	}
+	store_cached_build(!result && !context->has_errors);
+	finish_incremental_build(!result && !context->has_errors);
 
-	if (node != NULL)
-	{		
-		fill_library_symbols_used_with_dependencies();
+	context = previous_context;
 
-		#if DEBUG == 1
-		FILE *fp_AST = fopen("output_ast.json", "w");
-		fprint_ast(fp_AST, node);
-		fclose(fp_AST);
+	return result;
+}
+
+// Links the object files compiled with --object into the output of a context
+int link_objects(struct Z80HLAContext *compile_context, char **object_filenames, int count)
+{
+	struct Z80HLAContext *previous_context = context;
+	context = compile_context;
+
+	init_tables();
+	init_compiler();
+	start_trace();
+	start_stats();
+
+	printf("linking...\n");
+	uint64_t trace_start = start_trace_span();
+	int result = load_object_files(object_filenames, count);
+	add_trace_span("compile", "load object files", NULL, 0, trace_start);
+	result = result || link_output();
+	if (result)
+	{
+		write_error("Error linking");
+		context->has_errors = TRUE;
+	}
+	else if (!(result = write_symbol_file()))
+	{
+		printf("Linking successful\n");
+	}
+	if (finish_trace())
+	{
+		result = 1;
+	}
+	if (finish_stats())
+	{
+		result = 1;
+	}
 
-		FILE *fp_dependencies = fopen("output_dependencies.json", "w");
-		fprint_library_symbol_dependencies(fp_dependencies);
-		fclose(fp_dependencies);
+	context = previous_context;
 
-		FILE *fp_used_library_symbols = fopen("output_library_symbols_used.json", "w");
-		fprint_library_symbols_used(fp_used_library_symbols);
-		fclose(fp_used_library_symbols);
-		#endif
+	return result;
+}
 
-		init_compiler();
-		if (listing_filename != NULL)
+// Compiles the input file of a context without writing any file, on_parsed is given the nodes
+// before the compiler changes them. The tables are kept filled to be read after it.
+int check(struct Z80HLAContext *compile_context, void (*on_parsed)(struct ASTNode *first_node, void *argument), void *argument)
+{
+	struct Z80HLAContext *previous_context = context;
+	context = compile_context;
+	context->check_only = TRUE;
+	context->listing_filename = context->symbol_filename = NULL;
+	context->incremental = FALSE;
+
+	init_tables();
+	init_parser();
+
+	struct Lexer lexer;
+	struct ASTNode *node = NULL;
+	int result = parse_input(&lexer, &node);
+	if (!result)
+	{
+		if (node != NULL)
 		{
-			fp_list = fopen(listing_filename, "wt");
-			if (!fp_list)
-			{
-				printf("Cannot open file \"%s\" to write\n", listing_filename);
-				return 1;
-			}
+			on_parsed(node, argument);
 		}
-		if (compile(node))
-		{
-			write_error("Error compiling");
+		result = compile_input(node);
+		finish_prefetch();
+	}
 
-			if (fp_list)
-			{
-				fclose(fp_list);
-				if (remove(listing_filename))
-				{
-					write_error("Unable to remove file \"%s\"", listing_filename);
-				}
-				return 1;
-			}
-		}
-		else
-		{
-			#if DEBUG == 1			
-			FILE *fp_out = fopen("output_output.json", "w");
-			fprint_output(fp_out);
-			fclose(fp_out);
-			#endif
+	context = previous_context;
 
-			if (fp_list)
-			{
-				fclose(fp_list);
-			}
-		}
+	return result;
+}
 
-		#if DEBUG == 1
-		FILE *fp_constants = fopen("output_constants.json", "w");
-		fprint_constants(fp_constants);
-		fclose(fp_constants);
+// *************
+// Configurations
+// *************
 
-		FILE *fp_structs = fopen("output_structs.json", "w");
-		fprint_structured_types(fp_structs);
-		fclose(fp_structs);
+// Configurations where the same files are parsed the same way share the AST parsed by the first of them
+struct Configurations
+{
+	struct Z80HLAContext **contexts;
+	int *parsed_by; // index of the configuration that parses the files of each one
+	char ***ifdef_identifiers; // of each configuration that parses
+	int *ifdef_identifiers_count;
+	struct Lexer *lexers;
+	struct ASTNode **nodes;
+	int *parse_results;
+};
+
+// Two configurations are parsed the same way when every identifier #ifdef may check is defined in both or in neither
+static BOOL can_share_parse(struct Configurations *configurations, int parsing, int index)
+{
+	struct Z80HLAContext *parsing_context = configurations->contexts[parsing], *index_context = configurations->contexts[index];
+	char **identifiers = configurations->ifdef_identifiers[parsing];
 
-		FILE *fp_data = fopen("output_data.json", "w");
-		fprintf_data_symbols(fp_data);
-		fclose(fp_data);
-		#endif
+	if (strcmp(parsing_context->input_filename, index_context->input_filename) ||
+		!has_same_include_paths(parsing_context, index_context))
+	{
+		return FALSE;
+	}
+
+	for(int i = 0; i < configurations->ifdef_identifiers_count[parsing]; i++)
+	{
+		int identifier_size = (int)strlen(identifiers[i]);
+
+		context = parsing_context;
+		BOOL defined_in_parsing = has_define_identifier(identifiers[i], identifier_size);
+		context = index_context;
+		BOOL defined_in_index = has_define_identifier(identifiers[i], identifier_size);
+
+		if (defined_in_parsing != defined_in_index) { return FALSE; }
+	}
+
+	return TRUE;
+}
+
+static int parse_configuration_job(void *argument, int index)
+{
+	struct Configurations *configurations = (struct Configurations *)argument;
+	if (configurations->parsed_by[index] != index) { return 0; }
+
+	context = configurations->contexts[index];
+	init_tables();
+	init_parser();
+
+	configurations->parse_results[index] = parse_input(&configurations->lexers[index], &configurations->nodes[index]);
+	finish_prefetch();
+
+	return 0;
+}
+
+// Each configuration compiles its own copy of the AST, the compiler changes the nodes
+static int compile_configuration_job(void *argument, int index)
+{
+	struct Configurations *configurations = (struct Configurations *)argument;
+	int parsing = configurations->parsed_by[index];
+	struct Z80HLAContext *parsing_context = configurations->contexts[parsing];
+
+	context = configurations->contexts[index];
+	init_tables();
+	init_parser();
+
+	if (configurations->parse_results[parsing])
+	{
+		context->has_errors = TRUE;
+		return 1;
+	}
 
-		if (symbol_filename != NULL)
+	// A parse with errors leaves no nodes, the errors of the parsing context are not looked at
+	// since they include the ones of its compilation, running at the same time
+	if (configurations->nodes[parsing] == NULL)
+	{
+		context->has_errors = TRUE;
+		return compile_input(NULL);
+	}
+
+	if (parsing != index)
+	{
+		context->shares_parsed_tables = TRUE;
+		context->library_symbol_dependencies = parsing_context->library_symbol_dependencies;
+		context->library_symbols_used = parsing_context->library_symbols_used;
+		context->first_inline_symbol = parsing_context->first_inline_symbol;
+	}
+
+	if (context->output_directory != NULL && !make_directory(context->output_directory))
+	{
+		write_error("Unable to create directory \"%s\"", context->output_directory);
+		context->has_errors = TRUE;
+		return 1;
+	}
+
+	return compile_input(duplicate_node_deep(configurations->nodes[parsing]));
+}
+
+// Compiles several configurations at the same time, the files are parsed once for all the
+// configurations where #ifdef gives the same results
+int assemble_configurations(struct Z80HLAContext **compile_contexts, int count, int thread_count)
+{
+	struct Z80HLAContext *previous_context = context;
+	struct Configurations configurations;
+
+	configurations.contexts = compile_contexts;
+	configurations.parsed_by = (int *)malloc(sizeof(int) * count);
+	configurations.ifdef_identifiers = (char ***)calloc(count, sizeof(char **));
+	configurations.ifdef_identifiers_count = (int *)calloc(count, sizeof(int));
+	configurations.lexers = (struct Lexer *)calloc(count, sizeof(struct Lexer));
+	configurations.nodes = (struct ASTNode **)calloc(count, sizeof(struct ASTNode *));
+	configurations.parse_results = (int *)calloc(count, sizeof(int));
+
+	int parse_count = 0;
+	for(int i = 0; i < count; i++)
+	{
+		configurations.parsed_by[i] = i;
+		for(int j = 0; j < i; j++)
 		{
-			FILE *fp_symbols = fopen(symbol_filename, "w");
-			if (!fp_symbols)
+			if (configurations.parsed_by[j] == j && can_share_parse(&configurations, j, i))
 			{
-				printf("Cannot open file \"%s\" to write\n", symbol_filename);
-				return 1;
+				configurations.parsed_by[i] = j;
+				break;
 			}
-			fprintf_output_symbols(fp_symbols);
-			fclose(fp_symbols);
 		}
 
-		printf("Compilation successful\n");
+		if (configurations.parsed_by[i] == i)
+		{
+			context = compile_contexts[i];
+			configurations.ifdef_identifiers[i] = find_ifdef_identifiers(compile_contexts[i]->input_filename, &configurations.ifdef_identifiers_count[i]);
+			parse_count++;
+		}
 	}
-	else
+	context = previous_context;
+
+	printf("%d configurations, %d parsed\n", count, parse_count);
+
+	run_workers(count, thread_count, parse_configuration_job, &configurations);
+	run_workers(count, thread_count, compile_configuration_job, &configurations);
+
+	context = previous_context;
+
+	int result = 0;
+	for(int i = 0; i < count; i++)
 	{
-		write_error("Error parsing file");
+		printf("Configuration \"%s\": %s\n", compile_contexts[i]->name, compile_contexts[i]->has_errors ? "errors" : "successful");
+		if (compile_contexts[i]->has_errors) { result = 1; }
 	}
 
-	destroy_lexer(&lexer);	
+	for(int i = 0; i < count; i++)
+	{
+		if (configurations.parsed_by[i] == i && !configurations.parse_results[i])
+		{
+			destroy_lexer(&configurations.lexers[i]);
+		}
+		for(int j = 0; j < configurations.ifdef_identifiers_count[i]; j++)
+		{
+			free(configurations.ifdef_identifiers[i][j]);
+		}
+		free(configurations.ifdef_identifiers[i]);
+	}
 
-	return 0;
-}
+	free(configurations.parsed_by);
+	free(configurations.ifdef_identifiers);
+	free(configurations.ifdef_identifiers_count);
+	free(configurations.lexers);
+	free(configurations.nodes);
+	free(configurations.parse_results);
 
+	return result;
+}
@@ -46,6 +46,9 @@
 #define INCLUDE_ERROR_OVER_MAX_STACK    1
 #define INCLUDE_ERROR_CYCLIC            2
 
+#define FILE_ERROR_OPEN     1
+#define FILE_ERROR_READ     2
+
 #define BOOL char
 #define TRUE 1
 #define FALSE 0
@@ -54,9 +57,22 @@
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #endif
 
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 void write_error(char *fmt, ...);
 void write_compiler_error(char *filename, int current_line, char *fmt, ...);
+void write_print(char *fmt, ...);
 void write_debug_impl(char *fmt, ...);
+void hold_messages(BOOL hold);
+char *take_held_messages();
 
 BOOL is_str_equal(char *str1, int str1_size, char *str2);
 BOOL is_str_equal2(char *str1, int str1_size, char *str2, int str2_size);
@@ -64,6 +80,28 @@ BOOL is_native_type(char *type, int type_size);
 int get_native_type_size(char *type, int type_size);
 void filename_get_path(char *dst, char *filename);
 void filename_add_path(char *dst, char *filename, char *path);
+BOOL make_directory(char *path);
+void fprint_json_string(FILE *fp, char *str);
+
+#define HASH_INITIAL_VALUE  0xcbf29ce484222325ULL
+
+uint64_t hash_bytes(uint64_t hash, void *data, size_t size);
+
+#define SHA256_SIZE         32
+
+struct Sha256
+{
+    uint32_t state[8];
+    uint64_t size;
+    uint8_t block[64];
+};
+
+void init_sha256(struct Sha256 *sha256);
+void update_sha256(struct Sha256 *sha256, void *data, size_t size);
+void finish_sha256(struct Sha256 *sha256, uint8_t *digest);
+void sprint_digest(char *dst, uint8_t *digest);
+BOOL sscan_digest(char *src, uint8_t *digest);
+BOOL digest_file(char *filename, BOOL binary, uint8_t *digest);
 
 #if DEBUG == 1
 #define write_debug(fmt, ...) write_debug_impl(fmt, __VA_ARGS__)
@@ -78,9 +116,126 @@ enum CPUType
     CPU_TYPE_MSX
 };
 
-extern enum CPUType cpu_type, initial_cpu_type;
+// #ifdef and #ifndef being lexed, with the copy saved while a token is peeked
+struct IfdefStack
+{
+    struct IfdefExpect *first_ifdef_expect, *last_ifdef_expect;
+    struct IfdefExpect *dup_first_ifdef_expect, *dup_last_ifdef_expect;
+};
+
+// Everything about one compilation, the options it was given and the tables it fills.
+// Each thread works on its current context, threads created while compiling work on the same one.
+struct Z80HLAContext
+{
+    char *name; // of a configuration, its output files are written to a directory with this name
+    char *output_directory;
+    char *input_filename;
+    char *symbol_filename;
+    char *listing_filename;
+    char *compiler_output_filename;
+    BOOL include_generated_labels;
+    BOOL assemble_all;
+    BOOL jr_in_loops;
+    int thread_count;
+    BOOL lexer_thread;
+    char *precompiled_directory; // included files parsed are precompiled to this directory, NULL if not
+    BOOL incremental; // a build database is kept with the output and nothing is compiled when nothing changed
+    BOOL check_only; // compiled for the messages and the tables, no output file is written
+    char *object_filename; // compiled to this object file (.z80o) to be linked with others, NULL if not
+    char *cache_directory; // files written are kept in this build cache directory and copied from it, NULL if not
+    char *deps_filename; // Makefile rule with the files written depending on the files read, NULL if not
+    char *time_trace_filename; // spans of time of the phases are written to this Chrome trace event file, NULL if not
+    char *stats_filename; // counters of the compilation are written to this JSON file ("-" for the standard output), NULL if not
+
+    enum CPUType cpu_type, initial_cpu_type;
+    FILE *fp_list;
+    BOOL has_errors;
+
+    // Tables, the mutex guards the ones filled while included files are parsed in different threads
+    struct Mutex *tables_mutex;
+    struct ConstantList *first_constant;
+    int32_t *generated_labels; // addresses indexed by their number, -1 when not set
+    int generated_labels_capacity;
+    struct ContentCache *first_content_cache_element, *last_content_cache_element;
+    struct SymbolDependencies *library_symbol_dependencies;
+    struct SymbolList *library_symbols_used;
+    struct StructuredType *first_structured_type;
+    struct StructInitValue *struct_init_values;
+    int struct_init_values_count;
+    int struct_init_values_capacity;
+    struct DataSymbol *first_data_symbol, *last_data_symbol;
+    struct InlineSymbol *first_inline_symbol;
+    struct LoopLabel *first_loop_label, *last_loop_label;
+    struct InlineSymbolStack *first_inline_symbol_stack, *last_inline_symbol_stack;
+    struct IncludePath *first_include_path, *last_include_path;
+    struct DefineIdentifier *first_define_identifier;
+    BOOL shares_parsed_tables; // the library and inline tables are the ones of the configuration that parsed its files
+
+    // Memory of the nodes and of what they point to, shared with the copies of the context used by worker threads
+    struct ContextMemory *memory;
+
+    // Parser
+    struct IncludeFileStack *start_include_stack, *end_include_stack; // files included being parsed as they are reached
+    int include_stack_size;
+    struct IfdefStack ifdef_stack; // of the lexers of the calling thread, files parsed by worker threads have their own
+    struct IncludeJob *include_jobs;
+    int include_jobs_count;
+    int include_jobs_capacity;
+    char *include_main_filename;
+    struct PrefetchFile *prefetch_files;
+    int prefetch_files_count;
+    int prefetch_files_capacity;
+    struct Mutex *prefetch_mutex;
+    struct Thread *prefetch_thread;
+
+    // Compiler
+    struct OutputElement *first_output_elem, *last_output_elem;
+    int output_length;
+    int output_bytes;
+    int struct_count;
+    int new_label_count;
+    struct IRElement *ir_elements;
+    int ir_elements_count;
+    int ir_elements_capacity;
+    struct LoweredFunction *lowered_functions;
+    int lowered_functions_count;
+    int next_lowered_function;
+    uint16_t compiler_current_address;
+    struct ListLine *list_lines;
+    int list_lines_count;
+    int list_lines_capacity;
+    FILE *compiler_fp_output;
+    int bytes_saved;
+
+    // Incremental builds, the build cache and the dependency file, shared with the copies of the context used by worker threads
+    struct WrittenFiles *written_files;
+    uint8_t build_options_digest[SHA256_SIZE];
+
+    // Object file being compiled
+    struct ObjectFile *object;
+
+    // Time trace and statistics, shared with the copies of the context used by worker threads
+    struct Trace *trace;
+    uint64_t output_file_trace_start;
+    struct Stats *stats;
+};
+
+extern THREAD_LOCAL struct Z80HLAContext *context;
+
+struct ASTNode;
 
-extern FILE *fp_list;
+struct Z80HLAContext *create_context();
+void destroy_context(struct Z80HLAContext *compile_context);
+void *allocate_context_memory(size_t size);
+void keep_context_memory(void *memory);
+void add_context_include_path(struct Z80HLAContext *compile_context, char *path);
+void add_context_define_identifier(struct Z80HLAContext *compile_context, char *identifier);
+int assemble(struct Z80HLAContext *compile_context);
+int link_objects(struct Z80HLAContext *compile_context, char **object_filenames, int count);
+int check(struct Z80HLAContext *compile_context, void (*on_parsed)(struct ASTNode *first_node, void *argument), void *argument);
+int assemble_configurations(struct Z80HLAContext **compile_contexts, int count, int thread_count);
+
+struct TokenQueue;
 
 struct Lexer
 {    
@@ -88,6 +243,9 @@ struct Lexer
     char *buffer_at;
     char *filename;
     int current_line;
+    struct IfdefStack *ifdef_stack;
+
+    struct TokenQueue *token_queue;
 };
 
 enum TokenType
@@ -205,6 +363,7 @@ enum NodeType
     NODE_TYPE_DATA_VALUE,
     NODE_TYPE_DATA_SIZE,
     NODE_TYPE_DATA_FROM,
+    NODE_TYPE_DATA_PACKED,
     NODE_TYPE_CONST,
     NODE_TYPE_STRUCT,
     NODE_TYPE_STRUCT_ELEMENT,
@@ -236,9 +395,12 @@ enum NodeType
     NODE_TYPE_ARGUMENT,
     NODE_TYPE_CONTINUE,
     NODE_TYPE_CONTINUEIF,
-    NODE_TYPE_GB_IO_HI_RAM
+    NODE_TYPE_GB_IO_HI_RAM,
+    NODE_TYPE_GENERATED_LABEL
 };
 
+#define NODE_TYPE_COUNT     (NODE_TYPE_GENERATED_LABEL + 1)
+
 #define MAX_AST_NODE_CHILDREN   16
 
 struct ASTNode
@@ -258,6 +420,7 @@ struct ASTNode
 };
 
 BOOL is_node_expression_type(enum NodeType node_type);
+BOOL is_node_literal(struct ASTNode *node);
 BOOL is_node_identifier_expression(struct ASTNode *node);
 
 // Lexer
@@ -266,6 +429,8 @@ int init_lexer(struct Lexer *lexer, char *filename);
 int destroy_lexer(struct Lexer *lexer);
 int get_next_token(struct Lexer *lexer, struct Token *token, BOOL skip_newline);
 int peek_next_token(struct Lexer *lexer, struct Token *token, BOOL skip_newline);
+void start_lexer_thread(struct Lexer *lexer);
+void finish_lexer_thread(struct Lexer *lexer);
 
 // Parser
 
@@ -292,19 +457,43 @@ struct InlineSymbol
 	struct InlineSymbol *next;
 };
 
+void init_parser();
+extern char *node_type_names[];
+
 struct ASTNode *create_node(enum NodeType type, struct Lexer *lexer);
 struct ASTNode *create_node_str(enum NodeType type, struct Lexer *lexer, char *str_value, int str_size);
 struct ASTNode *create_node_str2(enum NodeType type, struct Lexer *lexer, char *str_value, int str_size, char *str_value2, int str_size2);
 struct ASTNode *create_node_num(enum NodeType type, struct Lexer *lexer, int64_t value);
 struct ASTNode *create_node_num2(enum NodeType type, struct Lexer *lexer, int64_t value, int64_t value2);
 struct ASTNode *duplicate_node(struct ASTNode *node_to_duplicate);
+struct ASTNode *duplicate_node_deep(struct ASTNode *node_to_duplicate);
 struct ASTNode *duplicate_node_and_replace_deep(struct ASTNode *node_to_duplicate, struct InlineSymbol *inline_symbol, struct ASTNode *node_arguments);
 BOOL is_node_expression(struct ASTNode *node);
 void fprint_ast(FILE *fp, struct ASTNode *node);
 struct ASTNode *parse(struct Lexer *lexer, struct ASTNode *parent_node, struct ASTNode **last_node);
+struct ASTNode *parse_with_includes(struct Lexer *lexer);
+char **find_ifdef_identifiers(char *filename, int *count);
+void start_prefetch(char *filename, char *content);
+void finish_prefetch();
+void free_parser();
+
+// Precompiled files
+
+void start_precompiled_recording();
+void finish_precompiled_recording();
+void record_inline_symbol(struct InlineSymbol *inline_symbol);
+void record_library_symbol_dependency(char *library_name, int library_size, char *symbol_name, int symbol_name_size,
+	char *library_dependency_name, int library_dependency_name_size, char *symbol_dependency_name, int symbol_dependency_name_size);
+void record_library_symbol_used(char *library_name, int library_size, char *symbol_name, int symbol_name_size);
+BOOL is_precompiling();
+void get_precompiled_key(char *filename, char *content, uint8_t *key);
+void save_precompiled_file(char *filename, uint8_t *key, struct ASTNode *first_node, struct ASTNode *last_node);
+BOOL load_precompiled_file(char *filename, uint8_t *key, int (*find_include_job)(char *filename), struct ASTNode **first_node, struct ASTNode **last_node);
 
 // Tables
 
+void init_tables();
+void free_tables();
 void fprint_constants(FILE *fp);
 int set_constant(char *library_name, int library_size, char *name, int name_size, int64_t value);
 int get_constant(char *library_name, int library_size, char *name, int name_size, int64_t *value);
@@ -313,8 +502,9 @@ BOOL is_constant_present(char *library_name, int library_size, char *name, int n
 int push_include_file(char *filename);
 void pop_include_file();
 
-char *get_content_from_cache(char *filename);
-void add_content_to_cache(char *filename, char *content);
+char *read_file_to_cache(char *filename, BOOL binary, long *size, int *error, void (*on_read)(char *filename, char *content));
+void add_file_to_cache(char *filename, char *content, long size);
+void for_each_cached_file(void (*function)(char *filename, BOOL binary, uint8_t *digest, void *argument), void *argument);
 
 void add_library_symbol_dependency(char *library_name, int library_size, char *symbol_name, int symbol_name_size,
 	char *library_dependency_name, int library_dependency_name_size, char *symbol_dependency_name, int symbol_dependency_name_size);
@@ -324,7 +514,7 @@ void fprint_library_symbols_used(FILE *fp);
 void fill_library_symbols_used_with_dependencies();
 BOOL is_library_symbol_needed(char *library_name, int library_size, char *symbol_name, int symbol_name_size);
 
-void fprintf_output_symbols(FILE *fp);
+void fprintf_output_symbols(FILE *fp, BOOL include_generated_labels);
 
 enum StructuredTypeType { STRUCT_TYPE_STRUCT, STRUCT_TYPE_UNION };
 
@@ -374,10 +564,16 @@ struct StructuredType *get_structured_type(char *name, int name_size, char *libr
 void fprint_structured_types(FILE *fp);
 struct StructElement *get_struct_element(struct StructuredType *structured_type, char *name, int name_size);
 
-extern struct ASTNode **struct_bytes;
+struct StructInitValue
+{
+    int offset;
+    int size;
+    struct ASTNode *node;
+};
 
-void clear_struct_bytes(int size);
-int set_struct_bytes(struct StructuredType *structured_type, int offset, struct StructElement *struct_element, int index, struct ASTNode *node);
+void clear_struct_init_values();
+int add_struct_init_value(int offset, struct StructElement *struct_element, int index, struct ASTNode *node);
+struct StructInitValue *get_struct_init_values(int *count);
 
 struct DataSymbol
 {
@@ -410,20 +606,26 @@ struct InlineSymbol *get_inline_symbol(char *name, int name_size, char *library_
 int add_inline_symbol_argument(struct InlineSymbol *inline_symbol, char *name, int name_size);
 int get_inline_symbol_argument_index(struct InlineSymbol *inline_symbol, char *name, int name_size);
 
-void push_loop_label(char *label_start, char *label_end);
-char *peek_loop_label_start();
-char *peek_loop_label_end();
+void push_loop_label(int label_start, int label_end);
+int peek_loop_label_start();
+int peek_loop_label_end();
 void pop_loop_label();
 
+void set_generated_label(int label, uint16_t address);
+int get_generated_label(int label, int64_t *value);
+
 void push_inline_symbol_stack(char *inline_symbol, int inline_symbol_size, char *library_name, int library_name_size);
 BOOL is_inline_symbol_in_stack(char *name, int name_size, char *library_name, int library_name_size);
 void pop_inline_symbol_stack();
 
 void add_include_path(char *path);
 BOOL get_file_include_path(char *output_file_path, char *file_path, char* origin_file_path);
+BOOL has_same_include_paths(struct Z80HLAContext *context1, struct Z80HLAContext *context2);
+void digest_include_paths(struct Sha256 *sha256);
 
 BOOL has_define_identifier(char *identifier, int identifier_size);
 void add_define_identifier(char *identifier, int identifier_size);
+void digest_define_identifiers(struct Sha256 *sha256);
 
 enum IfdefExpectType
 {
@@ -432,27 +634,107 @@ enum IfdefExpectType
     IFDEF_EXPECT_ENDIF
 };
 
-void push_ifdef_expect(int type);
-enum IfdefExpectType peek_ifdef_expect();
-void pop_ifdef_expect();
-void save_duplicate_all_ifdef_expect();
-void revert_to_duplicate_ifdef_expect();
+void push_ifdef_expect(struct IfdefStack *stack, int type);
+enum IfdefExpectType peek_ifdef_expect(struct IfdefStack *stack);
+void pop_ifdef_expect(struct IfdefStack *stack);
+void save_duplicate_all_ifdef_expect(struct IfdefStack *stack);
+void revert_to_duplicate_ifdef_expect(struct IfdefStack *stack);
+void clear_ifdef_stack(struct IfdefStack *stack);
 
 // Compiler
 
-extern uint16_t compiler_current_address;
-extern char *compiler_output_filename;
-
-extern BOOL assemble_all;
-extern BOOL jr_in_loops;
+struct OutputElement
+{
+    uint8_t value;
+    uint8_t *values; // values of a run of bytes (NULL for a run of zeros)
+    int size; // number of bytes, a run has more than one
+    struct ASTNode *node;
+    BOOL final; // an element to be written to the output file
+    BOOL set_address; // set compiler address at this point
+
+    struct OutputElement *next, *previous;
+};
 
 void init_compiler();
+void free_compiler();
+void get_output_path(char *dst, char *filename);
 int compile(struct ASTNode *first_node);
 void fprint_output(FILE *fp);
 void add_output_element(uint8_t value, struct ASTNode *node);
 void add_output_element_set_address(uint8_t value, struct ASTNode *node);
+void add_linked_output_element(uint8_t value, uint8_t *values, int size, struct ASTNode *node, BOOL final, BOOL set_address);
+int link_output();
 void dump_output(FILE *fp);
 
+// Object files
+
+void start_object_file(BOOL assemble_all);
+void finish_object_file();
+void add_object_section(char *library_name, int library_name_size, char *name, int name_size);
+void add_object_symbol(char *library_name, int library_name_size, char *name, int name_size, BOOL is_label, int64_t value);
+void add_object_generated_label(int label, int address);
+int save_object_file(char *filename);
+int load_object_files(char **filenames, int count);
+
+// Incremental builds
+
+BOOL start_incremental_build();
+void finish_incremental_build(BOOL successful);
+void add_written_file(char *path);
+void for_each_written_file(void (*function)(char *path, void *argument), void *argument);
+
+// Build cache
+
+BOOL restore_cached_build();
+void store_cached_build(BOOL successful);
+
+// Time trace
+
+void start_trace();
+int finish_trace();
+uint64_t start_trace_span();
+void add_trace_span(char *category, char *name, char *detail, int detail_size, uint64_t start);
+
+// Statistics
+
+// Counters of one thread, the counters of every thread are added when they are written
+struct StatsCounters
+{
+    uint64_t nodes_created[NODE_TYPE_COUNT];
+    uint64_t nodes_duplicated[NODE_TYPE_COUNT];
+    uint64_t output_elements;
+    uint64_t output_fixups[NODE_TYPE_COUNT]; // elements with a node to resolve, by its type
+    uint64_t constant_lookups;
+    uint64_t data_symbol_lookups;
+    uint64_t structured_type_lookups;
+    uint64_t inline_symbol_lookups;
+    uint64_t library_symbol_lookups;
+    uint64_t string_compares;
+
+    struct StatsCounters *next;
+};
+
+#define COUNT_STAT(counter) do { if (context != NULL && context->stats != NULL) { get_stats_counters()->counter++; } } while (0)
+
+void start_stats();
+int finish_stats();
+struct StatsCounters *get_stats_counters();
+void fprint_tables_stats(FILE *fp);
+
+// Watch and serve modes
+
+int watch_input(char *input_filename, struct Z80HLAContext *(*create_build_context)(void *argument), void *argument);
+int serve(char *socket_path, BOOL watch, char *input_filename, struct Z80HLAContext *(*create_build_context)(void *argument), void *argument);
+int request_build(char *socket_path);
+BOOL is_warm_cache_used();
+char *read_warm_file(char *filename, BOOL binary, long *size);
+char *get_warm_precompiled(char *filename, uint8_t *key);
+void add_warm_precompiled(char *filename, uint8_t *key, char *block, int size);
+
+// Language server
+
+int serve_language_server(char *input_filename, struct Z80HLAContext *(*create_build_context)(void *argument), void *argument);
+
 // Ops
 
 int compile_op(struct ASTNode *node, BOOL add_to_output, int *length);
@@ -463,4 +745,29 @@ void fprint_op(FILE *fp, struct ASTNode *node);
 
 int resolve_expression(struct ASTNode *node, int64_t *result);
 
+// Threads
+
+struct Thread;
+struct Mutex;
+
+struct Thread *create_thread(int (*function)(void *), void *argument);
+int join_thread(struct Thread *thread);
+struct Mutex *create_mutex();
+void destroy_mutex(struct Mutex *mutex);
+void lock_mutex(struct Mutex *mutex);
+void unlock_mutex(struct Mutex *mutex);
+int get_cpu_count();
+int load_acquire(volatile int *value);
+void store_release(volatile int *value, int new_value);
+void yield_thread();
+void sleep_thread(int milliseconds);
+uint64_t get_time_nanoseconds();
+uint64_t get_peak_memory();
+
+struct WorkerPool;
+
+struct WorkerPool *start_workers(int job_count, int worker_count, int (*job)(void *argument, int index), void *argument);
+int finish_workers(struct WorkerPool *pool);
+int run_workers(int job_count, int thread_count, int (*job)(void *argument, int index), void *argument);
+
 #endif
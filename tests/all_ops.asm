@@ -29,6 +29,10 @@ add a, 255
 add a, a
 add a, h
 add a, c
+db 0xdd, 0x85 ; add a, ixl
+db 0xdd, 0x84 ; add a, ixh
+db 0xfd, 0x85 ; add a, iyl
+db 0xfd, 0x84 ; add a, iyh
 add hl, bc
 add hl, de
 add hl, hl
@@ -154,6 +158,9 @@ ind
 indr
 ini
 inir
+jp (hl)
+jp (ix)
+jp (iy)
 jr $+10
 jr c, $+20
 jr nc, $-5
@@ -435,3 +442,24 @@ xor c
 ; xor ixh
 ; xor iyl
 ; xor iyh
+
+; gb
+db 0x46 ; ld b, (hl)
+db 0xf2 ; ld a, (c)
+db 0xe2 ; ld (c), a
+db 0x22 ; ldi (hl), a
+db 0x2a ; ldi a, (hl)
+db 0x32 ; ldd (hl), a
+db 0x3a ; ldd a, (hl)
+db 0x10, 0x00 ; stop
+db 0xf8, 5 ; ldhl sp, 5
+gb_end:
+jp gb_end
+
+; msx
+db 0xed, 0xc1 ; mulub a, b
+db 0xed, 0xc9 ; mulub a, c
+db 0xed, 0xd1 ; mulub a, d
+db 0xed, 0xd9 ; mulub a, e
+msx_end:
+jp msx_end
@@ -0,0 +1,349 @@
+# Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+# All rights reserved.
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+
+# 1. Redistributions of source code must retain the above copyright notice, this
+# list of conditions and the following disclaimer.
+
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Benchmark of the compiler on a generated project
+#
+# The project is generated from a few parameters (libraries, functions per library,
+# depth of the include tree, inlines, struct table rows, #ifdef regions and binary
+# asset sizes) with a fixed seed, so the same parameters always give the same sources.
+# Each phase is timed with --time-trace over several runs and the medians are compared
+# with a baseline saved before on the same machine (times from another machine mean nothing).
+
+import os
+import sys
+import json
+import time
+import random
+import shutil
+import argparse
+import tempfile
+import subprocess
+
+z80hla_executable = "../bin/z80hla"
+baseline_filename = "bench_baseline.json"
+
+# Phases shown, in order, as named by the spans of --time-trace (the ones not timed are left out)
+phases = ["lex", "parse", "library dependencies", "inline", "lower function", "pass 1", "pass 2", "encode chunk", "resolve segment", "pass 3", "write"]
+
+def writeFile(filePath, lines):
+    with open(filePath, mode='w', newline='\n') as file:
+        file.write("\n".join(lines) + "\n")
+
+def generateIncludes(path, parameters):
+    # A chain of included files, each one declaring constants and inlines used by the libraries,
+    # inside a library of their own so that they can be called from other libraries
+    for level in range(parameters.depth):
+        lines = [f"; include level {level}", "", "library Inlines", "{"]
+        for i in range(parameters.inlines):
+            lines.append(f"    const LEVEL{level}_VALUE{i} = {(level * 31 + i * 7) % 200 + 1}")
+        lines.append("")
+        for i in range(parameters.inlines):
+            lines += [
+                f"    inline level{level}_inline{i}(reg, value)",
+                "    {",
+                "        ld a, reg",
+                f"        add a, 0xff & (value + LEVEL{level}_VALUE{i})",
+                "        ld reg, a",
+            ]
+            if level > 0:
+                lines.append(f"        level{level - 1}_inline{i}(reg, value)")
+            lines += ["    }", ""]
+        lines += ["}", ""]
+        if level + 1 < parameters.depth:
+            lines.append(f"#include \"include_{level + 1}.z80hla\"")
+        writeFile(os.path.join(path, f"include_{level}.z80hla"), lines)
+
+def generateStructs(path, parameters):
+    lines = [
+        "library Types",
+        "{",
+        "    struct Entity",
+        "    {",
+        "        byte type",
+        "        struct {",
+        "            byte x, y",
+        "        } position",
+        "        word speed",
+        "        union {",
+        "            byte flags[2]",
+        "            word mask",
+        "        } state",
+        "        byte name[4]",
+        "    }",
+        "}",
+    ]
+    writeFile(os.path.join(path, "structs.z80hla"), lines)
+
+def generateLibrary(path, index, parameters, rng):
+    name = f"Library{index}"
+    inlineLevel = parameters.depth - 1
+    lines = [f"library {name}", "{"]
+    lines.append(f"    const BASE = {index * 3 + 1}")
+    lines.append("")
+    lines.append(f"    data byte counter = {index % 256}")
+    lines.append("    data word pointer")
+    lines.append(f"    data byte buffer[{16 + index % 16}]")
+    lines.append(f"    data byte asset from \"asset_{index}.bin\"")
+    lines.append("")
+    rows = []
+    for row in range(parameters.rows):
+        rows.append(
+            "{\n"
+            f"        type = {rng.randrange(8)}\n"
+            "        position = {\n"
+            f"            x = {rng.randrange(256)}\n"
+            f"            y = {rng.randrange(192)}\n"
+            "        }\n"
+            f"        speed = {rng.randrange(65536)}\n"
+            "        state = {\n"
+            f"            flags = {rng.randrange(256)}, {rng.randrange(256)}\n"
+            "        }\n"
+            f"        name = {', '.join(str(ord(c)) for c in f'E{row % 1000:03d}')}\n"
+            "    }")
+    lines.append("    data Types::Entity entities = " + ", ".join(rows))
+    lines.append("")
+    for function in range(parameters.functions):
+        inline = function % parameters.inlines
+        feature = function % parameters.ifdefs
+        lines += [
+            f"    function function{function}()",
+            "    {",
+            "        ld hl, counter",
+            "        ld a, (hl)",
+            f"        Inlines::level{inlineLevel}_inline{inline}(b, BASE + {function})",
+            f"        #ifdef FEATURE{feature}",
+            f"        ld de, entities + sizeof(Types::Entity) * {function % parameters.rows}",
+            "        ld (pointer), de",
+            "        #else",
+            f"        ld de, buffer + {function % 16}",
+            "        #endif",
+            "        cp 10",
+            "        if (nc)",
+            "        {",
+            "            ld a, (hl)",
+            "            dec a",
+            "            ld (hl), a",
+            "        }",
+            "        else",
+            "        {",
+            f"            ld bc, {rng.randrange(65536)}",
+            "        }",
+        ]
+        if function > 0:
+            lines.append(f"        function{function - 1}()")
+        elif index > 0:
+            lines.append(f"        Library{index - 1}::function{parameters.functions - 1}()")
+        if function == 0:
+            lines.append("        ld hl, asset")
+        lines += ["    }", ""]
+    lines.append("}")
+    writeFile(os.path.join(path, f"library_{index}.z80hla"), lines)
+    with open(os.path.join(path, f"asset_{index}.bin"), mode='wb') as file:
+        file.write(bytes(rng.randrange(256) for _ in range(parameters.asset_size)))
+
+# Returns the options defining the features, they are not defined with #define in main.z80hla
+# so the included files can be parsed in parallel
+def generateProject(path, parameters):
+    rng = random.Random(parameters.seed)
+    generateIncludes(path, parameters)
+    generateStructs(path, parameters)
+    lines = ["; generated by bench.py", ""]
+    defines = []
+    for feature in range(0, parameters.ifdefs, 2):
+        defines += ["-d", f"FEATURE{feature}"]
+    lines += ["#include \"include_0.z80hla\"", "#include \"structs.z80hla\"", ""]
+    for index in range(parameters.libraries):
+        generateLibrary(path, index, parameters, rng)
+        lines += [
+            "#origin 0x0000",
+            f"#output_file \"bank_{index}.bin\"",
+            f"#include \"library_{index}.z80hla\"",
+            f"Library{index}::function{parameters.functions - 1}()",
+            "",
+        ]
+    writeFile(os.path.join(path, "main.z80hla"), lines)
+    return defines
+
+def countSources(path):
+    lines = 0
+    size = 0
+    for name in os.listdir(path):
+        filePath = os.path.join(path, name)
+        size += os.path.getsize(filePath)
+        if name.endswith(".z80hla"):
+            with open(filePath, mode='rb') as file:
+                lines += file.read().count(b"\n")
+    return lines, size
+
+def getPhaseTimes(trace):
+    # Time of each phase summed over the threads, spans of the same phase nested in the
+    # same thread (included files, inlines inside inlines) are only counted once
+    spans = {}
+    for event in trace["traceEvents"]:
+        if event["ph"] == "X":
+            spans.setdefault((event["name"], event["tid"]), []).append((event["ts"], event["ts"] + event["dur"]))
+    times = {}
+    for (name, thread), intervals in spans.items():
+        intervals.sort()
+        duration = 0.0
+        end = None
+        for intervalStart, intervalEnd in intervals:
+            if end is None or intervalStart > end:
+                duration += intervalEnd - intervalStart
+                end = intervalEnd
+            elif intervalEnd > end:
+                duration += intervalEnd - end
+                end = intervalEnd
+        times[name] = times.get(name, 0.0) + duration / 1000000.0
+    return times
+
+def runCompiler(path, outputPath, threads, options):
+    # The output files are written to the working directory, the included files are relative to main.z80hla
+    tracePath = os.path.join(outputPath, "trace.json")
+    command = [os.path.abspath(z80hla_executable), "-o", "main.bin", "-t", str(threads), "--time-trace", tracePath] + options + [os.path.join(path, "main.z80hla")]
+    start = time.perf_counter()
+    result = subprocess.run(command, cwd=outputPath, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    total = time.perf_counter() - start
+    output = result.stdout.decode(errors="replace")
+    if result.returncode != 0 or "[ERROR]" in output or not os.path.exists(tracePath):
+        print(output)
+        return None
+    with open(tracePath) as file:
+        times = getPhaseTimes(json.load(file))
+    times["total"] = total
+    outputSize = 0
+    for name in os.listdir(outputPath):
+        if name.endswith(".bin"):
+            outputSize += os.path.getsize(os.path.join(outputPath, name))
+    return times, outputSize
+
+def median(values):
+    values = sorted(values)
+    middle = len(values) // 2
+    if len(values) % 2:
+        return values[middle]
+    return (values[middle - 1] + values[middle]) / 2
+
+def formatRate(value, unit):
+    for prefix in ["", "K", "M", "G"]:
+        if value < 1000:
+            break
+        value /= 1000
+    return f"{value:10.3f} {prefix}{unit}/s"
+
+def formatComparison(value, baselineValue, higherIsBetter):
+    if not baselineValue or not value:
+        return ""
+    ratio = value / baselineValue if higherIsBetter else baselineValue / value
+    if ratio >= 1:
+        return f"{(ratio - 1) * 100:6.1f}% faster"
+    return f"{(1 / ratio - 1) * 100:6.1f}% slower"
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark of z80hla on a generated project")
+    parser.add_argument("--libraries", type=int, default=16, help="number of libraries, each one in its own output file")
+    parser.add_argument("--functions", type=int, default=48, help="number of functions per library")
+    parser.add_argument("--depth", type=int, default=8, help="depth of the include tree")
+    parser.add_argument("--inlines", type=int, default=8, help="number of inlines per include level, each one expanding the one of the level before")
+    parser.add_argument("--rows", type=int, default=64, help="number of rows of the struct data table of each library")
+    parser.add_argument("--ifdefs", type=int, default=16, help="number of different #ifdef identifiers, half of them defined")
+    parser.add_argument("--asset-size", type=int, default=4096, help="size in bytes of the binary asset of each library")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the generated values")
+    parser.add_argument("--runs", type=int, default=5, help="number of runs, the median is reported")
+    parser.add_argument("--threads", type=int, default=1, help="number of threads used by the compiler (-t)")
+    parser.add_argument("--options", default="", help="additional options for the compiler, given as --options=\"...\"")
+    parser.add_argument("--baseline", default=baseline_filename, help="file with the baseline results, saved on this machine")
+    parser.add_argument("--save-baseline", action="store_true", help="save the results as the new baseline, to compare the next runs on this machine with")
+    parser.add_argument("--keep", metavar="DIRECTORY", help="generate the project into DIRECTORY and keep it")
+    parameters = parser.parse_args()
+
+    if not os.path.exists(z80hla_executable):
+        print(f"Executable not found: {z80hla_executable}")
+        return 1
+
+    path = parameters.keep if parameters.keep else tempfile.mkdtemp(prefix="z80hla_bench_")
+    outputPath = tempfile.mkdtemp(prefix="z80hla_bench_output_")
+    try:
+        os.makedirs(path, exist_ok=True)
+        defines = generateProject(path, parameters)
+        lines, size = countSources(path)
+
+        results = []
+        for run in range(parameters.runs):
+            result = runCompiler(path, outputPath, parameters.threads, defines + parameters.options.split())
+            if result is None:
+                print("Compilation failed")
+                return 1
+            results.append(result)
+        outputSize = results[0][1]
+        times = {}
+        for name in ["total"] + phases:
+            times[name] = median([result[0].get(name, 0.0) for result in results])
+
+        key = " ".join(f"{name}={getattr(parameters, name)}" for name in ["libraries", "functions", "depth", "inlines", "rows", "ifdefs", "asset_size", "seed", "threads", "options"])
+        current = {
+            "lines_per_second": lines / times["total"],
+            "bytes_per_second": size / times["total"],
+            "output_bytes_per_second": outputSize / times["total"],
+            "phases": times,
+        }
+
+        baselines = {}
+        if os.path.exists(parameters.baseline):
+            with open(parameters.baseline) as file:
+                baselines = json.load(file)
+        baseline = baselines.get(key)
+
+        print("Z80HLA Benchmark\n")
+        print(f"Project:\t{key}")
+        print(f"Sources:\t{lines} lines, {size} bytes (with binary assets)")
+        print(f"Output:\t\t{outputSize} bytes")
+        print(f"Runs:\t\t{parameters.runs} (median)")
+        if baseline is None:
+            print("Baseline:\tnone for these parameters")
+        print("")
+        for name, title, unit in [("lines_per_second", "source lines", "lines"), ("bytes_per_second", "source bytes", "B"), ("output_bytes_per_second", "output bytes", "B")]:
+            print(f"{title:24}{formatRate(current[name], unit):<20}" +
+                (formatComparison(current[name], baseline[name], True) if baseline else ""))
+        print("")
+        for name in ["total"] + phases:
+            if not times[name] and not (baseline and baseline["phases"].get(name)):
+                continue
+            print(f"{name:24}{times[name] * 1000:10.3f} ms{'':7}" +
+                (formatComparison(times[name], baseline["phases"].get(name, 0.0), False) if baseline else ""))
+
+        if parameters.save_baseline:
+            baselines[key] = current
+            with open(parameters.baseline, mode='w', newline='\n') as file:
+                json.dump(baselines, file, indent=4, sort_keys=True)
+                file.write("\n")
+            print(f"\nBaseline saved to {parameters.baseline}")
+        return 0
+    finally:
+        shutil.rmtree(outputPath, ignore_errors=True)
+        if not parameters.keep:
+            shutil.rmtree(path, ignore_errors=True)
+
+if __name__ == "__main__":
+    sys.exit(main())
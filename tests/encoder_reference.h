@@ -0,0 +1,954 @@
+// Generated by encoder_reference.py, reference encodings of every instruction form
+// for CPU_TYPE_Z80, CPU_TYPE_GB and CPU_TYPE_MSX (a length of -1 when it does not have it)
+
+static struct ReferenceOp reference_ops[] = {
+    { "ld b, b", { { 1, { 0x40 } }, { 1, { 0x40 } }, { 1, { 0x40 } } } },
+    { "ld b, c", { { 1, { 0x41 } }, { 1, { 0x41 } }, { 1, { 0x41 } } } },
+    { "ld b, d", { { 1, { 0x42 } }, { 1, { 0x42 } }, { 1, { 0x42 } } } },
+    { "ld b, e", { { 1, { 0x43 } }, { 1, { 0x43 } }, { 1, { 0x43 } } } },
+    { "ld b, h", { { 1, { 0x44 } }, { 1, { 0x44 } }, { 1, { 0x44 } } } },
+    { "ld b, l", { { 1, { 0x45 } }, { 1, { 0x45 } }, { 1, { 0x45 } } } },
+    { "ld b, (hl)", { { 1, { 0x46 } }, { 1, { 0x46 } }, { 1, { 0x46 } } } },
+    { "ld b, a", { { 1, { 0x47 } }, { 1, { 0x47 } }, { 1, { 0x47 } } } },
+    { "ld b, 18", { { 2, { 0x06, 0x12 } }, { 2, { 0x06, 0x12 } }, { 2, { 0x06, 0x12 } } } },
+    { "ld c, b", { { 1, { 0x48 } }, { 1, { 0x48 } }, { 1, { 0x48 } } } },
+    { "ld c, c", { { 1, { 0x49 } }, { 1, { 0x49 } }, { 1, { 0x49 } } } },
+    { "ld c, d", { { 1, { 0x4A } }, { 1, { 0x4A } }, { 1, { 0x4A } } } },
+    { "ld c, e", { { 1, { 0x4B } }, { 1, { 0x4B } }, { 1, { 0x4B } } } },
+    { "ld c, h", { { 1, { 0x4C } }, { 1, { 0x4C } }, { 1, { 0x4C } } } },
+    { "ld c, l", { { 1, { 0x4D } }, { 1, { 0x4D } }, { 1, { 0x4D } } } },
+    { "ld c, (hl)", { { 1, { 0x4E } }, { 1, { 0x4E } }, { 1, { 0x4E } } } },
+    { "ld c, a", { { 1, { 0x4F } }, { 1, { 0x4F } }, { 1, { 0x4F } } } },
+    { "ld c, 18", { { 2, { 0x0E, 0x12 } }, { 2, { 0x0E, 0x12 } }, { 2, { 0x0E, 0x12 } } } },
+    { "ld d, b", { { 1, { 0x50 } }, { 1, { 0x50 } }, { 1, { 0x50 } } } },
+    { "ld d, c", { { 1, { 0x51 } }, { 1, { 0x51 } }, { 1, { 0x51 } } } },
+    { "ld d, d", { { 1, { 0x52 } }, { 1, { 0x52 } }, { 1, { 0x52 } } } },
+    { "ld d, e", { { 1, { 0x53 } }, { 1, { 0x53 } }, { 1, { 0x53 } } } },
+    { "ld d, h", { { 1, { 0x54 } }, { 1, { 0x54 } }, { 1, { 0x54 } } } },
+    { "ld d, l", { { 1, { 0x55 } }, { 1, { 0x55 } }, { 1, { 0x55 } } } },
+    { "ld d, (hl)", { { 1, { 0x56 } }, { 1, { 0x56 } }, { 1, { 0x56 } } } },
+    { "ld d, a", { { 1, { 0x57 } }, { 1, { 0x57 } }, { 1, { 0x57 } } } },
+    { "ld d, 18", { { 2, { 0x16, 0x12 } }, { 2, { 0x16, 0x12 } }, { 2, { 0x16, 0x12 } } } },
+    { "ld e, b", { { 1, { 0x58 } }, { 1, { 0x58 } }, { 1, { 0x58 } } } },
+    { "ld e, c", { { 1, { 0x59 } }, { 1, { 0x59 } }, { 1, { 0x59 } } } },
+    { "ld e, d", { { 1, { 0x5A } }, { 1, { 0x5A } }, { 1, { 0x5A } } } },
+    { "ld e, e", { { 1, { 0x5B } }, { 1, { 0x5B } }, { 1, { 0x5B } } } },
+    { "ld e, h", { { 1, { 0x5C } }, { 1, { 0x5C } }, { 1, { 0x5C } } } },
+    { "ld e, l", { { 1, { 0x5D } }, { 1, { 0x5D } }, { 1, { 0x5D } } } },
+    { "ld e, (hl)", { { 1, { 0x5E } }, { 1, { 0x5E } }, { 1, { 0x5E } } } },
+    { "ld e, a", { { 1, { 0x5F } }, { 1, { 0x5F } }, { 1, { 0x5F } } } },
+    { "ld e, 18", { { 2, { 0x1E, 0x12 } }, { 2, { 0x1E, 0x12 } }, { 2, { 0x1E, 0x12 } } } },
+    { "ld h, b", { { 1, { 0x60 } }, { 1, { 0x60 } }, { 1, { 0x60 } } } },
+    { "ld h, c", { { 1, { 0x61 } }, { 1, { 0x61 } }, { 1, { 0x61 } } } },
+    { "ld h, d", { { 1, { 0x62 } }, { 1, { 0x62 } }, { 1, { 0x62 } } } },
+    { "ld h, e", { { 1, { 0x63 } }, { 1, { 0x63 } }, { 1, { 0x63 } } } },
+    { "ld h, h", { { 1, { 0x64 } }, { 1, { 0x64 } }, { 1, { 0x64 } } } },
+    { "ld h, l", { { 1, { 0x65 } }, { 1, { 0x65 } }, { 1, { 0x65 } } } },
+    { "ld h, (hl)", { { 1, { 0x66 } }, { 1, { 0x66 } }, { 1, { 0x66 } } } },
+    { "ld h, a", { { 1, { 0x67 } }, { 1, { 0x67 } }, { 1, { 0x67 } } } },
+    { "ld h, 18", { { 2, { 0x26, 0x12 } }, { 2, { 0x26, 0x12 } }, { 2, { 0x26, 0x12 } } } },
+    { "ld l, b", { { 1, { 0x68 } }, { 1, { 0x68 } }, { 1, { 0x68 } } } },
+    { "ld l, c", { { 1, { 0x69 } }, { 1, { 0x69 } }, { 1, { 0x69 } } } },
+    { "ld l, d", { { 1, { 0x6A } }, { 1, { 0x6A } }, { 1, { 0x6A } } } },
+    { "ld l, e", { { 1, { 0x6B } }, { 1, { 0x6B } }, { 1, { 0x6B } } } },
+    { "ld l, h", { { 1, { 0x6C } }, { 1, { 0x6C } }, { 1, { 0x6C } } } },
+    { "ld l, l", { { 1, { 0x6D } }, { 1, { 0x6D } }, { 1, { 0x6D } } } },
+    { "ld l, (hl)", { { 1, { 0x6E } }, { 1, { 0x6E } }, { 1, { 0x6E } } } },
+    { "ld l, a", { { 1, { 0x6F } }, { 1, { 0x6F } }, { 1, { 0x6F } } } },
+    { "ld l, 18", { { 2, { 0x2E, 0x12 } }, { 2, { 0x2E, 0x12 } }, { 2, { 0x2E, 0x12 } } } },
+    { "ld (hl), b", { { 1, { 0x70 } }, { 1, { 0x70 } }, { 1, { 0x70 } } } },
+    { "ld (hl), c", { { 1, { 0x71 } }, { 1, { 0x71 } }, { 1, { 0x71 } } } },
+    { "ld (hl), d", { { 1, { 0x72 } }, { 1, { 0x72 } }, { 1, { 0x72 } } } },
+    { "ld (hl), e", { { 1, { 0x73 } }, { 1, { 0x73 } }, { 1, { 0x73 } } } },
+    { "ld (hl), h", { { 1, { 0x74 } }, { 1, { 0x74 } }, { 1, { 0x74 } } } },
+    { "ld (hl), l", { { 1, { 0x75 } }, { 1, { 0x75 } }, { 1, { 0x75 } } } },
+    { "ld (hl), a", { { 1, { 0x77 } }, { 1, { 0x77 } }, { 1, { 0x77 } } } },
+    { "ld (hl), 18", { { 2, { 0x36, 0x12 } }, { 2, { 0x36, 0x12 } }, { 2, { 0x36, 0x12 } } } },
+    { "ld a, b", { { 1, { 0x78 } }, { 1, { 0x78 } }, { 1, { 0x78 } } } },
+    { "ld a, c", { { 1, { 0x79 } }, { 1, { 0x79 } }, { 1, { 0x79 } } } },
+    { "ld a, d", { { 1, { 0x7A } }, { 1, { 0x7A } }, { 1, { 0x7A } } } },
+    { "ld a, e", { { 1, { 0x7B } }, { 1, { 0x7B } }, { 1, { 0x7B } } } },
+    { "ld a, h", { { 1, { 0x7C } }, { 1, { 0x7C } }, { 1, { 0x7C } } } },
+    { "ld a, l", { { 1, { 0x7D } }, { 1, { 0x7D } }, { 1, { 0x7D } } } },
+    { "ld a, (hl)", { { 1, { 0x7E } }, { 1, { 0x7E } }, { 1, { 0x7E } } } },
+    { "ld a, a", { { 1, { 0x7F } }, { 1, { 0x7F } }, { 1, { 0x7F } } } },
+    { "ld a, 18", { { 2, { 0x3E, 0x12 } }, { 2, { 0x3E, 0x12 } }, { 2, { 0x3E, 0x12 } } } },
+    { "ld b, (ix+5)", { { 3, { 0xDD, 0x46, 0x05 } }, { -1 }, { 3, { 0xDD, 0x46, 0x05 } } } },
+    { "ld (ix+5), b", { { 3, { 0xDD, 0x70, 0x05 } }, { -1 }, { 3, { 0xDD, 0x70, 0x05 } } } },
+    { "ld c, (ix+5)", { { 3, { 0xDD, 0x4E, 0x05 } }, { -1 }, { 3, { 0xDD, 0x4E, 0x05 } } } },
+    { "ld (ix+5), c", { { 3, { 0xDD, 0x71, 0x05 } }, { -1 }, { 3, { 0xDD, 0x71, 0x05 } } } },
+    { "ld d, (ix+5)", { { 3, { 0xDD, 0x56, 0x05 } }, { -1 }, { 3, { 0xDD, 0x56, 0x05 } } } },
+    { "ld (ix+5), d", { { 3, { 0xDD, 0x72, 0x05 } }, { -1 }, { 3, { 0xDD, 0x72, 0x05 } } } },
+    { "ld e, (ix+5)", { { 3, { 0xDD, 0x5E, 0x05 } }, { -1 }, { 3, { 0xDD, 0x5E, 0x05 } } } },
+    { "ld (ix+5), e", { { 3, { 0xDD, 0x73, 0x05 } }, { -1 }, { 3, { 0xDD, 0x73, 0x05 } } } },
+    { "ld h, (ix+5)", { { 3, { 0xDD, 0x66, 0x05 } }, { -1 }, { 3, { 0xDD, 0x66, 0x05 } } } },
+    { "ld (ix+5), h", { { 3, { 0xDD, 0x74, 0x05 } }, { -1 }, { 3, { 0xDD, 0x74, 0x05 } } } },
+    { "ld l, (ix+5)", { { 3, { 0xDD, 0x6E, 0x05 } }, { -1 }, { 3, { 0xDD, 0x6E, 0x05 } } } },
+    { "ld (ix+5), l", { { 3, { 0xDD, 0x75, 0x05 } }, { -1 }, { 3, { 0xDD, 0x75, 0x05 } } } },
+    { "ld a, (ix+5)", { { 3, { 0xDD, 0x7E, 0x05 } }, { -1 }, { 3, { 0xDD, 0x7E, 0x05 } } } },
+    { "ld (ix+5), a", { { 3, { 0xDD, 0x77, 0x05 } }, { -1 }, { 3, { 0xDD, 0x77, 0x05 } } } },
+    { "ld (ix+5), 18", { { 4, { 0xDD, 0x36, 0x05, 0x12 } }, { -1 }, { 4, { 0xDD, 0x36, 0x05, 0x12 } } } },
+    { "ld b, (ix-3)", { { 3, { 0xDD, 0x46, 0xFD } }, { -1 }, { 3, { 0xDD, 0x46, 0xFD } } } },
+    { "ld (ix-3), b", { { 3, { 0xDD, 0x70, 0xFD } }, { -1 }, { 3, { 0xDD, 0x70, 0xFD } } } },
+    { "ld c, (ix-3)", { { 3, { 0xDD, 0x4E, 0xFD } }, { -1 }, { 3, { 0xDD, 0x4E, 0xFD } } } },
+    { "ld (ix-3), c", { { 3, { 0xDD, 0x71, 0xFD } }, { -1 }, { 3, { 0xDD, 0x71, 0xFD } } } },
+    { "ld d, (ix-3)", { { 3, { 0xDD, 0x56, 0xFD } }, { -1 }, { 3, { 0xDD, 0x56, 0xFD } } } },
+    { "ld (ix-3), d", { { 3, { 0xDD, 0x72, 0xFD } }, { -1 }, { 3, { 0xDD, 0x72, 0xFD } } } },
+    { "ld e, (ix-3)", { { 3, { 0xDD, 0x5E, 0xFD } }, { -1 }, { 3, { 0xDD, 0x5E, 0xFD } } } },
+    { "ld (ix-3), e", { { 3, { 0xDD, 0x73, 0xFD } }, { -1 }, { 3, { 0xDD, 0x73, 0xFD } } } },
+    { "ld h, (ix-3)", { { 3, { 0xDD, 0x66, 0xFD } }, { -1 }, { 3, { 0xDD, 0x66, 0xFD } } } },
+    { "ld (ix-3), h", { { 3, { 0xDD, 0x74, 0xFD } }, { -1 }, { 3, { 0xDD, 0x74, 0xFD } } } },
+    { "ld l, (ix-3)", { { 3, { 0xDD, 0x6E, 0xFD } }, { -1 }, { 3, { 0xDD, 0x6E, 0xFD } } } },
+    { "ld (ix-3), l", { { 3, { 0xDD, 0x75, 0xFD } }, { -1 }, { 3, { 0xDD, 0x75, 0xFD } } } },
+    { "ld a, (ix-3)", { { 3, { 0xDD, 0x7E, 0xFD } }, { -1 }, { 3, { 0xDD, 0x7E, 0xFD } } } },
+    { "ld (ix-3), a", { { 3, { 0xDD, 0x77, 0xFD } }, { -1 }, { 3, { 0xDD, 0x77, 0xFD } } } },
+    { "ld (ix-3), 18", { { 4, { 0xDD, 0x36, 0xFD, 0x12 } }, { -1 }, { 4, { 0xDD, 0x36, 0xFD, 0x12 } } } },
+    { "ld b, ixh", { { 2, { 0xDD, 0x44 } }, { -1 }, { 2, { 0xDD, 0x44 } } } },
+    { "ld b, ixl", { { 2, { 0xDD, 0x45 } }, { -1 }, { 2, { 0xDD, 0x45 } } } },
+    { "ld c, ixh", { { 2, { 0xDD, 0x4C } }, { -1 }, { 2, { 0xDD, 0x4C } } } },
+    { "ld c, ixl", { { 2, { 0xDD, 0x4D } }, { -1 }, { 2, { 0xDD, 0x4D } } } },
+    { "ld d, ixh", { { 2, { 0xDD, 0x54 } }, { -1 }, { 2, { 0xDD, 0x54 } } } },
+    { "ld d, ixl", { { 2, { 0xDD, 0x55 } }, { -1 }, { 2, { 0xDD, 0x55 } } } },
+    { "ld e, ixh", { { 2, { 0xDD, 0x5C } }, { -1 }, { 2, { 0xDD, 0x5C } } } },
+    { "ld e, ixl", { { 2, { 0xDD, 0x5D } }, { -1 }, { 2, { 0xDD, 0x5D } } } },
+    { "ld ixh, b", { { 2, { 0xDD, 0x60 } }, { -1 }, { 2, { 0xDD, 0x60 } } } },
+    { "ld ixh, c", { { 2, { 0xDD, 0x61 } }, { -1 }, { 2, { 0xDD, 0x61 } } } },
+    { "ld ixh, d", { { 2, { 0xDD, 0x62 } }, { -1 }, { 2, { 0xDD, 0x62 } } } },
+    { "ld ixh, e", { { 2, { 0xDD, 0x63 } }, { -1 }, { 2, { 0xDD, 0x63 } } } },
+    { "ld ixh, ixh", { { 2, { 0xDD, 0x64 } }, { -1 }, { 2, { 0xDD, 0x64 } } } },
+    { "ld ixh, ixl", { { 2, { 0xDD, 0x65 } }, { -1 }, { 2, { 0xDD, 0x65 } } } },
+    { "ld ixh, a", { { 2, { 0xDD, 0x67 } }, { -1 }, { 2, { 0xDD, 0x67 } } } },
+    { "ld ixh, 18", { { 3, { 0xDD, 0x26, 0x12 } }, { -1 }, { 3, { 0xDD, 0x26, 0x12 } } } },
+    { "ld ixl, b", { { 2, { 0xDD, 0x68 } }, { -1 }, { 2, { 0xDD, 0x68 } } } },
+    { "ld ixl, c", { { 2, { 0xDD, 0x69 } }, { -1 }, { 2, { 0xDD, 0x69 } } } },
+    { "ld ixl, d", { { 2, { 0xDD, 0x6A } }, { -1 }, { 2, { 0xDD, 0x6A } } } },
+    { "ld ixl, e", { { 2, { 0xDD, 0x6B } }, { -1 }, { 2, { 0xDD, 0x6B } } } },
+    { "ld ixl, ixh", { { 2, { 0xDD, 0x6C } }, { -1 }, { 2, { 0xDD, 0x6C } } } },
+    { "ld ixl, ixl", { { 2, { 0xDD, 0x6D } }, { -1 }, { 2, { 0xDD, 0x6D } } } },
+    { "ld ixl, a", { { 2, { 0xDD, 0x6F } }, { -1 }, { 2, { 0xDD, 0x6F } } } },
+    { "ld ixl, 18", { { 3, { 0xDD, 0x2E, 0x12 } }, { -1 }, { 3, { 0xDD, 0x2E, 0x12 } } } },
+    { "ld a, ixh", { { 2, { 0xDD, 0x7C } }, { -1 }, { 2, { 0xDD, 0x7C } } } },
+    { "ld a, ixl", { { 2, { 0xDD, 0x7D } }, { -1 }, { 2, { 0xDD, 0x7D } } } },
+    { "ld b, (iy+5)", { { 3, { 0xFD, 0x46, 0x05 } }, { -1 }, { 3, { 0xFD, 0x46, 0x05 } } } },
+    { "ld (iy+5), b", { { 3, { 0xFD, 0x70, 0x05 } }, { -1 }, { 3, { 0xFD, 0x70, 0x05 } } } },
+    { "ld c, (iy+5)", { { 3, { 0xFD, 0x4E, 0x05 } }, { -1 }, { 3, { 0xFD, 0x4E, 0x05 } } } },
+    { "ld (iy+5), c", { { 3, { 0xFD, 0x71, 0x05 } }, { -1 }, { 3, { 0xFD, 0x71, 0x05 } } } },
+    { "ld d, (iy+5)", { { 3, { 0xFD, 0x56, 0x05 } }, { -1 }, { 3, { 0xFD, 0x56, 0x05 } } } },
+    { "ld (iy+5), d", { { 3, { 0xFD, 0x72, 0x05 } }, { -1 }, { 3, { 0xFD, 0x72, 0x05 } } } },
+    { "ld e, (iy+5)", { { 3, { 0xFD, 0x5E, 0x05 } }, { -1 }, { 3, { 0xFD, 0x5E, 0x05 } } } },
+    { "ld (iy+5), e", { { 3, { 0xFD, 0x73, 0x05 } }, { -1 }, { 3, { 0xFD, 0x73, 0x05 } } } },
+    { "ld h, (iy+5)", { { 3, { 0xFD, 0x66, 0x05 } }, { -1 }, { 3, { 0xFD, 0x66, 0x05 } } } },
+    { "ld (iy+5), h", { { 3, { 0xFD, 0x74, 0x05 } }, { -1 }, { 3, { 0xFD, 0x74, 0x05 } } } },
+    { "ld l, (iy+5)", { { 3, { 0xFD, 0x6E, 0x05 } }, { -1 }, { 3, { 0xFD, 0x6E, 0x05 } } } },
+    { "ld (iy+5), l", { { 3, { 0xFD, 0x75, 0x05 } }, { -1 }, { 3, { 0xFD, 0x75, 0x05 } } } },
+    { "ld a, (iy+5)", { { 3, { 0xFD, 0x7E, 0x05 } }, { -1 }, { 3, { 0xFD, 0x7E, 0x05 } } } },
+    { "ld (iy+5), a", { { 3, { 0xFD, 0x77, 0x05 } }, { -1 }, { 3, { 0xFD, 0x77, 0x05 } } } },
+    { "ld (iy+5), 18", { { 4, { 0xFD, 0x36, 0x05, 0x12 } }, { -1 }, { 4, { 0xFD, 0x36, 0x05, 0x12 } } } },
+    { "ld b, (iy-3)", { { 3, { 0xFD, 0x46, 0xFD } }, { -1 }, { 3, { 0xFD, 0x46, 0xFD } } } },
+    { "ld (iy-3), b", { { 3, { 0xFD, 0x70, 0xFD } }, { -1 }, { 3, { 0xFD, 0x70, 0xFD } } } },
+    { "ld c, (iy-3)", { { 3, { 0xFD, 0x4E, 0xFD } }, { -1 }, { 3, { 0xFD, 0x4E, 0xFD } } } },
+    { "ld (iy-3), c", { { 3, { 0xFD, 0x71, 0xFD } }, { -1 }, { 3, { 0xFD, 0x71, 0xFD } } } },
+    { "ld d, (iy-3)", { { 3, { 0xFD, 0x56, 0xFD } }, { -1 }, { 3, { 0xFD, 0x56, 0xFD } } } },
+    { "ld (iy-3), d", { { 3, { 0xFD, 0x72, 0xFD } }, { -1 }, { 3, { 0xFD, 0x72, 0xFD } } } },
+    { "ld e, (iy-3)", { { 3, { 0xFD, 0x5E, 0xFD } }, { -1 }, { 3, { 0xFD, 0x5E, 0xFD } } } },
+    { "ld (iy-3), e", { { 3, { 0xFD, 0x73, 0xFD } }, { -1 }, { 3, { 0xFD, 0x73, 0xFD } } } },
+    { "ld h, (iy-3)", { { 3, { 0xFD, 0x66, 0xFD } }, { -1 }, { 3, { 0xFD, 0x66, 0xFD } } } },
+    { "ld (iy-3), h", { { 3, { 0xFD, 0x74, 0xFD } }, { -1 }, { 3, { 0xFD, 0x74, 0xFD } } } },
+    { "ld l, (iy-3)", { { 3, { 0xFD, 0x6E, 0xFD } }, { -1 }, { 3, { 0xFD, 0x6E, 0xFD } } } },
+    { "ld (iy-3), l", { { 3, { 0xFD, 0x75, 0xFD } }, { -1 }, { 3, { 0xFD, 0x75, 0xFD } } } },
+    { "ld a, (iy-3)", { { 3, { 0xFD, 0x7E, 0xFD } }, { -1 }, { 3, { 0xFD, 0x7E, 0xFD } } } },
+    { "ld (iy-3), a", { { 3, { 0xFD, 0x77, 0xFD } }, { -1 }, { 3, { 0xFD, 0x77, 0xFD } } } },
+    { "ld (iy-3), 18", { { 4, { 0xFD, 0x36, 0xFD, 0x12 } }, { -1 }, { 4, { 0xFD, 0x36, 0xFD, 0x12 } } } },
+    { "ld b, iyh", { { 2, { 0xFD, 0x44 } }, { -1 }, { 2, { 0xFD, 0x44 } } } },
+    { "ld b, iyl", { { 2, { 0xFD, 0x45 } }, { -1 }, { 2, { 0xFD, 0x45 } } } },
+    { "ld c, iyh", { { 2, { 0xFD, 0x4C } }, { -1 }, { 2, { 0xFD, 0x4C } } } },
+    { "ld c, iyl", { { 2, { 0xFD, 0x4D } }, { -1 }, { 2, { 0xFD, 0x4D } } } },
+    { "ld d, iyh", { { 2, { 0xFD, 0x54 } }, { -1 }, { 2, { 0xFD, 0x54 } } } },
+    { "ld d, iyl", { { 2, { 0xFD, 0x55 } }, { -1 }, { 2, { 0xFD, 0x55 } } } },
+    { "ld e, iyh", { { 2, { 0xFD, 0x5C } }, { -1 }, { 2, { 0xFD, 0x5C } } } },
+    { "ld e, iyl", { { 2, { 0xFD, 0x5D } }, { -1 }, { 2, { 0xFD, 0x5D } } } },
+    { "ld iyh, b", { { 2, { 0xFD, 0x60 } }, { -1 }, { 2, { 0xFD, 0x60 } } } },
+    { "ld iyh, c", { { 2, { 0xFD, 0x61 } }, { -1 }, { 2, { 0xFD, 0x61 } } } },
+    { "ld iyh, d", { { 2, { 0xFD, 0x62 } }, { -1 }, { 2, { 0xFD, 0x62 } } } },
+    { "ld iyh, e", { { 2, { 0xFD, 0x63 } }, { -1 }, { 2, { 0xFD, 0x63 } } } },
+    { "ld iyh, iyh", { { 2, { 0xFD, 0x64 } }, { -1 }, { 2, { 0xFD, 0x64 } } } },
+    { "ld iyh, iyl", { { 2, { 0xFD, 0x65 } }, { -1 }, { 2, { 0xFD, 0x65 } } } },
+    { "ld iyh, a", { { 2, { 0xFD, 0x67 } }, { -1 }, { 2, { 0xFD, 0x67 } } } },
+    { "ld iyh, 18", { { 3, { 0xFD, 0x26, 0x12 } }, { -1 }, { 3, { 0xFD, 0x26, 0x12 } } } },
+    { "ld iyl, b", { { 2, { 0xFD, 0x68 } }, { -1 }, { 2, { 0xFD, 0x68 } } } },
+    { "ld iyl, c", { { 2, { 0xFD, 0x69 } }, { -1 }, { 2, { 0xFD, 0x69 } } } },
+    { "ld iyl, d", { { 2, { 0xFD, 0x6A } }, { -1 }, { 2, { 0xFD, 0x6A } } } },
+    { "ld iyl, e", { { 2, { 0xFD, 0x6B } }, { -1 }, { 2, { 0xFD, 0x6B } } } },
+    { "ld iyl, iyh", { { 2, { 0xFD, 0x6C } }, { -1 }, { 2, { 0xFD, 0x6C } } } },
+    { "ld iyl, iyl", { { 2, { 0xFD, 0x6D } }, { -1 }, { 2, { 0xFD, 0x6D } } } },
+    { "ld iyl, a", { { 2, { 0xFD, 0x6F } }, { -1 }, { 2, { 0xFD, 0x6F } } } },
+    { "ld iyl, 18", { { 3, { 0xFD, 0x2E, 0x12 } }, { -1 }, { 3, { 0xFD, 0x2E, 0x12 } } } },
+    { "ld a, iyh", { { 2, { 0xFD, 0x7C } }, { -1 }, { 2, { 0xFD, 0x7C } } } },
+    { "ld a, iyl", { { 2, { 0xFD, 0x7D } }, { -1 }, { 2, { 0xFD, 0x7D } } } },
+    { "ld a, (bc)", { { 1, { 0x0A } }, { 1, { 0x0A } }, { 1, { 0x0A } } } },
+    { "ld a, (de)", { { 1, { 0x1A } }, { 1, { 0x1A } }, { 1, { 0x1A } } } },
+    { "ld (bc), a", { { 1, { 0x02 } }, { 1, { 0x02 } }, { 1, { 0x02 } } } },
+    { "ld (de), a", { { 1, { 0x12 } }, { 1, { 0x12 } }, { 1, { 0x12 } } } },
+    { "ld a, (4660)", { { 3, { 0x3A, 0x34, 0x12 } }, { 3, { 0xFA, 0x34, 0x12 } }, { 3, { 0x3A, 0x34, 0x12 } } } },
+    { "ld (4660), a", { { 3, { 0x32, 0x34, 0x12 } }, { 3, { 0xEA, 0x34, 0x12 } }, { 3, { 0x32, 0x34, 0x12 } } } },
+    { "ld a, i", { { 2, { 0xED, 0x57 } }, { -1 }, { 2, { 0xED, 0x57 } } } },
+    { "ld a, r", { { 2, { 0xED, 0x5F } }, { -1 }, { 2, { 0xED, 0x5F } } } },
+    { "ld i, a", { { 2, { 0xED, 0x47 } }, { -1 }, { 2, { 0xED, 0x47 } } } },
+    { "ld r, a", { { 2, { 0xED, 0x4F } }, { -1 }, { 2, { 0xED, 0x4F } } } },
+    { "ld a, (c)", { { -1 }, { 1, { 0xF2 } }, { -1 } } },
+    { "ld (c), a", { { -1 }, { 1, { 0xE2 } }, { -1 } } },
+    { "ld bc, 4660", { { 3, { 0x01, 0x34, 0x12 } }, { 3, { 0x01, 0x34, 0x12 } }, { 3, { 0x01, 0x34, 0x12 } } } },
+    { "ld bc, (4660)", { { 4, { 0xED, 0x4B, 0x34, 0x12 } }, { -1 }, { 4, { 0xED, 0x4B, 0x34, 0x12 } } } },
+    { "ld (4660), bc", { { 4, { 0xED, 0x43, 0x34, 0x12 } }, { -1 }, { 4, { 0xED, 0x43, 0x34, 0x12 } } } },
+    { "ld de, 4660", { { 3, { 0x11, 0x34, 0x12 } }, { 3, { 0x11, 0x34, 0x12 } }, { 3, { 0x11, 0x34, 0x12 } } } },
+    { "ld de, (4660)", { { 4, { 0xED, 0x5B, 0x34, 0x12 } }, { -1 }, { 4, { 0xED, 0x5B, 0x34, 0x12 } } } },
+    { "ld (4660), de", { { 4, { 0xED, 0x53, 0x34, 0x12 } }, { -1 }, { 4, { 0xED, 0x53, 0x34, 0x12 } } } },
+    { "ld hl, 4660", { { 3, { 0x21, 0x34, 0x12 } }, { 3, { 0x21, 0x34, 0x12 } }, { 3, { 0x21, 0x34, 0x12 } } } },
+    { "ld hl, (4660)", { { 3, { 0x2A, 0x34, 0x12 } }, { -1 }, { 3, { 0x2A, 0x34, 0x12 } } } },
+    { "ld (4660), hl", { { 3, { 0x22, 0x34, 0x12 } }, { -1 }, { 3, { 0x22, 0x34, 0x12 } } } },
+    { "ld sp, 4660", { { 3, { 0x31, 0x34, 0x12 } }, { 3, { 0x31, 0x34, 0x12 } }, { 3, { 0x31, 0x34, 0x12 } } } },
+    { "ld sp, (4660)", { { 4, { 0xED, 0x7B, 0x34, 0x12 } }, { -1 }, { 4, { 0xED, 0x7B, 0x34, 0x12 } } } },
+    { "ld (4660), sp", { { 4, { 0xED, 0x73, 0x34, 0x12 } }, { 3, { 0x08, 0x34, 0x12 } }, { 4, { 0xED, 0x73, 0x34, 0x12 } } } },
+    { "ld sp, hl", { { 1, { 0xF9 } }, { 1, { 0xF9 } }, { 1, { 0xF9 } } } },
+    { "ld ix, 4660", { { 4, { 0xDD, 0x21, 0x34, 0x12 } }, { -1 }, { 4, { 0xDD, 0x21, 0x34, 0x12 } } } },
+    { "ld ix, (4660)", { { 4, { 0xDD, 0x2A, 0x34, 0x12 } }, { -1 }, { 4, { 0xDD, 0x2A, 0x34, 0x12 } } } },
+    { "ld (4660), ix", { { 4, { 0xDD, 0x22, 0x34, 0x12 } }, { -1 }, { 4, { 0xDD, 0x22, 0x34, 0x12 } } } },
+    { "ld sp, ix", { { 2, { 0xDD, 0xF9 } }, { -1 }, { 2, { 0xDD, 0xF9 } } } },
+    { "ld iy, 4660", { { 4, { 0xFD, 0x21, 0x34, 0x12 } }, { -1 }, { 4, { 0xFD, 0x21, 0x34, 0x12 } } } },
+    { "ld iy, (4660)", { { 4, { 0xFD, 0x2A, 0x34, 0x12 } }, { -1 }, { 4, { 0xFD, 0x2A, 0x34, 0x12 } } } },
+    { "ld (4660), iy", { { 4, { 0xFD, 0x22, 0x34, 0x12 } }, { -1 }, { 4, { 0xFD, 0x22, 0x34, 0x12 } } } },
+    { "ld sp, iy", { { 2, { 0xFD, 0xF9 } }, { -1 }, { 2, { 0xFD, 0xF9 } } } },
+    { "ldi (hl), a", { { -1 }, { 1, { 0x22 } }, { -1 } } },
+    { "ldi a, (hl)", { { -1 }, { 1, { 0x2A } }, { -1 } } },
+    { "ldd (hl), a", { { -1 }, { 1, { 0x32 } }, { -1 } } },
+    { "ldd a, (hl)", { { -1 }, { 1, { 0x3A } }, { -1 } } },
+    { "ldh a, (18)", { { -1 }, { 2, { 0xF0, 0x12 } }, { -1 } } },
+    { "ldh (18), a", { { -1 }, { 2, { 0xE0, 0x12 } }, { -1 } } },
+    { "ldh a, (0xff12)", { { -1 }, { 2, { 0xF0, 0x12 } }, { -1 } } },
+    { "ldh (0xff12), a", { { -1 }, { 2, { 0xE0, 0x12 } }, { -1 } } },
+    { "ldhl sp, 5", { { -1 }, { 2, { 0xF8, 0x05 } }, { -1 } } },
+    { "ldhl sp, -3", { { -1 }, { 2, { 0xF8, 0xFD } }, { -1 } } },
+    { "push bc", { { 1, { 0xC5 } }, { 1, { 0xC5 } }, { 1, { 0xC5 } } } },
+    { "pop bc", { { 1, { 0xC1 } }, { 1, { 0xC1 } }, { 1, { 0xC1 } } } },
+    { "push de", { { 1, { 0xD5 } }, { 1, { 0xD5 } }, { 1, { 0xD5 } } } },
+    { "pop de", { { 1, { 0xD1 } }, { 1, { 0xD1 } }, { 1, { 0xD1 } } } },
+    { "push hl", { { 1, { 0xE5 } }, { 1, { 0xE5 } }, { 1, { 0xE5 } } } },
+    { "pop hl", { { 1, { 0xE1 } }, { 1, { 0xE1 } }, { 1, { 0xE1 } } } },
+    { "push af", { { 1, { 0xF5 } }, { 1, { 0xF5 } }, { 1, { 0xF5 } } } },
+    { "pop af", { { 1, { 0xF1 } }, { 1, { 0xF1 } }, { 1, { 0xF1 } } } },
+    { "push ix", { { 2, { 0xDD, 0xE5 } }, { -1 }, { 2, { 0xDD, 0xE5 } } } },
+    { "pop ix", { { 2, { 0xDD, 0xE1 } }, { -1 }, { 2, { 0xDD, 0xE1 } } } },
+    { "ex (sp), ix", { { 2, { 0xDD, 0xE3 } }, { -1 }, { 2, { 0xDD, 0xE3 } } } },
+    { "push iy", { { 2, { 0xFD, 0xE5 } }, { -1 }, { 2, { 0xFD, 0xE5 } } } },
+    { "pop iy", { { 2, { 0xFD, 0xE1 } }, { -1 }, { 2, { 0xFD, 0xE1 } } } },
+    { "ex (sp), iy", { { 2, { 0xFD, 0xE3 } }, { -1 }, { 2, { 0xFD, 0xE3 } } } },
+    { "ex af, af'", { { 1, { 0x08 } }, { -1 }, { 1, { 0x08 } } } },
+    { "ex de, hl", { { 1, { 0xEB } }, { -1 }, { 1, { 0xEB } } } },
+    { "ex (sp), hl", { { 1, { 0xE3 } }, { -1 }, { 1, { 0xE3 } } } },
+    { "exx", { { 1, { 0xD9 } }, { -1 }, { 1, { 0xD9 } } } },
+    { "ldi", { { 2, { 0xED, 0xA0 } }, { -1 }, { 2, { 0xED, 0xA0 } } } },
+    { "cpi", { { 2, { 0xED, 0xA1 } }, { -1 }, { 2, { 0xED, 0xA1 } } } },
+    { "ini", { { 2, { 0xED, 0xA2 } }, { -1 }, { 2, { 0xED, 0xA2 } } } },
+    { "outi", { { 2, { 0xED, 0xA3 } }, { -1 }, { 2, { 0xED, 0xA3 } } } },
+    { "ldd", { { 2, { 0xED, 0xA8 } }, { -1 }, { 2, { 0xED, 0xA8 } } } },
+    { "cpd", { { 2, { 0xED, 0xA9 } }, { -1 }, { 2, { 0xED, 0xA9 } } } },
+    { "ind", { { 2, { 0xED, 0xAA } }, { -1 }, { 2, { 0xED, 0xAA } } } },
+    { "outd", { { 2, { 0xED, 0xAB } }, { -1 }, { 2, { 0xED, 0xAB } } } },
+    { "ldir", { { 2, { 0xED, 0xB0 } }, { -1 }, { 2, { 0xED, 0xB0 } } } },
+    { "cpir", { { 2, { 0xED, 0xB1 } }, { -1 }, { 2, { 0xED, 0xB1 } } } },
+    { "inir", { { 2, { 0xED, 0xB2 } }, { -1 }, { 2, { 0xED, 0xB2 } } } },
+    { "otir", { { 2, { 0xED, 0xB3 } }, { -1 }, { 2, { 0xED, 0xB3 } } } },
+    { "lddr", { { 2, { 0xED, 0xB8 } }, { -1 }, { 2, { 0xED, 0xB8 } } } },
+    { "cpdr", { { 2, { 0xED, 0xB9 } }, { -1 }, { 2, { 0xED, 0xB9 } } } },
+    { "indr", { { 2, { 0xED, 0xBA } }, { -1 }, { 2, { 0xED, 0xBA } } } },
+    { "otdr", { { 2, { 0xED, 0xBB } }, { -1 }, { 2, { 0xED, 0xBB } } } },
+    { "add a, b", { { 1, { 0x80 } }, { 1, { 0x80 } }, { 1, { 0x80 } } } },
+    { "add a, c", { { 1, { 0x81 } }, { 1, { 0x81 } }, { 1, { 0x81 } } } },
+    { "add a, d", { { 1, { 0x82 } }, { 1, { 0x82 } }, { 1, { 0x82 } } } },
+    { "add a, e", { { 1, { 0x83 } }, { 1, { 0x83 } }, { 1, { 0x83 } } } },
+    { "add a, h", { { 1, { 0x84 } }, { 1, { 0x84 } }, { 1, { 0x84 } } } },
+    { "add a, l", { { 1, { 0x85 } }, { 1, { 0x85 } }, { 1, { 0x85 } } } },
+    { "add a, (hl)", { { 1, { 0x86 } }, { 1, { 0x86 } }, { 1, { 0x86 } } } },
+    { "add a, a", { { 1, { 0x87 } }, { 1, { 0x87 } }, { 1, { 0x87 } } } },
+    { "add a, 18", { { 2, { 0xC6, 0x12 } }, { 2, { 0xC6, 0x12 } }, { 2, { 0xC6, 0x12 } } } },
+    { "add a, (ix+5)", { { 3, { 0xDD, 0x86, 0x05 } }, { -1 }, { 3, { 0xDD, 0x86, 0x05 } } } },
+    { "add a, (ix-3)", { { 3, { 0xDD, 0x86, 0xFD } }, { -1 }, { 3, { 0xDD, 0x86, 0xFD } } } },
+    { "add a, ixh", { { 2, { 0xDD, 0x84 } }, { -1 }, { 2, { 0xDD, 0x84 } } } },
+    { "add a, ixl", { { 2, { 0xDD, 0x85 } }, { -1 }, { 2, { 0xDD, 0x85 } } } },
+    { "add a, (iy+5)", { { 3, { 0xFD, 0x86, 0x05 } }, { -1 }, { 3, { 0xFD, 0x86, 0x05 } } } },
+    { "add a, (iy-3)", { { 3, { 0xFD, 0x86, 0xFD } }, { -1 }, { 3, { 0xFD, 0x86, 0xFD } } } },
+    { "add a, iyh", { { 2, { 0xFD, 0x84 } }, { -1 }, { 2, { 0xFD, 0x84 } } } },
+    { "add a, iyl", { { 2, { 0xFD, 0x85 } }, { -1 }, { 2, { 0xFD, 0x85 } } } },
+    { "adc a, b", { { 1, { 0x88 } }, { 1, { 0x88 } }, { 1, { 0x88 } } } },
+    { "adc a, c", { { 1, { 0x89 } }, { 1, { 0x89 } }, { 1, { 0x89 } } } },
+    { "adc a, d", { { 1, { 0x8A } }, { 1, { 0x8A } }, { 1, { 0x8A } } } },
+    { "adc a, e", { { 1, { 0x8B } }, { 1, { 0x8B } }, { 1, { 0x8B } } } },
+    { "adc a, h", { { 1, { 0x8C } }, { 1, { 0x8C } }, { 1, { 0x8C } } } },
+    { "adc a, l", { { 1, { 0x8D } }, { 1, { 0x8D } }, { 1, { 0x8D } } } },
+    { "adc a, (hl)", { { 1, { 0x8E } }, { 1, { 0x8E } }, { 1, { 0x8E } } } },
+    { "adc a, a", { { 1, { 0x8F } }, { 1, { 0x8F } }, { 1, { 0x8F } } } },
+    { "adc a, 18", { { 2, { 0xCE, 0x12 } }, { 2, { 0xCE, 0x12 } }, { 2, { 0xCE, 0x12 } } } },
+    { "adc a, (ix+5)", { { 3, { 0xDD, 0x8E, 0x05 } }, { -1 }, { 3, { 0xDD, 0x8E, 0x05 } } } },
+    { "adc a, (ix-3)", { { 3, { 0xDD, 0x8E, 0xFD } }, { -1 }, { 3, { 0xDD, 0x8E, 0xFD } } } },
+    { "adc a, ixh", { { 2, { 0xDD, 0x8C } }, { -1 }, { 2, { 0xDD, 0x8C } } } },
+    { "adc a, ixl", { { 2, { 0xDD, 0x8D } }, { -1 }, { 2, { 0xDD, 0x8D } } } },
+    { "adc a, (iy+5)", { { 3, { 0xFD, 0x8E, 0x05 } }, { -1 }, { 3, { 0xFD, 0x8E, 0x05 } } } },
+    { "adc a, (iy-3)", { { 3, { 0xFD, 0x8E, 0xFD } }, { -1 }, { 3, { 0xFD, 0x8E, 0xFD } } } },
+    { "adc a, iyh", { { 2, { 0xFD, 0x8C } }, { -1 }, { 2, { 0xFD, 0x8C } } } },
+    { "adc a, iyl", { { 2, { 0xFD, 0x8D } }, { -1 }, { 2, { 0xFD, 0x8D } } } },
+    { "sub b", { { 1, { 0x90 } }, { 1, { 0x90 } }, { 1, { 0x90 } } } },
+    { "sub c", { { 1, { 0x91 } }, { 1, { 0x91 } }, { 1, { 0x91 } } } },
+    { "sub d", { { 1, { 0x92 } }, { 1, { 0x92 } }, { 1, { 0x92 } } } },
+    { "sub e", { { 1, { 0x93 } }, { 1, { 0x93 } }, { 1, { 0x93 } } } },
+    { "sub h", { { 1, { 0x94 } }, { 1, { 0x94 } }, { 1, { 0x94 } } } },
+    { "sub l", { { 1, { 0x95 } }, { 1, { 0x95 } }, { 1, { 0x95 } } } },
+    { "sub (hl)", { { 1, { 0x96 } }, { 1, { 0x96 } }, { 1, { 0x96 } } } },
+    { "sub a", { { 1, { 0x97 } }, { 1, { 0x97 } }, { 1, { 0x97 } } } },
+    { "sub 18", { { 2, { 0xD6, 0x12 } }, { 2, { 0xD6, 0x12 } }, { 2, { 0xD6, 0x12 } } } },
+    { "sub (ix+5)", { { 3, { 0xDD, 0x96, 0x05 } }, { -1 }, { 3, { 0xDD, 0x96, 0x05 } } } },
+    { "sub (ix-3)", { { 3, { 0xDD, 0x96, 0xFD } }, { -1 }, { 3, { 0xDD, 0x96, 0xFD } } } },
+    { "sub ixh", { { 2, { 0xDD, 0x94 } }, { -1 }, { 2, { 0xDD, 0x94 } } } },
+    { "sub ixl", { { 2, { 0xDD, 0x95 } }, { -1 }, { 2, { 0xDD, 0x95 } } } },
+    { "sub (iy+5)", { { 3, { 0xFD, 0x96, 0x05 } }, { -1 }, { 3, { 0xFD, 0x96, 0x05 } } } },
+    { "sub (iy-3)", { { 3, { 0xFD, 0x96, 0xFD } }, { -1 }, { 3, { 0xFD, 0x96, 0xFD } } } },
+    { "sub iyh", { { 2, { 0xFD, 0x94 } }, { -1 }, { 2, { 0xFD, 0x94 } } } },
+    { "sub iyl", { { 2, { 0xFD, 0x95 } }, { -1 }, { 2, { 0xFD, 0x95 } } } },
+    { "sbc a, b", { { 1, { 0x98 } }, { 1, { 0x98 } }, { 1, { 0x98 } } } },
+    { "sbc a, c", { { 1, { 0x99 } }, { 1, { 0x99 } }, { 1, { 0x99 } } } },
+    { "sbc a, d", { { 1, { 0x9A } }, { 1, { 0x9A } }, { 1, { 0x9A } } } },
+    { "sbc a, e", { { 1, { 0x9B } }, { 1, { 0x9B } }, { 1, { 0x9B } } } },
+    { "sbc a, h", { { 1, { 0x9C } }, { 1, { 0x9C } }, { 1, { 0x9C } } } },
+    { "sbc a, l", { { 1, { 0x9D } }, { 1, { 0x9D } }, { 1, { 0x9D } } } },
+    { "sbc a, (hl)", { { 1, { 0x9E } }, { 1, { 0x9E } }, { 1, { 0x9E } } } },
+    { "sbc a, a", { { 1, { 0x9F } }, { 1, { 0x9F } }, { 1, { 0x9F } } } },
+    { "sbc a, 18", { { 2, { 0xDE, 0x12 } }, { 2, { 0xDE, 0x12 } }, { 2, { 0xDE, 0x12 } } } },
+    { "sbc a, (ix+5)", { { 3, { 0xDD, 0x9E, 0x05 } }, { -1 }, { 3, { 0xDD, 0x9E, 0x05 } } } },
+    { "sbc a, (ix-3)", { { 3, { 0xDD, 0x9E, 0xFD } }, { -1 }, { 3, { 0xDD, 0x9E, 0xFD } } } },
+    { "sbc a, ixh", { { 2, { 0xDD, 0x9C } }, { -1 }, { 2, { 0xDD, 0x9C } } } },
+    { "sbc a, ixl", { { 2, { 0xDD, 0x9D } }, { -1 }, { 2, { 0xDD, 0x9D } } } },
+    { "sbc a, (iy+5)", { { 3, { 0xFD, 0x9E, 0x05 } }, { -1 }, { 3, { 0xFD, 0x9E, 0x05 } } } },
+    { "sbc a, (iy-3)", { { 3, { 0xFD, 0x9E, 0xFD } }, { -1 }, { 3, { 0xFD, 0x9E, 0xFD } } } },
+    { "sbc a, iyh", { { 2, { 0xFD, 0x9C } }, { -1 }, { 2, { 0xFD, 0x9C } } } },
+    { "sbc a, iyl", { { 2, { 0xFD, 0x9D } }, { -1 }, { 2, { 0xFD, 0x9D } } } },
+    { "and b", { { 1, { 0xA0 } }, { 1, { 0xA0 } }, { 1, { 0xA0 } } } },
+    { "and c", { { 1, { 0xA1 } }, { 1, { 0xA1 } }, { 1, { 0xA1 } } } },
+    { "and d", { { 1, { 0xA2 } }, { 1, { 0xA2 } }, { 1, { 0xA2 } } } },
+    { "and e", { { 1, { 0xA3 } }, { 1, { 0xA3 } }, { 1, { 0xA3 } } } },
+    { "and h", { { 1, { 0xA4 } }, { 1, { 0xA4 } }, { 1, { 0xA4 } } } },
+    { "and l", { { 1, { 0xA5 } }, { 1, { 0xA5 } }, { 1, { 0xA5 } } } },
+    { "and (hl)", { { 1, { 0xA6 } }, { 1, { 0xA6 } }, { 1, { 0xA6 } } } },
+    { "and a", { { 1, { 0xA7 } }, { 1, { 0xA7 } }, { 1, { 0xA7 } } } },
+    { "and 18", { { 2, { 0xE6, 0x12 } }, { 2, { 0xE6, 0x12 } }, { 2, { 0xE6, 0x12 } } } },
+    { "and (ix+5)", { { 3, { 0xDD, 0xA6, 0x05 } }, { -1 }, { 3, { 0xDD, 0xA6, 0x05 } } } },
+    { "and (ix-3)", { { 3, { 0xDD, 0xA6, 0xFD } }, { -1 }, { 3, { 0xDD, 0xA6, 0xFD } } } },
+    { "and ixh", { { 2, { 0xDD, 0xA4 } }, { -1 }, { 2, { 0xDD, 0xA4 } } } },
+    { "and ixl", { { 2, { 0xDD, 0xA5 } }, { -1 }, { 2, { 0xDD, 0xA5 } } } },
+    { "and (iy+5)", { { 3, { 0xFD, 0xA6, 0x05 } }, { -1 }, { 3, { 0xFD, 0xA6, 0x05 } } } },
+    { "and (iy-3)", { { 3, { 0xFD, 0xA6, 0xFD } }, { -1 }, { 3, { 0xFD, 0xA6, 0xFD } } } },
+    { "and iyh", { { 2, { 0xFD, 0xA4 } }, { -1 }, { 2, { 0xFD, 0xA4 } } } },
+    { "and iyl", { { 2, { 0xFD, 0xA5 } }, { -1 }, { 2, { 0xFD, 0xA5 } } } },
+    { "xor b", { { 1, { 0xA8 } }, { 1, { 0xA8 } }, { 1, { 0xA8 } } } },
+    { "xor c", { { 1, { 0xA9 } }, { 1, { 0xA9 } }, { 1, { 0xA9 } } } },
+    { "xor d", { { 1, { 0xAA } }, { 1, { 0xAA } }, { 1, { 0xAA } } } },
+    { "xor e", { { 1, { 0xAB } }, { 1, { 0xAB } }, { 1, { 0xAB } } } },
+    { "xor h", { { 1, { 0xAC } }, { 1, { 0xAC } }, { 1, { 0xAC } } } },
+    { "xor l", { { 1, { 0xAD } }, { 1, { 0xAD } }, { 1, { 0xAD } } } },
+    { "xor (hl)", { { 1, { 0xAE } }, { 1, { 0xAE } }, { 1, { 0xAE } } } },
+    { "xor a", { { 1, { 0xAF } }, { 1, { 0xAF } }, { 1, { 0xAF } } } },
+    { "xor 18", { { 2, { 0xEE, 0x12 } }, { 2, { 0xEE, 0x12 } }, { 2, { 0xEE, 0x12 } } } },
+    { "xor (ix+5)", { { 3, { 0xDD, 0xAE, 0x05 } }, { -1 }, { 3, { 0xDD, 0xAE, 0x05 } } } },
+    { "xor (ix-3)", { { 3, { 0xDD, 0xAE, 0xFD } }, { -1 }, { 3, { 0xDD, 0xAE, 0xFD } } } },
+    { "xor ixh", { { 2, { 0xDD, 0xAC } }, { -1 }, { 2, { 0xDD, 0xAC } } } },
+    { "xor ixl", { { 2, { 0xDD, 0xAD } }, { -1 }, { 2, { 0xDD, 0xAD } } } },
+    { "xor (iy+5)", { { 3, { 0xFD, 0xAE, 0x05 } }, { -1 }, { 3, { 0xFD, 0xAE, 0x05 } } } },
+    { "xor (iy-3)", { { 3, { 0xFD, 0xAE, 0xFD } }, { -1 }, { 3, { 0xFD, 0xAE, 0xFD } } } },
+    { "xor iyh", { { 2, { 0xFD, 0xAC } }, { -1 }, { 2, { 0xFD, 0xAC } } } },
+    { "xor iyl", { { 2, { 0xFD, 0xAD } }, { -1 }, { 2, { 0xFD, 0xAD } } } },
+    { "or b", { { 1, { 0xB0 } }, { 1, { 0xB0 } }, { 1, { 0xB0 } } } },
+    { "or c", { { 1, { 0xB1 } }, { 1, { 0xB1 } }, { 1, { 0xB1 } } } },
+    { "or d", { { 1, { 0xB2 } }, { 1, { 0xB2 } }, { 1, { 0xB2 } } } },
+    { "or e", { { 1, { 0xB3 } }, { 1, { 0xB3 } }, { 1, { 0xB3 } } } },
+    { "or h", { { 1, { 0xB4 } }, { 1, { 0xB4 } }, { 1, { 0xB4 } } } },
+    { "or l", { { 1, { 0xB5 } }, { 1, { 0xB5 } }, { 1, { 0xB5 } } } },
+    { "or (hl)", { { 1, { 0xB6 } }, { 1, { 0xB6 } }, { 1, { 0xB6 } } } },
+    { "or a", { { 1, { 0xB7 } }, { 1, { 0xB7 } }, { 1, { 0xB7 } } } },
+    { "or 18", { { 2, { 0xF6, 0x12 } }, { 2, { 0xF6, 0x12 } }, { 2, { 0xF6, 0x12 } } } },
+    { "or (ix+5)", { { 3, { 0xDD, 0xB6, 0x05 } }, { -1 }, { 3, { 0xDD, 0xB6, 0x05 } } } },
+    { "or (ix-3)", { { 3, { 0xDD, 0xB6, 0xFD } }, { -1 }, { 3, { 0xDD, 0xB6, 0xFD } } } },
+    { "or ixh", { { 2, { 0xDD, 0xB4 } }, { -1 }, { 2, { 0xDD, 0xB4 } } } },
+    { "or ixl", { { 2, { 0xDD, 0xB5 } }, { -1 }, { 2, { 0xDD, 0xB5 } } } },
+    { "or (iy+5)", { { 3, { 0xFD, 0xB6, 0x05 } }, { -1 }, { 3, { 0xFD, 0xB6, 0x05 } } } },
+    { "or (iy-3)", { { 3, { 0xFD, 0xB6, 0xFD } }, { -1 }, { 3, { 0xFD, 0xB6, 0xFD } } } },
+    { "or iyh", { { 2, { 0xFD, 0xB4 } }, { -1 }, { 2, { 0xFD, 0xB4 } } } },
+    { "or iyl", { { 2, { 0xFD, 0xB5 } }, { -1 }, { 2, { 0xFD, 0xB5 } } } },
+    { "cp b", { { 1, { 0xB8 } }, { 1, { 0xB8 } }, { 1, { 0xB8 } } } },
+    { "cp c", { { 1, { 0xB9 } }, { 1, { 0xB9 } }, { 1, { 0xB9 } } } },
+    { "cp d", { { 1, { 0xBA } }, { 1, { 0xBA } }, { 1, { 0xBA } } } },
+    { "cp e", { { 1, { 0xBB } }, { 1, { 0xBB } }, { 1, { 0xBB } } } },
+    { "cp h", { { 1, { 0xBC } }, { 1, { 0xBC } }, { 1, { 0xBC } } } },
+    { "cp l", { { 1, { 0xBD } }, { 1, { 0xBD } }, { 1, { 0xBD } } } },
+    { "cp (hl)", { { 1, { 0xBE } }, { 1, { 0xBE } }, { 1, { 0xBE } } } },
+    { "cp a", { { 1, { 0xBF } }, { 1, { 0xBF } }, { 1, { 0xBF } } } },
+    { "cp 18", { { 2, { 0xFE, 0x12 } }, { 2, { 0xFE, 0x12 } }, { 2, { 0xFE, 0x12 } } } },
+    { "cp (ix+5)", { { 3, { 0xDD, 0xBE, 0x05 } }, { -1 }, { 3, { 0xDD, 0xBE, 0x05 } } } },
+    { "cp (ix-3)", { { 3, { 0xDD, 0xBE, 0xFD } }, { -1 }, { 3, { 0xDD, 0xBE, 0xFD } } } },
+    { "cp ixh", { { 2, { 0xDD, 0xBC } }, { -1 }, { 2, { 0xDD, 0xBC } } } },
+    { "cp ixl", { { 2, { 0xDD, 0xBD } }, { -1 }, { 2, { 0xDD, 0xBD } } } },
+    { "cp (iy+5)", { { 3, { 0xFD, 0xBE, 0x05 } }, { -1 }, { 3, { 0xFD, 0xBE, 0x05 } } } },
+    { "cp (iy-3)", { { 3, { 0xFD, 0xBE, 0xFD } }, { -1 }, { 3, { 0xFD, 0xBE, 0xFD } } } },
+    { "cp iyh", { { 2, { 0xFD, 0xBC } }, { -1 }, { 2, { 0xFD, 0xBC } } } },
+    { "cp iyl", { { 2, { 0xFD, 0xBD } }, { -1 }, { 2, { 0xFD, 0xBD } } } },
+    { "inc b", { { 1, { 0x04 } }, { 1, { 0x04 } }, { 1, { 0x04 } } } },
+    { "dec b", { { 1, { 0x05 } }, { 1, { 0x05 } }, { 1, { 0x05 } } } },
+    { "inc c", { { 1, { 0x0C } }, { 1, { 0x0C } }, { 1, { 0x0C } } } },
+    { "dec c", { { 1, { 0x0D } }, { 1, { 0x0D } }, { 1, { 0x0D } } } },
+    { "inc d", { { 1, { 0x14 } }, { 1, { 0x14 } }, { 1, { 0x14 } } } },
+    { "dec d", { { 1, { 0x15 } }, { 1, { 0x15 } }, { 1, { 0x15 } } } },
+    { "inc e", { { 1, { 0x1C } }, { 1, { 0x1C } }, { 1, { 0x1C } } } },
+    { "dec e", { { 1, { 0x1D } }, { 1, { 0x1D } }, { 1, { 0x1D } } } },
+    { "inc h", { { 1, { 0x24 } }, { 1, { 0x24 } }, { 1, { 0x24 } } } },
+    { "dec h", { { 1, { 0x25 } }, { 1, { 0x25 } }, { 1, { 0x25 } } } },
+    { "inc l", { { 1, { 0x2C } }, { 1, { 0x2C } }, { 1, { 0x2C } } } },
+    { "dec l", { { 1, { 0x2D } }, { 1, { 0x2D } }, { 1, { 0x2D } } } },
+    { "inc (hl)", { { 1, { 0x34 } }, { 1, { 0x34 } }, { 1, { 0x34 } } } },
+    { "dec (hl)", { { 1, { 0x35 } }, { 1, { 0x35 } }, { 1, { 0x35 } } } },
+    { "inc a", { { 1, { 0x3C } }, { 1, { 0x3C } }, { 1, { 0x3C } } } },
+    { "dec a", { { 1, { 0x3D } }, { 1, { 0x3D } }, { 1, { 0x3D } } } },
+    { "inc (ix+5)", { { 3, { 0xDD, 0x34, 0x05 } }, { -1 }, { 3, { 0xDD, 0x34, 0x05 } } } },
+    { "dec (ix+5)", { { 3, { 0xDD, 0x35, 0x05 } }, { -1 }, { 3, { 0xDD, 0x35, 0x05 } } } },
+    { "inc (ix-3)", { { 3, { 0xDD, 0x34, 0xFD } }, { -1 }, { 3, { 0xDD, 0x34, 0xFD } } } },
+    { "dec (ix-3)", { { 3, { 0xDD, 0x35, 0xFD } }, { -1 }, { 3, { 0xDD, 0x35, 0xFD } } } },
+    { "inc ixh", { { 2, { 0xDD, 0x24 } }, { -1 }, { 2, { 0xDD, 0x24 } } } },
+    { "inc ixl", { { 2, { 0xDD, 0x2C } }, { -1 }, { 2, { 0xDD, 0x2C } } } },
+    { "dec ixh", { { 2, { 0xDD, 0x25 } }, { -1 }, { 2, { 0xDD, 0x25 } } } },
+    { "dec ixl", { { 2, { 0xDD, 0x2D } }, { -1 }, { 2, { 0xDD, 0x2D } } } },
+    { "inc ix", { { 2, { 0xDD, 0x23 } }, { -1 }, { 2, { 0xDD, 0x23 } } } },
+    { "dec ix", { { 2, { 0xDD, 0x2B } }, { -1 }, { 2, { 0xDD, 0x2B } } } },
+    { "add ix, bc", { { 2, { 0xDD, 0x09 } }, { -1 }, { 2, { 0xDD, 0x09 } } } },
+    { "add ix, de", { { 2, { 0xDD, 0x19 } }, { -1 }, { 2, { 0xDD, 0x19 } } } },
+    { "add ix, ix", { { 2, { 0xDD, 0x29 } }, { -1 }, { 2, { 0xDD, 0x29 } } } },
+    { "add ix, sp", { { 2, { 0xDD, 0x39 } }, { -1 }, { 2, { 0xDD, 0x39 } } } },
+    { "inc (iy+5)", { { 3, { 0xFD, 0x34, 0x05 } }, { -1 }, { 3, { 0xFD, 0x34, 0x05 } } } },
+    { "dec (iy+5)", { { 3, { 0xFD, 0x35, 0x05 } }, { -1 }, { 3, { 0xFD, 0x35, 0x05 } } } },
+    { "inc (iy-3)", { { 3, { 0xFD, 0x34, 0xFD } }, { -1 }, { 3, { 0xFD, 0x34, 0xFD } } } },
+    { "dec (iy-3)", { { 3, { 0xFD, 0x35, 0xFD } }, { -1 }, { 3, { 0xFD, 0x35, 0xFD } } } },
+    { "inc iyh", { { 2, { 0xFD, 0x24 } }, { -1 }, { 2, { 0xFD, 0x24 } } } },
+    { "inc iyl", { { 2, { 0xFD, 0x2C } }, { -1 }, { 2, { 0xFD, 0x2C } } } },
+    { "dec iyh", { { 2, { 0xFD, 0x25 } }, { -1 }, { 2, { 0xFD, 0x25 } } } },
+    { "dec iyl", { { 2, { 0xFD, 0x2D } }, { -1 }, { 2, { 0xFD, 0x2D } } } },
+    { "inc iy", { { 2, { 0xFD, 0x23 } }, { -1 }, { 2, { 0xFD, 0x23 } } } },
+    { "dec iy", { { 2, { 0xFD, 0x2B } }, { -1 }, { 2, { 0xFD, 0x2B } } } },
+    { "add iy, bc", { { 2, { 0xFD, 0x09 } }, { -1 }, { 2, { 0xFD, 0x09 } } } },
+    { "add iy, de", { { 2, { 0xFD, 0x19 } }, { -1 }, { 2, { 0xFD, 0x19 } } } },
+    { "add iy, iy", { { 2, { 0xFD, 0x29 } }, { -1 }, { 2, { 0xFD, 0x29 } } } },
+    { "add iy, sp", { { 2, { 0xFD, 0x39 } }, { -1 }, { 2, { 0xFD, 0x39 } } } },
+    { "inc bc", { { 1, { 0x03 } }, { 1, { 0x03 } }, { 1, { 0x03 } } } },
+    { "dec bc", { { 1, { 0x0B } }, { 1, { 0x0B } }, { 1, { 0x0B } } } },
+    { "add hl, bc", { { 1, { 0x09 } }, { 1, { 0x09 } }, { 1, { 0x09 } } } },
+    { "adc hl, bc", { { 2, { 0xED, 0x4A } }, { -1 }, { 2, { 0xED, 0x4A } } } },
+    { "sbc hl, bc", { { 2, { 0xED, 0x42 } }, { -1 }, { 2, { 0xED, 0x42 } } } },
+    { "inc de", { { 1, { 0x13 } }, { 1, { 0x13 } }, { 1, { 0x13 } } } },
+    { "dec de", { { 1, { 0x1B } }, { 1, { 0x1B } }, { 1, { 0x1B } } } },
+    { "add hl, de", { { 1, { 0x19 } }, { 1, { 0x19 } }, { 1, { 0x19 } } } },
+    { "adc hl, de", { { 2, { 0xED, 0x5A } }, { -1 }, { 2, { 0xED, 0x5A } } } },
+    { "sbc hl, de", { { 2, { 0xED, 0x52 } }, { -1 }, { 2, { 0xED, 0x52 } } } },
+    { "inc hl", { { 1, { 0x23 } }, { 1, { 0x23 } }, { 1, { 0x23 } } } },
+    { "dec hl", { { 1, { 0x2B } }, { 1, { 0x2B } }, { 1, { 0x2B } } } },
+    { "add hl, hl", { { 1, { 0x29 } }, { 1, { 0x29 } }, { 1, { 0x29 } } } },
+    { "adc hl, hl", { { 2, { 0xED, 0x6A } }, { -1 }, { 2, { 0xED, 0x6A } } } },
+    { "sbc hl, hl", { { 2, { 0xED, 0x62 } }, { -1 }, { 2, { 0xED, 0x62 } } } },
+    { "inc sp", { { 1, { 0x33 } }, { 1, { 0x33 } }, { 1, { 0x33 } } } },
+    { "dec sp", { { 1, { 0x3B } }, { 1, { 0x3B } }, { 1, { 0x3B } } } },
+    { "add hl, sp", { { 1, { 0x39 } }, { 1, { 0x39 } }, { 1, { 0x39 } } } },
+    { "adc hl, sp", { { 2, { 0xED, 0x7A } }, { -1 }, { 2, { 0xED, 0x7A } } } },
+    { "sbc hl, sp", { { 2, { 0xED, 0x72 } }, { -1 }, { 2, { 0xED, 0x72 } } } },
+    { "add sp, 5", { { -1 }, { 2, { 0xE8, 0x05 } }, { -1 } } },
+    { "add sp, -3", { { -1 }, { 2, { 0xE8, 0xFD } }, { -1 } } },
+    { "nop", { { 1, { 0x00 } }, { 1, { 0x00 } }, { 1, { 0x00 } } } },
+    { "rlca", { { 1, { 0x07 } }, { 1, { 0x07 } }, { 1, { 0x07 } } } },
+    { "rrca", { { 1, { 0x0F } }, { 1, { 0x0F } }, { 1, { 0x0F } } } },
+    { "rla", { { 1, { 0x17 } }, { 1, { 0x17 } }, { 1, { 0x17 } } } },
+    { "rra", { { 1, { 0x1F } }, { 1, { 0x1F } }, { 1, { 0x1F } } } },
+    { "daa", { { 1, { 0x27 } }, { 1, { 0x27 } }, { 1, { 0x27 } } } },
+    { "cpl", { { 1, { 0x2F } }, { 1, { 0x2F } }, { 1, { 0x2F } } } },
+    { "scf", { { 1, { 0x37 } }, { 1, { 0x37 } }, { 1, { 0x37 } } } },
+    { "ccf", { { 1, { 0x3F } }, { 1, { 0x3F } }, { 1, { 0x3F } } } },
+    { "halt", { { 1, { 0x76 } }, { 1, { 0x76 } }, { 1, { 0x76 } } } },
+    { "di", { { 1, { 0xF3 } }, { 1, { 0xF3 } }, { 1, { 0xF3 } } } },
+    { "ei", { { 1, { 0xFB } }, { 1, { 0xFB } }, { 1, { 0xFB } } } },
+    { "neg", { { 2, { 0xED, 0x44 } }, { -1 }, { 2, { 0xED, 0x44 } } } },
+    { "rrd", { { 2, { 0xED, 0x67 } }, { -1 }, { 2, { 0xED, 0x67 } } } },
+    { "rld", { { 2, { 0xED, 0x6F } }, { -1 }, { 2, { 0xED, 0x6F } } } },
+    { "im 0", { { 2, { 0xED, 0x46 } }, { -1 }, { 2, { 0xED, 0x46 } } } },
+    { "im 1", { { 2, { 0xED, 0x56 } }, { -1 }, { 2, { 0xED, 0x56 } } } },
+    { "im 2", { { 2, { 0xED, 0x5E } }, { -1 }, { 2, { 0xED, 0x5E } } } },
+    { "stop", { { -1 }, { 2, { 0x10, 0x00 } }, { -1 } } },
+    { "rlc b", { { 2, { 0xCB, 0x00 } }, { 2, { 0xCB, 0x00 } }, { 2, { 0xCB, 0x00 } } } },
+    { "rlc c", { { 2, { 0xCB, 0x01 } }, { 2, { 0xCB, 0x01 } }, { 2, { 0xCB, 0x01 } } } },
+    { "rlc d", { { 2, { 0xCB, 0x02 } }, { 2, { 0xCB, 0x02 } }, { 2, { 0xCB, 0x02 } } } },
+    { "rlc e", { { 2, { 0xCB, 0x03 } }, { 2, { 0xCB, 0x03 } }, { 2, { 0xCB, 0x03 } } } },
+    { "rlc h", { { 2, { 0xCB, 0x04 } }, { 2, { 0xCB, 0x04 } }, { 2, { 0xCB, 0x04 } } } },
+    { "rlc l", { { 2, { 0xCB, 0x05 } }, { 2, { 0xCB, 0x05 } }, { 2, { 0xCB, 0x05 } } } },
+    { "rlc (hl)", { { 2, { 0xCB, 0x06 } }, { 2, { 0xCB, 0x06 } }, { 2, { 0xCB, 0x06 } } } },
+    { "rlc a", { { 2, { 0xCB, 0x07 } }, { 2, { 0xCB, 0x07 } }, { 2, { 0xCB, 0x07 } } } },
+    { "rlc (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x06 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x06 } } } },
+    { "rlc (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x06 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x06 } } } },
+    { "rlc (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x06 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x06 } } } },
+    { "rlc (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x06 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x06 } } } },
+    { "rrc b", { { 2, { 0xCB, 0x08 } }, { 2, { 0xCB, 0x08 } }, { 2, { 0xCB, 0x08 } } } },
+    { "rrc c", { { 2, { 0xCB, 0x09 } }, { 2, { 0xCB, 0x09 } }, { 2, { 0xCB, 0x09 } } } },
+    { "rrc d", { { 2, { 0xCB, 0x0A } }, { 2, { 0xCB, 0x0A } }, { 2, { 0xCB, 0x0A } } } },
+    { "rrc e", { { 2, { 0xCB, 0x0B } }, { 2, { 0xCB, 0x0B } }, { 2, { 0xCB, 0x0B } } } },
+    { "rrc h", { { 2, { 0xCB, 0x0C } }, { 2, { 0xCB, 0x0C } }, { 2, { 0xCB, 0x0C } } } },
+    { "rrc l", { { 2, { 0xCB, 0x0D } }, { 2, { 0xCB, 0x0D } }, { 2, { 0xCB, 0x0D } } } },
+    { "rrc (hl)", { { 2, { 0xCB, 0x0E } }, { 2, { 0xCB, 0x0E } }, { 2, { 0xCB, 0x0E } } } },
+    { "rrc a", { { 2, { 0xCB, 0x0F } }, { 2, { 0xCB, 0x0F } }, { 2, { 0xCB, 0x0F } } } },
+    { "rrc (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x0E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x0E } } } },
+    { "rrc (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x0E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x0E } } } },
+    { "rrc (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x0E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x0E } } } },
+    { "rrc (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x0E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x0E } } } },
+    { "rl b", { { 2, { 0xCB, 0x10 } }, { 2, { 0xCB, 0x10 } }, { 2, { 0xCB, 0x10 } } } },
+    { "rl c", { { 2, { 0xCB, 0x11 } }, { 2, { 0xCB, 0x11 } }, { 2, { 0xCB, 0x11 } } } },
+    { "rl d", { { 2, { 0xCB, 0x12 } }, { 2, { 0xCB, 0x12 } }, { 2, { 0xCB, 0x12 } } } },
+    { "rl e", { { 2, { 0xCB, 0x13 } }, { 2, { 0xCB, 0x13 } }, { 2, { 0xCB, 0x13 } } } },
+    { "rl h", { { 2, { 0xCB, 0x14 } }, { 2, { 0xCB, 0x14 } }, { 2, { 0xCB, 0x14 } } } },
+    { "rl l", { { 2, { 0xCB, 0x15 } }, { 2, { 0xCB, 0x15 } }, { 2, { 0xCB, 0x15 } } } },
+    { "rl (hl)", { { 2, { 0xCB, 0x16 } }, { 2, { 0xCB, 0x16 } }, { 2, { 0xCB, 0x16 } } } },
+    { "rl a", { { 2, { 0xCB, 0x17 } }, { 2, { 0xCB, 0x17 } }, { 2, { 0xCB, 0x17 } } } },
+    { "rl (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x16 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x16 } } } },
+    { "rl (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x16 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x16 } } } },
+    { "rl (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x16 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x16 } } } },
+    { "rl (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x16 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x16 } } } },
+    { "rr b", { { 2, { 0xCB, 0x18 } }, { 2, { 0xCB, 0x18 } }, { 2, { 0xCB, 0x18 } } } },
+    { "rr c", { { 2, { 0xCB, 0x19 } }, { 2, { 0xCB, 0x19 } }, { 2, { 0xCB, 0x19 } } } },
+    { "rr d", { { 2, { 0xCB, 0x1A } }, { 2, { 0xCB, 0x1A } }, { 2, { 0xCB, 0x1A } } } },
+    { "rr e", { { 2, { 0xCB, 0x1B } }, { 2, { 0xCB, 0x1B } }, { 2, { 0xCB, 0x1B } } } },
+    { "rr h", { { 2, { 0xCB, 0x1C } }, { 2, { 0xCB, 0x1C } }, { 2, { 0xCB, 0x1C } } } },
+    { "rr l", { { 2, { 0xCB, 0x1D } }, { 2, { 0xCB, 0x1D } }, { 2, { 0xCB, 0x1D } } } },
+    { "rr (hl)", { { 2, { 0xCB, 0x1E } }, { 2, { 0xCB, 0x1E } }, { 2, { 0xCB, 0x1E } } } },
+    { "rr a", { { 2, { 0xCB, 0x1F } }, { 2, { 0xCB, 0x1F } }, { 2, { 0xCB, 0x1F } } } },
+    { "rr (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x1E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x1E } } } },
+    { "rr (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x1E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x1E } } } },
+    { "rr (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x1E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x1E } } } },
+    { "rr (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x1E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x1E } } } },
+    { "sla b", { { 2, { 0xCB, 0x20 } }, { 2, { 0xCB, 0x20 } }, { 2, { 0xCB, 0x20 } } } },
+    { "sla c", { { 2, { 0xCB, 0x21 } }, { 2, { 0xCB, 0x21 } }, { 2, { 0xCB, 0x21 } } } },
+    { "sla d", { { 2, { 0xCB, 0x22 } }, { 2, { 0xCB, 0x22 } }, { 2, { 0xCB, 0x22 } } } },
+    { "sla e", { { 2, { 0xCB, 0x23 } }, { 2, { 0xCB, 0x23 } }, { 2, { 0xCB, 0x23 } } } },
+    { "sla h", { { 2, { 0xCB, 0x24 } }, { 2, { 0xCB, 0x24 } }, { 2, { 0xCB, 0x24 } } } },
+    { "sla l", { { 2, { 0xCB, 0x25 } }, { 2, { 0xCB, 0x25 } }, { 2, { 0xCB, 0x25 } } } },
+    { "sla (hl)", { { 2, { 0xCB, 0x26 } }, { 2, { 0xCB, 0x26 } }, { 2, { 0xCB, 0x26 } } } },
+    { "sla a", { { 2, { 0xCB, 0x27 } }, { 2, { 0xCB, 0x27 } }, { 2, { 0xCB, 0x27 } } } },
+    { "sla (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x26 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x26 } } } },
+    { "sla (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x26 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x26 } } } },
+    { "sla (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x26 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x26 } } } },
+    { "sla (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x26 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x26 } } } },
+    { "sra b", { { 2, { 0xCB, 0x28 } }, { 2, { 0xCB, 0x28 } }, { 2, { 0xCB, 0x28 } } } },
+    { "sra c", { { 2, { 0xCB, 0x29 } }, { 2, { 0xCB, 0x29 } }, { 2, { 0xCB, 0x29 } } } },
+    { "sra d", { { 2, { 0xCB, 0x2A } }, { 2, { 0xCB, 0x2A } }, { 2, { 0xCB, 0x2A } } } },
+    { "sra e", { { 2, { 0xCB, 0x2B } }, { 2, { 0xCB, 0x2B } }, { 2, { 0xCB, 0x2B } } } },
+    { "sra h", { { 2, { 0xCB, 0x2C } }, { 2, { 0xCB, 0x2C } }, { 2, { 0xCB, 0x2C } } } },
+    { "sra l", { { 2, { 0xCB, 0x2D } }, { 2, { 0xCB, 0x2D } }, { 2, { 0xCB, 0x2D } } } },
+    { "sra (hl)", { { 2, { 0xCB, 0x2E } }, { 2, { 0xCB, 0x2E } }, { 2, { 0xCB, 0x2E } } } },
+    { "sra a", { { 2, { 0xCB, 0x2F } }, { 2, { 0xCB, 0x2F } }, { 2, { 0xCB, 0x2F } } } },
+    { "sra (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x2E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x2E } } } },
+    { "sra (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x2E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x2E } } } },
+    { "sra (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x2E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x2E } } } },
+    { "sra (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x2E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x2E } } } },
+    { "sll b", { { 2, { 0xCB, 0x30 } }, { -1 }, { -1 } } },
+    { "sll c", { { 2, { 0xCB, 0x31 } }, { -1 }, { -1 } } },
+    { "sll d", { { 2, { 0xCB, 0x32 } }, { -1 }, { -1 } } },
+    { "sll e", { { 2, { 0xCB, 0x33 } }, { -1 }, { -1 } } },
+    { "sll h", { { 2, { 0xCB, 0x34 } }, { -1 }, { -1 } } },
+    { "sll l", { { 2, { 0xCB, 0x35 } }, { -1 }, { -1 } } },
+    { "sll (hl)", { { 2, { 0xCB, 0x36 } }, { -1 }, { -1 } } },
+    { "sll a", { { 2, { 0xCB, 0x37 } }, { -1 }, { -1 } } },
+    { "sll (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x36 } }, { -1 }, { -1 } } },
+    { "sll (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x36 } }, { -1 }, { -1 } } },
+    { "sll (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x36 } }, { -1 }, { -1 } } },
+    { "sll (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x36 } }, { -1 }, { -1 } } },
+    { "srl b", { { 2, { 0xCB, 0x38 } }, { 2, { 0xCB, 0x38 } }, { 2, { 0xCB, 0x38 } } } },
+    { "srl c", { { 2, { 0xCB, 0x39 } }, { 2, { 0xCB, 0x39 } }, { 2, { 0xCB, 0x39 } } } },
+    { "srl d", { { 2, { 0xCB, 0x3A } }, { 2, { 0xCB, 0x3A } }, { 2, { 0xCB, 0x3A } } } },
+    { "srl e", { { 2, { 0xCB, 0x3B } }, { 2, { 0xCB, 0x3B } }, { 2, { 0xCB, 0x3B } } } },
+    { "srl h", { { 2, { 0xCB, 0x3C } }, { 2, { 0xCB, 0x3C } }, { 2, { 0xCB, 0x3C } } } },
+    { "srl l", { { 2, { 0xCB, 0x3D } }, { 2, { 0xCB, 0x3D } }, { 2, { 0xCB, 0x3D } } } },
+    { "srl (hl)", { { 2, { 0xCB, 0x3E } }, { 2, { 0xCB, 0x3E } }, { 2, { 0xCB, 0x3E } } } },
+    { "srl a", { { 2, { 0xCB, 0x3F } }, { 2, { 0xCB, 0x3F } }, { 2, { 0xCB, 0x3F } } } },
+    { "srl (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x3E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x3E } } } },
+    { "srl (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x3E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x3E } } } },
+    { "srl (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x3E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x3E } } } },
+    { "srl (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x3E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x3E } } } },
+    { "swap b", { { -1 }, { 2, { 0xCB, 0x30 } }, { -1 } } },
+    { "swap c", { { -1 }, { 2, { 0xCB, 0x31 } }, { -1 } } },
+    { "swap d", { { -1 }, { 2, { 0xCB, 0x32 } }, { -1 } } },
+    { "swap e", { { -1 }, { 2, { 0xCB, 0x33 } }, { -1 } } },
+    { "swap h", { { -1 }, { 2, { 0xCB, 0x34 } }, { -1 } } },
+    { "swap l", { { -1 }, { 2, { 0xCB, 0x35 } }, { -1 } } },
+    { "swap (hl)", { { -1 }, { 2, { 0xCB, 0x36 } }, { -1 } } },
+    { "swap a", { { -1 }, { 2, { 0xCB, 0x37 } }, { -1 } } },
+    { "bit 0, b", { { 2, { 0xCB, 0x40 } }, { 2, { 0xCB, 0x40 } }, { 2, { 0xCB, 0x40 } } } },
+    { "bit 0, c", { { 2, { 0xCB, 0x41 } }, { 2, { 0xCB, 0x41 } }, { 2, { 0xCB, 0x41 } } } },
+    { "bit 0, d", { { 2, { 0xCB, 0x42 } }, { 2, { 0xCB, 0x42 } }, { 2, { 0xCB, 0x42 } } } },
+    { "bit 0, e", { { 2, { 0xCB, 0x43 } }, { 2, { 0xCB, 0x43 } }, { 2, { 0xCB, 0x43 } } } },
+    { "bit 0, h", { { 2, { 0xCB, 0x44 } }, { 2, { 0xCB, 0x44 } }, { 2, { 0xCB, 0x44 } } } },
+    { "bit 0, l", { { 2, { 0xCB, 0x45 } }, { 2, { 0xCB, 0x45 } }, { 2, { 0xCB, 0x45 } } } },
+    { "bit 0, (hl)", { { 2, { 0xCB, 0x46 } }, { 2, { 0xCB, 0x46 } }, { 2, { 0xCB, 0x46 } } } },
+    { "bit 0, a", { { 2, { 0xCB, 0x47 } }, { 2, { 0xCB, 0x47 } }, { 2, { 0xCB, 0x47 } } } },
+    { "bit 0, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x46 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x46 } } } },
+    { "bit 0, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x46 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x46 } } } },
+    { "bit 0, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x46 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x46 } } } },
+    { "bit 0, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x46 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x46 } } } },
+    { "bit 1, b", { { 2, { 0xCB, 0x48 } }, { 2, { 0xCB, 0x48 } }, { 2, { 0xCB, 0x48 } } } },
+    { "bit 1, c", { { 2, { 0xCB, 0x49 } }, { 2, { 0xCB, 0x49 } }, { 2, { 0xCB, 0x49 } } } },
+    { "bit 1, d", { { 2, { 0xCB, 0x4A } }, { 2, { 0xCB, 0x4A } }, { 2, { 0xCB, 0x4A } } } },
+    { "bit 1, e", { { 2, { 0xCB, 0x4B } }, { 2, { 0xCB, 0x4B } }, { 2, { 0xCB, 0x4B } } } },
+    { "bit 1, h", { { 2, { 0xCB, 0x4C } }, { 2, { 0xCB, 0x4C } }, { 2, { 0xCB, 0x4C } } } },
+    { "bit 1, l", { { 2, { 0xCB, 0x4D } }, { 2, { 0xCB, 0x4D } }, { 2, { 0xCB, 0x4D } } } },
+    { "bit 1, (hl)", { { 2, { 0xCB, 0x4E } }, { 2, { 0xCB, 0x4E } }, { 2, { 0xCB, 0x4E } } } },
+    { "bit 1, a", { { 2, { 0xCB, 0x4F } }, { 2, { 0xCB, 0x4F } }, { 2, { 0xCB, 0x4F } } } },
+    { "bit 1, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x4E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x4E } } } },
+    { "bit 1, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x4E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x4E } } } },
+    { "bit 1, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x4E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x4E } } } },
+    { "bit 1, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x4E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x4E } } } },
+    { "bit 2, b", { { 2, { 0xCB, 0x50 } }, { 2, { 0xCB, 0x50 } }, { 2, { 0xCB, 0x50 } } } },
+    { "bit 2, c", { { 2, { 0xCB, 0x51 } }, { 2, { 0xCB, 0x51 } }, { 2, { 0xCB, 0x51 } } } },
+    { "bit 2, d", { { 2, { 0xCB, 0x52 } }, { 2, { 0xCB, 0x52 } }, { 2, { 0xCB, 0x52 } } } },
+    { "bit 2, e", { { 2, { 0xCB, 0x53 } }, { 2, { 0xCB, 0x53 } }, { 2, { 0xCB, 0x53 } } } },
+    { "bit 2, h", { { 2, { 0xCB, 0x54 } }, { 2, { 0xCB, 0x54 } }, { 2, { 0xCB, 0x54 } } } },
+    { "bit 2, l", { { 2, { 0xCB, 0x55 } }, { 2, { 0xCB, 0x55 } }, { 2, { 0xCB, 0x55 } } } },
+    { "bit 2, (hl)", { { 2, { 0xCB, 0x56 } }, { 2, { 0xCB, 0x56 } }, { 2, { 0xCB, 0x56 } } } },
+    { "bit 2, a", { { 2, { 0xCB, 0x57 } }, { 2, { 0xCB, 0x57 } }, { 2, { 0xCB, 0x57 } } } },
+    { "bit 2, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x56 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x56 } } } },
+    { "bit 2, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x56 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x56 } } } },
+    { "bit 2, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x56 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x56 } } } },
+    { "bit 2, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x56 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x56 } } } },
+    { "bit 3, b", { { 2, { 0xCB, 0x58 } }, { 2, { 0xCB, 0x58 } }, { 2, { 0xCB, 0x58 } } } },
+    { "bit 3, c", { { 2, { 0xCB, 0x59 } }, { 2, { 0xCB, 0x59 } }, { 2, { 0xCB, 0x59 } } } },
+    { "bit 3, d", { { 2, { 0xCB, 0x5A } }, { 2, { 0xCB, 0x5A } }, { 2, { 0xCB, 0x5A } } } },
+    { "bit 3, e", { { 2, { 0xCB, 0x5B } }, { 2, { 0xCB, 0x5B } }, { 2, { 0xCB, 0x5B } } } },
+    { "bit 3, h", { { 2, { 0xCB, 0x5C } }, { 2, { 0xCB, 0x5C } }, { 2, { 0xCB, 0x5C } } } },
+    { "bit 3, l", { { 2, { 0xCB, 0x5D } }, { 2, { 0xCB, 0x5D } }, { 2, { 0xCB, 0x5D } } } },
+    { "bit 3, (hl)", { { 2, { 0xCB, 0x5E } }, { 2, { 0xCB, 0x5E } }, { 2, { 0xCB, 0x5E } } } },
+    { "bit 3, a", { { 2, { 0xCB, 0x5F } }, { 2, { 0xCB, 0x5F } }, { 2, { 0xCB, 0x5F } } } },
+    { "bit 3, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x5E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x5E } } } },
+    { "bit 3, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x5E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x5E } } } },
+    { "bit 3, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x5E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x5E } } } },
+    { "bit 3, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x5E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x5E } } } },
+    { "bit 4, b", { { 2, { 0xCB, 0x60 } }, { 2, { 0xCB, 0x60 } }, { 2, { 0xCB, 0x60 } } } },
+    { "bit 4, c", { { 2, { 0xCB, 0x61 } }, { 2, { 0xCB, 0x61 } }, { 2, { 0xCB, 0x61 } } } },
+    { "bit 4, d", { { 2, { 0xCB, 0x62 } }, { 2, { 0xCB, 0x62 } }, { 2, { 0xCB, 0x62 } } } },
+    { "bit 4, e", { { 2, { 0xCB, 0x63 } }, { 2, { 0xCB, 0x63 } }, { 2, { 0xCB, 0x63 } } } },
+    { "bit 4, h", { { 2, { 0xCB, 0x64 } }, { 2, { 0xCB, 0x64 } }, { 2, { 0xCB, 0x64 } } } },
+    { "bit 4, l", { { 2, { 0xCB, 0x65 } }, { 2, { 0xCB, 0x65 } }, { 2, { 0xCB, 0x65 } } } },
+    { "bit 4, (hl)", { { 2, { 0xCB, 0x66 } }, { 2, { 0xCB, 0x66 } }, { 2, { 0xCB, 0x66 } } } },
+    { "bit 4, a", { { 2, { 0xCB, 0x67 } }, { 2, { 0xCB, 0x67 } }, { 2, { 0xCB, 0x67 } } } },
+    { "bit 4, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x66 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x66 } } } },
+    { "bit 4, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x66 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x66 } } } },
+    { "bit 4, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x66 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x66 } } } },
+    { "bit 4, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x66 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x66 } } } },
+    { "bit 5, b", { { 2, { 0xCB, 0x68 } }, { 2, { 0xCB, 0x68 } }, { 2, { 0xCB, 0x68 } } } },
+    { "bit 5, c", { { 2, { 0xCB, 0x69 } }, { 2, { 0xCB, 0x69 } }, { 2, { 0xCB, 0x69 } } } },
+    { "bit 5, d", { { 2, { 0xCB, 0x6A } }, { 2, { 0xCB, 0x6A } }, { 2, { 0xCB, 0x6A } } } },
+    { "bit 5, e", { { 2, { 0xCB, 0x6B } }, { 2, { 0xCB, 0x6B } }, { 2, { 0xCB, 0x6B } } } },
+    { "bit 5, h", { { 2, { 0xCB, 0x6C } }, { 2, { 0xCB, 0x6C } }, { 2, { 0xCB, 0x6C } } } },
+    { "bit 5, l", { { 2, { 0xCB, 0x6D } }, { 2, { 0xCB, 0x6D } }, { 2, { 0xCB, 0x6D } } } },
+    { "bit 5, (hl)", { { 2, { 0xCB, 0x6E } }, { 2, { 0xCB, 0x6E } }, { 2, { 0xCB, 0x6E } } } },
+    { "bit 5, a", { { 2, { 0xCB, 0x6F } }, { 2, { 0xCB, 0x6F } }, { 2, { 0xCB, 0x6F } } } },
+    { "bit 5, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x6E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x6E } } } },
+    { "bit 5, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x6E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x6E } } } },
+    { "bit 5, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x6E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x6E } } } },
+    { "bit 5, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x6E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x6E } } } },
+    { "bit 6, b", { { 2, { 0xCB, 0x70 } }, { 2, { 0xCB, 0x70 } }, { 2, { 0xCB, 0x70 } } } },
+    { "bit 6, c", { { 2, { 0xCB, 0x71 } }, { 2, { 0xCB, 0x71 } }, { 2, { 0xCB, 0x71 } } } },
+    { "bit 6, d", { { 2, { 0xCB, 0x72 } }, { 2, { 0xCB, 0x72 } }, { 2, { 0xCB, 0x72 } } } },
+    { "bit 6, e", { { 2, { 0xCB, 0x73 } }, { 2, { 0xCB, 0x73 } }, { 2, { 0xCB, 0x73 } } } },
+    { "bit 6, h", { { 2, { 0xCB, 0x74 } }, { 2, { 0xCB, 0x74 } }, { 2, { 0xCB, 0x74 } } } },
+    { "bit 6, l", { { 2, { 0xCB, 0x75 } }, { 2, { 0xCB, 0x75 } }, { 2, { 0xCB, 0x75 } } } },
+    { "bit 6, (hl)", { { 2, { 0xCB, 0x76 } }, { 2, { 0xCB, 0x76 } }, { 2, { 0xCB, 0x76 } } } },
+    { "bit 6, a", { { 2, { 0xCB, 0x77 } }, { 2, { 0xCB, 0x77 } }, { 2, { 0xCB, 0x77 } } } },
+    { "bit 6, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x76 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x76 } } } },
+    { "bit 6, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x76 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x76 } } } },
+    { "bit 6, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x76 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x76 } } } },
+    { "bit 6, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x76 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x76 } } } },
+    { "bit 7, b", { { 2, { 0xCB, 0x78 } }, { 2, { 0xCB, 0x78 } }, { 2, { 0xCB, 0x78 } } } },
+    { "bit 7, c", { { 2, { 0xCB, 0x79 } }, { 2, { 0xCB, 0x79 } }, { 2, { 0xCB, 0x79 } } } },
+    { "bit 7, d", { { 2, { 0xCB, 0x7A } }, { 2, { 0xCB, 0x7A } }, { 2, { 0xCB, 0x7A } } } },
+    { "bit 7, e", { { 2, { 0xCB, 0x7B } }, { 2, { 0xCB, 0x7B } }, { 2, { 0xCB, 0x7B } } } },
+    { "bit 7, h", { { 2, { 0xCB, 0x7C } }, { 2, { 0xCB, 0x7C } }, { 2, { 0xCB, 0x7C } } } },
+    { "bit 7, l", { { 2, { 0xCB, 0x7D } }, { 2, { 0xCB, 0x7D } }, { 2, { 0xCB, 0x7D } } } },
+    { "bit 7, (hl)", { { 2, { 0xCB, 0x7E } }, { 2, { 0xCB, 0x7E } }, { 2, { 0xCB, 0x7E } } } },
+    { "bit 7, a", { { 2, { 0xCB, 0x7F } }, { 2, { 0xCB, 0x7F } }, { 2, { 0xCB, 0x7F } } } },
+    { "bit 7, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x7E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x7E } } } },
+    { "bit 7, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x7E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x7E } } } },
+    { "bit 7, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x7E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x7E } } } },
+    { "bit 7, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x7E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x7E } } } },
+    { "res 0, b", { { 2, { 0xCB, 0x80 } }, { 2, { 0xCB, 0x80 } }, { 2, { 0xCB, 0x80 } } } },
+    { "res 0, c", { { 2, { 0xCB, 0x81 } }, { 2, { 0xCB, 0x81 } }, { 2, { 0xCB, 0x81 } } } },
+    { "res 0, d", { { 2, { 0xCB, 0x82 } }, { 2, { 0xCB, 0x82 } }, { 2, { 0xCB, 0x82 } } } },
+    { "res 0, e", { { 2, { 0xCB, 0x83 } }, { 2, { 0xCB, 0x83 } }, { 2, { 0xCB, 0x83 } } } },
+    { "res 0, h", { { 2, { 0xCB, 0x84 } }, { 2, { 0xCB, 0x84 } }, { 2, { 0xCB, 0x84 } } } },
+    { "res 0, l", { { 2, { 0xCB, 0x85 } }, { 2, { 0xCB, 0x85 } }, { 2, { 0xCB, 0x85 } } } },
+    { "res 0, (hl)", { { 2, { 0xCB, 0x86 } }, { 2, { 0xCB, 0x86 } }, { 2, { 0xCB, 0x86 } } } },
+    { "res 0, a", { { 2, { 0xCB, 0x87 } }, { 2, { 0xCB, 0x87 } }, { 2, { 0xCB, 0x87 } } } },
+    { "res 0, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x86 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x86 } } } },
+    { "res 0, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x86 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x86 } } } },
+    { "res 0, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x86 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x86 } } } },
+    { "res 0, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x86 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x86 } } } },
+    { "res 1, b", { { 2, { 0xCB, 0x88 } }, { 2, { 0xCB, 0x88 } }, { 2, { 0xCB, 0x88 } } } },
+    { "res 1, c", { { 2, { 0xCB, 0x89 } }, { 2, { 0xCB, 0x89 } }, { 2, { 0xCB, 0x89 } } } },
+    { "res 1, d", { { 2, { 0xCB, 0x8A } }, { 2, { 0xCB, 0x8A } }, { 2, { 0xCB, 0x8A } } } },
+    { "res 1, e", { { 2, { 0xCB, 0x8B } }, { 2, { 0xCB, 0x8B } }, { 2, { 0xCB, 0x8B } } } },
+    { "res 1, h", { { 2, { 0xCB, 0x8C } }, { 2, { 0xCB, 0x8C } }, { 2, { 0xCB, 0x8C } } } },
+    { "res 1, l", { { 2, { 0xCB, 0x8D } }, { 2, { 0xCB, 0x8D } }, { 2, { 0xCB, 0x8D } } } },
+    { "res 1, (hl)", { { 2, { 0xCB, 0x8E } }, { 2, { 0xCB, 0x8E } }, { 2, { 0xCB, 0x8E } } } },
+    { "res 1, a", { { 2, { 0xCB, 0x8F } }, { 2, { 0xCB, 0x8F } }, { 2, { 0xCB, 0x8F } } } },
+    { "res 1, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x8E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x8E } } } },
+    { "res 1, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x8E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x8E } } } },
+    { "res 1, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x8E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x8E } } } },
+    { "res 1, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x8E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x8E } } } },
+    { "res 2, b", { { 2, { 0xCB, 0x90 } }, { 2, { 0xCB, 0x90 } }, { 2, { 0xCB, 0x90 } } } },
+    { "res 2, c", { { 2, { 0xCB, 0x91 } }, { 2, { 0xCB, 0x91 } }, { 2, { 0xCB, 0x91 } } } },
+    { "res 2, d", { { 2, { 0xCB, 0x92 } }, { 2, { 0xCB, 0x92 } }, { 2, { 0xCB, 0x92 } } } },
+    { "res 2, e", { { 2, { 0xCB, 0x93 } }, { 2, { 0xCB, 0x93 } }, { 2, { 0xCB, 0x93 } } } },
+    { "res 2, h", { { 2, { 0xCB, 0x94 } }, { 2, { 0xCB, 0x94 } }, { 2, { 0xCB, 0x94 } } } },
+    { "res 2, l", { { 2, { 0xCB, 0x95 } }, { 2, { 0xCB, 0x95 } }, { 2, { 0xCB, 0x95 } } } },
+    { "res 2, (hl)", { { 2, { 0xCB, 0x96 } }, { 2, { 0xCB, 0x96 } }, { 2, { 0xCB, 0x96 } } } },
+    { "res 2, a", { { 2, { 0xCB, 0x97 } }, { 2, { 0xCB, 0x97 } }, { 2, { 0xCB, 0x97 } } } },
+    { "res 2, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x96 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x96 } } } },
+    { "res 2, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x96 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x96 } } } },
+    { "res 2, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x96 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x96 } } } },
+    { "res 2, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x96 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x96 } } } },
+    { "res 3, b", { { 2, { 0xCB, 0x98 } }, { 2, { 0xCB, 0x98 } }, { 2, { 0xCB, 0x98 } } } },
+    { "res 3, c", { { 2, { 0xCB, 0x99 } }, { 2, { 0xCB, 0x99 } }, { 2, { 0xCB, 0x99 } } } },
+    { "res 3, d", { { 2, { 0xCB, 0x9A } }, { 2, { 0xCB, 0x9A } }, { 2, { 0xCB, 0x9A } } } },
+    { "res 3, e", { { 2, { 0xCB, 0x9B } }, { 2, { 0xCB, 0x9B } }, { 2, { 0xCB, 0x9B } } } },
+    { "res 3, h", { { 2, { 0xCB, 0x9C } }, { 2, { 0xCB, 0x9C } }, { 2, { 0xCB, 0x9C } } } },
+    { "res 3, l", { { 2, { 0xCB, 0x9D } }, { 2, { 0xCB, 0x9D } }, { 2, { 0xCB, 0x9D } } } },
+    { "res 3, (hl)", { { 2, { 0xCB, 0x9E } }, { 2, { 0xCB, 0x9E } }, { 2, { 0xCB, 0x9E } } } },
+    { "res 3, a", { { 2, { 0xCB, 0x9F } }, { 2, { 0xCB, 0x9F } }, { 2, { 0xCB, 0x9F } } } },
+    { "res 3, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0x9E } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0x9E } } } },
+    { "res 3, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0x9E } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0x9E } } } },
+    { "res 3, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0x9E } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0x9E } } } },
+    { "res 3, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0x9E } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0x9E } } } },
+    { "res 4, b", { { 2, { 0xCB, 0xA0 } }, { 2, { 0xCB, 0xA0 } }, { 2, { 0xCB, 0xA0 } } } },
+    { "res 4, c", { { 2, { 0xCB, 0xA1 } }, { 2, { 0xCB, 0xA1 } }, { 2, { 0xCB, 0xA1 } } } },
+    { "res 4, d", { { 2, { 0xCB, 0xA2 } }, { 2, { 0xCB, 0xA2 } }, { 2, { 0xCB, 0xA2 } } } },
+    { "res 4, e", { { 2, { 0xCB, 0xA3 } }, { 2, { 0xCB, 0xA3 } }, { 2, { 0xCB, 0xA3 } } } },
+    { "res 4, h", { { 2, { 0xCB, 0xA4 } }, { 2, { 0xCB, 0xA4 } }, { 2, { 0xCB, 0xA4 } } } },
+    { "res 4, l", { { 2, { 0xCB, 0xA5 } }, { 2, { 0xCB, 0xA5 } }, { 2, { 0xCB, 0xA5 } } } },
+    { "res 4, (hl)", { { 2, { 0xCB, 0xA6 } }, { 2, { 0xCB, 0xA6 } }, { 2, { 0xCB, 0xA6 } } } },
+    { "res 4, a", { { 2, { 0xCB, 0xA7 } }, { 2, { 0xCB, 0xA7 } }, { 2, { 0xCB, 0xA7 } } } },
+    { "res 4, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xA6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xA6 } } } },
+    { "res 4, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xA6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xA6 } } } },
+    { "res 4, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xA6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xA6 } } } },
+    { "res 4, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xA6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xA6 } } } },
+    { "res 5, b", { { 2, { 0xCB, 0xA8 } }, { 2, { 0xCB, 0xA8 } }, { 2, { 0xCB, 0xA8 } } } },
+    { "res 5, c", { { 2, { 0xCB, 0xA9 } }, { 2, { 0xCB, 0xA9 } }, { 2, { 0xCB, 0xA9 } } } },
+    { "res 5, d", { { 2, { 0xCB, 0xAA } }, { 2, { 0xCB, 0xAA } }, { 2, { 0xCB, 0xAA } } } },
+    { "res 5, e", { { 2, { 0xCB, 0xAB } }, { 2, { 0xCB, 0xAB } }, { 2, { 0xCB, 0xAB } } } },
+    { "res 5, h", { { 2, { 0xCB, 0xAC } }, { 2, { 0xCB, 0xAC } }, { 2, { 0xCB, 0xAC } } } },
+    { "res 5, l", { { 2, { 0xCB, 0xAD } }, { 2, { 0xCB, 0xAD } }, { 2, { 0xCB, 0xAD } } } },
+    { "res 5, (hl)", { { 2, { 0xCB, 0xAE } }, { 2, { 0xCB, 0xAE } }, { 2, { 0xCB, 0xAE } } } },
+    { "res 5, a", { { 2, { 0xCB, 0xAF } }, { 2, { 0xCB, 0xAF } }, { 2, { 0xCB, 0xAF } } } },
+    { "res 5, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xAE } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xAE } } } },
+    { "res 5, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xAE } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xAE } } } },
+    { "res 5, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xAE } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xAE } } } },
+    { "res 5, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xAE } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xAE } } } },
+    { "res 6, b", { { 2, { 0xCB, 0xB0 } }, { 2, { 0xCB, 0xB0 } }, { 2, { 0xCB, 0xB0 } } } },
+    { "res 6, c", { { 2, { 0xCB, 0xB1 } }, { 2, { 0xCB, 0xB1 } }, { 2, { 0xCB, 0xB1 } } } },
+    { "res 6, d", { { 2, { 0xCB, 0xB2 } }, { 2, { 0xCB, 0xB2 } }, { 2, { 0xCB, 0xB2 } } } },
+    { "res 6, e", { { 2, { 0xCB, 0xB3 } }, { 2, { 0xCB, 0xB3 } }, { 2, { 0xCB, 0xB3 } } } },
+    { "res 6, h", { { 2, { 0xCB, 0xB4 } }, { 2, { 0xCB, 0xB4 } }, { 2, { 0xCB, 0xB4 } } } },
+    { "res 6, l", { { 2, { 0xCB, 0xB5 } }, { 2, { 0xCB, 0xB5 } }, { 2, { 0xCB, 0xB5 } } } },
+    { "res 6, (hl)", { { 2, { 0xCB, 0xB6 } }, { 2, { 0xCB, 0xB6 } }, { 2, { 0xCB, 0xB6 } } } },
+    { "res 6, a", { { 2, { 0xCB, 0xB7 } }, { 2, { 0xCB, 0xB7 } }, { 2, { 0xCB, 0xB7 } } } },
+    { "res 6, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xB6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xB6 } } } },
+    { "res 6, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xB6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xB6 } } } },
+    { "res 6, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xB6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xB6 } } } },
+    { "res 6, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xB6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xB6 } } } },
+    { "res 7, b", { { 2, { 0xCB, 0xB8 } }, { 2, { 0xCB, 0xB8 } }, { 2, { 0xCB, 0xB8 } } } },
+    { "res 7, c", { { 2, { 0xCB, 0xB9 } }, { 2, { 0xCB, 0xB9 } }, { 2, { 0xCB, 0xB9 } } } },
+    { "res 7, d", { { 2, { 0xCB, 0xBA } }, { 2, { 0xCB, 0xBA } }, { 2, { 0xCB, 0xBA } } } },
+    { "res 7, e", { { 2, { 0xCB, 0xBB } }, { 2, { 0xCB, 0xBB } }, { 2, { 0xCB, 0xBB } } } },
+    { "res 7, h", { { 2, { 0xCB, 0xBC } }, { 2, { 0xCB, 0xBC } }, { 2, { 0xCB, 0xBC } } } },
+    { "res 7, l", { { 2, { 0xCB, 0xBD } }, { 2, { 0xCB, 0xBD } }, { 2, { 0xCB, 0xBD } } } },
+    { "res 7, (hl)", { { 2, { 0xCB, 0xBE } }, { 2, { 0xCB, 0xBE } }, { 2, { 0xCB, 0xBE } } } },
+    { "res 7, a", { { 2, { 0xCB, 0xBF } }, { 2, { 0xCB, 0xBF } }, { 2, { 0xCB, 0xBF } } } },
+    { "res 7, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xBE } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xBE } } } },
+    { "res 7, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xBE } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xBE } } } },
+    { "res 7, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xBE } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xBE } } } },
+    { "res 7, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xBE } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xBE } } } },
+    { "set 0, b", { { 2, { 0xCB, 0xC0 } }, { 2, { 0xCB, 0xC0 } }, { 2, { 0xCB, 0xC0 } } } },
+    { "set 0, c", { { 2, { 0xCB, 0xC1 } }, { 2, { 0xCB, 0xC1 } }, { 2, { 0xCB, 0xC1 } } } },
+    { "set 0, d", { { 2, { 0xCB, 0xC2 } }, { 2, { 0xCB, 0xC2 } }, { 2, { 0xCB, 0xC2 } } } },
+    { "set 0, e", { { 2, { 0xCB, 0xC3 } }, { 2, { 0xCB, 0xC3 } }, { 2, { 0xCB, 0xC3 } } } },
+    { "set 0, h", { { 2, { 0xCB, 0xC4 } }, { 2, { 0xCB, 0xC4 } }, { 2, { 0xCB, 0xC4 } } } },
+    { "set 0, l", { { 2, { 0xCB, 0xC5 } }, { 2, { 0xCB, 0xC5 } }, { 2, { 0xCB, 0xC5 } } } },
+    { "set 0, (hl)", { { 2, { 0xCB, 0xC6 } }, { 2, { 0xCB, 0xC6 } }, { 2, { 0xCB, 0xC6 } } } },
+    { "set 0, a", { { 2, { 0xCB, 0xC7 } }, { 2, { 0xCB, 0xC7 } }, { 2, { 0xCB, 0xC7 } } } },
+    { "set 0, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xC6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xC6 } } } },
+    { "set 0, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xC6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xC6 } } } },
+    { "set 0, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xC6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xC6 } } } },
+    { "set 0, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xC6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xC6 } } } },
+    { "set 1, b", { { 2, { 0xCB, 0xC8 } }, { 2, { 0xCB, 0xC8 } }, { 2, { 0xCB, 0xC8 } } } },
+    { "set 1, c", { { 2, { 0xCB, 0xC9 } }, { 2, { 0xCB, 0xC9 } }, { 2, { 0xCB, 0xC9 } } } },
+    { "set 1, d", { { 2, { 0xCB, 0xCA } }, { 2, { 0xCB, 0xCA } }, { 2, { 0xCB, 0xCA } } } },
+    { "set 1, e", { { 2, { 0xCB, 0xCB } }, { 2, { 0xCB, 0xCB } }, { 2, { 0xCB, 0xCB } } } },
+    { "set 1, h", { { 2, { 0xCB, 0xCC } }, { 2, { 0xCB, 0xCC } }, { 2, { 0xCB, 0xCC } } } },
+    { "set 1, l", { { 2, { 0xCB, 0xCD } }, { 2, { 0xCB, 0xCD } }, { 2, { 0xCB, 0xCD } } } },
+    { "set 1, (hl)", { { 2, { 0xCB, 0xCE } }, { 2, { 0xCB, 0xCE } }, { 2, { 0xCB, 0xCE } } } },
+    { "set 1, a", { { 2, { 0xCB, 0xCF } }, { 2, { 0xCB, 0xCF } }, { 2, { 0xCB, 0xCF } } } },
+    { "set 1, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xCE } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xCE } } } },
+    { "set 1, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xCE } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xCE } } } },
+    { "set 1, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xCE } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xCE } } } },
+    { "set 1, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xCE } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xCE } } } },
+    { "set 2, b", { { 2, { 0xCB, 0xD0 } }, { 2, { 0xCB, 0xD0 } }, { 2, { 0xCB, 0xD0 } } } },
+    { "set 2, c", { { 2, { 0xCB, 0xD1 } }, { 2, { 0xCB, 0xD1 } }, { 2, { 0xCB, 0xD1 } } } },
+    { "set 2, d", { { 2, { 0xCB, 0xD2 } }, { 2, { 0xCB, 0xD2 } }, { 2, { 0xCB, 0xD2 } } } },
+    { "set 2, e", { { 2, { 0xCB, 0xD3 } }, { 2, { 0xCB, 0xD3 } }, { 2, { 0xCB, 0xD3 } } } },
+    { "set 2, h", { { 2, { 0xCB, 0xD4 } }, { 2, { 0xCB, 0xD4 } }, { 2, { 0xCB, 0xD4 } } } },
+    { "set 2, l", { { 2, { 0xCB, 0xD5 } }, { 2, { 0xCB, 0xD5 } }, { 2, { 0xCB, 0xD5 } } } },
+    { "set 2, (hl)", { { 2, { 0xCB, 0xD6 } }, { 2, { 0xCB, 0xD6 } }, { 2, { 0xCB, 0xD6 } } } },
+    { "set 2, a", { { 2, { 0xCB, 0xD7 } }, { 2, { 0xCB, 0xD7 } }, { 2, { 0xCB, 0xD7 } } } },
+    { "set 2, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xD6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xD6 } } } },
+    { "set 2, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xD6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xD6 } } } },
+    { "set 2, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xD6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xD6 } } } },
+    { "set 2, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xD6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xD6 } } } },
+    { "set 3, b", { { 2, { 0xCB, 0xD8 } }, { 2, { 0xCB, 0xD8 } }, { 2, { 0xCB, 0xD8 } } } },
+    { "set 3, c", { { 2, { 0xCB, 0xD9 } }, { 2, { 0xCB, 0xD9 } }, { 2, { 0xCB, 0xD9 } } } },
+    { "set 3, d", { { 2, { 0xCB, 0xDA } }, { 2, { 0xCB, 0xDA } }, { 2, { 0xCB, 0xDA } } } },
+    { "set 3, e", { { 2, { 0xCB, 0xDB } }, { 2, { 0xCB, 0xDB } }, { 2, { 0xCB, 0xDB } } } },
+    { "set 3, h", { { 2, { 0xCB, 0xDC } }, { 2, { 0xCB, 0xDC } }, { 2, { 0xCB, 0xDC } } } },
+    { "set 3, l", { { 2, { 0xCB, 0xDD } }, { 2, { 0xCB, 0xDD } }, { 2, { 0xCB, 0xDD } } } },
+    { "set 3, (hl)", { { 2, { 0xCB, 0xDE } }, { 2, { 0xCB, 0xDE } }, { 2, { 0xCB, 0xDE } } } },
+    { "set 3, a", { { 2, { 0xCB, 0xDF } }, { 2, { 0xCB, 0xDF } }, { 2, { 0xCB, 0xDF } } } },
+    { "set 3, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xDE } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xDE } } } },
+    { "set 3, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xDE } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xDE } } } },
+    { "set 3, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xDE } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xDE } } } },
+    { "set 3, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xDE } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xDE } } } },
+    { "set 4, b", { { 2, { 0xCB, 0xE0 } }, { 2, { 0xCB, 0xE0 } }, { 2, { 0xCB, 0xE0 } } } },
+    { "set 4, c", { { 2, { 0xCB, 0xE1 } }, { 2, { 0xCB, 0xE1 } }, { 2, { 0xCB, 0xE1 } } } },
+    { "set 4, d", { { 2, { 0xCB, 0xE2 } }, { 2, { 0xCB, 0xE2 } }, { 2, { 0xCB, 0xE2 } } } },
+    { "set 4, e", { { 2, { 0xCB, 0xE3 } }, { 2, { 0xCB, 0xE3 } }, { 2, { 0xCB, 0xE3 } } } },
+    { "set 4, h", { { 2, { 0xCB, 0xE4 } }, { 2, { 0xCB, 0xE4 } }, { 2, { 0xCB, 0xE4 } } } },
+    { "set 4, l", { { 2, { 0xCB, 0xE5 } }, { 2, { 0xCB, 0xE5 } }, { 2, { 0xCB, 0xE5 } } } },
+    { "set 4, (hl)", { { 2, { 0xCB, 0xE6 } }, { 2, { 0xCB, 0xE6 } }, { 2, { 0xCB, 0xE6 } } } },
+    { "set 4, a", { { 2, { 0xCB, 0xE7 } }, { 2, { 0xCB, 0xE7 } }, { 2, { 0xCB, 0xE7 } } } },
+    { "set 4, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xE6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xE6 } } } },
+    { "set 4, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xE6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xE6 } } } },
+    { "set 4, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xE6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xE6 } } } },
+    { "set 4, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xE6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xE6 } } } },
+    { "set 5, b", { { 2, { 0xCB, 0xE8 } }, { 2, { 0xCB, 0xE8 } }, { 2, { 0xCB, 0xE8 } } } },
+    { "set 5, c", { { 2, { 0xCB, 0xE9 } }, { 2, { 0xCB, 0xE9 } }, { 2, { 0xCB, 0xE9 } } } },
+    { "set 5, d", { { 2, { 0xCB, 0xEA } }, { 2, { 0xCB, 0xEA } }, { 2, { 0xCB, 0xEA } } } },
+    { "set 5, e", { { 2, { 0xCB, 0xEB } }, { 2, { 0xCB, 0xEB } }, { 2, { 0xCB, 0xEB } } } },
+    { "set 5, h", { { 2, { 0xCB, 0xEC } }, { 2, { 0xCB, 0xEC } }, { 2, { 0xCB, 0xEC } } } },
+    { "set 5, l", { { 2, { 0xCB, 0xED } }, { 2, { 0xCB, 0xED } }, { 2, { 0xCB, 0xED } } } },
+    { "set 5, (hl)", { { 2, { 0xCB, 0xEE } }, { 2, { 0xCB, 0xEE } }, { 2, { 0xCB, 0xEE } } } },
+    { "set 5, a", { { 2, { 0xCB, 0xEF } }, { 2, { 0xCB, 0xEF } }, { 2, { 0xCB, 0xEF } } } },
+    { "set 5, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xEE } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xEE } } } },
+    { "set 5, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xEE } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xEE } } } },
+    { "set 5, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xEE } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xEE } } } },
+    { "set 5, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xEE } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xEE } } } },
+    { "set 6, b", { { 2, { 0xCB, 0xF0 } }, { 2, { 0xCB, 0xF0 } }, { 2, { 0xCB, 0xF0 } } } },
+    { "set 6, c", { { 2, { 0xCB, 0xF1 } }, { 2, { 0xCB, 0xF1 } }, { 2, { 0xCB, 0xF1 } } } },
+    { "set 6, d", { { 2, { 0xCB, 0xF2 } }, { 2, { 0xCB, 0xF2 } }, { 2, { 0xCB, 0xF2 } } } },
+    { "set 6, e", { { 2, { 0xCB, 0xF3 } }, { 2, { 0xCB, 0xF3 } }, { 2, { 0xCB, 0xF3 } } } },
+    { "set 6, h", { { 2, { 0xCB, 0xF4 } }, { 2, { 0xCB, 0xF4 } }, { 2, { 0xCB, 0xF4 } } } },
+    { "set 6, l", { { 2, { 0xCB, 0xF5 } }, { 2, { 0xCB, 0xF5 } }, { 2, { 0xCB, 0xF5 } } } },
+    { "set 6, (hl)", { { 2, { 0xCB, 0xF6 } }, { 2, { 0xCB, 0xF6 } }, { 2, { 0xCB, 0xF6 } } } },
+    { "set 6, a", { { 2, { 0xCB, 0xF7 } }, { 2, { 0xCB, 0xF7 } }, { 2, { 0xCB, 0xF7 } } } },
+    { "set 6, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xF6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xF6 } } } },
+    { "set 6, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xF6 } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xF6 } } } },
+    { "set 6, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xF6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xF6 } } } },
+    { "set 6, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xF6 } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xF6 } } } },
+    { "set 7, b", { { 2, { 0xCB, 0xF8 } }, { 2, { 0xCB, 0xF8 } }, { 2, { 0xCB, 0xF8 } } } },
+    { "set 7, c", { { 2, { 0xCB, 0xF9 } }, { 2, { 0xCB, 0xF9 } }, { 2, { 0xCB, 0xF9 } } } },
+    { "set 7, d", { { 2, { 0xCB, 0xFA } }, { 2, { 0xCB, 0xFA } }, { 2, { 0xCB, 0xFA } } } },
+    { "set 7, e", { { 2, { 0xCB, 0xFB } }, { 2, { 0xCB, 0xFB } }, { 2, { 0xCB, 0xFB } } } },
+    { "set 7, h", { { 2, { 0xCB, 0xFC } }, { 2, { 0xCB, 0xFC } }, { 2, { 0xCB, 0xFC } } } },
+    { "set 7, l", { { 2, { 0xCB, 0xFD } }, { 2, { 0xCB, 0xFD } }, { 2, { 0xCB, 0xFD } } } },
+    { "set 7, (hl)", { { 2, { 0xCB, 0xFE } }, { 2, { 0xCB, 0xFE } }, { 2, { 0xCB, 0xFE } } } },
+    { "set 7, a", { { 2, { 0xCB, 0xFF } }, { 2, { 0xCB, 0xFF } }, { 2, { 0xCB, 0xFF } } } },
+    { "set 7, (ix+5)", { { 4, { 0xDD, 0xCB, 0x05, 0xFE } }, { -1 }, { 4, { 0xDD, 0xCB, 0x05, 0xFE } } } },
+    { "set 7, (ix-3)", { { 4, { 0xDD, 0xCB, 0xFD, 0xFE } }, { -1 }, { 4, { 0xDD, 0xCB, 0xFD, 0xFE } } } },
+    { "set 7, (iy+5)", { { 4, { 0xFD, 0xCB, 0x05, 0xFE } }, { -1 }, { 4, { 0xFD, 0xCB, 0x05, 0xFE } } } },
+    { "set 7, (iy-3)", { { 4, { 0xFD, 0xCB, 0xFD, 0xFE } }, { -1 }, { 4, { 0xFD, 0xCB, 0xFD, 0xFE } } } },
+    { "jp 4660", { { 3, { 0xC3, 0x34, 0x12 } }, { 3, { 0xC3, 0x34, 0x12 } }, { 3, { 0xC3, 0x34, 0x12 } } } },
+    { "call 4660", { { 3, { 0xCD, 0x34, 0x12 } }, { 3, { 0xCD, 0x34, 0x12 } }, { 3, { 0xCD, 0x34, 0x12 } } } },
+    { "ret", { { 1, { 0xC9 } }, { 1, { 0xC9 } }, { 1, { 0xC9 } } } },
+    { "jp (hl)", { { 1, { 0xE9 } }, { 1, { 0xE9 } }, { 1, { 0xE9 } } } },
+    { "jp (ix)", { { 2, { 0xDD, 0xE9 } }, { -1 }, { 2, { 0xDD, 0xE9 } } } },
+    { "jp (iy)", { { 2, { 0xFD, 0xE9 } }, { -1 }, { 2, { 0xFD, 0xE9 } } } },
+    { "jp nz, 4660", { { 3, { 0xC2, 0x34, 0x12 } }, { 3, { 0xC2, 0x34, 0x12 } }, { 3, { 0xC2, 0x34, 0x12 } } } },
+    { "call nz, 4660", { { 3, { 0xC4, 0x34, 0x12 } }, { 3, { 0xC4, 0x34, 0x12 } }, { 3, { 0xC4, 0x34, 0x12 } } } },
+    { "ret nz", { { 1, { 0xC0 } }, { 1, { 0xC0 } }, { 1, { 0xC0 } } } },
+    { "jr nz, $+10", { { 2, { 0x20, 0x08 } }, { 2, { 0x20, 0x08 } }, { 2, { 0x20, 0x08 } } } },
+    { "jp z, 4660", { { 3, { 0xCA, 0x34, 0x12 } }, { 3, { 0xCA, 0x34, 0x12 } }, { 3, { 0xCA, 0x34, 0x12 } } } },
+    { "call z, 4660", { { 3, { 0xCC, 0x34, 0x12 } }, { 3, { 0xCC, 0x34, 0x12 } }, { 3, { 0xCC, 0x34, 0x12 } } } },
+    { "ret z", { { 1, { 0xC8 } }, { 1, { 0xC8 } }, { 1, { 0xC8 } } } },
+    { "jr z, $+10", { { 2, { 0x28, 0x08 } }, { 2, { 0x28, 0x08 } }, { 2, { 0x28, 0x08 } } } },
+    { "jp nc, 4660", { { 3, { 0xD2, 0x34, 0x12 } }, { 3, { 0xD2, 0x34, 0x12 } }, { 3, { 0xD2, 0x34, 0x12 } } } },
+    { "call nc, 4660", { { 3, { 0xD4, 0x34, 0x12 } }, { 3, { 0xD4, 0x34, 0x12 } }, { 3, { 0xD4, 0x34, 0x12 } } } },
+    { "ret nc", { { 1, { 0xD0 } }, { 1, { 0xD0 } }, { 1, { 0xD0 } } } },
+    { "jr nc, $+10", { { 2, { 0x30, 0x08 } }, { 2, { 0x30, 0x08 } }, { 2, { 0x30, 0x08 } } } },
+    { "jp c, 4660", { { 3, { 0xDA, 0x34, 0x12 } }, { 3, { 0xDA, 0x34, 0x12 } }, { 3, { 0xDA, 0x34, 0x12 } } } },
+    { "call c, 4660", { { 3, { 0xDC, 0x34, 0x12 } }, { 3, { 0xDC, 0x34, 0x12 } }, { 3, { 0xDC, 0x34, 0x12 } } } },
+    { "ret c", { { 1, { 0xD8 } }, { 1, { 0xD8 } }, { 1, { 0xD8 } } } },
+    { "jr c, $+10", { { 2, { 0x38, 0x08 } }, { 2, { 0x38, 0x08 } }, { 2, { 0x38, 0x08 } } } },
+    { "jp po, 4660", { { 3, { 0xE2, 0x34, 0x12 } }, { -1 }, { 3, { 0xE2, 0x34, 0x12 } } } },
+    { "call po, 4660", { { 3, { 0xE4, 0x34, 0x12 } }, { -1 }, { 3, { 0xE4, 0x34, 0x12 } } } },
+    { "ret po", { { 1, { 0xE0 } }, { -1 }, { 1, { 0xE0 } } } },
+    { "jp pe, 4660", { { 3, { 0xEA, 0x34, 0x12 } }, { -1 }, { 3, { 0xEA, 0x34, 0x12 } } } },
+    { "call pe, 4660", { { 3, { 0xEC, 0x34, 0x12 } }, { -1 }, { 3, { 0xEC, 0x34, 0x12 } } } },
+    { "ret pe", { { 1, { 0xE8 } }, { -1 }, { 1, { 0xE8 } } } },
+    { "jp p, 4660", { { 3, { 0xF2, 0x34, 0x12 } }, { -1 }, { 3, { 0xF2, 0x34, 0x12 } } } },
+    { "call p, 4660", { { 3, { 0xF4, 0x34, 0x12 } }, { -1 }, { 3, { 0xF4, 0x34, 0x12 } } } },
+    { "ret p", { { 1, { 0xF0 } }, { -1 }, { 1, { 0xF0 } } } },
+    { "jp m, 4660", { { 3, { 0xFA, 0x34, 0x12 } }, { -1 }, { 3, { 0xFA, 0x34, 0x12 } } } },
+    { "call m, 4660", { { 3, { 0xFC, 0x34, 0x12 } }, { -1 }, { 3, { 0xFC, 0x34, 0x12 } } } },
+    { "ret m", { { 1, { 0xF8 } }, { -1 }, { 1, { 0xF8 } } } },
+    { "jr $+10", { { 2, { 0x18, 0x08 } }, { 2, { 0x18, 0x08 } }, { 2, { 0x18, 0x08 } } } },
+    { "jr $-10", { { 2, { 0x18, 0xF4 } }, { 2, { 0x18, 0xF4 } }, { 2, { 0x18, 0xF4 } } } },
+    { "djnz $+10", { { 2, { 0x10, 0x08 } }, { -1 }, { 2, { 0x10, 0x08 } } } },
+    { "djnz $-10", { { 2, { 0x10, 0xF4 } }, { -1 }, { 2, { 0x10, 0xF4 } } } },
+    { "reti", { { 2, { 0xED, 0x4D } }, { 1, { 0xD9 } }, { 2, { 0xED, 0x4D } } } },
+    { "retn", { { 2, { 0xED, 0x45 } }, { -1 }, { 2, { 0xED, 0x45 } } } },
+    { "rst 0", { { 1, { 0xC7 } }, { 1, { 0xC7 } }, { 1, { 0xC7 } } } },
+    { "rst 8", { { 1, { 0xCF } }, { 1, { 0xCF } }, { 1, { 0xCF } } } },
+    { "rst 16", { { 1, { 0xD7 } }, { 1, { 0xD7 } }, { 1, { 0xD7 } } } },
+    { "rst 24", { { 1, { 0xDF } }, { 1, { 0xDF } }, { 1, { 0xDF } } } },
+    { "rst 32", { { 1, { 0xE7 } }, { 1, { 0xE7 } }, { 1, { 0xE7 } } } },
+    { "rst 40", { { 1, { 0xEF } }, { 1, { 0xEF } }, { 1, { 0xEF } } } },
+    { "rst 48", { { 1, { 0xF7 } }, { 1, { 0xF7 } }, { 1, { 0xF7 } } } },
+    { "rst 56", { { 1, { 0xFF } }, { 1, { 0xFF } }, { 1, { 0xFF } } } },
+    { "in a, (18)", { { 2, { 0xDB, 0x12 } }, { -1 }, { 2, { 0xDB, 0x12 } } } },
+    { "out (18), a", { { 2, { 0xD3, 0x12 } }, { -1 }, { 2, { 0xD3, 0x12 } } } },
+    { "in b, (c)", { { 2, { 0xED, 0x40 } }, { -1 }, { 2, { 0xED, 0x40 } } } },
+    { "out (c), b", { { 2, { 0xED, 0x41 } }, { -1 }, { 2, { 0xED, 0x41 } } } },
+    { "in c, (c)", { { 2, { 0xED, 0x48 } }, { -1 }, { 2, { 0xED, 0x48 } } } },
+    { "out (c), c", { { 2, { 0xED, 0x49 } }, { -1 }, { 2, { 0xED, 0x49 } } } },
+    { "in d, (c)", { { 2, { 0xED, 0x50 } }, { -1 }, { 2, { 0xED, 0x50 } } } },
+    { "out (c), d", { { 2, { 0xED, 0x51 } }, { -1 }, { 2, { 0xED, 0x51 } } } },
+    { "in e, (c)", { { 2, { 0xED, 0x58 } }, { -1 }, { 2, { 0xED, 0x58 } } } },
+    { "out (c), e", { { 2, { 0xED, 0x59 } }, { -1 }, { 2, { 0xED, 0x59 } } } },
+    { "in h, (c)", { { 2, { 0xED, 0x60 } }, { -1 }, { 2, { 0xED, 0x60 } } } },
+    { "out (c), h", { { 2, { 0xED, 0x61 } }, { -1 }, { 2, { 0xED, 0x61 } } } },
+    { "in l, (c)", { { 2, { 0xED, 0x68 } }, { -1 }, { 2, { 0xED, 0x68 } } } },
+    { "out (c), l", { { 2, { 0xED, 0x69 } }, { -1 }, { 2, { 0xED, 0x69 } } } },
+    { "in a, (c)", { { 2, { 0xED, 0x78 } }, { -1 }, { 2, { 0xED, 0x78 } } } },
+    { "out (c), a", { { 2, { 0xED, 0x79 } }, { -1 }, { 2, { 0xED, 0x79 } } } },
+    { "in f, (c)", { { 2, { 0xED, 0x70 } }, { -1 }, { 2, { 0xED, 0x70 } } } },
+    { "mulub a, b", { { -1 }, { -1 }, { 2, { 0xED, 0xC1 } } } },
+    { "mulub a, c", { { -1 }, { -1 }, { 2, { 0xED, 0xC9 } } } },
+    { "mulub a, d", { { -1 }, { -1 }, { 2, { 0xED, 0xD1 } } } },
+    { "mulub a, e", { { -1 }, { -1 }, { 2, { 0xED, 0xD9 } } } },
+    { "mulub a, h", { { -1 }, { -1 }, { 2, { 0xED, 0xE1 } } } },
+    { "mulub a, l", { { -1 }, { -1 }, { 2, { 0xED, 0xE9 } } } },
+    { "mulub a, a", { { -1 }, { -1 }, { 2, { 0xED, 0xF9 } } } },
+    { "muluw hl, bc", { { -1 }, { -1 }, { 2, { 0xED, 0xC3 } } } },
+    { "muluw hl, sp", { { -1 }, { -1 }, { 2, { 0xED, 0xF3 } } } },
+    { "db 18", { { 1, { 0x12 } }, { 1, { 0x12 } }, { 1, { 0x12 } } } },
+    { "db 1, 2, 3", { { 3, { 0x01, 0x02, 0x03 } }, { 3, { 0x01, 0x02, 0x03 } }, { 3, { 0x01, 0x02, 0x03 } } } },
+};
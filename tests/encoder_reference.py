@@ -0,0 +1,271 @@
+# Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+# All rights reserved.
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+
+# 1. Redistributions of source code must retain the above copyright notice, this
+# list of conditions and the following disclaimer.
+
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Writes encoder_reference.h, the reference encodings used by encoder_test.c
+#
+# The encodings are derived here from the opcode tables of the Z80, the Game Boy CPU
+# and the R800 (MSX) instead of from the assembler, so that they can be used to check it.
+# Every instruction form is listed with its encoding for each cpu type, or with none
+# when the cpu type does not have it.
+
+R = ["b", "c", "d", "e", "h", "l", "(hl)", "a"]
+RP = ["bc", "de", "hl", "sp"]
+RP2 = ["bc", "de", "hl", "af"]
+CC = ["nz", "z", "nc", "c", "po", "pe", "p", "m"]
+ALU = ["add a,", "adc a,", "sub", "sbc a,", "and", "xor", "or", "cp"]
+ROT = ["rlc", "rrc", "rl", "rr", "sla", "sra", "sll", "srl"]
+INDEX = [("ix", 0xDD), ("iy", 0xFD)]
+
+# Operands used for each form
+N = 0x12
+NN = 0x1234
+OFFSETS = [5, -3]
+
+ops = []
+
+def add(text, z80=None, gb=None, msx="z80"):
+    """Adds a form with its bytes for each cpu type, the R800 has the Z80 ones unless given"""
+    ops.append((text, z80, gb, z80 if msx == "z80" else msx))
+
+def addAll(text, encoding):
+    add(text, encoding, encoding)
+
+def low(value):
+    return value & 0xFF
+
+def word(value):
+    return [value & 0xFF, (value >> 8) & 0xFF]
+
+def indexed(name, offset):
+    return f"({name}+{offset})" if offset >= 0 else f"({name}{offset})"
+
+def alu(i, operand):
+    return f"{ALU[i]} {operand}"
+
+def addLoads():
+    for i, destination in enumerate(R):
+        for j, source in enumerate(R):
+            if i != 6 or j != 6:
+                addAll(f"ld {destination}, {source}", [0x40 + 8 * i + j])
+        addAll(f"ld {destination}, {N}", [0x06 + 8 * i, N])
+    for name, prefix in INDEX:
+        for offset in OFFSETS:
+            for i, register in enumerate(R):
+                if i != 6:
+                    add(f"ld {register}, {indexed(name, offset)}", [prefix, 0x46 + 8 * i, low(offset)])
+                    add(f"ld {indexed(name, offset)}, {register}", [prefix, 0x70 + i, low(offset)])
+            add(f"ld {indexed(name, offset)}, {N}", [prefix, 0x36, low(offset), N])
+        # halves of the index registers take the place of h and l
+        halves = {4: name + "h", 5: name + "l"}
+        for i, destination in enumerate(R):
+            for j, source in enumerate(R):
+                if i != 6 and j != 6 and (i in halves or j in halves):
+                    add(f"ld {halves.get(i, destination)}, {halves.get(j, source)}", [prefix, 0x40 + 8 * i + j])
+            if i in halves:
+                add(f"ld {halves[i]}, {N}", [prefix, 0x06 + 8 * i, N])
+    addAll("ld a, (bc)", [0x0A])
+    addAll("ld a, (de)", [0x1A])
+    addAll("ld (bc), a", [0x02])
+    addAll("ld (de), a", [0x12])
+    add(f"ld a, ({NN})", [0x3A] + word(NN), [0xFA] + word(NN))
+    add(f"ld ({NN}), a", [0x32] + word(NN), [0xEA] + word(NN))
+    add("ld a, i", [0xED, 0x57])
+    add("ld a, r", [0xED, 0x5F])
+    add("ld i, a", [0xED, 0x47])
+    add("ld r, a", [0xED, 0x4F])
+    add("ld a, (c)", None, [0xF2])
+    add("ld (c), a", None, [0xE2])
+    for i, pair in enumerate(RP):
+        addAll(f"ld {pair}, {NN}", [0x01 + 16 * i] + word(NN))
+        if pair == "hl":
+            add(f"ld hl, ({NN})", [0x2A] + word(NN))
+            add(f"ld ({NN}), hl", [0x22] + word(NN))
+        else:
+            add(f"ld {pair}, ({NN})", [0xED, 0x4B + 16 * i] + word(NN))
+            add(f"ld ({NN}), {pair}", [0xED, 0x43 + 16 * i] + word(NN), [0x08] + word(NN) if pair == "sp" else None)
+    addAll("ld sp, hl", [0xF9])
+    for name, prefix in INDEX:
+        add(f"ld {name}, {NN}", [prefix, 0x21] + word(NN))
+        add(f"ld {name}, ({NN})", [prefix, 0x2A] + word(NN))
+        add(f"ld ({NN}), {name}", [prefix, 0x22] + word(NN))
+        add(f"ld sp, {name}", [prefix, 0xF9])
+    # Game Boy loads with increment and decrement, and to the high memory
+    add("ldi (hl), a", None, [0x22])
+    add("ldi a, (hl)", None, [0x2A])
+    add("ldd (hl), a", None, [0x32])
+    add("ldd a, (hl)", None, [0x3A])
+    add(f"ldh a, ({N})", None, [0xF0, N])
+    add(f"ldh ({N}), a", None, [0xE0, N])
+    add(f"ldh a, (0xff{N:02x})", None, [0xF0, N])
+    add(f"ldh (0xff{N:02x}), a", None, [0xE0, N])
+    for offset in OFFSETS:
+        add(f"ldhl sp, {offset}", None, [0xF8, low(offset)])
+
+def addStackAndExchanges():
+    for i, pair in enumerate(RP2):
+        addAll(f"push {pair}", [0xC5 + 16 * i])
+        addAll(f"pop {pair}", [0xC1 + 16 * i])
+    for name, prefix in INDEX:
+        add(f"push {name}", [prefix, 0xE5])
+        add(f"pop {name}", [prefix, 0xE1])
+        add(f"ex (sp), {name}", [prefix, 0xE3])
+    add("ex af, af'", [0x08])
+    add("ex de, hl", [0xEB])
+    add("ex (sp), hl", [0xE3])
+    add("exx", [0xD9])
+
+def addBlocks():
+    for text, opcode in [("ldi", 0xA0), ("cpi", 0xA1), ("ini", 0xA2), ("outi", 0xA3), ("ldd", 0xA8), ("cpd", 0xA9), ("ind", 0xAA), ("outd", 0xAB),
+                         ("ldir", 0xB0), ("cpir", 0xB1), ("inir", 0xB2), ("otir", 0xB3), ("lddr", 0xB8), ("cpdr", 0xB9), ("indr", 0xBA), ("otdr", 0xBB)]:
+        add(text, [0xED, opcode])
+
+def addArithmetic():
+    for i in range(len(ALU)):
+        for j, register in enumerate(R):
+            addAll(alu(i, register), [0x80 + 8 * i + j])
+        addAll(alu(i, N), [0xC6 + 8 * i, N])
+        for name, prefix in INDEX:
+            for offset in OFFSETS:
+                add(alu(i, indexed(name, offset)), [prefix, 0x86 + 8 * i, low(offset)])
+            add(alu(i, name + "h"), [prefix, 0x84 + 8 * i])
+            add(alu(i, name + "l"), [prefix, 0x85 + 8 * i])
+    for i, register in enumerate(R):
+        addAll(f"inc {register}", [0x04 + 8 * i])
+        addAll(f"dec {register}", [0x05 + 8 * i])
+    for name, prefix in INDEX:
+        for offset in OFFSETS:
+            add(f"inc {indexed(name, offset)}", [prefix, 0x34, low(offset)])
+            add(f"dec {indexed(name, offset)}", [prefix, 0x35, low(offset)])
+        add(f"inc {name}h", [prefix, 0x24])
+        add(f"inc {name}l", [prefix, 0x2C])
+        add(f"dec {name}h", [prefix, 0x25])
+        add(f"dec {name}l", [prefix, 0x2D])
+        add(f"inc {name}", [prefix, 0x23])
+        add(f"dec {name}", [prefix, 0x2B])
+        for i, pair in enumerate(["bc", "de", name, "sp"]):
+            add(f"add {name}, {pair}", [prefix, 0x09 + 16 * i])
+    for i, pair in enumerate(RP):
+        addAll(f"inc {pair}", [0x03 + 16 * i])
+        addAll(f"dec {pair}", [0x0B + 16 * i])
+        addAll(f"add hl, {pair}", [0x09 + 16 * i])
+        add(f"adc hl, {pair}", [0xED, 0x4A + 16 * i])
+        add(f"sbc hl, {pair}", [0xED, 0x42 + 16 * i])
+    for offset in OFFSETS:
+        add(f"add sp, {offset}", None, [0xE8, low(offset)])
+
+def addGeneral():
+    for text, opcode in [("nop", 0x00), ("rlca", 0x07), ("rrca", 0x0F), ("rla", 0x17), ("rra", 0x1F), ("daa", 0x27), ("cpl", 0x2F),
+                         ("scf", 0x37), ("ccf", 0x3F), ("halt", 0x76), ("di", 0xF3), ("ei", 0xFB)]:
+        addAll(text, [opcode])
+    add("neg", [0xED, 0x44])
+    add("rrd", [0xED, 0x67])
+    add("rld", [0xED, 0x6F])
+    add("im 0", [0xED, 0x46])
+    add("im 1", [0xED, 0x56])
+    add("im 2", [0xED, 0x5E])
+    add("stop", None, [0x10, 0x00])
+
+def addRotatesAndBits():
+    # sll is undocumented on the Z80, the R800 does not have it and on the Game Boy its opcode is swap
+    for i, operation in enumerate(ROT):
+        for j, register in enumerate(R):
+            if operation == "sll":
+                add(f"sll {register}", [0xCB, 0x30 + j], None, None)
+            else:
+                addAll(f"{operation} {register}", [0xCB, 8 * i + j])
+        for name, prefix in INDEX:
+            for offset in OFFSETS:
+                encoding = [prefix, 0xCB, low(offset), 8 * i + 6]
+                add(f"{operation} {indexed(name, offset)}", encoding, None, None if operation == "sll" else "z80")
+    for j, register in enumerate(R):
+        add(f"swap {register}", None, [0xCB, 0x30 + j])
+    for k, operation in [(1, "bit"), (2, "res"), (3, "set")]:
+        for bit in range(8):
+            for j, register in enumerate(R):
+                addAll(f"{operation} {bit}, {register}", [0xCB, 0x40 * k + 8 * bit + j])
+            for name, prefix in INDEX:
+                for offset in OFFSETS:
+                    add(f"{operation} {bit}, {indexed(name, offset)}", [prefix, 0xCB, low(offset), 0x40 * k + 8 * bit + 6])
+
+def addJumps():
+    addAll(f"jp {NN}", [0xC3] + word(NN))
+    addAll(f"call {NN}", [0xCD] + word(NN))
+    addAll("ret", [0xC9])
+    addAll("jp (hl)", [0xE9])
+    for name, prefix in INDEX:
+        add(f"jp ({name})", [prefix, 0xE9])
+    # the Game Boy only has the first four conditions
+    for i, condition in enumerate(CC):
+        addCondition = addAll if i < 4 else add
+        addCondition(f"jp {condition}, {NN}", [0xC2 + 8 * i] + word(NN))
+        addCondition(f"call {condition}, {NN}", [0xC4 + 8 * i] + word(NN))
+        addCondition(f"ret {condition}", [0xC0 + 8 * i])
+        if i < 4:
+            addAll(f"jr {condition}, $+10", [0x20 + 8 * i, 8])
+    # relative jumps are from the address after the instruction
+    addAll("jr $+10", [0x18, 8])
+    addAll("jr $-10", [0x18, low(-12)])
+    add("djnz $+10", [0x10, 8])
+    add("djnz $-10", [0x10, low(-12)])
+    add("reti", [0xED, 0x4D], [0xD9])
+    add("retn", [0xED, 0x45])
+    for address in range(0, 0x40, 8):
+        addAll(f"rst {address}", [0xC7 + address])
+
+def addInputOutput():
+    add(f"in a, ({N})", [0xDB, N])
+    add(f"out ({N}), a", [0xD3, N])
+    for i, register in enumerate(R):
+        if i != 6:
+            add(f"in {register}, (c)", [0xED, 0x40 + 8 * i])
+            add(f"out (c), {register}", [0xED, 0x41 + 8 * i])
+    add("in f, (c)", [0xED, 0x70])
+
+def addR800():
+    for j, register in enumerate(R):
+        if j != 6:
+            add(f"mulub a, {register}", None, None, [0xED, 0xC1 + 8 * j])
+    add("muluw hl, bc", None, None, [0xED, 0xC3])
+    add("muluw hl, sp", None, None, [0xED, 0xF3])
+
+def addData():
+    addAll(f"db {N}", [N])
+    addAll("db 1, 2, 3", [1, 2, 3])
+
+def formatEncoding(encoding):
+    if encoding is None:
+        return "{ -1 }"
+    return "{ %d, { %s } }" % (len(encoding), ", ".join(f"0x{value:02X}" for value in encoding))
+
+if __name__ == "__main__":
+    for addForms in [addLoads, addStackAndExchanges, addBlocks, addArithmetic, addGeneral, addRotatesAndBits, addJumps, addInputOutput, addR800, addData]:
+        addForms()
+    with open("encoder_reference.h", mode='w', newline='\n') as file:
+        file.write("// Generated by encoder_reference.py, reference encodings of every instruction form\n")
+        file.write("// for CPU_TYPE_Z80, CPU_TYPE_GB and CPU_TYPE_MSX (a length of -1 when it does not have it)\n\n")
+        file.write("static struct ReferenceOp reference_ops[] = {\n")
+        for text, z80, gb, msx in ops:
+            file.write('    { "%s", { %s, %s, %s } },\n' % (text, formatEncoding(z80), formatEncoding(gb), formatEncoding(msx)))
+        file.write("};\n")
+    print(f"{len(ops)} instruction forms written to encoder_reference.h")
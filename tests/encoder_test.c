@@ -0,0 +1,370 @@
+/*
+    Copyright (c) 2023, Sérgio Vieira <internalregister@gmail.com>
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Test and benchmark of the encoder: every instruction form of encoder_reference.h is encoded
+// for each cpu type and compared with its reference encoding, first through compile_op (length
+// and whether it is valid) and then assembled (the bytes written), then the instructions are
+// encoded repeatedly to measure how many are encoded per second, only computing their length
+// and also adding them to the output
+
+#include "../src/z80hla.h"
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define close _close
+#define NULL_DEVICE "NUL"
+#else
+#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+#define CPU_TYPES_COUNT 3
+#define MAX_REFERENCE_BYTES 4
+#define DEFAULT_ROUNDS 200
+
+#define SOURCE_FILENAME "encoder_test.z80hla"
+#define OUTPUT_FILENAME "encoder_test.bin"
+
+struct ReferenceEncoding
+{
+    int length; // -1 when the instruction is not valid for the cpu type
+    uint8_t bytes[MAX_REFERENCE_BYTES];
+};
+
+struct ReferenceOp
+{
+    char *text;
+    struct ReferenceEncoding encodings[CPU_TYPES_COUNT]; // indexed by enum CPUType
+};
+
+#include "encoder_reference.h"
+
+#define REFERENCE_OPS_COUNT ((int)(sizeof(reference_ops) / sizeof(reference_ops[0])))
+
+static char *cpu_type_names[CPU_TYPES_COUNT] = { "z80", "gb", "msx" };
+
+// Writes the instructions valid for a cpu type to the source file, or all of them when it is -1
+static int write_source(int cpu_type)
+{
+    FILE *fp = fopen(SOURCE_FILENAME, "w");
+    if (!fp)
+    {
+        printf("Cannot open file \"%s\" to write\n", SOURCE_FILENAME);
+        return 1;
+    }
+
+    if (cpu_type >= 0)
+    {
+        fprintf(fp, "#cpu_type \"%s\"\n", cpu_type_names[cpu_type]);
+    }
+    fprintf(fp, "#origin 0\n");
+    for(int i = 0; i < REFERENCE_OPS_COUNT; i++)
+    {
+        if (cpu_type < 0 || reference_ops[i].encodings[cpu_type].length >= 0)
+        {
+            fprintf(fp, "%s\n", reference_ops[i].text);
+        }
+    }
+    fclose(fp);
+
+    return 0;
+}
+
+// Parses every instruction, keeping their nodes in the order of the reference table
+static int parse_reference_ops(struct Lexer *lexer, struct ASTNode **op_nodes)
+{
+    if (write_source(-1) || init_lexer(lexer, SOURCE_FILENAME)) { return 1; }
+
+    push_include_file(lexer->filename);
+    struct ASTNode *first_node = parse(lexer, NULL, NULL);
+    pop_include_file();
+    if (first_node == NULL) { return 1; }
+
+    int count = 0;
+    for(struct ASTNode *current_node = first_node; current_node != NULL && current_node->children_count > 0; current_node = current_node->children[1])
+    {
+        if (current_node->children[0]->type == NODE_TYPE_OP && count < REFERENCE_OPS_COUNT)
+        {
+            op_nodes[count++] = current_node->children[0];
+        }
+    }
+    if (count != REFERENCE_OPS_COUNT)
+    {
+        printf("%d instructions parsed, %d expected\n", count, REFERENCE_OPS_COUNT);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Checks that compile_op accepts the instructions valid for each cpu type with their length
+// and rejects the others
+static int check_lengths(struct ASTNode **op_nodes)
+{
+    int failures = 0;
+
+    for(int cpu_type = 0; cpu_type < CPU_TYPES_COUNT; cpu_type++)
+    {
+        context->cpu_type = (enum CPUType)cpu_type;
+        for(int i = 0; i < REFERENCE_OPS_COUNT; i++)
+        {
+            struct ReferenceEncoding *encoding = &reference_ops[i].encodings[cpu_type];
+            int length = 0;
+
+            hold_messages(TRUE);
+            int result = compile_op(op_nodes[i], FALSE, &length);
+            free(take_held_messages());
+            hold_messages(FALSE);
+
+            if (encoding->length < 0 && !result)
+            {
+                printf("[%s] \"%s\": accepted, it should be invalid\n", cpu_type_names[cpu_type], reference_ops[i].text);
+                failures++;
+            }
+            else if (encoding->length >= 0 && result)
+            {
+                printf("[%s] \"%s\": rejected, it should be valid\n", cpu_type_names[cpu_type], reference_ops[i].text);
+                failures++;
+            }
+            else if (encoding->length >= 0 && length != encoding->length)
+            {
+                printf("[%s] \"%s\": length %d, it should be %d\n", cpu_type_names[cpu_type], reference_ops[i].text, length, encoding->length);
+                failures++;
+            }
+        }
+    }
+
+    return failures;
+}
+
+// Assembles a file with the instructions of a cpu type with the standard output discarded,
+// returns the bytes written and their number in size
+static uint8_t *assemble_reference_ops(int cpu_type, int *size)
+{
+    if (write_source(cpu_type)) { return NULL; }
+
+    struct Z80HLAContext *compile_context = create_context();
+    compile_context->input_filename = SOURCE_FILENAME;
+    compile_context->compiler_output_filename = OUTPUT_FILENAME;
+    compile_context->thread_count = 1;
+    remove(OUTPUT_FILENAME);
+
+    fflush(stdout);
+    int stdout_fd = dup(1);
+    int null_fd = open(NULL_DEVICE, O_WRONLY);
+    if (null_fd >= 0)
+    {
+        dup2(null_fd, 1);
+        close(null_fd);
+    }
+    int result = assemble(compile_context);
+    fflush(stdout);
+    dup2(stdout_fd, 1);
+    close(stdout_fd);
+
+    BOOL has_errors = compile_context->has_errors;
+    destroy_context(compile_context);
+    if (result || has_errors)
+    {
+        printf("[%s] Error assembling the instructions\n", cpu_type_names[cpu_type]);
+        return NULL;
+    }
+
+    FILE *fp = fopen(OUTPUT_FILENAME, "rb");
+    if (!fp)
+    {
+        printf("Cannot open file \"%s\" to read\n", OUTPUT_FILENAME);
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    *size = (int)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *bytes = (uint8_t *)malloc(MAX(1, *size));
+    if ((int)fread(bytes, 1, *size, fp) != *size)
+    {
+        *size = 0;
+    }
+    fclose(fp);
+    remove(OUTPUT_FILENAME);
+
+    return bytes;
+}
+
+// Checks the bytes written for the instructions of each cpu type, after the first one that
+// differs the rest are not compared as they may no longer be aligned
+static int check_encodings()
+{
+    int failures = 0;
+
+    for(int cpu_type = 0; cpu_type < CPU_TYPES_COUNT; cpu_type++)
+    {
+        int size = 0, offset = 0;
+        uint8_t *bytes = assemble_reference_ops(cpu_type, &size);
+        if (bytes == NULL)
+        {
+            failures++;
+            continue;
+        }
+
+        for(int i = 0; i < REFERENCE_OPS_COUNT; i++)
+        {
+            struct ReferenceEncoding *encoding = &reference_ops[i].encodings[cpu_type];
+            if (encoding->length < 0) { continue; }
+
+            if (offset + encoding->length > size || memcmp(bytes + offset, encoding->bytes, encoding->length))
+            {
+                printf("[%s] \"%s\": bytes", cpu_type_names[cpu_type], reference_ops[i].text);
+                for(int j = 0; j < encoding->length && offset + j < size; j++)
+                {
+                    printf(" %02X", bytes[offset + j]);
+                }
+                printf(", they should be");
+                for(int j = 0; j < encoding->length; j++)
+                {
+                    printf(" %02X", encoding->bytes[j]);
+                }
+                printf("\n");
+                failures++;
+                break;
+            }
+            offset += encoding->length;
+        }
+        if (!failures && offset != size)
+        {
+            printf("[%s] %d bytes written, %d expected\n", cpu_type_names[cpu_type], size, offset);
+            failures++;
+        }
+        free(bytes);
+    }
+
+    return failures;
+}
+
+static void free_output_elements()
+{
+    struct OutputElement *elem = context->first_output_elem;
+    while (elem != NULL)
+    {
+        struct OutputElement *next = elem->next;
+        free(elem);
+        elem = next;
+    }
+    context->first_output_elem = context->last_output_elem = NULL;
+}
+
+// Encodes the instructions valid for each cpu type a number of rounds and prints the
+// instructions encoded per second
+static void benchmark(struct ASTNode **op_nodes, int rounds, BOOL add_to_output)
+{
+    uint64_t count = 0;
+    int length;
+
+    hold_messages(TRUE);
+    uint64_t start = get_time_nanoseconds();
+    for(int round = 0; round < rounds; round++)
+    {
+        for(int cpu_type = 0; cpu_type < CPU_TYPES_COUNT; cpu_type++)
+        {
+            context->cpu_type = (enum CPUType)cpu_type;
+            if (add_to_output)
+            {
+                free_output_elements();
+                init_compiler();
+            }
+            for(int i = 0; i < REFERENCE_OPS_COUNT; i++)
+            {
+                if (reference_ops[i].encodings[cpu_type].length >= 0)
+                {
+                    compile_op(op_nodes[i], add_to_output, &length);
+                    count++;
+                }
+            }
+        }
+    }
+    uint64_t duration = get_time_nanoseconds() - start;
+    free(take_held_messages());
+    hold_messages(FALSE);
+
+    printf("%-12s %10"PRIu64" instructions in %8.3f ms, %12.0f instructions/s\n", add_to_output ? "Emit:" : "Length only:",
+        count, duration / 1000000.0, duration > 0 ? count * 1000000000.0 / duration : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+    int rounds = DEFAULT_ROUNDS;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if ((!strcmp(argv[i], "-r") || !strcmp(argv[i], "--rounds")) && i + 1 < argc)
+        {
+            rounds = atoi(argv[++i]);
+        }
+        else
+        {
+            printf("Usage: %s [-r|--rounds ROUNDS]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Results are shown as they are found, in case an instruction makes the encoder crash
+    setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+    printf("Z80HLA Encoder Test\n\n");
+
+    context = create_context();
+    init_tables();
+    init_parser();
+    init_compiler();
+
+    struct Lexer lexer;
+    struct ASTNode **op_nodes = (struct ASTNode **)malloc(sizeof(struct ASTNode *) * REFERENCE_OPS_COUNT);
+    if (parse_reference_ops(&lexer, op_nodes))
+    {
+        printf("Error parsing the instructions\n");
+        remove(SOURCE_FILENAME);
+        return 1;
+    }
+
+    int failures = check_lengths(op_nodes);
+    printf("Lengths:\t%d instruction forms, %s\n", REFERENCE_OPS_COUNT, failures ? "\033[91mFAILED\033[0m" : "\033[92mPASSED\033[0m");
+
+    struct Z80HLAContext *test_context = context;
+    int encoding_failures = check_encodings();
+    context = test_context;
+    printf("Encodings:\t%d instruction forms, %s\n\n", REFERENCE_OPS_COUNT, encoding_failures ? "\033[91mFAILED\033[0m" : "\033[92mPASSED\033[0m");
+    remove(SOURCE_FILENAME);
+
+    benchmark(op_nodes, rounds, FALSE);
+    benchmark(op_nodes, rounds, TRUE);
+
+    destroy_lexer(&lexer);
+    free(op_nodes);
+    destroy_context(context);
+
+    return failures || encoding_failures ? 1 : 0;
+}
@@ -0,0 +1,9 @@
+db "Hello", 9, "world", 10, 0
+db 34, "quoted", 34, " ", 92, " ", 39, 0, 27, $FF
+db 1, 2, end_label & $ff, 3, "ab", -128, 255, 'x', 10
+dw $FFFF, -1, 1000, end_label, 5
+dw $5678, $1234, $FFFF, $FFFF, $FFFF, $FFFF
+db $7F, $7F, $7F, $7F
+
+end_label:
+nop
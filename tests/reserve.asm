@@ -0,0 +1,4 @@
+ld hl, $C000
+ld de, $E000
+ld bc, $F004
+ld ($F400), a
@@ -68,6 +68,65 @@ def standardTest(name):
             removeFile(outputFile1)
             removeFile(outputFile2)
 
+def errorTest(name, error):
+    filePath = name + ".z80hla"
+    outputFile = name + "_output.bin"
+    try:
+        output = os.popen(f"{z80hla_executable} -o {outputFile} {filePath} 2>&1").read()
+        return error in output
+    finally:
+        removeFile(outputFile)
+
+def symbolsTest(name, options, expectedFile):
+    result = False
+    filePath = name + ".z80hla"
+    outputFile = name + "_output.bin"
+    symbolsFile = name + "_output.sym"
+    try:
+        removeFile(symbolsFile)
+        os.system(f"{z80hla_executable} {options} -s {symbolsFile} -o {outputFile} {filePath} > /dev/null 2>&1")
+        if (not os.path.exists(symbolsFile)):
+            return False
+        result = compare_binaries(symbolsFile, expectedFile)
+        return result
+    finally:
+        removeFile(outputFile)
+        if result:
+            removeFile(symbolsFile)
+
+def invalidOpTest(cpuType, op):
+    filePath = "invalid_op.z80hla"
+    try:
+        with open(filePath, mode='w') as file:
+            file.write(f"#cpu_type \"{cpuType}\"\n{op}\n")
+        return errorTest("invalid_op", f"invalid_op.z80hla:2: Invalid combination of instruction \"{op.split()[0]}\" and operands")
+    finally:
+        removeFile(filePath)
+
+def linkTest(name, modules):
+    result = False
+    filePath = name + ".z80hla"
+    outputFile1 = name + "_output1.bin"
+    outputFile2 = name + "_output2.bin"
+    objectFiles = [module + "_output.z80o" for module in modules]
+    try:
+        removeFile(outputFile1)
+        removeFile(outputFile2)
+        for module, objectFile in zip(modules, objectFiles):
+            os.system(f"{z80hla_executable} --object -o {objectFile} {module}.z80hla > /dev/null 2>&1")
+        os.system(f"{z80hla_executable} --link -o {outputFile1} {' '.join(objectFiles)} > /dev/null 2>&1")
+        os.system(f"{z80hla_executable} -o {outputFile2} {filePath} > /dev/null 2>&1")
+        if ((not os.path.exists(outputFile1)) or (not os.path.exists(outputFile2))):
+            return False
+        result = compare_binaries(outputFile1, outputFile2)
+        return result
+    finally:
+        for objectFile in objectFiles:
+            removeFile(objectFile)
+        if result:
+            removeFile(outputFile1)
+            removeFile(outputFile2)
+
 
 def testAllOps():
     """All ops     """
@@ -109,6 +168,36 @@ def testContinueif():
     """Continueif  """
     return standardTest("continueif")
 
+def testLabels():
+    """Labels      """
+    return symbolsTest("labels", "", "labels.sym")
+
+def testGeneratedLabels():
+    """Generated labels"""
+    return symbolsTest("labels", "-g", "labels_generated.sym")
+
+def testPacked():
+    """Packed      """
+    return standardTest("packed")
+
+def testPackedRange():
+    """Packed range"""
+    return errorTest("packed_range", "packed_range.z80hla:2: Expression value 300 is an invalid 8-bit value")
+
+def testReserve():
+    """Reserve     """
+    return standardTest("reserve")
+
+def testInvalidOps():
+    """Invalid ops """
+    return all(invalidOpTest(cpuType, op) for cpuType, op in [
+        ("z80", "ld a, (c)"), ("z80", "ld (c), a"), ("msx", "ld a, (c)"), ("msx", "ld (c), a"),
+        ("gb", "exx"), ("gb", "set 1, (ix+2)"), ("gb", "set 1, (iy-2)")])
+
+def testLink():
+    """Link        """
+    return linkTest("link", ["link_main", "link_sound"])
+
 if __name__ == "__main__":
     print("Z80HLA Tests\n")
     testFunctions = [obj for name,obj in inspect.getmembers(sys.modules[__name__]) if (inspect.isfunction(obj) and name.startswith('test'))]
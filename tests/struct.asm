@@ -10,4 +10,7 @@ ld hl, 4
 
 db 0, 0, 0, 0, $64, 0, 0, 0
 
-ld hl, 48
\ No newline at end of file
+ld hl, 48
+
+dw $1234
+db 5, 1, 0, 0, 2